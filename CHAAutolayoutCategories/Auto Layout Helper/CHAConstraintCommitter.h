@@ -0,0 +1,49 @@
+//
+//  CHAConstraintCommitter.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import "CHAConstraintDescriptor.h"
+
+/**
+ @description Installs constraints described on any thread in one batch per turn of the main run loop.
+ @discussion Build descriptor records for a whole screen off the main thread and hand them over with commit...; nothing
+ touches UIKit until the main run loop next turns, when every record committed since the last turn is materialized and
+ installed on the nearest common ancestor of its items, one addConstraints: per ancestor. The views must already be in
+ their final hierarchy when the commit runs. Items are retained from commit until they are installed.
+ */
+@interface CHAConstraintCommitter : NSObject
+
+/**
+ @description The committer that installs on the main run loop
+ */
++ (instancetype)mainCommitter;
+
+/**
+ @description Queue every record of a batch for the next commit. Thread-safe.
+ @param batch A batch whose items are UIView's bridged to const void *
+ */
+- (void)commitDescriptorBatch:(const CHADescriptorBatch *)batch;
+
+/**
+ @description Queue a run of records for the next commit. Thread-safe.
+ @param records Records whose items are UIView's bridged to const void *
+ @param count The number of records
+ */
+- (void)commitDescriptors:(const CHAConstraintDescriptor *)records count:(NSUInteger)count;
+
+/**
+ @description Install everything queued so far without waiting for the run loop. Main thread only.
+ @return The number of records installed
+ */
+- (NSUInteger)flush;
+
+/**
+ @description The number of batched installs so far
+ */
+@property (nonatomic, readonly) NSUInteger commitCount;
+
+@end
@@ -0,0 +1,109 @@
+//
+//  CHAConstraintCommitter.mm
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import "CHAConstraintCommitter.h"
+#import "UIView+AutoLayoutHelper.h"
+
+#include <memory>
+
+#include "CHAConstraintCommitQueue.h"
+
+static void CHAReleaseItems(const CHAConstraintDescriptor *records, size_t count)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        CFRelease(records[index].item);
+        if (records[index].toItem) CFRelease(records[index].toItem);
+    }
+}
+
+static const void *CHASuperviewOfItem(const void *item)
+{
+    id object = (__bridge id)item;
+    if (![object isKindOfClass:[UIView class]]) return NULL;
+    return (__bridge const void *)[(UIView *)object superview];
+}
+
+@implementation CHAConstraintCommitter
+{
+    std::unique_ptr<cha::ConstraintCommitQueue> _queue;
+}
+
++ (instancetype)mainCommitter
+{
+    static CHAConstraintCommitter *mainCommitter;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mainCommitter = [self new];
+    });
+    return mainCommitter;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (!self) return nil;
+
+    __weak CHAConstraintCommitter *weakSelf = self;
+    auto commit = [](const cha::CommitBatch &batch) {
+        for (const cha::CommitGroup &group : batch.groups)
+        {
+            UIView *ancestor = (__bridge UIView *)group.ancestor;
+            [ancestor addConstraints:[UIView constraintsWithDescriptors:&batch.records[group.first] count:group.count]];
+        }
+
+        for (const CHAConstraintDescriptor &orphan : batch.orphans)
+        {
+            NSLog(@"Not installed, %@ and %@ share no ancestor.", (__bridge id)orphan.item, (__bridge id)orphan.toItem);
+        }
+        NSCAssert(batch.orphans.empty(), @"Committed constraints between views in different hierarchies.");
+
+        CHAReleaseItems(batch.records.data(), batch.records.size());
+        CHAReleaseItems(batch.orphans.data(), batch.orphans.size());
+    };
+    // One perform block per wake; the queue asks again only after the block has drained it.
+    auto wake = [weakSelf] {
+        CFRunLoopRef mainRunLoop = CFRunLoopGetMain();
+        CFRunLoopPerformBlock(mainRunLoop, kCFRunLoopCommonModes, ^{
+            [weakSelf flush];
+        });
+        CFRunLoopWakeUp(mainRunLoop);
+    };
+    _queue.reset(new cha::ConstraintCommitQueue(CHASuperviewOfItem, commit, wake));
+    return self;
+}
+
+- (void)commitDescriptorBatch:(const CHADescriptorBatch *)batch
+{
+    NSAssert(batch != NULL, @"No descriptor batch provided.");
+    [self commitDescriptors:batch->records count:batch->count];
+}
+
+- (void)commitDescriptors:(const CHAConstraintDescriptor *)records count:(NSUInteger)count
+{
+    NSAssert(records != NULL || count == 0, @"No descriptor records provided.");
+    for (NSUInteger index = 0; index < count; index++)
+    {
+        NSAssert(records[index].item != NULL, @"Every record needs an item.");
+        CFRetain(records[index].item);
+        if (records[index].toItem) CFRetain(records[index].toItem);
+    }
+    _queue->submit(records, count);
+}
+
+- (NSUInteger)flush
+{
+    NSAssert([NSThread isMainThread], @"Constraints must be installed on the main thread.");
+    return (NSUInteger)_queue->drain();
+}
+
+- (NSUInteger)commitCount
+{
+    return (NSUInteger)_queue->commitCount();
+}
+
+@end
@@ -0,0 +1,42 @@
+//
+//  CHAConstraintEditHandle.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ @description Animates the constant of one constraint, frame by frame, without removing or recreating the constraint.
+ @discussion A suggested value is written to the constraint's constant only when it differs from the current one; that
+ skipped write is the only saving over setting the constant directly. UIKit carries each constant change into the rows of
+ its engine that mention the constraint rather than rebuilding them, so the cost of a frame does not grow with the number
+ of constraints in the window. The value is the constraint's own constant: for trailing and bottom pins that is the
+ negated margin.
+ */
+@interface CHAConstraintEditHandle : NSObject
+
+/**
+ @param constraint The constraint to edit; it stays installed throughout
+ */
+- (instancetype)initWithConstraint:(NSLayoutConstraint *)constraint;
+
+@property (nonatomic, readonly) NSLayoutConstraint *constraint;
+@property (nonatomic, readonly) CGFloat value;
+
+/**
+ @description Move the constraint's constant to a value, e.g. from a CADisplayLink callback
+ */
+- (void)suggestValue:(CGFloat)value;
+
+/**
+ @description Suggest a value to each of several handles, in order
+ @discussion Each handle whose value changed sets its constant, and so updates the engine, on its own; handles whose value
+ is unchanged are skipped.
+ @param values One value per handle, in the same order
+ @param handles CHAConstraintEditHandle's
+ */
++ (void)suggestValues:(const CGFloat *)values forHandles:(NSArray *)handles;
+
+@end
@@ -0,0 +1,51 @@
+//
+//  CHAConstraintEditHandle.m
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import "CHAConstraintEditHandle.h"
+
+@implementation CHAConstraintEditHandle
+
+- (instancetype)init
+{
+    return [self initWithConstraint:nil];
+}
+
+- (instancetype)initWithConstraint:(NSLayoutConstraint *)constraint
+{
+    NSAssert(constraint != nil, @"No constraint provided. Please provide the constraint to edit.");
+    self = [super init];
+    if (!self) return nil;
+
+    _constraint = constraint;
+    return self;
+}
+
+- (CGFloat)value
+{
+    return self.constraint.constant;
+}
+
+- (void)suggestValue:(CGFloat)value
+{
+    // Handles that hold still in a frame cost nothing.
+    if (self.constraint.constant == value) return;
+    self.constraint.constant = value;
+}
+
++ (void)suggestValues:(const CGFloat *)values forHandles:(NSArray *)handles
+{
+    NSAssert(values != NULL || handles.count == 0, @"No values provided. Please provide one value per handle.");
+
+    NSUInteger index = 0;
+    for (CHAConstraintEditHandle *handle in handles)
+    {
+        NSAssert([handle isKindOfClass:[CHAConstraintEditHandle class]], @"Invalid object type provided. Only edit handles should be provided");
+        [handle suggestValue:values[index++]];
+    }
+}
+
+@end
@@ -0,0 +1,78 @@
+//
+//  CHALayoutPrecomputer.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ @description A view hierarchy's constraints recorded once, independent of any particular view instances.
+ @discussion Views are identified by their position in the views array; the container is slot 0. Every constraint must relate
+ only the container and those views, so the template can be solved on a background thread without touching UIKit.
+ */
+@interface CHALayoutTemplate : NSObject
+
+/**
+ @description Record a template from a prototype hierarchy
+ @param container The view whose bounds the frames are measured against
+ @param views The container's descendants, in the order frames are later applied
+ @param constraints Constraints built by the helpers (active or not) among container and views
+ @return A template that can be shared by every hierarchy with the same structure
+ */
+- (instancetype)initWithContainer:(UIView *)container views:(NSArray *)views constraints:(NSArray *)constraints;
+
+@property (nonatomic, readonly) NSUInteger viewCount;
+
+@end
+
+/**
+ @description Solves layout templates off the main thread and caches the frames by container size and content.
+ @discussion Typical use is a table view prefetching rows: call precompute... as rows come into range, then apply... from
+ -layoutSubviews. Apply falls back to a synchronous solve on a miss, so it always succeeds, but a hit costs only a cache lookup
+ and one frame assignment per view. Views laid out this way should not also carry active constraints.
+ */
+@interface CHALayoutPrecomputer : NSObject
+
++ (instancetype)sharedPrecomputer;
+
+/**
+ @param cacheCapacity The number of solved instances to keep
+ */
+- (instancetype)initWithCacheCapacity:(NSUInteger)cacheCapacity;
+
+/**
+ @description Solve a template in the background unless the result is already cached or being solved
+ @param width The container width
+ @param contentHash Identifies the content sizes, e.g. a hash of the model object shown in the cell
+ @param contentSizes One NSValue-wrapped CGSize per view of the template; zero dimensions are left to the constraints
+ */
+- (void)precomputeTemplate:(CHALayoutTemplate *)layoutTemplate
+                     width:(CGFloat)width
+               contentHash:(NSUInteger)contentHash
+              contentSizes:(NSArray *)contentSizes;
+
+/**
+ @description The container height the constraints give a template at a width, solving synchronously on a miss
+ */
+- (CGFloat)heightForTemplate:(CHALayoutTemplate *)layoutTemplate
+                       width:(CGFloat)width
+                 contentHash:(NSUInteger)contentHash
+                contentSizes:(NSArray *)contentSizes;
+
+/**
+ @description Assign cached frames to a hierarchy with the template's structure, solving synchronously on a miss
+ @param views The views in the same order as when the template was recorded
+ @return YES if the frames came from the cache
+ */
+- (BOOL)applyTemplate:(CHALayoutTemplate *)layoutTemplate
+          toContainer:(UIView *)container
+                views:(NSArray *)views
+          contentHash:(NSUInteger)contentHash
+         contentSizes:(NSArray *)contentSizes;
+
+@property (nonatomic, readonly) NSUInteger cacheHitCount;
+@property (nonatomic, readonly) NSUInteger cacheMissCount;
+
+@end
@@ -0,0 +1,186 @@
+//
+//  CHALayoutPrecomputer.mm
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import "CHALayoutPrecomputer.h"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include "CHALayoutPipeline.h"
+
+static const NSUInteger CHALayoutPrecomputerDefaultCacheCapacity = 512;
+
+@interface CHALayoutTemplate ()
+{
+    std::shared_ptr<const cha::LayoutTemplate> _template;
+}
+
+- (const std::shared_ptr<const cha::LayoutTemplate> &)portableTemplate;
+
+@end
+
+@implementation CHALayoutTemplate
+
+- (instancetype)initWithContainer:(UIView *)container views:(NSArray *)views constraints:(NSArray *)constraints
+{
+    NSAssert(container != nil, @"A template needs a container view.");
+    self = [super init];
+    if (!self) return nil;
+
+    static std::atomic<uint64_t> nextIdentifier(1);
+    auto layoutTemplate = std::make_shared<cha::LayoutTemplate>(nextIdentifier.fetch_add(1), (uint32_t)views.count + 1);
+
+    std::unordered_map<const void *, const void *> slots;
+    slots[(__bridge const void *)container] = cha::LayoutTemplate::slotHandle(0);
+    for (NSUInteger index = 0; index < views.count; index++)
+    {
+        slots[(__bridge const void *)views[index]] = cha::LayoutTemplate::slotHandle((uint32_t)index + 1);
+    }
+
+    for (NSLayoutConstraint *constraint in constraints)
+    {
+        auto item = slots.find((__bridge const void *)constraint.firstItem);
+        auto toItem = slots.find((__bridge const void *)constraint.secondItem);
+        BOOL related = item != slots.end() && (toItem != slots.end() || constraint.secondItem == nil);
+        NSAssert(related, @"Template constraints may only relate the container and the template's views: %@", constraint);
+        if (!related) continue;
+
+        CHAConstraintDescriptor descriptor = {item->second, toItem != slots.end() ? toItem->second : NULL,
+                                              constraint.multiplier, constraint.constant, constraint.priority,
+                                              (CHALayoutAttribute)constraint.firstAttribute,
+                                              (CHALayoutAttribute)constraint.secondAttribute,
+                                              (CHALayoutRelation)constraint.relation, 0};
+        layoutTemplate->addDescriptor(descriptor);
+    }
+
+    _template = layoutTemplate;
+    _viewCount = views.count;
+    return self;
+}
+
+- (const std::shared_ptr<const cha::LayoutTemplate> &)portableTemplate
+{
+    return _template;
+}
+
+@end
+
+static cha::LayoutRequest CHALayoutRequestMake(CHALayoutTemplate *layoutTemplate,
+                                               CGFloat width,
+                                               NSUInteger contentHash,
+                                               NSArray *contentSizes)
+{
+    NSCAssert(contentSizes.count == 0 || contentSizes.count == layoutTemplate.viewCount,
+              @"Pass one content size per template view, or none.");
+
+    cha::LayoutRequest request = {width, -1, contentHash, {}};
+    request.contentSizes.reserve(contentSizes.count);
+    for (NSUInteger index = 0; index < contentSizes.count; index++)
+    {
+        CGSize size = [contentSizes[index] CGSizeValue];
+        if (size.width > 0 || size.height > 0) request.contentSizes.push_back({(uint32_t)index + 1, size.width, size.height});
+    }
+    return request;
+}
+
+@implementation CHALayoutPrecomputer
+{
+    std::unique_ptr<cha::LayoutPipeline> _pipeline;
+}
+
++ (instancetype)sharedPrecomputer
+{
+    static CHALayoutPrecomputer *sharedPrecomputer;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedPrecomputer = [[self alloc] initWithCacheCapacity:CHALayoutPrecomputerDefaultCacheCapacity];
+    });
+    return sharedPrecomputer;
+}
+
+- (instancetype)init
+{
+    return [self initWithCacheCapacity:CHALayoutPrecomputerDefaultCacheCapacity];
+}
+
+- (instancetype)initWithCacheCapacity:(NSUInteger)cacheCapacity
+{
+    self = [super init];
+    if (!self) return nil;
+
+    // Leave a core for the main thread.
+    NSUInteger workers = MAX((NSUInteger)1, [NSProcessInfo processInfo].activeProcessorCount - 1);
+    _pipeline.reset(new cha::LayoutPipeline(cacheCapacity, workers));
+    return self;
+}
+
+#pragma mark - Precomputing
+
+- (void)precomputeTemplate:(CHALayoutTemplate *)layoutTemplate
+                     width:(CGFloat)width
+               contentHash:(NSUInteger)contentHash
+              contentSizes:(NSArray *)contentSizes
+{
+    _pipeline->enqueue(layoutTemplate.portableTemplate, CHALayoutRequestMake(layoutTemplate, width, contentHash, contentSizes));
+}
+
+- (CGFloat)heightForTemplate:(CHALayoutTemplate *)layoutTemplate
+                       width:(CGFloat)width
+                 contentHash:(NSUInteger)contentHash
+                contentSizes:(NSArray *)contentSizes
+{
+    cha::LayoutRequest request = CHALayoutRequestMake(layoutTemplate, width, contentHash, contentSizes);
+    cha::FrameCache::Frames frames = _pipeline->solveSynchronously(*layoutTemplate.portableTemplate, request);
+    return (CGFloat)(*frames)[0].height;
+}
+
+#pragma mark - Applying
+
+- (BOOL)applyTemplate:(CHALayoutTemplate *)layoutTemplate
+          toContainer:(UIView *)container
+                views:(NSArray *)views
+          contentHash:(NSUInteger)contentHash
+         contentSizes:(NSArray *)contentSizes
+{
+    NSAssert([NSThread isMainThread], @"Frames must be applied on the main thread.");
+    NSAssert(views.count == layoutTemplate.viewCount, @"The views must match the template's views.");
+
+    cha::LayoutRequest request = CHALayoutRequestMake(layoutTemplate, CGRectGetWidth(container.bounds), contentHash, contentSizes);
+    const cha::LayoutTemplate &portableTemplate = *layoutTemplate.portableTemplate;
+    cha::FrameCache::Frames frames = _pipeline->framesFor(portableTemplate, request);
+    BOOL cached = frames != nullptr;
+    if (!cached) frames = _pipeline->solveSynchronously(portableTemplate, request);
+
+    // Solved frames are in container coordinates; each view's frame is relative to its own superview.
+    [views enumerateObjectsUsingBlock:^(UIView *view, NSUInteger index, BOOL *stop) {
+        const cha::Frame &frame = (*frames)[index + 1];
+        CGRect rect = CGRectMake(frame.x, frame.y, frame.width, frame.height);
+
+        UIView *superview = view.superview;
+        NSUInteger superviewIndex = superview == container ? NSNotFound : [views indexOfObjectIdenticalTo:superview];
+        if (superviewIndex != NSNotFound)
+        {
+            const cha::Frame &superviewFrame = (*frames)[superviewIndex + 1];
+            rect = CGRectOffset(rect, -superviewFrame.x, -superviewFrame.y);
+        }
+        view.frame = rect;
+    }];
+    return cached;
+}
+
+- (NSUInteger)cacheHitCount
+{
+    return (NSUInteger)_pipeline->cache().hitCount();
+}
+
+- (NSUInteger)cacheMissCount
+{
+    return (NSUInteger)_pipeline->cache().missCount();
+}
+
+@end
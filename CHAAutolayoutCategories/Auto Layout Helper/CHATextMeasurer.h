@@ -0,0 +1,41 @@
+//
+//  CHATextMeasurer.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+/**
+ @description Measures text once per distinct string, font, width and line limit and remembers the result.
+ @discussion Sizes are kept in a least-recently-used cache held to a memory budget, and the cache is emptied on a memory
+ warning. Strings are keyed by a hash of their full contents and fonts by name and point size, so equal text in
+ different cells shares an entry. Thread-safe.
+ */
+@interface CHATextMeasurer : NSObject
+
++ (instancetype)sharedMeasurer;
+
+/**
+ @param byteBudget The most memory the cached sizes may take
+ */
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget;
+
+/**
+ @description The size text takes when wrapped at a width
+ @param width The wrapping width, or 0 for a single unbounded line
+ @param lineLimit The maximum number of lines, or 0 for no limit
+ @return The size, rounded up to whole points
+ */
+- (CGSize)sizeForText:(NSString *)text font:(UIFont *)font width:(CGFloat)width lineLimit:(NSUInteger)lineLimit;
+
+- (void)removeAllSizes;
+
+@property (nonatomic, assign) NSUInteger byteBudget;
+@property (nonatomic, readonly) NSUInteger hitCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+@property (nonatomic, readonly) NSUInteger evictionCount;
+@property (nonatomic, readonly) double hitRate;
+
+@end
@@ -0,0 +1,147 @@
+//
+//  CHATextMeasurer.mm
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import "CHATextMeasurer.h"
+
+#include <memory>
+#include <vector>
+
+#include "CHATextMeasurementCache.h"
+
+static const NSUInteger CHATextMeasurerDefaultByteBudget = 256 * 1024;
+
+/**
+ @description What a miss hands the measurer: the objects the key was made from
+ */
+struct CHATextMeasurement
+{
+    __unsafe_unretained NSString *text;
+    __unsafe_unretained UIFont *font;
+};
+
+static uint64_t CHATextHash(NSString *text)
+{
+    const NSUInteger length = text.length;
+    const UniChar *characters = CFStringGetCharactersPtr((__bridge CFStringRef)text);
+    if (characters) return cha::hashBytes(characters, length * sizeof(UniChar));
+
+    std::vector<UniChar> buffer(length);
+    [text getCharacters:buffer.data() range:NSMakeRange(0, length)];
+    return cha::hashBytes(buffer.data(), length * sizeof(UniChar));
+}
+
+static uint64_t CHAFontHash(UIFont *font)
+{
+    const char *name = font.fontName.UTF8String;
+    const double pointSize = font.pointSize;
+    uint64_t hash = cha::hashBytes(name, strlen(name));
+    return cha::hashBytes(&pointSize, sizeof(pointSize), hash);
+}
+
+static cha::TextSize CHAMeasureText(const cha::TextMeasurementKey &key, const void *context)
+{
+    const CHATextMeasurement *measurement = static_cast<const CHATextMeasurement *>(context);
+    UIFont *font = measurement->font;
+
+    CGFloat maximumHeight = key.lineLimit > 0 ? key.lineLimit * font.lineHeight : CGFLOAT_MAX;
+    CGSize bounds = CGSizeMake(key.width > 0 ? key.width : CGFLOAT_MAX, maximumHeight);
+    CGRect rect = [measurement->text boundingRectWithSize:bounds
+                                                  options:NSStringDrawingUsesLineFragmentOrigin
+                                               attributes:@{NSFontAttributeName : font}
+                                                  context:nil];
+    return cha::TextSize{ceil(CGRectGetWidth(rect)), ceil(MIN(CGRectGetHeight(rect), maximumHeight))};
+}
+
+@implementation CHATextMeasurer
+{
+    std::unique_ptr<cha::TextMeasurementCache> _cache;
+}
+
++ (instancetype)sharedMeasurer
+{
+    static CHATextMeasurer *sharedMeasurer;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedMeasurer = [[self alloc] initWithByteBudget:CHATextMeasurerDefaultByteBudget];
+    });
+    return sharedMeasurer;
+}
+
+- (instancetype)init
+{
+    return [self initWithByteBudget:CHATextMeasurerDefaultByteBudget];
+}
+
+- (instancetype)initWithByteBudget:(NSUInteger)byteBudget
+{
+    self = [super init];
+    if (!self) return nil;
+
+    _cache.reset(new cha::TextMeasurementCache(byteBudget, CHAMeasureText));
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(removeAllSizes)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+#pragma mark - Measuring
+
+- (CGSize)sizeForText:(NSString *)text font:(UIFont *)font width:(CGFloat)width lineLimit:(NSUInteger)lineLimit
+{
+    NSAssert(font != nil, @"No font provided. Please provide the font the text is drawn in.");
+    if (text.length == 0) return CGSizeMake(0, ceil(font.lineHeight));
+
+    cha::TextMeasurementKey key = {CHATextHash(text), CHAFontHash(font), MAX(width, 0), (uint32_t)lineLimit};
+    CHATextMeasurement measurement = {text, font};
+    cha::TextSize size = _cache->measure(key, &measurement);
+    return CGSizeMake(size.width, size.height);
+}
+
+- (void)removeAllSizes
+{
+    _cache->clear();
+}
+
+#pragma mark - Budget and Counters
+
+- (NSUInteger)byteBudget
+{
+    return (NSUInteger)_cache->byteBudget();
+}
+
+- (void)setByteBudget:(NSUInteger)byteBudget
+{
+    _cache->setByteBudget(byteBudget);
+}
+
+- (NSUInteger)hitCount
+{
+    return (NSUInteger)_cache->hitCount();
+}
+
+- (NSUInteger)missCount
+{
+    return (NSUInteger)_cache->missCount();
+}
+
+- (NSUInteger)evictionCount
+{
+    return (NSUInteger)_cache->evictionCount();
+}
+
+- (double)hitRate
+{
+    return _cache->hitRate();
+}
+
+@end
@@ -0,0 +1,45 @@
+//
+//  CHAAspectRatio.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAAspectRatio.h"
+
+namespace cha {
+
+RatioStatus resolveRatio(const RatioSpec &spec, double intrinsicWidth, double intrinsicHeight, double *multiplier)
+{
+    double width = spec.width;
+    double height = spec.height;
+
+    switch (spec.source)
+    {
+        case RatioSourceDeclared:
+            if (!(width > 0) || !(height > 0)) return RatioStatusInvalid;
+            break;
+        case RatioSourceImageSize:
+            // An image that has not loaded reports a zero size.
+            if (!(width > 0) || !(height > 0)) return RatioStatusPending;
+            break;
+        case RatioSourceIntrinsicSize:
+            if (intrinsicWidth > 0 && intrinsicHeight > 0)
+            {
+                width = intrinsicWidth;
+                height = intrinsicHeight;
+            }
+            else if (!(width > 0) || !(height > 0))
+            {
+                return RatioStatusPending;
+            }
+            break;
+        default:
+            return RatioStatusInvalid;
+    }
+
+    if (multiplier) *multiplier = height / width;
+    return RatioStatusResolved;
+}
+
+}
@@ -0,0 +1,64 @@
+//
+//  CHAAspectRatio.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAAspectRatio_h
+#define CHAAutolayoutCategories_CHAAspectRatio_h
+
+#include <cstdint>
+
+namespace cha {
+
+/**
+ @description Where a ratio constraint takes its width:height ratio from. None of them is the item's current frame.
+ */
+enum RatioSource : uint8_t
+{
+    // A ratio the caller states, e.g. 16:9.
+    RatioSourceDeclared,
+    // The pixel or point size of an image the item will show, known before the item is laid out.
+    RatioSourceImageSize,
+    // The item's intrinsic content size, looked up when the ratio is first resolved.
+    RatioSourceIntrinsicSize
+};
+
+/**
+ @description A width:height ratio to be resolved into the multiplier of height = multiplier * width
+ @field width For RatioSourceIntrinsicSize, the fallback used while the intrinsic size is unknown (0 for none)
+ */
+struct RatioSpec
+{
+    RatioSource source;
+    double width;
+    double height;
+
+    static RatioSpec declared(double width, double height) { return RatioSpec{RatioSourceDeclared, width, height}; }
+    static RatioSpec imageSize(double width, double height) { return RatioSpec{RatioSourceImageSize, width, height}; }
+    static RatioSpec intrinsicSize(double fallbackWidth = 0, double fallbackHeight = 0)
+    {
+        return RatioSpec{RatioSourceIntrinsicSize, fallbackWidth, fallbackHeight};
+    }
+};
+
+enum RatioStatus
+{
+    RatioStatusResolved = 0,
+    // The source has no size yet, e.g. an image that has not loaded or a view without intrinsic content size.
+    RatioStatusPending,
+    // A declared ratio with a dimension that is not positive.
+    RatioStatusInvalid
+};
+
+/**
+ @description Turn a ratio into a height-for-width multiplier
+ @param intrinsicWidth The item's intrinsic width, or a non-positive value if it has none; only read for RatioSourceIntrinsicSize
+ @param multiplier Receives height / width when the ratio resolves
+ */
+RatioStatus resolveRatio(const RatioSpec &spec, double intrinsicWidth, double intrinsicHeight, double *multiplier);
+
+}
+
+#endif
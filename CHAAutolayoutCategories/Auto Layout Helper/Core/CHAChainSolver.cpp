@@ -0,0 +1,61 @@
+//
+//  CHAChainSolver.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAChainSolver.h"
+
+#include <cmath>
+
+namespace cha {
+
+namespace {
+
+const double kTolerance = 1e-6;
+
+}
+
+ChainStatus solveChain(const Chain &chain, double length, std::vector<ChainSpan> &spans, double *solvedLength)
+{
+    double fixed = chain.leadingMargin + (chain.pinTrailing ? chain.trailingMargin : 0.0);
+    double weight = 0.0;
+    for (size_t i = 0; i < chain.items.size(); i++)
+    {
+        const ChainItem &item = chain.items[i];
+        if (i > 0) fixed += item.spacing;
+        if (item.sizing == ChainSizingFixed) fixed += item.value;
+        else weight += item.value;
+    }
+
+    if (!chain.pinTrailing && length < 0.0) return ChainStatusUnderconstrained;
+
+    double unit = 0.0;
+    if (weight != 0.0)
+    {
+        if (!chain.pinTrailing || length < 0.0) return ChainStatusUnderconstrained;
+        unit = (length - fixed) / weight;
+    }
+    else if (chain.pinTrailing)
+    {
+        if (length < 0.0) length = fixed;
+        else if (std::fabs(length - fixed) > kTolerance) return ChainStatusUnsatisfiable;
+    }
+
+    spans.resize(chain.items.size());
+    double offset = chain.leadingMargin;
+    for (size_t i = 0; i < chain.items.size(); i++)
+    {
+        const ChainItem &item = chain.items[i];
+        if (i > 0) offset += item.spacing;
+        const double itemLength = item.sizing == ChainSizingFixed ? item.value : item.value * unit;
+        spans[i] = ChainSpan{offset, itemLength};
+        offset += itemLength;
+    }
+
+    if (solvedLength) *solvedLength = length;
+    return ChainStatusOK;
+}
+
+}
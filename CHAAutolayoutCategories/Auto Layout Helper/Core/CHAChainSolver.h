@@ -0,0 +1,69 @@
+//
+//  CHAChainSolver.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAChainSolver_h
+#define CHAAutolayoutCategories_CHAChainSolver_h
+
+#include <cstddef>
+#include <vector>
+
+namespace cha {
+
+enum ChainSizing
+{
+    // The item has a fixed length along the chain.
+    ChainSizingFixed = 0,
+    // The item's length is its weight times a shared unit that absorbs the remaining space.
+    ChainSizingWeighted
+};
+
+struct ChainItem
+{
+    ChainSizing sizing;
+    // The fixed length, or the weight.
+    double value;
+    // The gap before this item; ignored for the first item.
+    double spacing;
+};
+
+/**
+ @description A 1-D chain: items placed end to end from a leading margin, optionally ending at a trailing margin
+ */
+struct Chain
+{
+    double leadingMargin;
+    double trailingMargin;
+    bool pinTrailing;
+    std::vector<ChainItem> items;
+};
+
+struct ChainSpan
+{
+    double offset;
+    double length;
+};
+
+enum ChainStatus
+{
+    ChainStatusOK = 0,
+    // Nothing fixes the weighted unit or the container length, e.g. weighted items with an unpinned end.
+    ChainStatusUnderconstrained,
+    // Only fixed items, both ends pinned, and they do not add up to the container length.
+    ChainStatusUnsatisfiable
+};
+
+/**
+ @description Resolve a chain in two linear passes, one to total the fixed lengths and weights, one to place items.
+ @param length The container length, or negative to derive it from the chain (only possible without weighted items)
+ @param solvedLength Receives the container length used; may be null
+ @return ChainStatusOK, in which case spans holds one span per item
+ */
+ChainStatus solveChain(const Chain &chain, double length, std::vector<ChainSpan> &spans, double *solvedLength = nullptr);
+
+}
+
+#endif
@@ -0,0 +1,332 @@
+//
+//  CHACompiledLayout.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHACompiledLayout.h"
+
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CHALayoutDSL.h"
+#include "CHATextMeasurementCache.h"
+
+namespace cha {
+
+namespace {
+
+const char kMagic[4] = {'C', 'H', 'A', 'L'};
+const uint16_t kVersion = 1;
+const size_t kRecordAlignment = 8;
+
+static_assert(sizeof(CompiledLayoutHeader) == 40, "The header layout is part of the format");
+static_assert(sizeof(CompiledRecord) == 32, "The record layout is part of the format");
+
+bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+size_t alignedSize(size_t size)
+{
+    return (size + kRecordAlignment - 1) / kRecordAlignment * kRecordAlignment;
+}
+
+bool validAttribute(CHALayoutAttribute attribute)
+{
+    return attribute >= CHALayoutAttributeLeft && attribute <= CHALayoutAttributeBaseline;
+}
+
+bool validRecord(const CompiledRecord &record, uint32_t slotCount)
+{
+    if (record.item >= slotCount || !validAttribute(record.attribute)) return false;
+    if (record.toItem == CompiledRecordNoSlot)
+    {
+        // Only a dimension can be a constant on its own.
+        if (record.toAttribute != CHALayoutAttributeNotAnAttribute) return false;
+        if (!dsl::isDimensionAttribute(record.attribute)) return false;
+    }
+    else if (record.toItem >= slotCount || !validAttribute(record.toAttribute))
+    {
+        return false;
+    }
+    else if (!dsl::canRelateAttributes(record.attribute, record.toAttribute))
+    {
+        return false;
+    }
+    if (record.relation < CHALayoutRelationLessThanOrEqual || record.relation > CHALayoutRelationGreaterThanOrEqual)
+    {
+        return false;
+    }
+    // Written as !(in range) so that NaN fails.
+    if (!(record.priority > 0 && record.priority <= CHALayoutPriorityRequired)) return false;
+    return std::isfinite(record.multiplier) && std::isfinite(record.constant) && record.reserved == 0;
+}
+
+// Slot handles are slot + 1, so that slot 0 is not null.
+uint32_t slotForHandle(const void *handle)
+{
+    const uintptr_t value = reinterpret_cast<uintptr_t>(handle);
+    return value == 0 || value - 1 >= CompiledRecordNoSlot ? CompiledRecordNoSlot : (uint32_t)(value - 1);
+}
+
+uint64_t mixLane(uint64_t lane, uint64_t word)
+{
+    lane = (lane ^ word) * 0x100000001b3ULL;
+    return lane ^ (lane >> 29);
+}
+
+uint32_t readOffset(const uint8_t *bytes)
+{
+    uint32_t offset;
+    std::memcpy(&offset, bytes, sizeof(offset));
+    return offset;
+}
+
+}
+
+const char *describeCompiledLayoutStatus(CompiledLayoutStatus status)
+{
+    switch (status)
+    {
+        case CompiledLayoutStatusOK: return "ok";
+        case CompiledLayoutStatusUnreadable: return "cannot be read";
+        case CompiledLayoutStatusTruncated: return "truncated";
+        case CompiledLayoutStatusBadMagic: return "not a compiled layout";
+        case CompiledLayoutStatusUnsupportedVersion: return "unsupported version";
+        case CompiledLayoutStatusWrongByteOrder: return "byte order differs from this host";
+        case CompiledLayoutStatusMisaligned: return "records are not 8-byte aligned in memory";
+        case CompiledLayoutStatusBadSection: return "section out of bounds";
+        case CompiledLayoutStatusBadChecksum: return "checksum mismatch";
+        case CompiledLayoutStatusBadRecord: return "invalid record";
+        case CompiledLayoutStatusBadName: return "invalid slot name";
+    }
+    return "unknown status";
+}
+
+uint64_t compiledLayoutChecksum(const void *bytes, size_t length)
+{
+    // Four independent lanes over 8-byte words, so the check keeps up with a mapped file instead of costing more than
+    // everything else the loader does.
+    const uint8_t *data = static_cast<const uint8_t *>(bytes);
+    uint64_t lanes[4] = {0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL, 0x9e3779b97f4a7c15ULL, 0x7f4a7c159e3779b9ULL};
+    size_t index = 0;
+    for (; index + 4 * sizeof(uint64_t) <= length; index += 4 * sizeof(uint64_t))
+    {
+        uint64_t words[4];
+        std::memcpy(words, data + index, sizeof(words));
+        for (int lane = 0; lane < 4; lane++) lanes[lane] = mixLane(lanes[lane], words[lane]);
+    }
+    uint64_t tail[4] = {0, 0, 0, 0};
+    std::memcpy(tail, data + index, length - index);
+    for (int lane = 0; lane < 4; lane++) lanes[lane] = mixLane(lanes[lane], tail[lane]);
+    return hashBytes(lanes, sizeof(lanes), length);
+}
+
+CompiledLayoutWriter::CompiledLayoutWriter(uint32_t slotCount) : slotCount_(slotCount), names_(slotCount), named_(false)
+{
+}
+
+bool CompiledLayoutWriter::setSlotName(uint32_t slot, const std::string &name)
+{
+    if (slot >= slotCount_ || name.find('\0') != std::string::npos) return false;
+    names_[slot] = name;
+    named_ = true;
+    return true;
+}
+
+bool CompiledLayoutWriter::addDescriptor(const CHAConstraintDescriptor &descriptor)
+{
+    CompiledRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.multiplier = descriptor.multiplier;
+    record.constant = descriptor.constant;
+    record.priority = descriptor.priority;
+    record.item = slotForHandle(descriptor.item);
+    record.toItem = slotForHandle(descriptor.toItem);
+    record.attribute = descriptor.attribute;
+    record.toAttribute = descriptor.toItem ? descriptor.toAttribute : (CHALayoutAttribute)CHALayoutAttributeNotAnAttribute;
+    record.relation = descriptor.relation;
+
+    if (!validRecord(record, slotCount_)) return false;
+    records_.push_back(record);
+    return true;
+}
+
+void CompiledLayoutWriter::write(std::vector<uint8_t> &bytes) const
+{
+    const size_t recordOffset = alignedSize(sizeof(CompiledLayoutHeader));
+    const size_t recordsEnd = recordOffset + records_.size() * sizeof(CompiledRecord);
+
+    size_t size = recordsEnd;
+    if (named_)
+    {
+        size += slotCount_ * sizeof(uint32_t);
+        for (const std::string &name : names_) size += name.size() + 1;
+    }
+
+    bytes.assign(size, 0);
+    if (!records_.empty()) std::memcpy(&bytes[recordOffset], records_.data(), records_.size() * sizeof(CompiledRecord));
+
+    if (named_)
+    {
+        size_t offset = slotCount_ * sizeof(uint32_t);
+        for (uint32_t slot = 0; slot < slotCount_; slot++)
+        {
+            const uint32_t nameOffset = (uint32_t)offset;
+            std::memcpy(&bytes[recordsEnd + slot * sizeof(uint32_t)], &nameOffset, sizeof(nameOffset));
+            std::memcpy(&bytes[recordsEnd + offset], names_[slot].data(), names_[slot].size());
+            offset += names_[slot].size() + 1;
+        }
+    }
+
+    CompiledLayoutHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = (uint16_t)sizeof(CompiledLayoutHeader);
+    header.slotCount = slotCount_;
+    header.recordCount = (uint32_t)records_.size();
+    header.recordOffset = (uint32_t)recordOffset;
+    header.nameOffset = named_ ? (uint32_t)recordsEnd : 0;
+    header.size = (uint32_t)size;
+    header.checksum = compiledLayoutChecksum(bytes.data() + sizeof(header), size - sizeof(header));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+}
+
+CompiledLayout::CompiledLayout()
+    : version_(0), slotCount_(0), recordCount_(0), records_(nullptr), names_(nullptr), namesSize_(0)
+{
+}
+
+CompiledLayoutStatus CompiledLayout::open(const void *bytes, size_t size)
+{
+    *this = CompiledLayout();
+
+    CompiledLayoutHeader header;
+    if (!bytes || size < sizeof(header)) return CompiledLayoutStatusTruncated;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return CompiledLayoutStatusBadMagic;
+    if (!hostIsLittleEndian()) return CompiledLayoutStatusWrongByteOrder;
+    if (header.version != kVersion) return CompiledLayoutStatusUnsupportedVersion;
+    if (header.headerSize < sizeof(header) || header.size < header.headerSize) return CompiledLayoutStatusBadSection;
+    if (header.size > size) return CompiledLayoutStatusTruncated;
+
+    // 64-bit arithmetic, so that no count or offset in the header can wrap the bounds checks.
+    const uint64_t recordsEnd = (uint64_t)header.recordOffset + (uint64_t)header.recordCount * sizeof(CompiledRecord);
+    if (header.recordOffset < header.headerSize || header.recordOffset % kRecordAlignment != 0 || recordsEnd > header.size)
+    {
+        return CompiledLayoutStatusBadSection;
+    }
+    const uint64_t nameTableEnd = (uint64_t)header.nameOffset + (uint64_t)header.slotCount * sizeof(uint32_t);
+    if (header.nameOffset != 0 && (header.nameOffset < recordsEnd || nameTableEnd > header.size))
+    {
+        return CompiledLayoutStatusBadSection;
+    }
+
+    const uint8_t *base = static_cast<const uint8_t *>(bytes);
+    if (reinterpret_cast<uintptr_t>(base + header.recordOffset) % kRecordAlignment != 0) return CompiledLayoutStatusMisaligned;
+    if (compiledLayoutChecksum(base + header.headerSize, header.size - header.headerSize) != header.checksum)
+    {
+        return CompiledLayoutStatusBadChecksum;
+    }
+
+    const CompiledRecord *records = reinterpret_cast<const CompiledRecord *>(base + header.recordOffset);
+    for (uint32_t index = 0; index < header.recordCount; index++)
+    {
+        if (!validRecord(records[index], header.slotCount)) return CompiledLayoutStatusBadRecord;
+    }
+
+    const uint8_t *names = header.nameOffset != 0 ? base + header.nameOffset : nullptr;
+    const size_t namesSize = header.nameOffset != 0 ? header.size - header.nameOffset : 0;
+    for (uint32_t slot = 0; names && slot < header.slotCount; slot++)
+    {
+        const uint32_t offset = readOffset(names + slot * sizeof(uint32_t));
+        if (offset < header.slotCount * sizeof(uint32_t) || offset >= namesSize) return CompiledLayoutStatusBadName;
+        if (!std::memchr(names + offset, '\0', namesSize - offset)) return CompiledLayoutStatusBadName;
+    }
+
+    version_ = header.version;
+    slotCount_ = header.slotCount;
+    recordCount_ = header.recordCount;
+    records_ = records;
+    names_ = names;
+    namesSize_ = namesSize;
+    return CompiledLayoutStatusOK;
+}
+
+const char *CompiledLayout::slotName(uint32_t slot) const
+{
+    if (!names_ || slot >= slotCount_) return nullptr;
+    return reinterpret_cast<const char *>(names_ + readOffset(names_ + slot * sizeof(uint32_t)));
+}
+
+void CompiledLayout::instantiate(const void *const *items, CHAConstraintDescriptor *descriptors) const
+{
+    instantiateCompiledRecords(records_, recordCount_, items, descriptors);
+}
+
+CompiledLayoutStatus validateCompiledLayout(const void *bytes, size_t size)
+{
+    CompiledLayout layout;
+    return layout.open(bytes, size);
+}
+
+MappedCompiledLayout::MappedCompiledLayout() : mapping_(nullptr), mappingSize_(0)
+{
+}
+
+MappedCompiledLayout::~MappedCompiledLayout()
+{
+    close();
+}
+
+CompiledLayoutStatus MappedCompiledLayout::open(const char *path)
+{
+    close();
+
+    const int file = ::open(path, O_RDONLY);
+    if (file < 0) return CompiledLayoutStatusUnreadable;
+
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        ::close(file);
+        return CompiledLayoutStatusUnreadable;
+    }
+    if ((size_t)info.st_size < sizeof(CompiledLayoutHeader))
+    {
+        ::close(file);
+        return CompiledLayoutStatusTruncated;
+    }
+
+    void *mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED) return CompiledLayoutStatusUnreadable;
+
+    mapping_ = mapping;
+    mappingSize_ = (size_t)info.st_size;
+    const CompiledLayoutStatus status = layout_.open(mapping_, mappingSize_);
+    if (status != CompiledLayoutStatusOK) close();
+    return status;
+}
+
+void MappedCompiledLayout::close()
+{
+    if (mapping_) munmap(mapping_, mappingSize_);
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    layout_ = CompiledLayout();
+}
+
+}
@@ -0,0 +1,230 @@
+//
+//  CHACompiledLayout.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHACompiledLayout_h
+#define CHAAutolayoutCategories_CHACompiledLayout_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+/**
+ @description The fixed header at the start of a compiled layout
+ @discussion A compiled layout is one little-endian block that holds no pointers, so it can be mapped from a file and read in
+ place. Offsets are from the start of the header:
+     header       CompiledLayoutHeader, headerSize bytes
+     records      recordCount CompiledRecord's at recordOffset, a multiple of 8
+     names        optional: slotCount uint32 offsets from nameOffset, then the NUL-terminated slot names
+ The checksum is compiledLayoutChecksum() over every byte after the header up to size. A reader accepts any headerSize
+ at least as large as this struct and rejects versions it does not know.
+ */
+struct CompiledLayoutHeader
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t slotCount;
+    uint32_t recordCount;
+    uint32_t recordOffset;
+    // 0 when the slots are unnamed.
+    uint32_t nameOffset;
+    uint32_t size;
+    uint32_t reserved;
+    uint64_t checksum;
+};
+
+/**
+ @description One constraint, with its items as slot indices. Slot 0 is the container.
+ */
+struct CompiledRecord
+{
+    double multiplier;
+    double constant;
+    float priority;
+    uint32_t item;
+    // CompiledRecordNoSlot for a constraint on item alone, such as a fixed width.
+    uint32_t toItem;
+    CHALayoutAttribute attribute;
+    CHALayoutAttribute toAttribute;
+    CHALayoutRelation relation;
+    uint8_t reserved;
+};
+
+enum : uint32_t
+{
+    CompiledRecordNoSlot = 0xffffffff
+};
+
+enum CompiledLayoutStatus
+{
+    CompiledLayoutStatusOK = 0,
+    CompiledLayoutStatusUnreadable,
+    CompiledLayoutStatusTruncated,
+    CompiledLayoutStatusBadMagic,
+    CompiledLayoutStatusUnsupportedVersion,
+    CompiledLayoutStatusWrongByteOrder,
+    CompiledLayoutStatusMisaligned,
+    CompiledLayoutStatusBadSection,
+    CompiledLayoutStatusBadChecksum,
+    CompiledLayoutStatusBadRecord,
+    CompiledLayoutStatusBadName
+};
+
+const char *describeCompiledLayoutStatus(CompiledLayoutStatus status);
+
+/**
+ @description Turn records into descriptors in one pass, with items taken from a table indexed by slot
+ @discussion The records must already be valid for the table, as after CompiledLayout::open() or from the layout DSL.
+ */
+inline void instantiateCompiledRecords(const CompiledRecord *records, size_t count, const void *const *items,
+                                       CHAConstraintDescriptor *descriptors)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        const CompiledRecord &record = records[index];
+        CHAConstraintDescriptor &descriptor = descriptors[index];
+        descriptor.item = items[record.item];
+        descriptor.toItem = record.toItem == CompiledRecordNoSlot ? nullptr : items[record.toItem];
+        descriptor.multiplier = record.multiplier;
+        descriptor.constant = record.constant;
+        descriptor.priority = record.priority;
+        descriptor.attribute = record.attribute;
+        descriptor.toAttribute = record.toAttribute;
+        descriptor.relation = record.relation;
+        descriptor.reserved = 0;
+    }
+}
+
+/**
+ @description The checksum stored in a compiled layout's header. Not cryptographic; it catches damaged files, not forged ones.
+ */
+uint64_t compiledLayoutChecksum(const void *bytes, size_t length);
+
+/**
+ @description Builds a compiled layout from descriptor records.
+ @discussion Record items are slot handles as made by LayoutTemplate::slotHandle(), which is also how ConstraintRecording
+ numbers its items, so a template or a recording compiles without translation.
+ */
+class CompiledLayoutWriter
+{
+public:
+    explicit CompiledLayoutWriter(uint32_t slotCount);
+
+    static const void *slotHandle(uint32_t slot) { return reinterpret_cast<const void *>((uintptr_t)slot + 1); }
+
+    /**
+     @description Name a slot, e.g. after its view's accessibilityIdentifier. A layout either names every slot or none;
+     unnamed slots are written with empty names.
+     @return false for an out-of-range slot or a name containing a NUL
+     */
+    bool setSlotName(uint32_t slot, const std::string &name);
+
+    /**
+     @return false, adding nothing, when the record would not validate: an item outside the slots, an attribute the core
+     does not know, a pair of attributes UIKit will not relate, a position with no toItem, a non-finite multiplier or
+     constant, or a priority outside (0, 1000]
+     */
+    bool addDescriptor(const CHAConstraintDescriptor &descriptor);
+
+    uint32_t slotCount() const { return slotCount_; }
+    size_t recordCount() const { return records_.size(); }
+
+    /**
+     @description Replace bytes with the compiled layout
+     */
+    void write(std::vector<uint8_t> &bytes) const;
+
+private:
+    uint32_t slotCount_;
+    std::vector<CompiledRecord> records_;
+    std::vector<std::string> names_;
+    bool named_;
+};
+
+/**
+ @description A read-only view of a compiled layout in memory, validated once and then read without copying.
+ @discussion The bytes must stay alive and unchanged while the view is used, and the records must be 8-byte aligned, as
+ they are in a mapped file or a heap block.
+ */
+class CompiledLayout
+{
+public:
+    CompiledLayout();
+
+    /**
+     @description Validate a compiled layout and point the view at it. On failure the view is left empty.
+     @discussion Checks the header, that every section lies within size, the checksum, and every record and name, so that
+     nothing read afterwards can go out of bounds.
+     */
+    CompiledLayoutStatus open(const void *bytes, size_t size);
+
+    uint16_t version() const { return version_; }
+    uint32_t slotCount() const { return slotCount_; }
+    size_t recordCount() const { return recordCount_; }
+    const CompiledRecord *records() const { return records_; }
+
+    /**
+     @return The slot's name, or null when the layout's slots are unnamed
+     */
+    const char *slotName(uint32_t slot) const;
+
+    /**
+     @description Turn every record into a descriptor in one pass, with items taken from a table indexed by slot
+     @param items slotCount() items, the container first
+     @param descriptors Receives recordCount() records
+     */
+    void instantiate(const void *const *items, CHAConstraintDescriptor *descriptors) const;
+
+private:
+    uint16_t version_;
+    uint32_t slotCount_;
+    size_t recordCount_;
+    const CompiledRecord *records_;
+    const uint8_t *names_;
+    size_t namesSize_;
+};
+
+/**
+ @description Validate a compiled layout without keeping a view of it
+ */
+CompiledLayoutStatus validateCompiledLayout(const void *bytes, size_t size);
+
+/**
+ @description A compiled layout file mapped read-only into memory
+ */
+class MappedCompiledLayout
+{
+public:
+    MappedCompiledLayout();
+    ~MappedCompiledLayout();
+
+    MappedCompiledLayout(const MappedCompiledLayout &) = delete;
+    MappedCompiledLayout &operator=(const MappedCompiledLayout &) = delete;
+
+    /**
+     @description Map a file and validate it, unmapping any file mapped before
+     @return CompiledLayoutStatusUnreadable when the file cannot be opened or mapped, or the validation result
+     */
+    CompiledLayoutStatus open(const char *path);
+    void close();
+
+    const CompiledLayout &layout() const { return layout_; }
+
+private:
+    void *mapping_;
+    size_t mappingSize_;
+    CompiledLayout layout_;
+};
+
+}
+
+#endif
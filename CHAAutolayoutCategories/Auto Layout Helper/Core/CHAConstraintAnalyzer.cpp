@@ -0,0 +1,361 @@
+//
+//  CHAConstraintAnalyzer.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include "CHAConstraintRecording.h"
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+namespace {
+
+const double kEpsilon = 1e-9;
+
+bool nearZero(double value)
+{
+    return std::fabs(value) < kEpsilon;
+}
+
+// Incremental rank of a set of linear equalities. Each basis row is reduced against every earlier one when it is added,
+// so it can only mention pivots of later rows, and reducing a new row in basis order eliminates every pivot once.
+class EqualityRank
+{
+public:
+    struct Reduction
+    {
+        std::unordered_map<Solver::Variable, double> terms;
+        double constant;
+        std::vector<uint32_t> sources;
+    };
+
+    void reduce(const Solver::Term *terms, size_t termCount, double constant, Reduction &reduction) const
+    {
+        reduction.terms.clear();
+        reduction.constant = constant;
+        reduction.sources.clear();
+
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> pending;
+        for (size_t i = 0; i < termCount; i++)
+        {
+            reduction.terms[terms[i].variable] += terms[i].coefficient;
+            notePivot(terms[i].variable, pending);
+        }
+
+        while (!pending.empty())
+        {
+            const size_t index = pending.top();
+            pending.pop();
+
+            const Row &row = rows_[index];
+            auto found = reduction.terms.find(row.pivot);
+            if (found == reduction.terms.end() || nearZero(found->second)) continue;
+
+            const double factor = found->second / row.pivotCoefficient;
+            for (const Solver::Term &term : row.terms)
+            {
+                double &coefficient = reduction.terms[term.variable];
+                coefficient -= factor * term.coefficient;
+                if (term.variable != row.pivot) notePivot(term.variable, pending);
+            }
+            reduction.terms[row.pivot] = 0.0;
+            reduction.constant -= factor * row.constant;
+            reduction.sources.insert(reduction.sources.end(), row.sources.begin(), row.sources.end());
+        }
+
+        for (auto it = reduction.terms.begin(); it != reduction.terms.end();)
+        {
+            it = nearZero(it->second) ? reduction.terms.erase(it) : std::next(it);
+        }
+        std::sort(reduction.sources.begin(), reduction.sources.end());
+        reduction.sources.erase(std::unique(reduction.sources.begin(), reduction.sources.end()), reduction.sources.end());
+    }
+
+    // Add a reduced row that still has terms, tagged with the record it came from.
+    void insert(const Reduction &reduction, uint32_t source)
+    {
+        Row row;
+        row.pivot = 0;
+        row.pivotCoefficient = 0.0;
+        row.constant = reduction.constant;
+        row.sources = reduction.sources;
+        if (source != kAnalysisNoRecord) row.sources.insert(std::lower_bound(row.sources.begin(), row.sources.end(), source), source);
+
+        double largest = 0.0;
+        for (const auto &term : reduction.terms)
+        {
+            row.terms.push_back(Solver::Term{term.first, term.second});
+            if (std::fabs(term.second) > largest || (std::fabs(term.second) == largest && term.first < row.pivot))
+            {
+                largest = std::fabs(term.second);
+                row.pivot = term.first;
+                row.pivotCoefficient = term.second;
+            }
+        }
+        pivots_[row.pivot] = rows_.size();
+        rows_.push_back(std::move(row));
+    }
+
+private:
+    struct Row
+    {
+        std::vector<Solver::Term> terms;
+        double constant;
+        Solver::Variable pivot;
+        double pivotCoefficient;
+        std::vector<uint32_t> sources;
+    };
+
+    void notePivot(Solver::Variable variable, std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> &pending) const
+    {
+        auto found = pivots_.find(variable);
+        if (found != pivots_.end()) pending.push(found->second);
+    }
+
+    std::vector<Row> rows_;
+    std::unordered_map<Solver::Variable, size_t> pivots_;
+};
+
+bool isHorizontal(CHALayoutAttribute attribute)
+{
+    switch (attribute)
+    {
+        case CHALayoutAttributeLeft:
+        case CHALayoutAttributeRight:
+        case CHALayoutAttributeLeading:
+        case CHALayoutAttributeTrailing:
+        case CHALayoutAttributeWidth:
+        case CHALayoutAttributeCenterX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+AnalysisAxis axisOf(const CHAConstraintDescriptor &record)
+{
+    return isHorizontal(record.attribute) ? AnalysisAxisHorizontal : AnalysisAxisVertical;
+}
+
+bool touches(const CHAConstraintDescriptor &record, const void *item, AnalysisAxis axis)
+{
+    const bool horizontal = axis == AnalysisAxisHorizontal;
+    if (record.item == item && isHorizontal(record.attribute) == horizontal) return true;
+    return record.toItem == item && record.toAttribute != CHALayoutAttributeNotAnAttribute &&
+           isHorizontal(record.toAttribute) == horizontal;
+}
+
+bool sharesItem(const CHAConstraintDescriptor &a, const CHAConstraintDescriptor &b)
+{
+    return a.item == b.item || (b.toItem && a.item == b.toItem) || (a.toItem && (a.toItem == b.item || a.toItem == b.toItem));
+}
+
+size_t termsForRecord(LayoutSystem &layout, const CHAConstraintDescriptor &record, Solver::Term *terms)
+{
+    size_t termCount = layout.termsForAttribute(record.item, record.attribute, 1.0, terms);
+    if (record.toItem && record.toAttribute != CHALayoutAttributeNotAnAttribute)
+    {
+        termCount += layout.termsForAttribute(record.toItem, record.toAttribute, -record.multiplier, terms + termCount);
+    }
+    return termCount;
+}
+
+// Earlier required records that share an item with the record; the solver does not say which rows made it infeasible.
+std::vector<uint32_t> candidateCauses(const CHAConstraintDescriptor *records, size_t index)
+{
+    std::vector<uint32_t> causes;
+    for (size_t i = 0; i < index; i++)
+    {
+        if (records[i].priority >= CHALayoutPriorityRequired && sharesItem(records[i], records[index])) causes.push_back((uint32_t)i);
+    }
+    return causes;
+}
+
+std::string formatNumber(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
+}
+
+std::string describeReference(uint32_t index, const CHAConstraintDescriptor *records, const char *const *origins,
+                              const ItemNamer &nameForItem)
+{
+    if (index == kAnalysisContainerWidthRecord) return "container width";
+    if (index == kAnalysisContainerHeightRecord) return "container height";
+
+    std::string text = "#" + std::to_string(index) + " " + describeRecord(records[index], nameForItem);
+    if (origins && origins[index]) text += std::string(" (from ") + origins[index] + ")";
+    return text;
+}
+
+}
+
+size_t AnalysisReport::countOf(AnalysisIssueKind kind) const
+{
+    return (size_t)std::count_if(issues.begin(), issues.end(), [kind](const AnalysisIssue &issue) { return issue.kind == kind; });
+}
+
+void analyzeConstraints(const CHAConstraintDescriptor *records,
+                        size_t count,
+                        const void *container,
+                        double width,
+                        double height,
+                        AnalysisReport &report)
+{
+    report.issues.clear();
+
+    LayoutSystem layout;
+    layout.setContainer(container, -1, -1);
+    EqualityRank rank;
+    EqualityRank::Reduction reduction;
+    Solver::Term terms[4];
+
+    // The origin pins LayoutSystem adds, and the container size as required equalities so conflicts with it surface.
+    const CHAConstraintDescriptor pins[] = {
+        {container, nullptr, 0, 0, CHALayoutPriorityRequired, CHALayoutAttributeLeft, CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0},
+        {container, nullptr, 0, 0, CHALayoutPriorityRequired, CHALayoutAttributeTop, CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0},
+        {container, nullptr, 0, width, CHALayoutPriorityRequired, CHALayoutAttributeWidth, CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0},
+        {container, nullptr, 0, height, CHALayoutPriorityRequired, CHALayoutAttributeHeight, CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0}};
+    const uint32_t pinSources[] = { kAnalysisNoRecord, kAnalysisNoRecord, kAnalysisContainerWidthRecord, kAnalysisContainerHeightRecord };
+    for (size_t i = 0; i < 4; i++)
+    {
+        if (pins[i].constant < 0.0) continue;
+        const size_t termCount = termsForRecord(layout, pins[i], terms);
+        rank.reduce(terms, termCount, -pins[i].constant, reduction);
+        rank.insert(reduction, pinSources[i]);
+        if (i >= 2) layout.addDescriptor(pins[i]);
+    }
+
+    for (size_t index = 0; index < count; index++)
+    {
+        const CHAConstraintDescriptor &record = records[index];
+        const bool required = record.priority >= CHALayoutPriorityRequired;
+
+        if (required && record.relation == CHALayoutRelationEqual)
+        {
+            const size_t termCount = termsForRecord(layout, record, terms);
+            rank.reduce(terms, termCount, -record.constant, reduction);
+            if (reduction.terms.empty())
+            {
+                const AnalysisIssueKind kind = nearZero(reduction.constant) ? AnalysisIssueRedundant : AnalysisIssueConflict;
+                report.issues.push_back(AnalysisIssue{kind, axisOf(record), (uint32_t)index, record.item, reduction.sources});
+                continue;
+            }
+        }
+
+        if (layout.addDescriptor(record) == Solver::StatusUnsatisfiable)
+        {
+            report.issues.push_back(AnalysisIssue{AnalysisIssueConflict, axisOf(record), (uint32_t)index, record.item,
+                                                  candidateCauses(records, index)});
+            continue;
+        }
+
+        if (required && record.relation == CHALayoutRelationEqual) rank.insert(reduction, (uint32_t)index);
+    }
+
+    // Pull every item's frame weakly toward two different targets; whatever the constraints leave free follows the pull.
+    std::vector<const void *> items;
+    for (size_t index = 0; index < count; index++)
+    {
+        for (const void *item : { records[index].item, records[index].toItem })
+        {
+            if (item && item != container && std::find(items.begin(), items.end(), item) == items.end()) items.push_back(item);
+        }
+    }
+
+    std::vector<Frame> solutions[2];
+    const CHALayoutAttribute pulled[] = { CHALayoutAttributeLeft, CHALayoutAttributeTop, CHALayoutAttributeWidth, CHALayoutAttributeHeight };
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<Solver::Constraint> pulls;
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            for (size_t a = 0; a < 4; a++)
+            {
+                const double target = pass == 0 ? 1000.0 + 37.0 * (double)(4 * i + a) : -500.0 - 53.0 * (double)(4 * i + a);
+                const size_t termCount = layout.termsForAttribute(items[i], pulled[a], 1.0, terms);
+                Solver::Constraint pull;
+                if (layout.solver().addConstraint(terms, termCount, -target, CHALayoutRelationEqual, Strength::weak, &pull) ==
+                    Solver::StatusOK)
+                {
+                    pulls.push_back(pull);
+                }
+            }
+        }
+        layout.solve();
+        for (const void *item : items) solutions[pass].push_back(layout.frame(item));
+        for (Solver::Constraint pull : pulls) layout.solver().removeConstraint(pull);
+    }
+
+    auto moved = [](double a, double b) { return std::fabs(a - b) > 1e-6 * std::max(1.0, std::fabs(a)); };
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const Frame &a = solutions[0][i];
+        const Frame &b = solutions[1][i];
+        const bool ambiguous[2] = { moved(a.x, b.x) || moved(a.width, b.width), moved(a.y, b.y) || moved(a.height, b.height) };
+        for (int axis = 0; axis < 2; axis++)
+        {
+            if (!ambiguous[axis]) continue;
+            AnalysisIssue issue = {AnalysisIssueAmbiguous, (AnalysisAxis)axis, kAnalysisNoRecord, items[i], {}};
+            for (size_t index = 0; index < count; index++)
+            {
+                if (touches(records[index], items[i], (AnalysisAxis)axis)) issue.related.push_back((uint32_t)index);
+            }
+            report.issues.push_back(std::move(issue));
+        }
+    }
+}
+
+std::string describeRecord(const CHAConstraintDescriptor &record, const ItemNamer &nameForItem)
+{
+    std::string text = nameForItem(record.item) + "." + nameForAttribute(record.attribute) + " " + symbolForRelation(record.relation) + " ";
+    if (record.toItem && record.toAttribute != CHALayoutAttributeNotAnAttribute)
+    {
+        text += nameForItem(record.toItem) + "." + nameForAttribute(record.toAttribute) + " * " + formatNumber(record.multiplier) + " + ";
+    }
+    text += formatNumber(record.constant) + " @" + formatNumber(record.priority);
+    return text;
+}
+
+std::string describeIssue(const AnalysisIssue &issue,
+                          const CHAConstraintDescriptor *records,
+                          const char *const *origins,
+                          const ItemNamer &nameForItem)
+{
+    std::string text;
+    switch (issue.kind)
+    {
+        case AnalysisIssueConflict:
+            text = "conflict: " + describeReference(issue.record, records, origins, nameForItem) +
+                   (issue.related.empty() ? std::string(" cannot be satisfied") : std::string(" contradicts"));
+            break;
+        case AnalysisIssueRedundant:
+            text = "redundant: " + describeReference(issue.record, records, origins, nameForItem) + " is implied by";
+            break;
+        case AnalysisIssueAmbiguous:
+            text = "ambiguous: " + nameForItem(issue.item) +
+                   (issue.axis == AnalysisAxisHorizontal ? " has no fixed x/width" : " has no fixed y/height");
+            text += issue.related.empty() ? std::string("; nothing constrains it") : std::string("; constrained by");
+            break;
+    }
+
+    for (uint32_t related : issue.related)
+    {
+        text += "\n    " + describeReference(related, records, origins, nameForItem);
+    }
+    return text;
+}
+
+}
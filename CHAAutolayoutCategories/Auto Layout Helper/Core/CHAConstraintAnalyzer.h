@@ -0,0 +1,100 @@
+//
+//  CHAConstraintAnalyzer.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintAnalyzer_h
+#define CHAAutolayoutCategories_CHAConstraintAnalyzer_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+enum AnalysisIssueKind : uint8_t
+{
+    // A required record that cannot hold together with the required records before it.
+    AnalysisIssueConflict = 0,
+    // A required equality already implied by the required equalities before it.
+    AnalysisIssueRedundant,
+    // An item whose position or size along an axis is not determined by the whole set.
+    AnalysisIssueAmbiguous
+};
+
+enum AnalysisAxis : uint8_t
+{
+    AnalysisAxisHorizontal = 0,
+    AnalysisAxisVertical
+};
+
+/**
+ @description Records that stand in for the container's size, which the analysis holds as required equalities
+ */
+const uint32_t kAnalysisContainerWidthRecord = UINT32_MAX - 1;
+const uint32_t kAnalysisContainerHeightRecord = UINT32_MAX - 2;
+const uint32_t kAnalysisNoRecord = UINT32_MAX;
+
+/**
+ @field record The offending record, or kAnalysisNoRecord for an ambiguous item
+ @field related For conflicts and redundancies, the earlier records the offending one contradicts or repeats when they
+ can be traced, ascending; for ambiguities, every record that touches the item along the axis
+ */
+struct AnalysisIssue
+{
+    AnalysisIssueKind kind;
+    AnalysisAxis axis;
+    uint32_t record;
+    const void *item;
+    std::vector<uint32_t> related;
+};
+
+struct AnalysisReport
+{
+    std::vector<AnalysisIssue> issues;
+
+    size_t countOf(AnalysisIssueKind kind) const;
+    bool clean() const { return issues.empty(); }
+};
+
+/**
+ @description Check a constraint set before it is installed.
+ @discussion Required records are added in order. Equalities go through an incremental rank check, a sparse Gaussian
+ elimination that keeps, for every basis row, the records it was built from: an equality that reduces to 0 = 0 is
+ redundant and one that reduces to 0 = c is a conflict with exactly those records. Inequalities are checked for
+ feasibility by adding them to a Cassowary solver. Once every record is in, the set is solved twice with weak pulls
+ toward two different targets; an item whose frame moves between the two solves is ambiguous along that axis.
+ @param width The container width, or negative to leave it to the constraints; height likewise
+ */
+void analyzeConstraints(const CHAConstraintDescriptor *records,
+                        size_t count,
+                        const void *container,
+                        double width,
+                        double height,
+                        AnalysisReport &report);
+
+typedef std::function<std::string(const void *item)> ItemNamer;
+
+/**
+ @description A record in the form "label.leading == container.leading * 1 + 10 @1000"
+ */
+std::string describeRecord(const CHAConstraintDescriptor &record, const ItemNamer &nameForItem);
+
+/**
+ @description One line per issue, naming the records involved and, where origins is non-null, the helper call that made each
+ @param origins One entry per record, each possibly null
+ */
+std::string describeIssue(const AnalysisIssue &issue,
+                          const CHAConstraintDescriptor *records,
+                          const char *const *origins,
+                          const ItemNamer &nameForItem);
+
+}
+
+#endif
@@ -0,0 +1,160 @@
+//
+//  CHAConstraintCommitQueue.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintCommitQueue.h"
+
+#include <utility>
+
+namespace cha {
+
+namespace {
+
+const size_t kNoGroup = (size_t)-1;
+
+size_t depth(const void *item, const ParentFunction &parentOf)
+{
+    size_t depth = 0;
+    for (const void *ancestor = parentOf(item); ancestor; ancestor = parentOf(ancestor)) depth++;
+    return depth;
+}
+
+}
+
+const void *nearestCommonAncestor(const void *a, const void *b, const ParentFunction &parentOf)
+{
+    if (!a || !b) return nullptr;
+    if (a == b) return a;
+
+    // Bring both items to the same depth, then climb in step until the chains meet.
+    size_t depthA = depth(a, parentOf);
+    size_t depthB = depth(b, parentOf);
+    for (; depthA > depthB; depthA--) a = parentOf(a);
+    for (; depthB > depthA; depthB--) b = parentOf(b);
+
+    while (a != b)
+    {
+        a = parentOf(a);
+        b = parentOf(b);
+    }
+    return a;
+}
+
+const void *installationTarget(const CHAConstraintDescriptor &record, const ParentFunction &parentOf)
+{
+    if (!record.toItem) return record.item;
+    return nearestCommonAncestor(record.item, record.toItem, parentOf);
+}
+
+void CommitBatch::clear()
+{
+    records.clear();
+    groups.clear();
+    orphans.clear();
+}
+
+ConstraintCommitQueue::ConstraintCommitQueue(ParentFunction parentOf, CommitFunction commit, WakeFunction wake)
+: parentOf_(std::move(parentOf)),
+  commit_(std::move(commit)),
+  wake_(std::move(wake)),
+  wakePending_(false),
+  commits_(0),
+  wakes_(0)
+{
+}
+
+void ConstraintCommitQueue::submit(const CHAConstraintDescriptor *records, size_t count)
+{
+    if (count == 0) return;
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.insert(pending_.end(), records, records + count);
+        if (!wakePending_)
+        {
+            wakePending_ = true;
+            wake = true;
+            wakes_++;
+        }
+    }
+    if (wake && wake_) wake_();
+}
+
+size_t ConstraintCommitQueue::drain()
+{
+    draining_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        draining_.swap(pending_);
+        wakePending_ = false;
+    }
+    if (draining_.empty()) return 0;
+
+    batch_.clear();
+    recordGroups_.clear();
+    groupIndex_.clear();
+
+    // Count each target's records, then lay the groups out back to back and place the records in submission order.
+    for (const CHAConstraintDescriptor &record : draining_)
+    {
+        const void *target = installationTarget(record, parentOf_);
+        if (!target)
+        {
+            recordGroups_.push_back(kNoGroup);
+            batch_.orphans.push_back(record);
+            continue;
+        }
+
+        auto inserted = groupIndex_.emplace(target, batch_.groups.size());
+        if (inserted.second) batch_.groups.push_back(CommitGroup{target, 0, 0});
+        recordGroups_.push_back(inserted.first->second);
+        batch_.groups[inserted.first->second].count++;
+    }
+
+    size_t offset = 0;
+    for (CommitGroup &group : batch_.groups)
+    {
+        group.first = offset;
+        offset += group.count;
+        group.count = 0;
+    }
+    batch_.records.resize(offset);
+
+    for (size_t index = 0; index < draining_.size(); index++)
+    {
+        if (recordGroups_[index] == kNoGroup) continue;
+        CommitGroup &group = batch_.groups[recordGroups_[index]];
+        batch_.records[group.first + group.count++] = draining_[index];
+    }
+
+    commit_(batch_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        commits_++;
+    }
+    return draining_.size();
+}
+
+size_t ConstraintCommitQueue::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+uint64_t ConstraintCommitQueue::commitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commits_;
+}
+
+uint64_t ConstraintCommitQueue::wakeCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wakes_;
+}
+
+}
@@ -0,0 +1,114 @@
+//
+//  CHAConstraintCommitQueue.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintCommitQueue_h
+#define CHAAutolayoutCategories_CHAConstraintCommitQueue_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+/**
+ @description Returns an item's parent in the view hierarchy, or null at the root
+ */
+typedef std::function<const void *(const void *item)> ParentFunction;
+
+/**
+ @description The nearest item that is an ancestor of both a and b, counting each item as its own ancestor
+ @return null if they are in different hierarchies
+ */
+const void *nearestCommonAncestor(const void *a, const void *b, const ParentFunction &parentOf);
+
+/**
+ @description Where a record is installed: the item itself when it has no toItem, as UIKit does for size constants, and
+ otherwise the nearest common ancestor of item and toItem
+ */
+const void *installationTarget(const CHAConstraintDescriptor &record, const ParentFunction &parentOf);
+
+/**
+ @description Records installed together on one ancestor: records[first, first + count) of the batch
+ */
+struct CommitGroup
+{
+    const void *ancestor;
+    size_t first;
+    size_t count;
+};
+
+/**
+ @description Everything committed in one turn
+ @field records Grouped by installation target, in order of each target's first appearance, submission order within a group
+ @field orphans Records whose items share no ancestor; they cannot be installed
+ */
+struct CommitBatch
+{
+    std::vector<CHAConstraintDescriptor> records;
+    std::vector<CommitGroup> groups;
+    std::vector<CHAConstraintDescriptor> orphans;
+
+    void clear();
+};
+
+/**
+ @description Collects constraint records built on any thread and hands them to the UI thread in one commit per turn.
+ @discussion submit() is thread-safe. The first submission after a drain calls wake, which should schedule drain() on the
+ consumer thread (for UIKit, the main run loop); submissions made before that drain runs join the same commit. drain()
+ resolves installation targets with parentOf and calls commit once with every pending record, outside the lock, so
+ producers are never blocked by the install itself.
+ */
+class ConstraintCommitQueue
+{
+public:
+    typedef std::function<void(const CommitBatch &batch)> CommitFunction;
+    typedef std::function<void()> WakeFunction;
+
+    ConstraintCommitQueue(ParentFunction parentOf, CommitFunction commit, WakeFunction wake);
+
+    ConstraintCommitQueue(const ConstraintCommitQueue &) = delete;
+    ConstraintCommitQueue &operator=(const ConstraintCommitQueue &) = delete;
+
+    void submit(const CHAConstraintDescriptor *records, size_t count);
+    void submitBatch(const CHADescriptorBatch &batch) { submit(batch.records, batch.count); }
+
+    /**
+     @description Commit every pending record. Consumer thread only; not reentrant.
+     @return The number of records committed, orphans included
+     */
+    size_t drain();
+
+    size_t pendingCount() const;
+    uint64_t commitCount() const;
+    uint64_t wakeCount() const;
+
+private:
+    ParentFunction parentOf_;
+    CommitFunction commit_;
+    WakeFunction wake_;
+
+    mutable std::mutex mutex_;
+    std::vector<CHAConstraintDescriptor> pending_;
+    bool wakePending_;
+    uint64_t commits_;
+    uint64_t wakes_;
+
+    // Consumer-side buffers, reused from turn to turn.
+    std::vector<CHAConstraintDescriptor> draining_;
+    std::vector<size_t> recordGroups_;
+    std::unordered_map<const void *, size_t> groupIndex_;
+    CommitBatch batch_;
+};
+
+}
+
+#endif
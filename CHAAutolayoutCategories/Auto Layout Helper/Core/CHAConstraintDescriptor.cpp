@@ -0,0 +1,124 @@
+//
+//  CHAConstraintDescriptor.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintDescriptor.h"
+
+#include <cassert>
+
+namespace {
+
+const CHAEdgeMask kEdgeOrder[] = {
+    CHAEdgeTop, CHAEdgeBottom, CHAEdgeLeading, CHAEdgeTrailing, CHAEdgeLeft, CHAEdgeRight
+};
+
+}
+
+void CHADescriptorBatchReset(CHADescriptorBatch *batch)
+{
+    batch->count = 0;
+}
+
+CHAConstraintDescriptor *CHADescriptorBatchAppend(CHADescriptorBatch *batch,
+                                                  const void *item,
+                                                  CHALayoutAttribute attribute,
+                                                  CHALayoutRelation relation,
+                                                  const void *toItem,
+                                                  CHALayoutAttribute toAttribute,
+                                                  double multiplier,
+                                                  double constant)
+{
+    assert(batch->count < CHA_DESCRIPTOR_BATCH_CAPACITY && "Descriptor batch is full; commit it and reset it first");
+    if (batch->count >= CHA_DESCRIPTOR_BATCH_CAPACITY) return nullptr;
+
+    CHAConstraintDescriptor *record = &batch->records[batch->count++];
+    record->item = item;
+    record->toItem = toItem;
+    record->multiplier = multiplier;
+    record->constant = constant;
+    record->priority = CHALayoutPriorityRequired;
+    record->attribute = attribute;
+    record->toAttribute = toAttribute;
+    record->relation = relation;
+    record->reserved = 0;
+    return record;
+}
+
+size_t CHADescriptorBatchAppendEdges(CHADescriptorBatch *batch,
+                                     const void *item,
+                                     const void *toItem,
+                                     CHAEdgeMask edges,
+                                     double constant)
+{
+    size_t appended = 0;
+    for (CHAEdgeMask edge : kEdgeOrder)
+    {
+        if (!(edges & edge)) continue;
+
+        CHALayoutAttribute attribute = CHALayoutAttributeForEdge(edge);
+        if (CHADescriptorBatchAppend(batch, item, attribute, CHALayoutRelationEqual, toItem, attribute, 1,
+                                     CHASignedConstantForAttribute(attribute, constant)))
+        {
+            appended++;
+        }
+    }
+    return appended;
+}
+
+size_t CHADescriptorBatchAppendInsets(CHADescriptorBatch *batch,
+                                      const void *item,
+                                      const void *toItem,
+                                      double top,
+                                      double leading,
+                                      double bottom,
+                                      double trailing)
+{
+    return CHADescriptorBatchAppendEdges(batch, item, toItem, CHAEdgeTop, top) +
+           CHADescriptorBatchAppendEdges(batch, item, toItem, CHAEdgeBottom, bottom) +
+           CHADescriptorBatchAppendEdges(batch, item, toItem, CHAEdgeLeading, leading) +
+           CHADescriptorBatchAppendEdges(batch, item, toItem, CHAEdgeTrailing, trailing);
+}
+
+CHALayoutAttribute CHALayoutAttributeForEdge(CHAEdgeMask edge)
+{
+    switch (edge)
+    {
+        case CHAEdgeTop: return CHALayoutAttributeTop;
+        case CHAEdgeBottom: return CHALayoutAttributeBottom;
+        case CHAEdgeLeading: return CHALayoutAttributeLeading;
+        case CHAEdgeTrailing: return CHALayoutAttributeTrailing;
+        case CHAEdgeLeft: return CHALayoutAttributeLeft;
+        case CHAEdgeRight: return CHALayoutAttributeRight;
+        default: return CHALayoutAttributeNotAnAttribute;
+    }
+}
+
+CHAEdgeMask CHAEdgeMaskForAttribute(CHALayoutAttribute attribute)
+{
+    switch (attribute)
+    {
+        case CHALayoutAttributeTop: return CHAEdgeTop;
+        case CHALayoutAttributeBottom: return CHAEdgeBottom;
+        case CHALayoutAttributeLeading: return CHAEdgeLeading;
+        case CHALayoutAttributeTrailing: return CHAEdgeTrailing;
+        case CHALayoutAttributeLeft: return CHAEdgeLeft;
+        case CHALayoutAttributeRight: return CHAEdgeRight;
+        default: return 0;
+    }
+}
+
+double CHASignedConstantForAttribute(CHALayoutAttribute attribute, double constant)
+{
+    switch (attribute)
+    {
+        case CHALayoutAttributeBottom:
+        case CHALayoutAttributeTrailing:
+        case CHALayoutAttributeRight:
+            return -constant;
+        default:
+            return constant;
+    }
+}
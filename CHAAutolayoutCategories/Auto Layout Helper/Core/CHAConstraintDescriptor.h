@@ -0,0 +1,161 @@
+//
+//  CHAConstraintDescriptor.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintDescriptor_h
+#define CHAAutolayoutCategories_CHAConstraintDescriptor_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ @description Layout attributes. The raw values match NSLayoutAttribute so records can be handed to UIKit without translation.
+ */
+typedef int8_t CHALayoutAttribute;
+enum
+{
+    CHALayoutAttributeNotAnAttribute = 0,
+    CHALayoutAttributeLeft = 1,
+    CHALayoutAttributeRight = 2,
+    CHALayoutAttributeTop = 3,
+    CHALayoutAttributeBottom = 4,
+    CHALayoutAttributeLeading = 5,
+    CHALayoutAttributeTrailing = 6,
+    CHALayoutAttributeWidth = 7,
+    CHALayoutAttributeHeight = 8,
+    CHALayoutAttributeCenterX = 9,
+    CHALayoutAttributeCenterY = 10,
+    CHALayoutAttributeBaseline = 11
+};
+
+/**
+ @description Layout relations. The raw values match NSLayoutRelation.
+ */
+typedef int8_t CHALayoutRelation;
+enum
+{
+    CHALayoutRelationLessThanOrEqual = -1,
+    CHALayoutRelationEqual = 0,
+    CHALayoutRelationGreaterThanOrEqual = 1
+};
+
+#define CHALayoutPriorityRequired 1000.f
+
+/**
+ @description Edge bitmask used in place of an array of boxed NSLayoutAttribute's
+ */
+typedef uint8_t CHAEdgeMask;
+enum
+{
+    CHAEdgeTop = 1 << 0,
+    CHAEdgeBottom = 1 << 1,
+    CHAEdgeLeading = 1 << 2,
+    CHAEdgeTrailing = 1 << 3,
+    CHAEdgeLeft = 1 << 4,
+    CHAEdgeRight = 1 << 5,
+    CHAEdgeAll = CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing
+};
+
+/**
+ @description A plain record describing one constraint: item.attribute (relation) toItem.toAttribute * multiplier + constant
+ @discussion Items are opaque, unretained pointers. The record is 40 bytes on 64-bit targets.
+ */
+typedef struct CHAConstraintDescriptor
+{
+    const void *item;
+    const void *toItem;
+    double multiplier;
+    double constant;
+    float priority;
+    CHALayoutAttribute attribute;
+    CHALayoutAttribute toAttribute;
+    CHALayoutRelation relation;
+    uint8_t reserved;
+} CHAConstraintDescriptor;
+
+#define CHA_DESCRIPTOR_BATCH_CAPACITY 16
+
+/**
+ @description A fixed-size batch of descriptors, large enough to hold every constraint a single view needs. Lives on the stack.
+ */
+typedef struct CHADescriptorBatch
+{
+    CHAConstraintDescriptor records[CHA_DESCRIPTOR_BATCH_CAPACITY];
+    uint32_t count;
+} CHADescriptorBatch;
+
+/**
+ @description Empty a batch so it can be reused
+ @param batch The batch to reset
+ */
+void CHADescriptorBatchReset(CHADescriptorBatch *batch);
+
+/**
+ @description Append a single record to a batch at required priority
+ @discussion Callers must not append more than CHA_DESCRIPTOR_BATCH_CAPACITY records between resets. Doing so asserts; with
+ assertions compiled out the record is dropped.
+ @return The appended record, or NULL if the batch was full
+ */
+CHAConstraintDescriptor *CHADescriptorBatchAppend(CHADescriptorBatch *batch,
+                                                  const void *item,
+                                                  CHALayoutAttribute attribute,
+                                                  CHALayoutRelation relation,
+                                                  const void *toItem,
+                                                  CHALayoutAttribute toAttribute,
+                                                  double multiplier,
+                                                  double constant);
+
+/**
+ @description Append one record per edge in the mask, relating each edge of item to the same edge of toItem
+ @discussion Records are emitted in the order top, bottom, leading, trailing, left, right. The constant is negated for bottom, trailing and right edges so that a positive constant always insets the item. The batch must have room for
+ every edge, as with CHADescriptorBatchAppend.
+ @return The number of records appended
+ */
+size_t CHADescriptorBatchAppendEdges(CHADescriptorBatch *batch,
+                                     const void *item,
+                                     const void *toItem,
+                                     CHAEdgeMask edges,
+                                     double constant);
+
+/**
+ @description Append top, bottom, leading and trailing records with a separate inset for each edge
+ @return The number of records appended
+ */
+size_t CHADescriptorBatchAppendInsets(CHADescriptorBatch *batch,
+                                      const void *item,
+                                      const void *toItem,
+                                      double top,
+                                      double leading,
+                                      double bottom,
+                                      double trailing);
+
+/**
+ @description The layout attribute for a single edge bit
+ @return The matching attribute, or CHALayoutAttributeNotAnAttribute if the mask is not a single known edge
+ */
+CHALayoutAttribute CHALayoutAttributeForEdge(CHAEdgeMask edge);
+
+/**
+ @description The edge bit for a layout attribute
+ @return The matching edge bit, or 0 for non-edge attributes
+ */
+CHAEdgeMask CHAEdgeMaskForAttribute(CHALayoutAttribute attribute);
+
+/**
+ @description Apply the per-edge sign convention to an inset
+ @return -constant for bottom, trailing and right edges; constant otherwise
+ */
+double CHASignedConstantForAttribute(CHALayoutAttribute attribute, double constant);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+//
+//  CHAConstraintDiff.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintDiff.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace cha {
+
+namespace {
+
+// A total order on structure. Ties keep their original order so duplicates pair up first-to-first.
+int compareStructure(const CHAConstraintDescriptor &a, const CHAConstraintDescriptor &b)
+{
+    std::less<const void *> before;
+    if (a.item != b.item) return before(a.item, b.item) ? -1 : 1;
+    if (a.toItem != b.toItem) return before(a.toItem, b.toItem) ? -1 : 1;
+    if (a.attribute != b.attribute) return a.attribute < b.attribute ? -1 : 1;
+    if (a.toAttribute != b.toAttribute) return a.toAttribute < b.toAttribute ? -1 : 1;
+    if (a.relation != b.relation) return a.relation < b.relation ? -1 : 1;
+    if (a.multiplier != b.multiplier) return a.multiplier < b.multiplier ? -1 : 1;
+    return 0;
+}
+
+void sortByStructure(const CHAConstraintDescriptor *records, size_t count, std::vector<uint32_t> &order)
+{
+    order.resize(count);
+    for (size_t i = 0; i < count; i++) order[i] = (uint32_t)i;
+    std::sort(order.begin(), order.end(), [records](uint32_t a, uint32_t b) {
+        int comparison = compareStructure(records[a], records[b]);
+        return comparison != 0 ? comparison < 0 : a < b;
+    });
+}
+
+bool isRequired(float priority)
+{
+    return priority >= CHALayoutPriorityRequired;
+}
+
+uint8_t changesBetween(const CHAConstraintDescriptor &from, const CHAConstraintDescriptor &to)
+{
+    uint8_t changes = DiffChangeNone;
+    if (from.constant != to.constant) changes |= DiffChangeConstant;
+    if (from.priority != to.priority)
+    {
+        changes |= DiffChangePriority;
+        if (isRequired(from.priority) != isRequired(to.priority)) changes |= DiffChangeReinstall;
+    }
+    return changes;
+}
+
+}
+
+size_t ConstraintDiff::changedCount() const
+{
+    size_t changed = additions.size() + removals.size();
+    for (const DiffMatch &match : matches)
+    {
+        if (match.changes != DiffChangeNone) changed++;
+    }
+    return changed;
+}
+
+void ConstraintDiff::clear()
+{
+    matches.clear();
+    additions.clear();
+    removals.clear();
+}
+
+bool structurallyEqual(const CHAConstraintDescriptor &a, const CHAConstraintDescriptor &b)
+{
+    return compareStructure(a, b) == 0;
+}
+
+void diffConstraints(const CHAConstraintDescriptor *oldRecords,
+                     size_t oldCount,
+                     const CHAConstraintDescriptor *newRecords,
+                     size_t newCount,
+                     ConstraintDiff &diff)
+{
+    diff.clear();
+
+    std::vector<uint32_t> oldOrder, newOrder;
+    sortByStructure(oldRecords, oldCount, oldOrder);
+    sortByStructure(newRecords, newCount, newOrder);
+
+    size_t o = 0, n = 0;
+    while (o < oldCount && n < newCount)
+    {
+        const CHAConstraintDescriptor &before = oldRecords[oldOrder[o]];
+        const CHAConstraintDescriptor &after = newRecords[newOrder[n]];
+        const int comparison = compareStructure(before, after);
+        if (comparison < 0)
+        {
+            diff.removals.push_back(oldOrder[o++]);
+        }
+        else if (comparison > 0)
+        {
+            diff.additions.push_back(newOrder[n++]);
+        }
+        else
+        {
+            diff.matches.push_back(DiffMatch{oldOrder[o], newOrder[n], changesBetween(before, after)});
+            o++;
+            n++;
+        }
+    }
+    for (; o < oldCount; o++) diff.removals.push_back(oldOrder[o]);
+    for (; n < newCount; n++) diff.additions.push_back(newOrder[n]);
+
+    std::sort(diff.matches.begin(), diff.matches.end(),
+              [](const DiffMatch &a, const DiffMatch &b) { return a.newIndex < b.newIndex; });
+    std::sort(diff.additions.begin(), diff.additions.end());
+    std::sort(diff.removals.begin(), diff.removals.end());
+}
+
+}
@@ -0,0 +1,71 @@
+//
+//  CHAConstraintDiff.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintDiff_h
+#define CHAAutolayoutCategories_CHAConstraintDiff_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+/**
+ @description What a matched constraint needs to become its new record
+ */
+enum DiffChange : uint8_t
+{
+    DiffChangeNone = 0,
+    DiffChangeConstant = 1 << 0,
+    DiffChangePriority = 1 << 1,
+    // The priority crosses the required boundary, which UIKit only allows while the constraint is inactive.
+    DiffChangeReinstall = 1 << 2
+};
+
+struct DiffMatch
+{
+    uint32_t oldIndex;
+    uint32_t newIndex;
+    uint8_t changes;
+};
+
+/**
+ @description The edit that turns one constraint set into another
+ @field matches One entry per new record that reuses an old constraint, changed or not, in new-record order
+ @field additions New records with no structural match, ascending
+ @field removals Old records with no structural match, ascending
+ */
+struct ConstraintDiff
+{
+    std::vector<DiffMatch> matches;
+    std::vector<uint32_t> additions;
+    std::vector<uint32_t> removals;
+
+    size_t changedCount() const;
+    void clear();
+};
+
+/**
+ @description Whether two records constrain the same thing: same items, attributes, relation and multiplier
+ */
+bool structurallyEqual(const CHAConstraintDescriptor &a, const CHAConstraintDescriptor &b);
+
+/**
+ @description Match two constraint sets structurally. Records that share a structure are paired in their original order;
+ the rest are additions and removals. Sorting both sides makes this O(n log n).
+ */
+void diffConstraints(const CHAConstraintDescriptor *oldRecords,
+                     size_t oldCount,
+                     const CHAConstraintDescriptor *newRecords,
+                     size_t newCount,
+                     ConstraintDiff &diff);
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+//
+//  CHAConstraintOwnershipIndex.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintOwnershipIndex.h"
+
+#include <algorithm>
+
+namespace cha {
+
+void ConstraintOwnershipIndex::add(Handle constraint, Handle firstItem, Handle secondItem)
+{
+    if (!constraint || !firstItem || byConstraint_.count(constraint)) return;
+
+    uint32_t index;
+    if (!freeEntries_.empty())
+    {
+        index = freeEntries_.back();
+        freeEntries_.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)entries_.size();
+        entries_.push_back(Entry{nullptr, {nullptr, nullptr}, 0, false});
+    }
+
+    Entry &entry = entries_[index];
+    entry.constraint = constraint;
+    entry.items[0] = firstItem;
+    entry.items[1] = (secondItem == firstItem) ? nullptr : secondItem;
+    entry.live = true;
+
+    byConstraint_[constraint] = index;
+    link(entry.items[0], index);
+    if (entry.items[1]) link(entry.items[1], index);
+}
+
+bool ConstraintOwnershipIndex::remove(Handle constraint)
+{
+    auto found = byConstraint_.find(constraint);
+    if (found == byConstraint_.end()) return false;
+
+    release(found->second, nullptr);
+    return true;
+}
+
+size_t ConstraintOwnershipIndex::takeConstraintsForItems(const Handle *items, size_t itemCount, std::vector<Handle> &constraints)
+{
+    size_t taken = 0;
+    for (size_t i = 0; i < itemCount; i++)
+    {
+        auto found = byItem_.find(items[i]);
+        if (found == byItem_.end()) continue;
+
+        std::vector<Reference> references;
+        references.swap(found->second.references);
+        byItem_.erase(found);
+
+        for (const Reference &reference : references)
+        {
+            if (!isCurrent(reference)) continue;
+
+            constraints.push_back(entries_[reference.entry].constraint);
+            release(reference.entry, items[i]);
+            taken++;
+        }
+    }
+    return taken;
+}
+
+bool ConstraintOwnershipIndex::contains(Handle constraint) const
+{
+    return byConstraint_.count(constraint) != 0;
+}
+
+size_t ConstraintOwnershipIndex::constraintCountForItem(Handle item) const
+{
+    auto found = byItem_.find(item);
+    return found == byItem_.end() ? 0 : found->second.live;
+}
+
+void ConstraintOwnershipIndex::link(Handle item, uint32_t entry)
+{
+    ItemList &list = byItem_[item];
+
+    // Drop references to released entries once they outnumber the live ones.
+    if (list.references.size() >= 8 && list.references.size() > 2 * (size_t)list.live)
+    {
+        list.references.erase(std::remove_if(list.references.begin(), list.references.end(),
+                                             [this](const Reference &reference) { return !isCurrent(reference); }),
+                              list.references.end());
+    }
+
+    list.references.push_back(Reference{entry, entries_[entry].generation});
+    list.live++;
+}
+
+void ConstraintOwnershipIndex::release(uint32_t index, Handle skippedItem)
+{
+    Entry &entry = entries_[index];
+    for (Handle item : entry.items)
+    {
+        if (!item || item == skippedItem) continue;
+
+        auto found = byItem_.find(item);
+        if (found == byItem_.end()) continue;
+        if (--found->second.live == 0) byItem_.erase(found);
+    }
+
+    byConstraint_.erase(entry.constraint);
+    entry.constraint = nullptr;
+    entry.items[0] = entry.items[1] = nullptr;
+    entry.live = false;
+    entry.generation++;
+    freeEntries_.push_back(index);
+}
+
+bool ConstraintOwnershipIndex::isCurrent(const Reference &reference) const
+{
+    const Entry &entry = entries_[reference.entry];
+    return entry.live && entry.generation == reference.generation;
+}
+
+}
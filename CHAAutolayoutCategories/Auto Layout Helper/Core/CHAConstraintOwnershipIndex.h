@@ -0,0 +1,87 @@
+//
+//  CHAConstraintOwnershipIndex.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintOwnershipIndex_h
+#define CHAAutolayoutCategories_CHAConstraintOwnershipIndex_h
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cha {
+
+/**
+ @description Side table from each item (view or layout guide) to the constraints that reference it.
+ @discussion Items and constraints are opaque, unretained pointers. Every constraint is stored once and referenced from the
+ lists of both of its items; removing it through one item leaves a stale reference in the other list that is skipped by a
+ generation check and compacted away later. Taking the constraints for k items costs O(k + constraints found).
+ Not thread-safe; the category guards its shared index with a mutex.
+ */
+class ConstraintOwnershipIndex
+{
+public:
+    typedef const void *Handle;
+
+    /**
+     @description Record a constraint relating firstItem to secondItem. secondItem may be null. Adding a constraint that is
+     already indexed is a no-op.
+     */
+    void add(Handle constraint, Handle firstItem, Handle secondItem);
+
+    /**
+     @description Forget a constraint, e.g. when it is deallocated
+     @return true if the constraint was indexed
+     */
+    bool remove(Handle constraint);
+
+    /**
+     @description Remove every constraint that references any of the given items from the index and append each of them to
+     constraints exactly once
+     @return The number of constraints appended
+     */
+    size_t takeConstraintsForItems(const Handle *items, size_t itemCount, std::vector<Handle> &constraints);
+
+    bool contains(Handle constraint) const;
+    size_t constraintCount() const { return byConstraint_.size(); }
+    size_t itemCount() const { return byItem_.size(); }
+    size_t constraintCountForItem(Handle item) const;
+
+private:
+    struct Entry
+    {
+        Handle constraint;
+        Handle items[2];
+        uint32_t generation;
+        bool live;
+    };
+
+    struct Reference
+    {
+        uint32_t entry;
+        uint32_t generation;
+    };
+
+    struct ItemList
+    {
+        std::vector<Reference> references;
+        uint32_t live;
+    };
+
+    void link(Handle item, uint32_t entry);
+    void release(uint32_t entry, Handle skippedItem);
+    bool isCurrent(const Reference &reference) const;
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> freeEntries_;
+    std::unordered_map<Handle, uint32_t> byConstraint_;
+    std::unordered_map<Handle, ItemList> byItem_;
+};
+
+}
+
+#endif
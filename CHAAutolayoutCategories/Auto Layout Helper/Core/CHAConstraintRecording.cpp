@@ -0,0 +1,207 @@
+//
+//  CHAConstraintRecording.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAConstraintRecording.h"
+
+#include <cstdio>
+#include <sstream>
+
+namespace cha {
+
+namespace {
+
+const struct
+{
+    CHALayoutAttribute attribute;
+    const char *name;
+} kAttributeNames[] = {
+    {CHALayoutAttributeNotAnAttribute, "notAnAttribute"},
+    {CHALayoutAttributeLeft, "left"},
+    {CHALayoutAttributeRight, "right"},
+    {CHALayoutAttributeTop, "top"},
+    {CHALayoutAttributeBottom, "bottom"},
+    {CHALayoutAttributeLeading, "leading"},
+    {CHALayoutAttributeTrailing, "trailing"},
+    {CHALayoutAttributeWidth, "width"},
+    {CHALayoutAttributeHeight, "height"},
+    {CHALayoutAttributeCenterX, "centerX"},
+    {CHALayoutAttributeCenterY, "centerY"},
+    {CHALayoutAttributeBaseline, "baseline"},
+};
+
+std::string sanitizedName(const std::string &name)
+{
+    std::string sanitized = name.empty() ? std::string("-") : name;
+    for (char &character : sanitized)
+    {
+        if (character == ' ' || character == '\t' || character == '\n' || character == '\r') character = '_';
+    }
+    return sanitized;
+}
+
+std::string formatNumber(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+bool fail(std::string *error, size_t line, const std::string &message)
+{
+    if (error) *error = "line " + std::to_string(line) + ": " + message;
+    return false;
+}
+
+}
+
+ConstraintRecording::ConstraintRecording()
+: width(-1),
+  height(-1)
+{
+}
+
+const void *ConstraintRecording::itemNamed(const std::string &name)
+{
+    for (size_t index = 0; index < itemNames.size(); index++)
+    {
+        if (itemNames[index] == name) return item(index);
+    }
+    itemNames.push_back(name);
+    return item(itemNames.size() - 1);
+}
+
+std::vector<const char *> ConstraintRecording::originPointers() const
+{
+    std::vector<const char *> pointers;
+    for (const std::string &origin : origins) pointers.push_back(origin.empty() ? nullptr : origin.c_str());
+    return pointers;
+}
+
+const char *nameForAttribute(CHALayoutAttribute attribute)
+{
+    for (const auto &entry : kAttributeNames)
+    {
+        if (entry.attribute == attribute) return entry.name;
+    }
+    return "notAnAttribute";
+}
+
+bool attributeForName(const std::string &name, CHALayoutAttribute &attribute)
+{
+    for (const auto &entry : kAttributeNames)
+    {
+        if (name == entry.name)
+        {
+            attribute = entry.attribute;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *symbolForRelation(CHALayoutRelation relation)
+{
+    if (relation == CHALayoutRelationLessThanOrEqual) return "<=";
+    if (relation == CHALayoutRelationGreaterThanOrEqual) return ">=";
+    return "==";
+}
+
+bool relationForSymbol(const std::string &symbol, CHALayoutRelation &relation)
+{
+    if (symbol == "==") relation = CHALayoutRelationEqual;
+    else if (symbol == "<=") relation = CHALayoutRelationLessThanOrEqual;
+    else if (symbol == ">=") relation = CHALayoutRelationGreaterThanOrEqual;
+    else return false;
+    return true;
+}
+
+bool parseConstraintRecording(const std::string &text, ConstraintRecording &recording, std::string *error)
+{
+    recording = ConstraintRecording();
+    std::istringstream lines(text);
+    std::string line;
+    size_t lineNumber = 0;
+    bool sawContainer = false;
+
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword) || keyword[0] == '#') continue;
+
+        if (keyword == "container")
+        {
+            std::string name;
+            if (sawContainer) return fail(error, lineNumber, "second container");
+            if (!(fields >> name >> recording.width >> recording.height)) return fail(error, lineNumber, "expected container <name> <width> <height>");
+            recording.itemNames.push_back(name);
+            sawContainer = true;
+        }
+        else if (keyword == "constraint")
+        {
+            if (!sawContainer) return fail(error, lineNumber, "constraint before container");
+
+            std::string item, attribute, relation, toItem, toAttribute;
+            CHAConstraintDescriptor record = {nullptr, nullptr, 1, 0, CHALayoutPriorityRequired, 0, 0, 0, 0};
+            if (!(fields >> item >> attribute >> relation >> toItem >> toAttribute >> record.multiplier >> record.constant >> record.priority))
+            {
+                return fail(error, lineNumber, "expected constraint <item> <attribute> <relation> <toItem> <toAttribute> <multiplier> <constant> <priority>");
+            }
+            if (!attributeForName(attribute, record.attribute) || !attributeForName(toAttribute, record.toAttribute))
+            {
+                return fail(error, lineNumber, "unknown attribute");
+            }
+            if (!relationForSymbol(relation, record.relation)) return fail(error, lineNumber, "unknown relation " + relation);
+
+            record.item = recording.itemNamed(item);
+            record.toItem = toItem == "-" ? nullptr : recording.itemNamed(toItem);
+
+            std::string origin;
+            std::getline(fields >> std::ws, origin);
+            recording.records.push_back(record);
+            recording.origins.push_back(origin);
+        }
+        else
+        {
+            return fail(error, lineNumber, "unknown keyword " + keyword);
+        }
+    }
+
+    if (!sawContainer) return fail(error, lineNumber, "no container");
+    return true;
+}
+
+std::string writeConstraintRecording(const ConstraintRecording &recording)
+{
+    std::string text = "container " + sanitizedName(recording.itemNames.empty() ? std::string() : recording.itemNames[0]) + " " +
+                       formatNumber(recording.width) + " " + formatNumber(recording.height) + "\n";
+
+    for (size_t index = 0; index < recording.records.size(); index++)
+    {
+        const CHAConstraintDescriptor &record = recording.records[index];
+        text += "constraint " + sanitizedName(recording.nameOfItem(record.item)) + " " + nameForAttribute(record.attribute) + " " +
+                symbolForRelation(record.relation) + " " +
+                (record.toItem ? sanitizedName(recording.nameOfItem(record.toItem)) : std::string("-")) + " " +
+                nameForAttribute(record.toAttribute) + " " + formatNumber(record.multiplier) + " " + formatNumber(record.constant) +
+                " " + formatNumber(record.priority);
+
+        if (index < recording.origins.size() && !recording.origins[index].empty())
+        {
+            std::string origin = recording.origins[index];
+            for (char &character : origin)
+            {
+                if (character == '\n' || character == '\r') character = ' ';
+            }
+            text += " " + origin;
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+}
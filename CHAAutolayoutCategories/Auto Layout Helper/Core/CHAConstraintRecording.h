@@ -0,0 +1,67 @@
+//
+//  CHAConstraintRecording.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAConstraintRecording_h
+#define CHAAutolayoutCategories_CHAConstraintRecording_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+/**
+ @description A constraint set captured on a device, replayable without UIKit.
+ @discussion The text form is line-based:
+     container <name> <width> <height>
+     constraint <item> <attribute> <relation> <toItem|-> <toAttribute> <multiplier> <constant> <priority> [origin]
+ Names contain no whitespace, a negative container dimension is free, the origin runs to the end of the line, and lines
+ starting with # are comments. Items in records are the opaque pointers returned by item(), with item(0) the container.
+ */
+struct ConstraintRecording
+{
+    std::vector<std::string> itemNames;
+    double width;
+    double height;
+    std::vector<CHAConstraintDescriptor> records;
+    std::vector<std::string> origins;
+
+    ConstraintRecording();
+
+    static const void *item(size_t index) { return reinterpret_cast<const void *>((uintptr_t)(index + 1)); }
+    static size_t indexOfItem(const void *item) { return (size_t)reinterpret_cast<uintptr_t>(item) - 1; }
+    const void *container() const { return item(0); }
+
+    /**
+     @description The item registered under name, registering it when it is new
+     */
+    const void *itemNamed(const std::string &name);
+    const std::string &nameOfItem(const void *item) const { return itemNames[indexOfItem(item)]; }
+
+    /**
+     @description Pointers into origins, null for empty ones, for describeIssue
+     */
+    std::vector<const char *> originPointers() const;
+};
+
+const char *nameForAttribute(CHALayoutAttribute attribute);
+bool attributeForName(const std::string &name, CHALayoutAttribute &attribute);
+const char *symbolForRelation(CHALayoutRelation relation);
+bool relationForSymbol(const std::string &symbol, CHALayoutRelation &relation);
+
+/**
+ @return false with a "line N: ..." message in error if the text is malformed
+ */
+bool parseConstraintRecording(const std::string &text, ConstraintRecording &recording, std::string *error);
+std::string writeConstraintRecording(const ConstraintRecording &recording);
+
+}
+
+#endif
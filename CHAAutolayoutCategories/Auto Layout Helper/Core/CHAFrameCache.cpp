@@ -0,0 +1,101 @@
+//
+//  CHAFrameCache.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAFrameCache.h"
+
+#include <cstring>
+#include <functional>
+#include <utility>
+
+namespace cha {
+
+size_t FrameCacheKeyHash::operator()(const FrameCacheKey &key) const
+{
+    uint64_t widthBits, heightBits;
+    std::memcpy(&widthBits, &key.width, sizeof(widthBits));
+    std::memcpy(&heightBits, &key.height, sizeof(heightBits));
+
+    uint64_t hash = key.templateIdentifier;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ widthBits;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ heightBits;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ key.contentHash;
+    return std::hash<uint64_t>()(hash);
+}
+
+FrameCache::FrameCache(size_t capacity)
+: capacity_(capacity),
+  hits_(0),
+  misses_(0)
+{
+}
+
+FrameCache::Frames FrameCache::find(const FrameCacheKey &key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(key);
+    if (found == index_.end())
+    {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->second;
+}
+
+void FrameCache::insert(const FrameCacheKey &key, Frames frames)
+{
+    if (capacity_ == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(key);
+    if (found != index_.end())
+    {
+        found->second->second = std::move(frames);
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+
+    entries_.emplace_front(key, std::move(frames));
+    index_[key] = entries_.begin();
+
+    if (entries_.size() > capacity_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
+
+void FrameCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+size_t FrameCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t FrameCache::hitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t FrameCache::missCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+}
@@ -0,0 +1,82 @@
+//
+//  CHAFrameCache.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAFrameCache_h
+#define CHAAutolayoutCategories_CHAFrameCache_h
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+/**
+ @description Identifies one solved instance of a template: the template, the container size and the content
+ */
+struct FrameCacheKey
+{
+    uint64_t templateIdentifier;
+    double width;
+    double height;
+    uint64_t contentHash;
+
+    bool operator==(const FrameCacheKey &other) const
+    {
+        return templateIdentifier == other.templateIdentifier && width == other.width && height == other.height &&
+               contentHash == other.contentHash;
+    }
+};
+
+struct FrameCacheKeyHash
+{
+    size_t operator()(const FrameCacheKey &key) const;
+};
+
+/**
+ @description A thread-safe, size-bounded LRU cache of solved frames.
+ @discussion Values are immutable and shared, so a reader on the main thread keeps its frames alive even if a worker
+ evicts the entry a moment later.
+ */
+class FrameCache
+{
+public:
+    typedef std::shared_ptr<const std::vector<Frame>> Frames;
+
+    explicit FrameCache(size_t capacity);
+
+    /**
+     @return The cached frames, or null on a miss. A hit marks the entry most recently used.
+     */
+    Frames find(const FrameCacheKey &key);
+    void insert(const FrameCacheKey &key, Frames frames);
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+    uint64_t hitCount() const;
+    uint64_t missCount() const;
+
+private:
+    typedef std::list<std::pair<FrameCacheKey, Frames>> Entries;
+
+    size_t capacity_;
+    Entries entries_;
+    std::unordered_map<FrameCacheKey, Entries::iterator, FrameCacheKeyHash> index_;
+    mutable std::mutex mutex_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+}
+
+#endif
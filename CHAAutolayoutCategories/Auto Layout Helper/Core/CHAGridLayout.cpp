@@ -0,0 +1,371 @@
+//
+//  CHAGridLayout.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAGridLayout.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define CHA_GRID_SSE2 1
+#endif
+#if defined(__AVX__)
+#define CHA_GRID_AVX 1
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CHA_GRID_NEON 1
+#endif
+
+namespace cha {
+
+namespace {
+
+struct Track
+{
+    double offset;
+    double length;
+};
+
+// Tracks share the space left by the insets and spacing, in proportion to their weights.
+void sizeTracks(size_t count, double start, double available, double spacing, const double *weights, std::vector<Track> &tracks)
+{
+    tracks.resize(count);
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++) total += weights ? weights[i] : 1.0;
+
+    double offset = start;
+    for (size_t i = 0; i < count; i++)
+    {
+        double length = available * (weights ? weights[i] : 1.0) / total;
+        tracks[i] = Track{offset, length};
+        offset += length + spacing;
+    }
+}
+
+// Each kernel writes one row: the column offsets and widths are copied and the row's y and height are broadcast. No
+// arithmetic happens here; the vector paths only widen the loads and stores.
+struct RowArguments
+{
+    const double *columnX;
+    const double *columnWidth;
+    double y;
+    double height;
+    double *x;
+    double *rowY;
+    double *width;
+    double *rowHeight;
+};
+
+void writeRowScalar(const RowArguments &row, size_t begin, size_t count)
+{
+    for (size_t i = begin; i < count; i++)
+    {
+        row.x[i] = row.columnX[i];
+        row.width[i] = row.columnWidth[i];
+        row.rowY[i] = row.y;
+        row.rowHeight[i] = row.height;
+    }
+}
+
+#if CHA_GRID_SSE2
+void writeRowSSE2(const RowArguments &row, size_t count)
+{
+    const __m128d y = _mm_set1_pd(row.y);
+    const __m128d height = _mm_set1_pd(row.height);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        _mm_storeu_pd(row.x + i, _mm_loadu_pd(row.columnX + i));
+        _mm_storeu_pd(row.width + i, _mm_loadu_pd(row.columnWidth + i));
+        _mm_storeu_pd(row.rowY + i, y);
+        _mm_storeu_pd(row.rowHeight + i, height);
+    }
+    writeRowScalar(row, i, count);
+}
+#endif
+
+#if CHA_GRID_AVX
+void writeRowAVX(const RowArguments &row, size_t count)
+{
+    const __m256d y = _mm256_set1_pd(row.y);
+    const __m256d height = _mm256_set1_pd(row.height);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(row.x + i, _mm256_loadu_pd(row.columnX + i));
+        _mm256_storeu_pd(row.width + i, _mm256_loadu_pd(row.columnWidth + i));
+        _mm256_storeu_pd(row.rowY + i, y);
+        _mm256_storeu_pd(row.rowHeight + i, height);
+    }
+    writeRowScalar(row, i, count);
+}
+#endif
+
+#if CHA_GRID_NEON
+void writeRowNEON(const RowArguments &row, size_t count)
+{
+    const float64x2_t y = vdupq_n_f64(row.y);
+    const float64x2_t height = vdupq_n_f64(row.height);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        vst1q_f64(row.x + i, vld1q_f64(row.columnX + i));
+        vst1q_f64(row.width + i, vld1q_f64(row.columnWidth + i));
+        vst1q_f64(row.rowY + i, y);
+        vst1q_f64(row.rowHeight + i, height);
+    }
+    writeRowScalar(row, i, count);
+}
+#endif
+
+void writeRow(GridKernel kernel, const RowArguments &row, size_t count)
+{
+    switch (kernel)
+    {
+#if CHA_GRID_SSE2
+        case GridKernelSSE2:
+            writeRowSSE2(row, count);
+            return;
+#endif
+#if CHA_GRID_AVX
+        case GridKernelAVX:
+            writeRowAVX(row, count);
+            return;
+#endif
+#if CHA_GRID_NEON
+        case GridKernelNEON:
+            writeRowNEON(row, count);
+            return;
+#endif
+        default:
+            writeRowScalar(row, 0, count);
+            return;
+    }
+}
+
+CHAConstraintDescriptor makeDescriptor(const void *item, CHALayoutAttribute attribute, const void *toItem,
+                                       CHALayoutAttribute toAttribute, double multiplier, double constant)
+{
+    return CHAConstraintDescriptor{item, toItem, multiplier, constant, CHALayoutPriorityRequired, attribute, toAttribute,
+                                   CHALayoutRelationEqual, 0};
+}
+
+// The first track's length as a fraction of the container's, after insets and spacing.
+void appendShareOfContainer(const void *item, CHALayoutAttribute attribute, const void *container, size_t tracks, double insets,
+                            double spacing, const double *weights, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < tracks; i++) total += weights ? weights[i] : 1.0;
+    const double share = (weights ? weights[0] : 1.0) / total;
+    const double space = insets + spacing * (double)(tracks - 1);
+    descriptors.push_back(makeDescriptor(item, attribute, container, attribute, share, -space * share));
+}
+
+}
+
+void FrameBuffer::resize(size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    width.resize(count);
+    height.resize(count);
+}
+
+bool isGridKernelAvailable(GridKernel kernel)
+{
+    switch (kernel)
+    {
+        case GridKernelScalar:
+            return true;
+#if CHA_GRID_SSE2
+        case GridKernelSSE2:
+            return true;
+#endif
+#if CHA_GRID_AVX
+        case GridKernelAVX:
+            return true;
+#endif
+#if CHA_GRID_NEON
+        case GridKernelNEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+GridKernel preferredGridKernel()
+{
+#if CHA_GRID_AVX
+    return GridKernelAVX;
+#elif CHA_GRID_SSE2
+    return GridKernelSSE2;
+#elif CHA_GRID_NEON
+    return GridKernelNEON;
+#else
+    return GridKernelScalar;
+#endif
+}
+
+const char *nameForGridKernel(GridKernel kernel)
+{
+    switch (kernel)
+    {
+        case GridKernelScalar:
+            return "scalar";
+        case GridKernelSSE2:
+            return "sse2";
+        case GridKernelAVX:
+            return "avx";
+        case GridKernelNEON:
+            return "neon";
+    }
+    return "unknown";
+}
+
+size_t gridRowCount(const CHAGridSpec &spec, size_t count)
+{
+    if (spec.rows > 0) return spec.rows;
+    if (spec.columns == 0) return 0;
+    return (count + spec.columns - 1) / spec.columns;
+}
+
+bool layoutGrid(const CHAGridSpec &spec,
+                double width,
+                double height,
+                size_t count,
+                FrameBuffer &frames,
+                GridKernel kernel,
+                double *contentHeight)
+{
+    const size_t columns = spec.columns;
+    const size_t rows = gridRowCount(spec, count);
+    if (columns == 0 || count > rows * columns) return false;
+    if (spec.rowHeight <= 0.0 && height < 0.0) return false;
+    if (!isGridKernelAvailable(kernel)) kernel = GridKernelScalar;
+
+    std::vector<Track> columnTracks;
+    std::vector<Track> rowTracks;
+    const double columnSpace = width - spec.leading - spec.trailing - spec.columnSpacing * (double)(columns - 1);
+    sizeTracks(columns, spec.leading, columnSpace, spec.columnSpacing, spec.columnWeights, columnTracks);
+    if (spec.rowHeight > 0.0)
+    {
+        sizeTracks(rows, spec.top, spec.rowHeight * (double)rows, spec.rowSpacing, nullptr, rowTracks);
+    }
+    else
+    {
+        const double rowSpace = height - spec.top - spec.bottom - spec.rowSpacing * (double)(rows > 0 ? rows - 1 : 0);
+        sizeTracks(rows, spec.top, rowSpace, spec.rowSpacing, spec.rowWeights, rowTracks);
+    }
+
+    std::vector<double> columnX(columns);
+    std::vector<double> columnWidth(columns);
+    for (size_t column = 0; column < columns; column++)
+    {
+        columnX[column] = columnTracks[column].offset;
+        columnWidth[column] = columnTracks[column].length;
+    }
+
+    frames.resize(count);
+    for (size_t row = 0, first = 0; first < count; row++, first += columns)
+    {
+        const size_t cells = count - first < columns ? count - first : columns;
+        RowArguments arguments = {columnX.data(),
+                                  columnWidth.data(),
+                                  rowTracks[row].offset,
+                                  rowTracks[row].length,
+                                  frames.x.data() + first,
+                                  frames.y.data() + first,
+                                  frames.width.data() + first,
+                                  frames.height.data() + first};
+        writeRow(kernel, arguments, cells);
+    }
+
+    if (contentHeight)
+    {
+        const Track &last = rows > 0 ? rowTracks[rows - 1] : Track{spec.top, 0.0};
+        *contentHeight = last.offset + last.length + spec.bottom;
+    }
+    return true;
+}
+
+void appendGridDescriptors(const CHAGridSpec &spec,
+                           const void *container,
+                           const void *const *items,
+                           size_t count,
+                           std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    const size_t columns = spec.columns;
+    if (count == 0 || columns == 0) return;
+    const size_t rows = gridRowCount(spec, count);
+
+    descriptors.reserve(descriptors.size() + 4 * count + 2);
+    for (size_t i = 0; i < count; i++)
+    {
+        const size_t row = i / columns;
+        const size_t column = i % columns;
+
+        if (column == 0)
+        {
+            descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeLeading, container, CHALayoutAttributeLeading, 1, spec.leading));
+        }
+        else
+        {
+            descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeLeading, items[i - 1], CHALayoutAttributeTrailing, 1,
+                                                 spec.columnSpacing));
+        }
+
+        if (row == 0)
+        {
+            descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeTop, container, CHALayoutAttributeTop, 1, spec.top));
+        }
+        else
+        {
+            descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeTop, items[i - columns], CHALayoutAttributeBottom, 1,
+                                                 spec.rowSpacing));
+        }
+
+        if (i == 0) continue;
+
+        const double columnRatio = spec.columnWeights ? spec.columnWeights[column] / spec.columnWeights[0] : 1.0;
+        descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeWidth, items[0], CHALayoutAttributeWidth, columnRatio, 0));
+
+        const double rowRatio = spec.rowWeights && spec.rowHeight <= 0.0 ? spec.rowWeights[row] / spec.rowWeights[0] : 1.0;
+        descriptors.push_back(makeDescriptor(items[i], CHALayoutAttributeHeight, items[0], CHALayoutAttributeHeight, rowRatio, 0));
+    }
+
+    // A full first row closes the columns with a trailing pin; a partial one sizes the first column from the container.
+    if (count >= columns)
+    {
+        descriptors.push_back(makeDescriptor(items[columns - 1], CHALayoutAttributeTrailing, container, CHALayoutAttributeTrailing, 1,
+                                             -spec.trailing));
+    }
+    else
+    {
+        appendShareOfContainer(items[0], CHALayoutAttributeWidth, container, columns, spec.leading + spec.trailing,
+                               spec.columnSpacing, spec.columnWeights, descriptors);
+    }
+
+    // Likewise rows: a fixed height, a bottom pin under the last row, or a share of the container when rows stay empty.
+    const size_t lastRow = (count - 1) / columns;
+    if (spec.rowHeight > 0.0)
+    {
+        descriptors.push_back(makeDescriptor(items[0], CHALayoutAttributeHeight, nullptr, CHALayoutAttributeNotAnAttribute, 0,
+                                             spec.rowHeight));
+    }
+    else if (lastRow + 1 == rows)
+    {
+        descriptors.push_back(makeDescriptor(items[lastRow * columns], CHALayoutAttributeBottom, container, CHALayoutAttributeBottom,
+                                             1, -spec.bottom));
+    }
+    else
+    {
+        appendShareOfContainer(items[0], CHALayoutAttributeHeight, container, rows, spec.top + spec.bottom, spec.rowSpacing,
+                               spec.rowWeights, descriptors);
+    }
+}
+
+}
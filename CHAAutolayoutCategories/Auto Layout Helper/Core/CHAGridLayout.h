@@ -0,0 +1,113 @@
+//
+//  CHAGridLayout.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAGridLayout_h
+#define CHAAutolayoutCategories_CHAGridLayout_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ @description A uniform grid filled row by row
+ @field rows Row count; 0 derives it from the number of views
+ @field columns Column count, at least 1
+ @field rowHeight A positive value fixes every row's height; otherwise the rows share the height left by the insets and spacing
+ @field columnWeights Per-column weights, or null for equal columns
+ @field rowWeights Per-row weights, or null for equal rows; ignored when rowHeight is set
+ */
+typedef struct CHAGridSpec
+{
+    uint32_t rows;
+    uint32_t columns;
+    double rowSpacing;
+    double columnSpacing;
+    double top;
+    double leading;
+    double bottom;
+    double trailing;
+    double rowHeight;
+    const double *columnWeights;
+    const double *rowWeights;
+} CHAGridSpec;
+
+#ifdef __cplusplus
+
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+/**
+ @description Frames stored as one array per field so a kernel can write whole rows with vector stores
+ */
+struct FrameBuffer
+{
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> width;
+    std::vector<double> height;
+
+    size_t size() const { return x.size(); }
+    void resize(size_t count);
+    Frame frame(size_t index) const { return Frame{x[index], y[index], width[index], height[index]}; }
+};
+
+/**
+ @description The instruction sets the grid kernel is compiled for. Only the ones enabled for the target at compile time are
+ available; there is no runtime detection, so an x86 build without -mavx never uses AVX.
+ */
+enum GridKernel
+{
+    GridKernelScalar = 0,
+    GridKernelSSE2,
+    GridKernelAVX,
+    GridKernelNEON
+};
+
+bool isGridKernelAvailable(GridKernel kernel);
+GridKernel preferredGridKernel();
+const char *nameForGridKernel(GridKernel kernel);
+
+/**
+ @description Rows needed for count views under spec
+ */
+size_t gridRowCount(const CHAGridSpec &spec, size_t count);
+
+/**
+ @description Frames for count views in a grid, in closed form: track offsets and lengths are computed once in scalar code,
+ then the kernel fills every row by copying the column tracks and broadcasting the row's y and height with vector stores.
+ @param height The container height; may be negative when spec.rowHeight is set
+ @param frames Receives one frame per view, row-major
+ @param contentHeight Receives the height the grid occupies including its insets; may be null
+ @return false if spec has no columns, the views need more rows than spec.rows, or the row heights are undetermined
+ */
+bool layoutGrid(const CHAGridSpec &spec,
+                double width,
+                double height,
+                size_t count,
+                FrameBuffer &frames,
+                GridKernel kernel = preferredGridKernel(),
+                double *contentHeight = nullptr);
+
+/**
+ @description Append the constraint set that expresses the same grid the way -equalWidths: and -equalHeights: would: every
+ view's width and height relative to the first view, a leading chain per row, a top chain per column, and the trailing
+ and bottom pins that close the first row and column.
+ */
+void appendGridDescriptors(const CHAGridSpec &spec,
+                           const void *container,
+                           const void *const *items,
+                           size_t count,
+                           std::vector<CHAConstraintDescriptor> &descriptors);
+
+}
+
+#endif
+
+#endif
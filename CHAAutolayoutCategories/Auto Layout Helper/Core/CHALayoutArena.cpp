@@ -0,0 +1,217 @@
+//
+//  CHALayoutArena.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHALayoutArena.h"
+
+#include <algorithm>
+
+namespace cha {
+
+LayoutArena::LayoutArena(size_t chunkSize)
+: chunkSize_(std::max<size_t>(chunkSize, 256)),
+  chunkIndex_(0),
+  offset_(0),
+  bytesInUse_(0),
+  highWaterMark_(0),
+  capacity_(0),
+  chunkAllocations_(0)
+{
+    std::fill(freeBlocks_, freeBlocks_ + kSizeClasses, nullptr);
+}
+
+size_t LayoutArena::sizeClassFor(size_t size)
+{
+    size_t sizeClass = 4;
+    while (((size_t)1 << sizeClass) < size) sizeClass++;
+    return sizeClass;
+}
+
+void *LayoutArena::allocate(size_t size, size_t alignment)
+{
+    if (size == 0) size = 1;
+
+    // Walk forward through the chunks kept from earlier passes before taking a new one.
+    while (chunkIndex_ < chunks_.size())
+    {
+        Chunk &chunk = chunks_[chunkIndex_];
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.bytes.get());
+        size_t aligned = (size_t)(((base + offset_ + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+        if (aligned + size <= chunk.size)
+        {
+            bytesInUse_ += aligned + size - offset_;
+            highWaterMark_ = std::max(highWaterMark_, bytesInUse_);
+            offset_ = aligned + size;
+            return chunk.bytes.get() + aligned;
+        }
+        chunkIndex_++;
+        offset_ = 0;
+    }
+
+    size_t chunkSize = std::max(chunkSize_, size + alignment);
+    chunks_.push_back(Chunk{std::unique_ptr<unsigned char[]>(new unsigned char[chunkSize]), chunkSize});
+    capacity_ += chunkSize;
+    chunkAllocations_++;
+    chunkIndex_ = chunks_.size() - 1;
+    offset_ = 0;
+    return allocate(size, alignment);
+}
+
+void *LayoutArena::allocateBlock(size_t size)
+{
+    size_t sizeClass = sizeClassFor(size);
+    if (sizeClass >= kSizeClasses) return allocate(size);
+
+    if (FreeBlock *block = freeBlocks_[sizeClass])
+    {
+        freeBlocks_[sizeClass] = block->next;
+        return block;
+    }
+    return allocate((size_t)1 << sizeClass);
+}
+
+void LayoutArena::recycleBlock(void *block, size_t size)
+{
+    size_t sizeClass = sizeClassFor(size);
+    if (!block || sizeClass >= kSizeClasses) return;
+
+    FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+    freeBlock->next = freeBlocks_[sizeClass];
+    freeBlocks_[sizeClass] = freeBlock;
+}
+
+void LayoutArena::reset()
+{
+    std::fill(freeBlocks_, freeBlocks_ + kSizeClasses, nullptr);
+    chunkIndex_ = 0;
+    offset_ = 0;
+    bytesInUse_ = 0;
+}
+
+DescriptorBlockPool::DescriptorBlockPool()
+: free_(nullptr),
+  created_(0),
+  inUse_(0),
+  highWaterMark_(0)
+{
+}
+
+DescriptorBlockPool::~DescriptorBlockPool()
+{
+    while (free_)
+    {
+        DescriptorBlock *next = free_->next;
+        delete free_;
+        free_ = next;
+    }
+}
+
+DescriptorBlockPool &DescriptorBlockPool::shared()
+{
+    static DescriptorBlockPool *pool = new DescriptorBlockPool();
+    return *pool;
+}
+
+DescriptorBlock *DescriptorBlockPool::acquire()
+{
+    DescriptorBlock *block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inUse_++;
+        highWaterMark_ = std::max(highWaterMark_, inUse_);
+        if (free_)
+        {
+            block = free_;
+            free_ = block->next;
+        }
+        else
+        {
+            created_++;
+        }
+    }
+
+    if (!block) block = new DescriptorBlock;
+    block->next = nullptr;
+    block->count = 0;
+    return block;
+}
+
+void DescriptorBlockPool::release(DescriptorBlock *chain)
+{
+    if (!chain) return;
+
+    size_t count = 1;
+    DescriptorBlock *last = chain;
+    while (last->next)
+    {
+        last = last->next;
+        count++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    last->next = free_;
+    free_ = chain;
+    inUse_ -= count;
+}
+
+size_t DescriptorBlockPool::blocksCreated() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_;
+}
+
+size_t DescriptorBlockPool::blocksInUse() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inUse_;
+}
+
+size_t DescriptorBlockPool::highWaterMark() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return highWaterMark_;
+}
+
+DescriptorList::DescriptorList(DescriptorBlockPool &pool)
+: pool_(&pool),
+  first_(nullptr),
+  last_(nullptr),
+  count_(0)
+{
+}
+
+DescriptorList::~DescriptorList()
+{
+    clear();
+}
+
+void DescriptorList::append(const CHAConstraintDescriptor &record)
+{
+    if (!last_ || last_->count == kDescriptorBlockCapacity)
+    {
+        DescriptorBlock *block = pool_->acquire();
+        if (last_) last_->next = block;
+        else first_ = block;
+        last_ = block;
+    }
+    last_->records[last_->count++] = record;
+    count_++;
+}
+
+void DescriptorList::append(const CHAConstraintDescriptor *records, size_t count)
+{
+    for (size_t index = 0; index < count; index++) append(records[index]);
+}
+
+void DescriptorList::clear()
+{
+    pool_->release(first_);
+    first_ = nullptr;
+    last_ = nullptr;
+    count_ = 0;
+}
+
+}
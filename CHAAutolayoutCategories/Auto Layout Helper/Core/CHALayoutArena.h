@@ -0,0 +1,240 @@
+//
+//  CHALayoutArena.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutArena_h
+#define CHAAutolayoutCategories_CHALayoutArena_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+
+namespace cha {
+
+/**
+ @description A bump allocator for the short-lived allocations of one layout pass.
+ @discussion Memory comes from chunks taken from the heap and is only given back all at once by reset(), which rewinds to
+ the first chunk and keeps every chunk for the next pass. A pass that allocates no more than an earlier one therefore
+ touches the heap not at all. Containers allocate through allocateBlock() and recycleBlock() instead, which round sizes
+ up to a power of two and hand a recycled block to the next request of its size class, so a growing vector does not
+ leave a trail of dead copies behind. Not thread-safe.
+ */
+class LayoutArena
+{
+public:
+    static const size_t kDefaultChunkSize = 64 * 1024;
+
+    explicit LayoutArena(size_t chunkSize = kDefaultChunkSize);
+
+    LayoutArena(const LayoutArena &) = delete;
+    LayoutArena &operator=(const LayoutArena &) = delete;
+
+    /**
+     @description Allocate size bytes. Requests larger than the chunk size get a chunk of their own.
+     */
+    void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T *allocateArray(size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     @description A block of at least size bytes aligned for any type, reusing a recycled block of the same size class
+     */
+    void *allocateBlock(size_t size);
+    /**
+     @description Make a block from allocateBlock(size) available to later requests of its size class
+     */
+    void recycleBlock(void *block, size_t size);
+
+    /**
+     @description Release everything allocated since the last reset. Anything still pointing into the arena must be gone.
+     */
+    void reset();
+
+    /**
+     @description Bytes handed out since the last reset, including alignment padding
+     */
+    size_t bytesInUse() const { return bytesInUse_; }
+    /**
+     @description The most bytes in use at once across all passes
+     */
+    size_t highWaterMark() const { return highWaterMark_; }
+    /**
+     @description Bytes held in chunks
+     */
+    size_t capacity() const { return capacity_; }
+    /**
+     @description Chunks taken from the heap since construction; constant once passes reach a steady state
+     */
+    uint64_t chunkAllocations() const { return chunkAllocations_; }
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<unsigned char[]> bytes;
+        size_t size;
+    };
+
+    static const size_t kSizeClasses = 48;
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    static size_t sizeClassFor(size_t size);
+
+    size_t chunkSize_;
+    FreeBlock *freeBlocks_[kSizeClasses];
+    std::vector<Chunk> chunks_;
+    size_t chunkIndex_;
+    size_t offset_;
+    size_t bytesInUse_;
+    size_t highWaterMark_;
+    size_t capacity_;
+    uint64_t chunkAllocations_;
+};
+
+/**
+ @description A standard allocator over an optional arena. Without an arena it forwards to the heap, so containers can take
+ one allocator type whether or not their owner was given an arena. Deallocation into an arena recycles the block.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator(LayoutArena *arena = nullptr) : arena_(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena())
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        if (arena_) return static_cast<T *>(arena_->allocateBlock(count * sizeof(T)));
+        return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, size_t count)
+    {
+        if (arena_) arena_->recycleBlock(pointer, count * sizeof(T));
+        else ::operator delete(pointer);
+    }
+
+    LayoutArena *arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const
+    {
+        return arena_ == other.arena();
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const
+    {
+        return arena_ != other.arena();
+    }
+
+private:
+    LayoutArena *arena_;
+};
+
+const size_t kDescriptorBlockCapacity = 64;
+
+/**
+ @description A fixed run of descriptor records, chained into lists
+ */
+struct DescriptorBlock
+{
+    DescriptorBlock *next;
+    uint32_t count;
+    CHAConstraintDescriptor records[kDescriptorBlockCapacity];
+};
+
+/**
+ @description Recycles descriptor blocks between layout passes. Blocks are taken from the heap only when the free list is
+ empty and are never given back before the pool is destroyed. Thread-safe.
+ */
+class DescriptorBlockPool
+{
+public:
+    DescriptorBlockPool();
+    ~DescriptorBlockPool();
+
+    DescriptorBlockPool(const DescriptorBlockPool &) = delete;
+    DescriptorBlockPool &operator=(const DescriptorBlockPool &) = delete;
+
+    static DescriptorBlockPool &shared();
+
+    /**
+     @description An empty block, unlinked
+     */
+    DescriptorBlock *acquire();
+    /**
+     @description Return a chain of blocks linked through next
+     */
+    void release(DescriptorBlock *chain);
+
+    size_t blocksCreated() const;
+    size_t blocksInUse() const;
+    /**
+     @description The most blocks in use at once
+     */
+    size_t highWaterMark() const;
+
+private:
+    mutable std::mutex mutex_;
+    DescriptorBlock *free_;
+    size_t created_;
+    size_t inUse_;
+    size_t highWaterMark_;
+};
+
+/**
+ @description Descriptor records appended one at a time into pooled blocks
+ */
+class DescriptorList
+{
+public:
+    explicit DescriptorList(DescriptorBlockPool &pool = DescriptorBlockPool::shared());
+    ~DescriptorList();
+
+    DescriptorList(const DescriptorList &) = delete;
+    DescriptorList &operator=(const DescriptorList &) = delete;
+
+    void append(const CHAConstraintDescriptor &record);
+    void append(const CHAConstraintDescriptor *records, size_t count);
+    /**
+     @description Return every block to the pool
+     */
+    void clear();
+
+    size_t count() const { return count_; }
+    const DescriptorBlock *firstBlock() const { return first_; }
+
+private:
+    DescriptorBlockPool *pool_;
+    DescriptorBlock *first_;
+    DescriptorBlock *last_;
+    size_t count_;
+};
+
+}
+
+#endif
@@ -0,0 +1,572 @@
+//
+//  CHALayoutDSL.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  The category's helpers as constexpr expressions over view slots, for Objective-C++ callers. Attributes, relations,
+//  stack axes and the views themselves are template arguments, so invalid pairings, sign conventions and record counts
+//  are settled by the compiler and each expression folds to a fixed-size array of records.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutDSL_h
+#define CHAAutolayoutCategories_CHALayoutDSL_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "CHACompiledLayout.h"
+#include "CHAConstraintDescriptor.h"
+#include "CHAStackLayout.h"
+
+namespace cha {
+namespace dsl {
+
+/**
+ @description A view, known by its slot in the items table an expression is instantiated with, and by its superview's slot
+ @discussion Slot 0 is the container, the view that holds the layout. The superview stands in for self.superview in the
+ helpers that pin to it, so pinning a view without one fails to compile as the helper's NSAssert would fail at runtime.
+ */
+template <uint32_t Slot, uint32_t Superview = 0>
+struct View
+{
+    static_assert(Slot != CompiledRecordNoSlot, "The slot is reserved for a missing item");
+    static_assert(Slot != Superview, "A view cannot be its own superview");
+};
+
+typedef View<0, CompiledRecordNoSlot> Container;
+
+/**
+ @description A group of views, as taken by the helpers that accept an NSArray of views
+ */
+template <typename... Views>
+struct ViewList
+{
+};
+
+template <typename... Views>
+constexpr ViewList<Views...> views(Views...)
+{
+    return ViewList<Views...>();
+}
+
+/**
+ @description Margins around a stack, matching StackSpec
+ */
+struct Insets
+{
+    double top;
+    double leading;
+    double bottom;
+    double trailing;
+};
+
+/**
+ @description The records of an expression, item and toItem being slots
+ */
+template <size_t Count>
+struct Constraints
+{
+    // One spare record when empty, as an expression that skips every view leaves no records.
+    CompiledRecord records[Count > 0 ? Count : 1];
+
+    static constexpr size_t count() { return Count; }
+    constexpr const CompiledRecord &operator[](size_t index) const { return records[index]; }
+
+    /**
+     @return One past the highest slot the records use: the smallest items table they can be instantiated with
+     */
+    constexpr uint32_t slotCount() const
+    {
+        uint32_t slots = 0;
+        for (size_t index = 0; index < Count; index++)
+        {
+            const CompiledRecord &record = records[index];
+            if (record.item + 1 > slots) slots = record.item + 1;
+            if (record.toItem != CompiledRecordNoSlot && record.toItem + 1 > slots) slots = record.toItem + 1;
+        }
+        return slots;
+    }
+
+    /**
+     @param items At least slotCount() items, the container first
+     @param descriptors Receives count() records, ready for constraintsWithDescriptors:count: or a LayoutSystem
+     */
+    void instantiate(const void *const *items, CHAConstraintDescriptor *descriptors) const
+    {
+        instantiateCompiledRecords(records, Count, items, descriptors);
+    }
+};
+
+constexpr bool isHorizontalAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeLeft || attribute == CHALayoutAttributeRight ||
+           attribute == CHALayoutAttributeLeading || attribute == CHALayoutAttributeTrailing ||
+           attribute == CHALayoutAttributeWidth || attribute == CHALayoutAttributeCenterX;
+}
+
+constexpr bool isVerticalAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeTop || attribute == CHALayoutAttributeBottom ||
+           attribute == CHALayoutAttributeHeight || attribute == CHALayoutAttributeCenterY ||
+           attribute == CHALayoutAttributeBaseline;
+}
+
+constexpr bool isDimensionAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeWidth || attribute == CHALayoutAttributeHeight;
+}
+
+constexpr bool isCenterAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeCenterX || attribute == CHALayoutAttributeCenterY;
+}
+
+constexpr bool isAbsoluteAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeLeft || attribute == CHALayoutAttributeRight;
+}
+
+constexpr bool isDirectionalAttribute(CHALayoutAttribute attribute)
+{
+    return attribute == CHALayoutAttributeLeading || attribute == CHALayoutAttributeTrailing;
+}
+
+/**
+ @return Whether UIKit accepts a constraint between the two attributes: two dimensions, or two positions on the same axis
+ that do not mix left/right with leading/trailing
+ */
+constexpr bool canRelateAttributes(CHALayoutAttribute attribute, CHALayoutAttribute toAttribute)
+{
+    return isDimensionAttribute(attribute) || isDimensionAttribute(toAttribute)
+               ? isDimensionAttribute(attribute) && isDimensionAttribute(toAttribute)
+               : ((isHorizontalAttribute(attribute) && isHorizontalAttribute(toAttribute)) ||
+                  (isVerticalAttribute(attribute) && isVerticalAttribute(toAttribute))) &&
+                     !(isAbsoluteAttribute(attribute) && isDirectionalAttribute(toAttribute)) &&
+                     !(isDirectionalAttribute(attribute) && isAbsoluteAttribute(toAttribute));
+}
+
+constexpr bool isValidRelation(CHALayoutRelation relation)
+{
+    return relation >= CHALayoutRelationLessThanOrEqual && relation <= CHALayoutRelationGreaterThanOrEqual;
+}
+
+/**
+ @description CHASignedConstantForAttribute, folded: a positive inset moves bottom, trailing and right edges inward
+ */
+constexpr double insetConstant(CHALayoutAttribute attribute, double constant)
+{
+    return attribute == CHALayoutAttributeBottom || attribute == CHALayoutAttributeTrailing ||
+                   attribute == CHALayoutAttributeRight
+               ? -constant
+               : constant;
+}
+
+constexpr size_t edgeCount(CHAEdgeMask edges)
+{
+    size_t count = 0;
+    for (; edges != 0; edges &= (CHAEdgeMask)(edges - 1)) count++;
+    return count;
+}
+
+/**
+ @return The number of records appendStackDescriptors makes for a stack of count views
+ */
+constexpr size_t stackRecordCount(CHAStackDistribution distribution, size_t count)
+{
+    return count + (distribution != CHAStackDistributionLeading ? 1 : 0) +
+           (distribution == CHAStackDistributionFillEqually ? count - 1 : 0) + 2 * count;
+}
+
+namespace detail {
+
+constexpr CompiledRecord record(uint32_t item, CHALayoutAttribute attribute, CHALayoutRelation relation, uint32_t toItem,
+                                CHALayoutAttribute toAttribute, double multiplier, double constant)
+{
+    return CompiledRecord{multiplier, constant, CHALayoutPriorityRequired, item, toItem, attribute, toAttribute, relation,
+                          0};
+}
+
+// Slot arrays are padded with an unused slot so that an empty pack still declares an array.
+template <uint32_t... Slots>
+constexpr size_t countOtherThan(uint32_t slot)
+{
+    const uint32_t slots[] = {Slots..., CompiledRecordNoSlot};
+    size_t count = 0;
+    for (size_t index = 0; index < sizeof...(Slots); index++)
+    {
+        if (slots[index] != slot) count++;
+    }
+    return count;
+}
+
+template <uint32_t... Slots>
+constexpr bool contains(uint32_t slot)
+{
+    return countOtherThan<Slots...>(slot) != sizeof...(Slots);
+}
+
+template <uint32_t... Slots>
+constexpr bool allEqual(uint32_t slot)
+{
+    return countOtherThan<Slots...>(slot) == 0;
+}
+
+constexpr Constraints<1> single(const CompiledRecord &record)
+{
+    Constraints<1> constraints{};
+    constraints.records[0] = record;
+    return constraints;
+}
+
+// Every view's dimension equal to the reference's, skipping the reference as equalWidths: does.
+template <CHALayoutAttribute Dimension, size_t Count, uint32_t... Slots>
+constexpr Constraints<Count> equalDimensions(uint32_t reference, double multiplier)
+{
+    const uint32_t slots[] = {Slots..., CompiledRecordNoSlot};
+    Constraints<Count> constraints{};
+    size_t emitted = 0;
+    for (size_t index = 0; index < sizeof...(Slots); index++)
+    {
+        if (slots[index] == reference) continue;
+        constraints.records[emitted++] =
+            record(slots[index], Dimension, CHALayoutRelationEqual, reference, Dimension, multiplier, 0);
+    }
+    return constraints;
+}
+
+template <CHALayoutAttribute Center, uint32_t... Slots>
+constexpr Constraints<sizeof...(Slots)> alignCenters(uint32_t reference)
+{
+    const uint32_t slots[] = {Slots..., CompiledRecordNoSlot};
+    Constraints<sizeof...(Slots)> constraints{};
+    for (size_t index = 0; index < sizeof...(Slots); index++)
+    {
+        constraints.records[index] = record(slots[index], Center, CHALayoutRelationEqual, reference, Center, 1, 0);
+    }
+    return constraints;
+}
+
+template <size_t Count>
+constexpr Constraints<Count> edges(uint32_t item, uint32_t toItem, CHAEdgeMask mask, double constant)
+{
+    // The order of CHADescriptorBatchAppendEdges.
+    const CHAEdgeMask order[] = {CHAEdgeTop, CHAEdgeBottom, CHAEdgeLeading, CHAEdgeTrailing, CHAEdgeLeft, CHAEdgeRight};
+    const CHALayoutAttribute attributes[] = {CHALayoutAttributeTop,     CHALayoutAttributeBottom,
+                                             CHALayoutAttributeLeading, CHALayoutAttributeTrailing,
+                                             CHALayoutAttributeLeft,    CHALayoutAttributeRight};
+    Constraints<Count> constraints{};
+    size_t emitted = 0;
+    for (size_t index = 0; index < 6; index++)
+    {
+        if (!(mask & order[index])) continue;
+        const CHALayoutAttribute attribute = attributes[index];
+        constraints.records[emitted++] = record(item, attribute, CHALayoutRelationEqual, toItem, attribute, 1,
+                                                insetConstant(attribute, constant));
+    }
+    return constraints;
+}
+
+// The records of appendStackDescriptors, in its order.
+template <CHAStackAxis Axis, CHAStackDistribution Distribution, uint32_t... Slots>
+constexpr Constraints<stackRecordCount(Distribution, sizeof...(Slots))> stack(uint32_t container, double spacing,
+                                                                              const Insets &margins)
+{
+    const uint32_t slots[] = {Slots..., CompiledRecordNoSlot};
+    const size_t count = sizeof...(Slots);
+    const bool vertical = Axis == CHAStackAxisVertical;
+    const CHALayoutAttribute start = vertical ? CHALayoutAttributeTop : CHALayoutAttributeLeading;
+    const CHALayoutAttribute end = vertical ? CHALayoutAttributeBottom : CHALayoutAttributeTrailing;
+    const CHALayoutAttribute length = vertical ? CHALayoutAttributeHeight : CHALayoutAttributeWidth;
+    const CHALayoutAttribute crossStart = vertical ? CHALayoutAttributeLeading : CHALayoutAttributeTop;
+    const CHALayoutAttribute crossEnd = vertical ? CHALayoutAttributeTrailing : CHALayoutAttributeBottom;
+    const double leadingMargin = vertical ? margins.top : margins.leading;
+    const double trailingMargin = vertical ? margins.bottom : margins.trailing;
+    const double crossLeadingMargin = vertical ? margins.leading : margins.top;
+    const double crossTrailingMargin = vertical ? margins.trailing : margins.bottom;
+
+    Constraints<stackRecordCount(Distribution, sizeof...(Slots))> constraints{};
+    size_t emitted = 0;
+    constraints.records[emitted++] = record(slots[0], start, CHALayoutRelationEqual, container, start, 1, leadingMargin);
+    for (size_t index = 1; index < count; index++)
+    {
+        constraints.records[emitted++] =
+            record(slots[index], start, CHALayoutRelationEqual, slots[index - 1], end, 1, spacing);
+    }
+    if (Distribution != CHAStackDistributionLeading)
+    {
+        constraints.records[emitted++] =
+            record(slots[count - 1], end, CHALayoutRelationEqual, container, end, 1, -trailingMargin);
+    }
+    for (size_t index = 1; Distribution == CHAStackDistributionFillEqually && index < count; index++)
+    {
+        constraints.records[emitted++] = record(slots[index], length, CHALayoutRelationEqual, slots[0], length, 1, 0);
+    }
+    for (size_t index = 0; index < count; index++)
+    {
+        constraints.records[emitted++] =
+            record(slots[index], crossStart, CHALayoutRelationEqual, container, crossStart, 1, crossLeadingMargin);
+        constraints.records[emitted++] =
+            record(slots[index], crossEnd, CHALayoutRelationEqual, container, crossEnd, 1, -crossTrailingMargin);
+    }
+    return constraints;
+}
+
+}
+
+template <size_t Count, size_t OtherCount>
+constexpr Constraints<Count + OtherCount> operator+(const Constraints<Count> &constraints,
+                                                    const Constraints<OtherCount> &other)
+{
+    Constraints<Count + OtherCount> combined{};
+    for (size_t index = 0; index < Count; index++) combined.records[index] = constraints.records[index];
+    for (size_t index = 0; index < OtherCount; index++) combined.records[Count + index] = other.records[index];
+    return combined;
+}
+
+template <size_t Count>
+constexpr Constraints<Count> layout(const Constraints<Count> &constraints)
+{
+    return constraints;
+}
+
+/**
+ @description Every record of the expressions, in order, as one array
+ */
+template <size_t Count, size_t... Counts>
+constexpr auto layout(const Constraints<Count> &constraints, const Constraints<Counts> &... rest)
+    -> decltype(constraints + layout(rest...))
+{
+    return constraints + layout(rest...);
+}
+
+/**
+ @description The same records at a different priority, as when setting a returned constraint's priority
+ */
+template <size_t Count>
+constexpr Constraints<Count> withPriority(const Constraints<Count> &constraints, float priority)
+{
+    Constraints<Count> prioritized = constraints;
+    for (size_t index = 0; index < Count; index++) prioritized.records[index].priority = priority;
+    return prioritized;
+}
+
+/**
+ @description pin:side:layoutRelation:toView:secondSide:constant:multiplier:, with the constant taken as given
+ */
+template <CHALayoutAttribute Side, CHALayoutAttribute SecondSide = Side, CHALayoutRelation Relation = CHALayoutRelationEqual,
+          uint32_t Slot, uint32_t Superview, uint32_t SecondSlot, uint32_t SecondSuperview>
+constexpr Constraints<1> pin(View<Slot, Superview>, View<SecondSlot, SecondSuperview>, double constant = 0,
+                             double multiplier = 1)
+{
+    static_assert(canRelateAttributes(Side, SecondSide),
+                  "The attributes cannot be related: they must be two dimensions, or two positions on one axis that do "
+                  "not mix left/right with leading/trailing");
+    static_assert(isValidRelation(Relation), "Unknown layout relation");
+    static_assert(Slot != SecondSlot || Side != SecondSide, "An attribute cannot be constrained to itself");
+    return detail::single(detail::record(Slot, Side, Relation, SecondSlot, SecondSide, multiplier, constant));
+}
+
+/**
+ @description pinSide:constant:, relating a side to the same side of the superview with the constant taken as given
+ */
+template <CHALayoutAttribute Side, CHALayoutRelation Relation = CHALayoutRelationEqual, uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> pinSide(View<Slot, Superview> view, double constant = 0)
+{
+    static_assert(Superview != CompiledRecordNoSlot, "The container has no superview to pin to");
+    static_assert(!isDimensionAttribute(Side), "Use equalWidth or equalHeight to relate a dimension to the superview");
+    return pin<Side, Side, Relation>(view, View<Superview, CompiledRecordNoSlot>(), constant);
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> pinLeading(View<Slot, Superview> view, double constant = 0)
+{
+    return pinSide<CHALayoutAttributeLeading>(view, insetConstant(CHALayoutAttributeLeading, constant));
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> pinTrailing(View<Slot, Superview> view, double constant = 0)
+{
+    return pinSide<CHALayoutAttributeTrailing>(view, insetConstant(CHALayoutAttributeTrailing, constant));
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<2> pinLeadingTrailing(View<Slot, Superview> view, double constant = 0)
+{
+    return pinLeading(view, constant) + pinTrailing(view, constant);
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> pinToTopSuperview(View<Slot, Superview> view, double constant = 0)
+{
+    return pinSide<CHALayoutAttributeTop>(view, insetConstant(CHALayoutAttributeTop, constant));
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> pinToBottomSuperview(View<Slot, Superview> view, double constant = 0)
+{
+    return pinSide<CHALayoutAttributeBottom>(view, insetConstant(CHALayoutAttributeBottom, constant));
+}
+
+/**
+ @description pinEdges:constant:, one record per edge in the order of CHADescriptorBatchAppendEdges
+ */
+template <CHAEdgeMask Edges, uint32_t Slot, uint32_t Superview>
+constexpr Constraints<edgeCount(Edges)> pinEdges(View<Slot, Superview>, double constant = 0)
+{
+    static_assert(Superview != CompiledRecordNoSlot, "The container has no superview to pin to");
+    static_assert(Edges != 0, "No edges provided. Please provide one or more edges");
+    static_assert((Edges & ~(CHAEdgeAll | CHAEdgeLeft | CHAEdgeRight)) == 0, "Unknown edge in the mask");
+    static_assert(!((Edges & (CHAEdgeLeading | CHAEdgeTrailing)) && (Edges & (CHAEdgeLeft | CHAEdgeRight))),
+                  "Left and right edges cannot be mixed with leading and trailing ones");
+    return detail::edges<edgeCount(Edges)>(Slot, Superview, Edges, constant);
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<4> pinToSuperviewBounds(View<Slot, Superview> view, double constant = 0)
+{
+    return pinEdges<CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeft | CHAEdgeRight>(view, constant);
+}
+
+/**
+ @description alignCenter:views:referenceView:. Where the helper returns nil for a view aligned to itself, this does not
+ compile.
+ */
+template <CHALayoutAttribute Center, uint32_t... Slots, uint32_t... Superviews, uint32_t Reference,
+          uint32_t ReferenceSuperview>
+constexpr Constraints<sizeof...(Slots)> alignCenter(ViewList<View<Slots, Superviews>...>,
+                                                    View<Reference, ReferenceSuperview>)
+{
+    static_assert(isCenterAttribute(Center), "Only centerX and centerY can be aligned");
+    static_assert(sizeof...(Slots) > 0, "No views provided for center alignment.");
+    static_assert(!detail::contains<Slots...>(Reference), "A view cannot be center-aligned to itself");
+    return detail::alignCenters<Center, Slots...>(Reference);
+}
+
+template <typename... Views, uint32_t Reference, uint32_t ReferenceSuperview>
+constexpr Constraints<sizeof...(Views)> alignCenterHorizontal(ViewList<Views...> views,
+                                                              View<Reference, ReferenceSuperview> reference)
+{
+    return alignCenter<CHALayoutAttributeCenterX>(views, reference);
+}
+
+template <typename... Views, uint32_t Reference, uint32_t ReferenceSuperview>
+constexpr Constraints<sizeof...(Views)> alignCenterVertical(ViewList<Views...> views,
+                                                            View<Reference, ReferenceSuperview> reference)
+{
+    return alignCenter<CHALayoutAttributeCenterY>(views, reference);
+}
+
+template <CHALayoutRelation Relation = CHALayoutRelationEqual, uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> width(View<Slot, Superview>, double constant)
+{
+    static_assert(isValidRelation(Relation), "Unknown layout relation");
+    return detail::single(detail::record(Slot, CHALayoutAttributeWidth, Relation, CompiledRecordNoSlot,
+                                         CHALayoutAttributeNotAnAttribute, 1, constant));
+}
+
+template <CHALayoutRelation Relation = CHALayoutRelationEqual, uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> height(View<Slot, Superview>, double constant)
+{
+    static_assert(isValidRelation(Relation), "Unknown layout relation");
+    return detail::single(detail::record(Slot, CHALayoutAttributeHeight, Relation, CompiledRecordNoSlot,
+                                         CHALayoutAttributeNotAnAttribute, 1, constant));
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> equalWidth(View<Slot, Superview> view, double multiplier = 1)
+{
+    static_assert(Superview != CompiledRecordNoSlot, "The container has no superview to match");
+    return pin<CHALayoutAttributeWidth>(view, View<Superview, CompiledRecordNoSlot>(), 0, multiplier);
+}
+
+template <uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> equalHeight(View<Slot, Superview> view, double multiplier = 1)
+{
+    static_assert(Superview != CompiledRecordNoSlot, "The container has no superview to match");
+    return pin<CHALayoutAttributeHeight>(view, View<Superview, CompiledRecordNoSlot>(), 0, multiplier);
+}
+
+template <uint32_t Slot, uint32_t Superview, uint32_t SecondSlot, uint32_t SecondSuperview>
+constexpr Constraints<1> equalWidthToView(View<Slot, Superview> view, View<SecondSlot, SecondSuperview> secondView,
+                                          double multiplier = 1)
+{
+    return pin<CHALayoutAttributeWidth>(view, secondView, 0, multiplier);
+}
+
+template <uint32_t Slot, uint32_t Superview, uint32_t SecondSlot, uint32_t SecondSuperview>
+constexpr Constraints<1> equalHeightToView(View<Slot, Superview> view, View<SecondSlot, SecondSuperview> secondView,
+                                           double multiplier = 1)
+{
+    return pin<CHALayoutAttributeHeight>(view, secondView, 0, multiplier);
+}
+
+/**
+ @description equalWidths:referenceView:multiplier:. The reference is skipped if it is among the views, as in the helper,
+ and the record count reflects that.
+ */
+template <uint32_t Reference, uint32_t ReferenceSuperview, uint32_t... Slots, uint32_t... Superviews>
+constexpr Constraints<detail::countOtherThan<Slots...>(Reference)>
+equalWidths(View<Reference, ReferenceSuperview>, ViewList<View<Slots, Superviews>...>, double multiplier = 1)
+{
+    static_assert(sizeof...(Slots) > 0, "No views provided to create equal width constraints.");
+    return detail::equalDimensions<CHALayoutAttributeWidth, detail::countOtherThan<Slots...>(Reference), Slots...>(
+        Reference, multiplier);
+}
+
+template <uint32_t Reference, uint32_t ReferenceSuperview, uint32_t... Slots, uint32_t... Superviews>
+constexpr Constraints<detail::countOtherThan<Slots...>(Reference)>
+equalHeights(View<Reference, ReferenceSuperview>, ViewList<View<Slots, Superviews>...>, double multiplier = 1)
+{
+    static_assert(sizeof...(Slots) > 0, "No views provided to create equal height constraints.");
+    return detail::equalDimensions<CHALayoutAttributeHeight, detail::countOtherThan<Slots...>(Reference), Slots...>(
+        Reference, multiplier);
+}
+
+/**
+ @description aspectRatio: with a ratio of Width / Height: the view's height is its width * Height / Width
+ */
+template <unsigned Width, unsigned Height, uint32_t Slot, uint32_t Superview>
+constexpr Constraints<1> aspectRatio(View<Slot, Superview>)
+{
+    static_assert(Width > 0 && Height > 0, "A declared ratio needs a positive width and height.");
+    return detail::single(detail::record(Slot, CHALayoutAttributeHeight, CHALayoutRelationEqual, Slot,
+                                         CHALayoutAttributeWidth, (double)Height / Width, 0));
+}
+
+/**
+ @description stackAboveView:superviewMargin:interViewSpacing:, each view pinned to its own superview
+ */
+template <uint32_t Slot, uint32_t Superview, uint32_t BottomSlot, uint32_t BottomSuperview>
+constexpr Constraints<7> stackAboveView(View<Slot, Superview> view, View<BottomSlot, BottomSuperview> bottomView,
+                                        double superviewMargin = 0, double interViewSpacing = 0)
+{
+    static_assert(Slot != BottomSlot, "A view cannot be stacked above itself");
+    return pinEdges<CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing>(view, superviewMargin) +
+           pinEdges<CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing>(bottomView, superviewMargin) +
+           pin<CHALayoutAttributeBottom, CHALayoutAttributeTop>(view, bottomView, interViewSpacing);
+}
+
+/**
+ @description stackViews:axis:spacing:margins:distribution:, the same records as appendStackDescriptors
+ @discussion Every view must be a subview of the stacking view. Proportional stacks weigh views by intrinsic content size,
+ which is only known at runtime, so they are left to the helper.
+ */
+template <CHAStackAxis Axis, CHAStackDistribution Distribution = CHAStackDistributionFill, uint32_t StackSlot,
+          uint32_t StackSuperview, uint32_t... Slots, uint32_t... Superviews>
+constexpr Constraints<stackRecordCount(Distribution, sizeof...(Slots))>
+stackViews(View<StackSlot, StackSuperview>, ViewList<View<Slots, Superviews>...>, double spacing,
+           const Insets &margins = Insets{0, 0, 0, 0})
+{
+    static_assert(Axis == CHAStackAxisHorizontal || Axis == CHAStackAxisVertical, "Unknown stack axis");
+    static_assert(Distribution >= CHAStackDistributionLeading && Distribution <= CHAStackDistributionFillEqually,
+                  "Proportional stacks need intrinsic content sizes; use stackViews:axis:spacing:margins:distribution:");
+    static_assert(sizeof...(Slots) > 0, "No views found. Please provide one or more views to stack");
+    static_assert(detail::allEqual<Superviews...>(StackSlot), "Stacked views must be subviews of the receiving view.");
+    return detail::stack<Axis, Distribution, Slots...>(StackSlot, spacing, margins);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,50 @@
+//
+//  CHALayoutPass.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHALayoutPass.h"
+
+namespace cha {
+
+LayoutPass::LayoutPass(DescriptorBlockPool &pool, size_t arenaChunkSize)
+: arena_(arenaChunkSize),
+  descriptors_(pool),
+  system_(&arena_),
+  added_(0),
+  status_(Solver::StatusOK)
+{
+}
+
+void LayoutPass::begin(Item container, double width, double height)
+{
+    system_.reset();
+    arena_.reset();
+    descriptors_.clear();
+    added_ = 0;
+    status_ = Solver::StatusOK;
+    system_.setContainer(container, width, height);
+}
+
+Solver::Status LayoutPass::solve()
+{
+    size_t index = 0;
+    for (const DescriptorBlock *block = descriptors_.firstBlock(); block; block = block->next)
+    {
+        if (index + block->count > added_)
+        {
+            size_t skip = added_ > index ? added_ - index : 0;
+            Solver::Status status = system_.addDescriptors(block->records + skip, block->count - skip);
+            if (status_ == Solver::StatusOK) status_ = status;
+        }
+        index += block->count;
+    }
+    added_ = index;
+
+    system_.solve();
+    return status_;
+}
+
+}
@@ -0,0 +1,65 @@
+//
+//  CHALayoutPass.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutPass_h
+#define CHAAutolayoutCategories_CHALayoutPass_h
+
+#include <cstddef>
+
+#include "CHAConstraintDescriptor.h"
+#include "CHALayoutArena.h"
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+/**
+ @description Builds and solves a screen, then does it again without touching the heap.
+ @discussion Records are collected into pooled descriptor blocks and solved by a layout system whose storage comes from a
+ bump arena. begin() ends the previous pass: the system is emptied, the arena rewound and the blocks returned to the pool.
+ Once a pass has run at the size of the largest screen it builds, later passes reuse the same memory. Not thread-safe; use
+ one pass per thread.
+ */
+class LayoutPass
+{
+public:
+    typedef LayoutSystem::Item Item;
+
+    explicit LayoutPass(DescriptorBlockPool &pool = DescriptorBlockPool::shared(),
+                        size_t arenaChunkSize = LayoutArena::kDefaultChunkSize);
+
+    /**
+     @description Start a pass over a container; negative dimensions are left to the constraints
+     */
+    void begin(Item container, double width, double height);
+
+    void append(const CHAConstraintDescriptor &record) { descriptors_.append(record); }
+    void append(const CHAConstraintDescriptor *records, size_t count) { descriptors_.append(records, count); }
+    void appendBatch(const CHADescriptorBatch &batch) { descriptors_.append(batch.records, batch.count); }
+
+    /**
+     @description Add the records appended since the last solve and solve the system
+     @return StatusOK, or the first failure in this pass
+     */
+    Solver::Status solve();
+
+    Frame frame(Item item) const { return system_.frame(item); }
+
+    size_t descriptorCount() const { return descriptors_.count(); }
+    LayoutSystem &system() { return system_; }
+    const LayoutArena &arena() const { return arena_; }
+
+private:
+    LayoutArena arena_;
+    DescriptorList descriptors_;
+    LayoutSystem system_;
+    size_t added_;
+    Solver::Status status_;
+};
+
+}
+
+#endif
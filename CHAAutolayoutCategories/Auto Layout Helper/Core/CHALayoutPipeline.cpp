@@ -0,0 +1,69 @@
+//
+//  CHALayoutPipeline.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHALayoutPipeline.h"
+
+#include <utility>
+
+namespace cha {
+
+LayoutPipeline::LayoutPipeline(size_t cacheCapacity, size_t threadCount)
+: cache_(cacheCapacity),
+  solves_(0),
+  workers_(threadCount)
+{
+}
+
+FrameCacheKey LayoutPipeline::keyFor(const LayoutTemplate &layoutTemplate, const LayoutRequest &request)
+{
+    FrameCacheKey key = {layoutTemplate.identifier(), request.width, request.height, request.contentHash};
+    return key;
+}
+
+bool LayoutPipeline::enqueue(const Template &layoutTemplate, const LayoutRequest &request)
+{
+    const FrameCacheKey key = keyFor(*layoutTemplate, request);
+    if (cache_.find(key)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex_);
+        if (!inFlight_.insert(key).second) return false;
+    }
+
+    workers_.submit([this, layoutTemplate, request, key] {
+        solve(*layoutTemplate, request);
+
+        std::lock_guard<std::mutex> lock(inFlightMutex_);
+        inFlight_.erase(key);
+    });
+    return true;
+}
+
+FrameCache::Frames LayoutPipeline::framesFor(const LayoutTemplate &layoutTemplate, const LayoutRequest &request)
+{
+    return cache_.find(keyFor(layoutTemplate, request));
+}
+
+FrameCache::Frames LayoutPipeline::solveSynchronously(const LayoutTemplate &layoutTemplate, const LayoutRequest &request)
+{
+    FrameCache::Frames frames = cache_.find(keyFor(layoutTemplate, request));
+    return frames ? frames : solve(layoutTemplate, request);
+}
+
+FrameCache::Frames LayoutPipeline::solve(const LayoutTemplate &layoutTemplate, const LayoutRequest &request)
+{
+    std::shared_ptr<std::vector<Frame>> frames = std::make_shared<std::vector<Frame>>();
+    const Solver::Status status = layoutTemplate.solve(request, *frames);
+    solves_.fetch_add(1, std::memory_order_relaxed);
+
+    // The frames of a rejected solve are still returned, but not kept for later requests.
+    FrameCache::Frames shared = std::move(frames);
+    if (status == Solver::StatusOK) cache_.insert(keyFor(layoutTemplate, request), shared);
+    return shared;
+}
+
+}
@@ -0,0 +1,75 @@
+//
+//  CHALayoutPipeline.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutPipeline_h
+#define CHAAutolayoutCategories_CHALayoutPipeline_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "CHAFrameCache.h"
+#include "CHALayoutTemplate.h"
+#include "CHAWorkerPool.h"
+
+namespace cha {
+
+/**
+ @description Solves layout templates on background workers and caches the resulting frames.
+ @discussion enqueue() is cheap to call from the main thread, e.g. while prefetching table cells: a request that is already
+ cached or already being solved is dropped. framesFor() never blocks on a solve.
+ */
+class LayoutPipeline
+{
+public:
+    typedef std::shared_ptr<const LayoutTemplate> Template;
+
+    LayoutPipeline(size_t cacheCapacity, size_t threadCount = 0);
+
+    /**
+     @description Schedule a background solve unless the frames are cached or already in flight
+     @return true if a solve was scheduled
+     */
+    bool enqueue(const Template &layoutTemplate, const LayoutRequest &request);
+
+    /**
+     @description The cached frames for a request, or null if they have not been solved yet
+     */
+    FrameCache::Frames framesFor(const LayoutTemplate &layoutTemplate, const LayoutRequest &request);
+
+    /**
+     @description Solve on the calling thread, reusing and filling the cache. Use when a frame is needed right now.
+     @discussion Only solves that succeed are cached, so a request the solver rejects is solved again each time.
+     */
+    FrameCache::Frames solveSynchronously(const LayoutTemplate &layoutTemplate, const LayoutRequest &request);
+
+    /**
+     @description Block until every scheduled solve has been cached
+     */
+    void waitUntilIdle() { workers_.waitUntilIdle(); }
+
+    FrameCache &cache() { return cache_; }
+    uint64_t solveCount() const { return solves_.load(std::memory_order_relaxed); }
+
+private:
+    static FrameCacheKey keyFor(const LayoutTemplate &layoutTemplate, const LayoutRequest &request);
+    FrameCache::Frames solve(const LayoutTemplate &layoutTemplate, const LayoutRequest &request);
+
+    FrameCache cache_;
+    std::mutex inFlightMutex_;
+    std::unordered_set<FrameCacheKey, FrameCacheKeyHash> inFlight_;
+    std::atomic<uint64_t> solves_;
+    // Declared last so workers are joined before the state they use is destroyed.
+    WorkerPool workers_;
+};
+
+}
+
+#endif
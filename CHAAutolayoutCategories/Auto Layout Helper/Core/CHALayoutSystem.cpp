@@ -0,0 +1,283 @@
+//
+//  CHALayoutSystem.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+namespace {
+
+const double kContainerStrength = 999.0 * Strength::strong;
+
+}
+
+LayoutSystem::LayoutSystem(LayoutArena *arena)
+: arena_(arena),
+  solver_(arena),
+  items_(ItemMap::allocator_type(arena)),
+  container_(nullptr),
+  widthDriven_(false),
+  heightDriven_(false),
+  unresolvedRatios_(0),
+  ratioResolutions_(0)
+{
+}
+
+void LayoutSystem::reset()
+{
+    // A fresh table rather than clear(), which would keep a bucket array the arena is about to reuse.
+    items_ = ItemMap(ItemMap::allocator_type(arena_));
+    solver_.reset();
+    container_ = nullptr;
+    widthDriven_ = false;
+    heightDriven_ = false;
+    ratios_.clear();
+    intrinsicSizes_.clear();
+    unresolvedRatios_ = 0;
+}
+
+void LayoutSystem::setContainer(Item container, double width, double height)
+{
+    const ItemVariables &variables = variablesFor(container);
+
+    if (container_ != container)
+    {
+        container_ = container;
+
+        Solver::Term minX = {variables.minX, 1.0};
+        Solver::Term minY = {variables.minY, 1.0};
+        solver_.addConstraint(&minX, 1, 0.0, CHALayoutRelationEqual, Strength::required, nullptr);
+        solver_.addConstraint(&minY, 1, 0.0, CHALayoutRelationEqual, Strength::required, nullptr);
+    }
+
+    driveContainerDimension(variables.width, width, widthDriven_);
+    driveContainerDimension(variables.height, height, heightDriven_);
+}
+
+void LayoutSystem::driveContainerDimension(Solver::Variable variable, double value, bool &driven)
+{
+    if (value < 0.0) return;
+
+    if (!driven)
+    {
+        solver_.addEditVariable(variable, kContainerStrength);
+        driven = true;
+    }
+    solver_.suggestValue(variable, value);
+}
+
+Solver::Status LayoutSystem::addDescriptor(const CHAConstraintDescriptor &descriptor, Solver::Constraint *constraint)
+{
+    // item.attribute - multiplier * toItem.toAttribute - constant (relation) 0
+    Solver::Term terms[4];
+    size_t termCount = termsForAttribute(descriptor.item, descriptor.attribute, 1.0, terms);
+
+    if (descriptor.toItem && descriptor.toAttribute != CHALayoutAttributeNotAnAttribute)
+    {
+        termCount += termsForAttribute(descriptor.toItem, descriptor.toAttribute, -descriptor.multiplier, terms + termCount);
+    }
+
+    return solver_.addConstraint(terms,
+                                 termCount,
+                                 -descriptor.constant,
+                                 descriptor.relation,
+                                 Strength::forPriority(descriptor.priority),
+                                 constraint);
+}
+
+Solver::Status LayoutSystem::addDescriptors(const CHAConstraintDescriptor *descriptors, size_t count)
+{
+    Solver::Status result = Solver::StatusOK;
+    for (size_t i = 0; i < count; i++)
+    {
+        Solver::Status status = addDescriptor(descriptors[i]);
+        if (result == Solver::StatusOK) result = status;
+    }
+    return result;
+}
+
+Solver::Status LayoutSystem::setConstant(Solver::Constraint constraint, double constant)
+{
+    return solver_.setConstant(constraint, -constant);
+}
+
+Solver::Status LayoutSystem::setConstants(const Solver::Constraint *constraints, const double *constants, size_t count)
+{
+    solverConstants_.resize(count);
+    for (size_t i = 0; i < count; i++) solverConstants_[i] = -constants[i];
+    return solver_.setConstants(constraints, solverConstants_.data(), count);
+}
+
+LayoutSystem::AspectRatio LayoutSystem::addAspectRatio(Item item, const RatioSpec &spec, float priority)
+{
+    ratios_.push_back(LazyRatio{item, spec, priority, RatioStatusPending, false, 0.0, 0});
+    unresolvedRatios_++;
+    return (AspectRatio)(ratios_.size() - 1);
+}
+
+void LayoutSystem::setIntrinsicSize(Item item, double width, double height)
+{
+    intrinsicSizes_[item] = std::make_pair(width, height);
+}
+
+void LayoutSystem::invalidateAspectRatios(Item item)
+{
+    for (LazyRatio &ratio : ratios_)
+    {
+        if (ratio.item != item || ratio.status == RatioStatusPending) continue;
+
+        if (ratio.installed) solver_.removeConstraint(ratio.constraint);
+        ratio.installed = false;
+        ratio.status = RatioStatusPending;
+        unresolvedRatios_++;
+    }
+}
+
+RatioStatus LayoutSystem::aspectRatioStatus(AspectRatio ratio, double *multiplier) const
+{
+    if (ratio >= ratios_.size()) return RatioStatusInvalid;
+
+    const LazyRatio &lazyRatio = ratios_[ratio];
+    if (lazyRatio.status == RatioStatusResolved && multiplier) *multiplier = lazyRatio.multiplier;
+    return lazyRatio.status;
+}
+
+void LayoutSystem::resolveAspectRatios()
+{
+    for (LazyRatio &ratio : ratios_)
+    {
+        if (ratio.status != RatioStatusPending) continue;
+
+        double intrinsicWidth = -1, intrinsicHeight = -1;
+        auto intrinsic = intrinsicSizes_.find(ratio.item);
+        if (intrinsic != intrinsicSizes_.end())
+        {
+            intrinsicWidth = intrinsic->second.first;
+            intrinsicHeight = intrinsic->second.second;
+        }
+
+        ratio.status = resolveRatio(ratio.spec, intrinsicWidth, intrinsicHeight, &ratio.multiplier);
+        if (ratio.status == RatioStatusPending) continue;
+
+        unresolvedRatios_--;
+        if (ratio.status != RatioStatusResolved) continue;
+
+        ratioResolutions_++;
+        CHAConstraintDescriptor descriptor = {ratio.item, ratio.item, ratio.multiplier, 0.0, ratio.priority,
+                                              CHALayoutAttributeHeight, CHALayoutAttributeWidth, CHALayoutRelationEqual, 0};
+        ratio.installed = addDescriptor(descriptor, &ratio.constraint) == Solver::StatusOK;
+    }
+}
+
+void LayoutSystem::solve()
+{
+    if (unresolvedRatios_ > 0) resolveAspectRatios();
+    solver_.updateVariables();
+}
+
+Frame LayoutSystem::frame(Item item) const
+{
+    auto found = items_.find(item);
+    if (found == items_.end()) return Frame{0, 0, 0, 0};
+
+    const ItemVariables &variables = found->second;
+    return Frame{solver_.value(variables.minX),
+                 solver_.value(variables.minY),
+                 solver_.value(variables.width),
+                 solver_.value(variables.height)};
+}
+
+Frame LayoutSystem::currentFrame(Item item) const
+{
+    auto found = items_.find(item);
+    if (found == items_.end()) return Frame{0, 0, 0, 0};
+
+    const ItemVariables &variables = found->second;
+    return Frame{solver_.currentValue(variables.minX),
+                 solver_.currentValue(variables.minY),
+                 solver_.currentValue(variables.width),
+                 solver_.currentValue(variables.height)};
+}
+
+Solver::Status LayoutSystem::pinFrame(Item item, const Frame &frame)
+{
+    const ItemVariables &variables = variablesFor(item);
+    const Solver::Variable edges[] = {variables.minX, variables.minY, variables.width, variables.height};
+    const double values[] = {frame.x, frame.y, frame.width, frame.height};
+
+    Solver::Status result = Solver::StatusOK;
+    for (size_t edge = 0; edge < 4; edge++)
+    {
+        Solver::Term term = {edges[edge], 1.0};
+        Solver::Status status = solver_.addConstraint(&term, 1, -values[edge], CHALayoutRelationEqual, Strength::required, nullptr);
+        if (result == Solver::StatusOK) result = status;
+    }
+    return result;
+}
+
+bool LayoutSystem::isFrameDetermined(Item item) const
+{
+    auto found = items_.find(item);
+    if (found == items_.end()) return false;
+
+    const ItemVariables &variables = found->second;
+    return solver_.isDetermined(variables.minX) && solver_.isDetermined(variables.minY) &&
+           solver_.isDetermined(variables.width) && solver_.isDetermined(variables.height);
+}
+
+size_t LayoutSystem::termsForAttribute(Item item, CHALayoutAttribute attribute, double coefficient, Solver::Term *terms)
+{
+    const ItemVariables &variables = variablesFor(item);
+
+    switch (attribute)
+    {
+        case CHALayoutAttributeLeft:
+        case CHALayoutAttributeLeading:
+            terms[0] = Solver::Term{variables.minX, coefficient};
+            return 1;
+        case CHALayoutAttributeRight:
+        case CHALayoutAttributeTrailing:
+            terms[0] = Solver::Term{variables.minX, coefficient};
+            terms[1] = Solver::Term{variables.width, coefficient};
+            return 2;
+        case CHALayoutAttributeTop:
+            terms[0] = Solver::Term{variables.minY, coefficient};
+            return 1;
+        case CHALayoutAttributeBottom:
+        case CHALayoutAttributeBaseline:
+            terms[0] = Solver::Term{variables.minY, coefficient};
+            terms[1] = Solver::Term{variables.height, coefficient};
+            return 2;
+        case CHALayoutAttributeWidth:
+            terms[0] = Solver::Term{variables.width, coefficient};
+            return 1;
+        case CHALayoutAttributeHeight:
+            terms[0] = Solver::Term{variables.height, coefficient};
+            return 1;
+        case CHALayoutAttributeCenterX:
+            terms[0] = Solver::Term{variables.minX, coefficient};
+            terms[1] = Solver::Term{variables.width, 0.5 * coefficient};
+            return 2;
+        case CHALayoutAttributeCenterY:
+            terms[0] = Solver::Term{variables.minY, coefficient};
+            terms[1] = Solver::Term{variables.height, 0.5 * coefficient};
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+const LayoutSystem::ItemVariables &LayoutSystem::variablesFor(Item item)
+{
+    auto found = items_.find(item);
+    if (found != items_.end()) return found->second;
+
+    ItemVariables variables = {solver_.addVariable(), solver_.addVariable(), solver_.addVariable(), solver_.addVariable()};
+    return items_.emplace(item, variables).first->second;
+}
+
+}
@@ -0,0 +1,193 @@
+//
+//  CHALayoutSystem.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutSystem_h
+#define CHAAutolayoutCategories_CHALayoutSystem_h
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "CHAAspectRatio.h"
+#include "CHAConstraintDescriptor.h"
+#include "CHASimplexSolver.h"
+
+namespace cha {
+
+/**
+ @description A frame in the coordinate space of the layout's container
+ */
+struct Frame
+{
+    double x;
+    double y;
+    double width;
+    double height;
+};
+
+/**
+ @description Evaluates the constraint descriptors produced by the helpers without UIKit.
+ @discussion Each item gets four solver variables (minX, minY, width, height). Leading and trailing resolve left-to-right.
+ The container is held at the origin and its size is driven through edit variables, so resizing it re-solves incrementally.
+ Given an arena, the item table and the solver's storage are allocated from it; see LayoutPass.
+ */
+class LayoutSystem
+{
+public:
+    typedef const void *Item;
+
+    /**
+     @param arena Backs the item table and the solver until reset() or destruction; may be null for the heap
+     */
+    explicit LayoutSystem(LayoutArena *arena = nullptr);
+
+    /**
+     @description Drop every item and constraint, including the container. Reset the arena, if any, only after this.
+     */
+    void reset();
+
+    /**
+     @description Set the item every frame is measured against and its size
+     @discussion Pass a negative dimension to leave it to the constraints, e.g. a self-sizing cell whose height follows its
+     content. A dimension that was once driven cannot be released again.
+     */
+    void setContainer(Item container, double width, double height);
+    Item container() const { return container_; }
+
+    /**
+     @description Add a descriptor record as a solver constraint. Priorities below CHALayoutPriorityRequired become optional
+     constraints of proportional strength.
+     @param constraint Receives the solver identifier of the constraint; may be null
+     */
+    Solver::Status addDescriptor(const CHAConstraintDescriptor &descriptor, Solver::Constraint *constraint = nullptr);
+    /**
+     @description Add every record in order
+     @return StatusOK, or the first failure; records after a failure are still added
+     */
+    Solver::Status addDescriptors(const CHAConstraintDescriptor *descriptors, size_t count);
+    Solver::Status addBatch(const CHADescriptorBatch &batch) { return addDescriptors(batch.records, batch.count); }
+    Solver::Status removeConstraint(Solver::Constraint constraint) { return solver_.removeConstraint(constraint); }
+
+    /**
+     @description Change the constant of a record added with addDescriptor, as setting NSLayoutConstraint.constant does.
+     @discussion The constraint keeps its rows and only those rows are re-optimized, so animating a margin costs the same
+     however many other constraints the system holds. Read the result with currentFrame(), or solve() and frame().
+     @return StatusOK, or StatusUnsatisfiable with the constant left unchanged; see Solver::setConstant
+     */
+    Solver::Status setConstant(Solver::Constraint constraint, double constant);
+    /**
+     @description Change several records' constants and re-optimize once, e.g. every margin an animation frame moves
+     */
+    Solver::Status setConstants(const Solver::Constraint *constraints, const double *constants, size_t count);
+
+    typedef uint32_t AspectRatio;
+
+    /**
+     @description Hold an item's height to a ratio of its width. The multiplier is resolved at the next solve() and kept
+     from then on; a ratio whose source has no size yet is retried at every solve until it has one.
+     */
+    AspectRatio addAspectRatio(Item item, const RatioSpec &spec, float priority = CHALayoutPriorityRequired);
+    /**
+     @description The size ratios from RatioSourceIntrinsicSize resolve against. Does not affect ratios already resolved.
+     */
+    void setIntrinsicSize(Item item, double width, double height);
+    /**
+     @description Resolve an item's ratios again at the next solve(), e.g. after its content changed
+     */
+    void invalidateAspectRatios(Item item);
+    /**
+     @param multiplier Receives the cached multiplier once resolved
+     @return The ratio's state as of the last solve()
+     */
+    RatioStatus aspectRatioStatus(AspectRatio ratio, double *multiplier) const;
+    /**
+     @description How many times a ratio has been resolved
+     */
+    uint64_t ratioResolutionCount() const { return ratioResolutions_; }
+
+    /**
+     @description Copy the current solution out of the solver. Call after adding constraints or resizing the container.
+     */
+    void solve();
+
+    /**
+     @description The solved frame for an item, or a zero frame for an item no constraint mentions
+     */
+    Frame frame(Item item) const;
+    /**
+     @description The item's frame in the current solution, read from the solver without a solve(). Suited to reading a
+     few frames after each setConstants(); frame() is cheaper when reading many after one solve().
+     */
+    Frame currentFrame(Item item) const;
+
+    /**
+     @description Hold an item at a known frame with required constraints, e.g. a view already solved in another partition
+     */
+    Solver::Status pinFrame(Item item, const Frame &frame);
+    /**
+     @description Whether required equalities alone fix every edge of the item's frame as of the last solve(); see
+     Solver::isDetermined
+     */
+    bool isFrameDetermined(Item item) const;
+
+    /**
+     @description The solver variable for an item's attribute expression, creating the item's variables when needed.
+     Leading/Left map to minX, Width to width, and so on; compound attributes such as CenterX expand into several terms.
+     @return The number of terms written to terms (at most 2)
+     */
+    size_t termsForAttribute(Item item, CHALayoutAttribute attribute, double coefficient, Solver::Term *terms);
+
+    size_t itemCount() const { return items_.size(); }
+    Solver &solver() { return solver_; }
+    const Solver &solver() const { return solver_; }
+
+private:
+    struct ItemVariables
+    {
+        Solver::Variable minX;
+        Solver::Variable minY;
+        Solver::Variable width;
+        Solver::Variable height;
+    };
+
+    const ItemVariables &variablesFor(Item item);
+
+    struct LazyRatio
+    {
+        Item item;
+        RatioSpec spec;
+        float priority;
+        RatioStatus status;
+        bool installed;
+        double multiplier;
+        Solver::Constraint constraint;
+    };
+
+    void driveContainerDimension(Solver::Variable variable, double value, bool &driven);
+    void resolveAspectRatios();
+
+    typedef std::unordered_map<Item, ItemVariables, std::hash<Item>, std::equal_to<Item>,
+                               ArenaAllocator<std::pair<const Item, ItemVariables>>>
+        ItemMap;
+
+    LayoutArena *arena_;
+    Solver solver_;
+    ItemMap items_;
+    Item container_;
+    bool widthDriven_;
+    bool heightDriven_;
+
+    std::vector<double> solverConstants_;
+    std::vector<LazyRatio> ratios_;
+    std::unordered_map<Item, std::pair<double, double>> intrinsicSizes_;
+    size_t unresolvedRatios_;
+    uint64_t ratioResolutions_;
+};
+
+}
+
+#endif
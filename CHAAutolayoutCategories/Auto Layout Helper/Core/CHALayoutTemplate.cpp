@@ -0,0 +1,84 @@
+//
+//  CHALayoutTemplate.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHALayoutTemplate.h"
+
+#include "CHAStackLayout.h"
+
+namespace cha {
+
+namespace {
+
+// Content sizes behave like intrinsic content size: strong enough to beat defaults, weaker than required constraints.
+const float kContentPriority = 750.f;
+
+}
+
+LayoutTemplate::LayoutTemplate(uint64_t identifier, uint32_t slotCount)
+: identifier_(identifier),
+  slotCount_(slotCount)
+{
+}
+
+void LayoutTemplate::addDescriptor(const CHAConstraintDescriptor &descriptor)
+{
+    descriptors_.push_back(descriptor);
+}
+
+void LayoutTemplate::addBatch(const CHADescriptorBatch &batch)
+{
+    descriptors_.insert(descriptors_.end(), batch.records, batch.records + batch.count);
+}
+
+Solver::Status LayoutTemplate::solve(const LayoutRequest &request, std::vector<Frame> &frames) const
+{
+    if (request.contentSizes.empty() && solveAsStack(request, frames)) return Solver::StatusOK;
+
+    LayoutSystem layout;
+    layout.setContainer(slotHandle(0), request.width, request.height);
+    Solver::Status status = layout.addDescriptors(descriptors_.data(), descriptors_.size());
+
+    for (const ContentSize &content : request.contentSizes)
+    {
+        const CHALayoutAttribute attributes[] = { CHALayoutAttributeWidth, CHALayoutAttributeHeight };
+        const double values[] = { content.width, content.height };
+        for (int i = 0; i < 2; i++)
+        {
+            if (values[i] <= 0) continue;
+
+            CHAConstraintDescriptor descriptor = {slotHandle(content.slot), nullptr, 1.0, values[i], kContentPriority,
+                                                  attributes[i], CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0};
+            layout.addDescriptor(descriptor);
+        }
+    }
+
+    layout.solve();
+
+    frames.resize(slotCount_);
+    for (uint32_t slot = 0; slot < slotCount_; slot++) frames[slot] = layout.frame(slotHandle(slot));
+    return status;
+}
+
+bool LayoutTemplate::solveAsStack(const LayoutRequest &request, std::vector<Frame> &frames) const
+{
+    StackLayout stack;
+    std::vector<Frame> stackFrames;
+    Frame containerFrame;
+    if (!recognizeStack(descriptors_.data(), descriptors_.size(), slotHandle(0), stack) ||
+        !solveStack(stack, request.width, request.height, stackFrames, &containerFrame)) return false;
+
+    frames.assign(slotCount_, Frame{0, 0, 0, 0});
+    frames[0] = containerFrame;
+    for (size_t i = 0; i < stack.items.size(); i++)
+    {
+        const uint32_t slot = slotForHandle(stack.items[i]);
+        if (slot < slotCount_) frames[slot] = stackFrames[i];
+    }
+    return true;
+}
+
+}
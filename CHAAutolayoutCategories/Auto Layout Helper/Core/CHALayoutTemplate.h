@@ -0,0 +1,82 @@
+//
+//  CHALayoutTemplate.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHALayoutTemplate_h
+#define CHAAutolayoutCategories_CHALayoutTemplate_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+/**
+ @description An intrinsic size for one slot of a layout request. A zero dimension is ignored.
+ */
+struct ContentSize
+{
+    uint32_t slot;
+    double width;
+    double height;
+};
+
+/**
+ @description The per-instance inputs to a template: container size and content
+ @discussion A negative height lets the content decide it. contentHash identifies the content sizes for caching.
+ */
+struct LayoutRequest
+{
+    double width;
+    double height;
+    uint64_t contentHash;
+    std::vector<ContentSize> contentSizes;
+};
+
+/**
+ @description A reusable set of descriptors whose items are slot indices instead of views.
+ @discussion Slot 0 is the container. Descriptor items are slot handles from slotHandle(), so a template can be recorded once
+ from the helpers' output and solved for any number of instances on any thread.
+ */
+class LayoutTemplate
+{
+public:
+    LayoutTemplate(uint64_t identifier, uint32_t slotCount);
+
+    static const void *slotHandle(uint32_t slot) { return reinterpret_cast<const void *>((uintptr_t)slot + 1); }
+    static uint32_t slotForHandle(const void *handle) { return (uint32_t)(reinterpret_cast<uintptr_t>(handle) - 1); }
+
+    /**
+     @description Append a descriptor whose item and toItem are slot handles (toItem may be null)
+     */
+    void addDescriptor(const CHAConstraintDescriptor &descriptor);
+    void addBatch(const CHADescriptorBatch &batch);
+
+    uint64_t identifier() const { return identifier_; }
+    uint32_t slotCount() const { return slotCount_; }
+    const std::vector<CHAConstraintDescriptor> &descriptors() const { return descriptors_; }
+
+    /**
+     @description Solve one instance. frames receives one frame per slot, in container coordinates.
+     @discussion A template that is a pure stack is resolved by the linear chain solver instead of the simplex solver.
+     @return StatusOK, or the first constraint the solver rejected
+     */
+    Solver::Status solve(const LayoutRequest &request, std::vector<Frame> &frames) const;
+
+private:
+    bool solveAsStack(const LayoutRequest &request, std::vector<Frame> &frames) const;
+
+    uint64_t identifier_;
+    uint32_t slotCount_;
+    std::vector<CHAConstraintDescriptor> descriptors_;
+};
+
+}
+
+#endif
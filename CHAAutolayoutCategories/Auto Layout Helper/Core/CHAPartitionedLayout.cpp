@@ -0,0 +1,437 @@
+//
+//  CHAPartitionedLayout.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPartitionedLayout.h"
+
+#include <algorithm>
+
+namespace cha {
+
+namespace {
+
+const uint32_t kNone = UINT32_MAX;
+// Item index 0 is always the container, and part 0 the root part.
+const uint32_t kContainer = 0;
+// Components are handed to workers in tasks of at least this many records, so that small subtrees share a task.
+const size_t kGrainRecords = 256;
+
+bool relatesTwoItems(const CHAConstraintDescriptor &record)
+{
+    return record.toItem && record.toItem != record.item && record.toAttribute != CHALayoutAttributeNotAnAttribute;
+}
+
+class DisjointSet
+{
+public:
+    explicit DisjointSet(size_t count) : parents_(count)
+    {
+        for (size_t i = 0; i < count; i++) parents_[i] = (uint32_t)i;
+    }
+
+    uint32_t find(uint32_t element)
+    {
+        while (parents_[element] != element)
+        {
+            parents_[element] = parents_[parents_[element]];
+            element = parents_[element];
+        }
+        return element;
+    }
+
+    void unite(uint32_t a, uint32_t b) { parents_[find(a)] = find(b); }
+
+private:
+    std::vector<uint32_t> parents_;
+};
+
+}
+
+PartitionedLayout::PartitionedLayout(WorkerPool *workers)
+: workers_(workers),
+  container_(nullptr),
+  width_(-1),
+  height_(-1),
+  containerHeld_(false),
+  stats_(),
+  status_(Solver::StatusOK),
+  mergedCuts_(0),
+  outstanding_(0)
+{
+}
+
+void PartitionedLayout::setContainer(Item container, double width, double height)
+{
+    container_ = container;
+    width_ = width;
+    height_ = height;
+}
+
+uint32_t PartitionedLayout::indexFor(Item item)
+{
+    auto inserted = indexes_.emplace(item, (uint32_t)items_.size());
+    if (inserted.second) items_.push_back(item);
+    return inserted.first->second;
+}
+
+void PartitionedLayout::setDescriptors(const CHAConstraintDescriptor *descriptors, size_t count, const ParentFunction &parentOf)
+{
+    records_.assign(descriptors, descriptors + count);
+    items_.clear();
+    indexes_.clear();
+    parts_.clear();
+
+    indexFor(container_);
+    containerHeld_ = container_ && width_ >= 0.0 && height_ >= 0.0;
+    for (const CHAConstraintDescriptor &record : records_)
+    {
+        indexFor(record.item);
+        if (relatesTwoItems(record)) indexFor(record.toItem);
+    }
+
+    buildParts(parentOf);
+
+    stats_ = PartitionStats();
+    stats_.partCount = parts_.size();
+    for (const Part &part : parts_)
+    {
+        stats_.componentCount += part.components.size();
+        for (const Component &component : part.components)
+        {
+            stats_.largestComponentRecords = std::max(stats_.largestComponentRecords, component.records.size());
+        }
+    }
+}
+
+void PartitionedLayout::buildParts(const ParentFunction &parentOf)
+{
+    const size_t itemCount = items_.size();
+
+    // The item tree: each item's nearest ancestor that some record mentions, or the container.
+    std::vector<uint32_t> parents(itemCount, kContainer);
+    parents[kContainer] = kNone;
+    if (parentOf)
+    {
+        for (size_t i = 1; i < itemCount; i++)
+        {
+            for (Item ancestor = parentOf(items_[i]); ancestor && ancestor != container_; ancestor = parentOf(ancestor))
+            {
+                auto found = indexes_.find(ancestor);
+                if (found == indexes_.end()) continue;
+                parents[i] = found->second;
+                break;
+            }
+        }
+    }
+
+    std::vector<uint32_t> depths(itemCount, kNone);
+    std::vector<uint32_t> path;
+    depths[kContainer] = 0;
+    for (size_t i = 1; i < itemCount; i++)
+    {
+        uint32_t item = (uint32_t)i;
+        for (; depths[item] == kNone; item = parents[item]) path.push_back(item);
+        for (uint32_t depth = depths[item]; !path.empty(); path.pop_back()) depths[path.back()] = ++depth;
+    }
+
+    // A subtree can be cut off unless a record joins a view strictly inside it to a view outside it. Such a record rules
+    // out every view between each of its items and their nearest common ancestor.
+    std::vector<char> cuttable(itemCount, 1);
+    cuttable[kContainer] = 0;
+    for (const CHAConstraintDescriptor &record : records_)
+    {
+        if (!relatesTwoItems(record)) continue;
+
+        uint32_t a = indexes_[record.item], b = indexes_[record.toItem];
+        uint32_t ancestorA = a, ancestorB = b;
+        while (depths[ancestorA] > depths[ancestorB]) ancestorA = parents[ancestorA];
+        while (depths[ancestorB] > depths[ancestorA]) ancestorB = parents[ancestorB];
+        while (ancestorA != ancestorB)
+        {
+            ancestorA = parents[ancestorA];
+            ancestorB = parents[ancestorB];
+        }
+
+        for (uint32_t item = parents[a]; item != kNone && depths[item] > depths[ancestorA]; item = parents[item])
+        {
+            cuttable[item] = 0;
+        }
+        for (uint32_t item = parents[b]; item != kNone && depths[item] > depths[ancestorA]; item = parents[item])
+        {
+            cuttable[item] = 0;
+        }
+    }
+
+    // Every item belongs to the part of its nearest cuttable strict ancestor; ancestors come first in depth order.
+    std::vector<uint32_t> order(itemCount);
+    for (size_t i = 0; i < itemCount; i++) order[i] = (uint32_t)i;
+    std::stable_sort(order.begin(), order.end(), [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+    std::vector<uint32_t> partRoots(itemCount, kContainer);
+    for (uint32_t item : order)
+    {
+        if (item == kContainer) continue;
+        const uint32_t parent = parents[item];
+        partRoots[item] = cuttable[parent] ? parent : partRoots[parent];
+    }
+
+    // A record goes to the deeper of its items' parts: a view's own constraints sit with its parent's part, and records
+    // inside a subtree with the subtree.
+    std::vector<uint32_t> partForRoot(itemCount, kNone);
+    std::vector<std::vector<uint32_t>> partRecords;
+    parts_.push_back(Part{kContainer, {}});
+    partRecords.emplace_back();
+    partForRoot[kContainer] = 0;
+
+    for (size_t r = 0; r < records_.size(); r++)
+    {
+        const CHAConstraintDescriptor &record = records_[r];
+        uint32_t root = partRoots[indexes_[record.item]];
+        if (relatesTwoItems(record))
+        {
+            const uint32_t other = partRoots[indexes_[record.toItem]];
+            if (depths[other] > depths[root]) root = other;
+        }
+
+        if (partForRoot[root] == kNone)
+        {
+            partForRoot[root] = (uint32_t)parts_.size();
+            parts_.push_back(Part{root, {}});
+            partRecords.emplace_back();
+        }
+        partRecords[partForRoot[root]].push_back((uint32_t)r);
+    }
+
+    // Each cut hangs off the nearest enclosing part that has records of its own.
+    std::vector<std::vector<uint32_t>> partCuts(parts_.size());
+    for (size_t p = 1; p < parts_.size(); p++)
+    {
+        uint32_t enclosing = partRoots[parts_[p].root];
+        while (partForRoot[enclosing] == kNone) enclosing = partRoots[enclosing];
+        partCuts[partForRoot[enclosing]].push_back((uint32_t)p);
+    }
+
+    std::vector<uint32_t> slots(itemCount, kNone);
+    for (size_t p = 0; p < parts_.size(); p++) buildComponents(parts_[p], partRecords[p], partCuts[p], slots);
+}
+
+void PartitionedLayout::buildComponents(Part &part,
+                                        const std::vector<uint32_t> &records,
+                                        const std::vector<uint32_t> &cuts,
+                                        std::vector<uint32_t> &slots)
+{
+    // The part's root is pinned rather than solved: a subtree's root by its parent part, the container by its size.
+    const uint32_t root = part.root;
+    const bool rootHeld = root != kContainer || containerHeld_;
+    auto isHeld = [&](uint32_t item) { return rootHeld && item == root; };
+
+    std::vector<uint32_t> locals;
+    auto slotFor = [&](uint32_t item) {
+        if (slots[item] == kNone)
+        {
+            slots[item] = (uint32_t)locals.size();
+            locals.push_back(item);
+        }
+        return slots[item];
+    };
+
+    for (uint32_t r : records)
+    {
+        const CHAConstraintDescriptor &record = records_[r];
+        if (!isHeld(indexes_[record.item])) slotFor(indexes_[record.item]);
+        if (relatesTwoItems(record) && !isHeld(indexes_[record.toItem])) slotFor(indexes_[record.toItem]);
+    }
+    for (uint32_t cut : cuts) slotFor(parts_[cut].root);
+
+    DisjointSet sets(locals.size());
+    for (uint32_t r : records)
+    {
+        const CHAConstraintDescriptor &record = records_[r];
+        if (!relatesTwoItems(record)) continue;
+
+        const uint32_t a = indexes_[record.item], b = indexes_[record.toItem];
+        if (!isHeld(a) && !isHeld(b)) sets.unite(slots[a], slots[b]);
+    }
+
+    std::vector<uint32_t> componentForSet(locals.size(), kNone);
+    auto componentFor = [&](uint32_t item) {
+        const uint32_t set = sets.find(slots[item]);
+        if (componentForSet[set] == kNone)
+        {
+            componentForSet[set] = (uint32_t)part.components.size();
+            part.components.emplace_back();
+        }
+        return componentForSet[set];
+    };
+
+    uint32_t heldOnly = kNone;
+    for (uint32_t r : records)
+    {
+        const CHAConstraintDescriptor &record = records_[r];
+        uint32_t item = indexes_[record.item];
+        if (isHeld(item) && relatesTwoItems(record)) item = indexes_[record.toItem];
+
+        uint32_t component;
+        if (!isHeld(item)) component = componentFor(item);
+        else
+        {
+            // Records between held items only, e.g. a size for the container, still have to be checked.
+            if (heldOnly == kNone)
+            {
+                heldOnly = (uint32_t)part.components.size();
+                part.components.emplace_back();
+            }
+            component = heldOnly;
+        }
+        part.components[component].records.push_back(r);
+    }
+
+    for (uint32_t item : locals) part.components[componentFor(item)].items.push_back(item);
+    for (uint32_t cut : cuts) part.components[componentFor(parts_[cut].root)].cuts.push_back(cut);
+
+    for (uint32_t item : locals) slots[item] = kNone;
+}
+
+Solver::Status PartitionedLayout::solve()
+{
+    status_.store(Solver::StatusOK);
+    mergedCuts_.store(0);
+    frames_.assign(items_.size(), Frame{0, 0, 0, 0});
+    if (containerHeld_) frames_[kContainer] = Frame{0, 0, width_, height_};
+
+    std::vector<ComponentRef> roots;
+    if (!parts_.empty())
+    {
+        for (size_t c = 0; c < parts_[0].components.size(); c++) roots.push_back(ComponentRef{0, (uint32_t)c});
+    }
+
+    if (!workers_)
+    {
+        solveComponents(roots);
+    }
+    else
+    {
+        schedule(roots);
+        std::unique_lock<std::mutex> lock(doneMutex_);
+        done_.wait(lock, [this] { return outstanding_.load() == 0; });
+    }
+
+    stats_.mergedCutCount = mergedCuts_.load();
+    return (Solver::Status)status_.load();
+}
+
+void PartitionedLayout::schedule(const std::vector<ComponentRef> &components)
+{
+    std::vector<ComponentRef> task;
+    size_t taskRecords = 0;
+    for (size_t i = 0; i < components.size(); i++)
+    {
+        const ComponentRef &reference = components[i];
+        task.push_back(reference);
+        taskRecords += parts_[reference.part].components[reference.component].records.size();
+        if (taskRecords < kGrainRecords && i + 1 < components.size()) continue;
+
+        outstanding_.fetch_add(1);
+        workers_->submit([this, task] {
+            solveComponents(task);
+            finishTask();
+        });
+        task.clear();
+        taskRecords = 0;
+    }
+}
+
+void PartitionedLayout::finishTask()
+{
+    if (outstanding_.fetch_sub(1) != 1) return;
+
+    std::lock_guard<std::mutex> lock(doneMutex_);
+    done_.notify_all();
+}
+
+void PartitionedLayout::solveComponents(const std::vector<ComponentRef> &components)
+{
+    LayoutSystem system;
+    std::vector<ComponentRef> ready;
+    for (const ComponentRef &reference : components)
+    {
+        system.reset();
+        solveComponent(system, reference, ready);
+    }
+    if (ready.empty()) return;
+
+    // Scheduled before this task finishes, so the count of outstanding tasks cannot touch zero early.
+    if (workers_) schedule(ready);
+    else solveComponents(ready);
+}
+
+void PartitionedLayout::solveComponent(LayoutSystem &system, const ComponentRef &reference, std::vector<ComponentRef> &ready)
+{
+    const Part &part = parts_[reference.part];
+    const Component &component = part.components[reference.component];
+
+    if (part.root != kContainer) noteStatus(system.pinFrame(items_[part.root], frames_[part.root]));
+    else if (containerHeld_) noteStatus(system.pinFrame(container_, frames_[kContainer]));
+    else if (container_) system.setContainer(container_, width_, height_);
+
+    for (uint32_t r : component.records) noteStatus(system.addDescriptor(records_[r]));
+
+    std::vector<const std::vector<uint32_t> *> solved(1, &component.items);
+    std::vector<uint32_t> pending = component.cuts, merged;
+    for (;;)
+    {
+        system.solve();
+
+        merged.clear();
+        for (uint32_t cut : pending)
+        {
+            if (system.isFrameDetermined(items_[parts_[cut].root]))
+            {
+                for (size_t c = 0; c < parts_[cut].components.size(); c++) ready.push_back(ComponentRef{cut, (uint32_t)c});
+            }
+            else
+            {
+                merged.push_back(cut);
+            }
+        }
+        if (merged.empty()) break;
+
+        // The subtree could have moved its root, so it joins this component after all.
+        pending.clear();
+        for (uint32_t cut : merged)
+        {
+            mergedCuts_.fetch_add(1);
+            for (const Component &inner : parts_[cut].components)
+            {
+                for (uint32_t r : inner.records) noteStatus(system.addDescriptor(records_[r]));
+                solved.push_back(&inner.items);
+                pending.insert(pending.end(), inner.cuts.begin(), inner.cuts.end());
+            }
+        }
+    }
+
+    for (const std::vector<uint32_t> *items : solved)
+    {
+        for (uint32_t item : *items) frames_[item] = system.frame(items_[item]);
+    }
+}
+
+void PartitionedLayout::noteStatus(Solver::Status status)
+{
+    if (status == Solver::StatusOK) return;
+
+    int expected = Solver::StatusOK;
+    status_.compare_exchange_strong(expected, status);
+}
+
+Frame PartitionedLayout::frame(Item item) const
+{
+    auto found = indexes_.find(item);
+    if (found == indexes_.end() || found->second >= frames_.size()) return Frame{0, 0, 0, 0};
+    return frames_[found->second];
+}
+
+}
@@ -0,0 +1,145 @@
+//
+//  CHAPartitionedLayout.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAPartitionedLayout_h
+#define CHAAutolayoutCategories_CHAPartitionedLayout_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "CHAConstraintCommitQueue.h"
+#include "CHALayoutSystem.h"
+#include "CHAWorkerPool.h"
+
+namespace cha {
+
+/**
+ @description How a constraint set was split, as of the last solve()
+ @field partCount The root plus every subtree that was cut off on its own
+ @field componentCount Independently solved pieces across all parts
+ @field mergedCutCount Subtrees whose root turned out not to be fixed from outside, and were solved with their parent instead
+ */
+struct PartitionStats
+{
+    size_t partCount;
+    size_t componentCount;
+    size_t mergedCutCount;
+    size_t largestComponentRecords;
+};
+
+/**
+ @description Solves a constraint set as independent pieces on a worker pool and merges the frames.
+ @discussion The set is split twice. A view's subtree is cut off when no constraint joins a view inside it to a view
+ outside it except through the subtree's root, as with the internals of a header that only the header's bottom edge
+ couples to the content below. Within the root and each subtree, the records then fall into connected components, with the
+ container and the subtree's root held constant. Components are solved concurrently; a subtree is solved once the component
+ holding its root is, with the root pinned to the frame just found. A cut is only kept when required equalities alone fix
+ its root's frame (see Solver::isDetermined), so that nothing inside the subtree could have moved the root; otherwise the
+ subtree is solved together with its parent. For layouts with a unique solution the frames match a single LayoutSystem.
+ The container is held at its size with required constraints when both dimensions are given, rather than the strong edit
+ LayoutSystem uses.
+ */
+class PartitionedLayout
+{
+public:
+    typedef const void *Item;
+
+    /**
+     @param workers Solves the pieces; may be null to solve them one after another on the calling thread
+     */
+    explicit PartitionedLayout(WorkerPool *workers = nullptr);
+
+    PartitionedLayout(const PartitionedLayout &) = delete;
+    PartitionedLayout &operator=(const PartitionedLayout &) = delete;
+
+    /**
+     @description As LayoutSystem::setContainer. Takes effect at the next setDescriptors().
+     */
+    void setContainer(Item container, double width, double height);
+
+    /**
+     @description Split records into parts and components, ready to solve. The records are copied.
+     @param parentOf Finds the subtrees to cut; may be null to split into connected components only
+     */
+    void setDescriptors(const CHAConstraintDescriptor *descriptors, size_t count, const ParentFunction &parentOf);
+
+    /**
+     @description Solve every component and merge the frames
+     @return StatusOK, or the first failure any component reported
+     */
+    Solver::Status solve();
+
+    /**
+     @description The solved frame for an item, or a zero frame for an item no record mentions
+     */
+    Frame frame(Item item) const;
+
+    const PartitionStats &stats() const { return stats_; }
+
+private:
+    struct Component
+    {
+        std::vector<uint32_t> records;
+        // Items solved by this component, excluding the held part root and container.
+        std::vector<uint32_t> items;
+        // Parts whose root is one of items.
+        std::vector<uint32_t> cuts;
+    };
+
+    struct Part
+    {
+        uint32_t root;
+        std::vector<Component> components;
+    };
+
+    struct ComponentRef
+    {
+        uint32_t part;
+        uint32_t component;
+    };
+
+    uint32_t indexFor(Item item);
+    void buildParts(const ParentFunction &parentOf);
+    void buildComponents(Part &part,
+                         const std::vector<uint32_t> &records,
+                         const std::vector<uint32_t> &cuts,
+                         std::vector<uint32_t> &slots);
+
+    void schedule(const std::vector<ComponentRef> &components);
+    void solveComponents(const std::vector<ComponentRef> &components);
+    void solveComponent(LayoutSystem &system, const ComponentRef &reference, std::vector<ComponentRef> &ready);
+    void noteStatus(Solver::Status status);
+    void finishTask();
+
+    WorkerPool *workers_;
+    Item container_;
+    double width_;
+    double height_;
+    bool containerHeld_;
+
+    std::vector<CHAConstraintDescriptor> records_;
+    std::vector<Item> items_;
+    std::unordered_map<Item, uint32_t> indexes_;
+    std::vector<Part> parts_;
+    std::vector<Frame> frames_;
+    PartitionStats stats_;
+
+    std::atomic<int> status_;
+    std::atomic<size_t> mergedCuts_;
+    std::atomic<size_t> outstanding_;
+    std::mutex doneMutex_;
+    std::condition_variable done_;
+};
+
+}
+
+#endif
@@ -0,0 +1,777 @@
+//
+//  CHASimplexSolver.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHASimplexSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace cha {
+
+namespace {
+
+const double kEpsilon = 1.0e-8;
+
+inline bool nearZero(double value)
+{
+    return value < 0 ? -value < kEpsilon : value < kEpsilon;
+}
+
+double clipStrength(double strength)
+{
+    return std::max(0.0, std::min(Strength::required, strength));
+}
+
+}
+
+double Solver::Row::coefficientFor(Symbol symbol) const
+{
+    auto found = std::lower_bound(cells.begin(), cells.end(), symbol,
+                                  [](const Cell &cell, Symbol value) { return cell.symbol < value; });
+    return (found != cells.end() && found->symbol == symbol) ? found->coefficient : 0.0;
+}
+
+void Solver::Row::insert(Symbol symbol, double coefficient)
+{
+    auto found = std::lower_bound(cells.begin(), cells.end(), symbol,
+                                  [](const Cell &cell, Symbol value) { return cell.symbol < value; });
+    if (found != cells.end() && found->symbol == symbol)
+    {
+        found->coefficient += coefficient;
+        if (nearZero(found->coefficient)) cells.erase(found);
+    }
+    else if (!nearZero(coefficient))
+    {
+        cells.insert(found, Cell{symbol, coefficient});
+    }
+}
+
+void Solver::Row::insert(const Row &other, double coefficient, Cells &scratch, std::vector<Symbol> *introduced)
+{
+    constant += other.constant * coefficient;
+
+    Cells &merged = scratch;
+    merged.clear();
+    merged.reserve(cells.size() + other.cells.size());
+
+    auto mine = cells.begin();
+    auto theirs = other.cells.begin();
+    while (mine != cells.end() || theirs != other.cells.end())
+    {
+        if (theirs == other.cells.end() || (mine != cells.end() && mine->symbol < theirs->symbol))
+        {
+            merged.push_back(*mine++);
+        }
+        else if (mine == cells.end() || theirs->symbol < mine->symbol)
+        {
+            double value = theirs->coefficient * coefficient;
+            if (!nearZero(value))
+            {
+                merged.push_back(Cell{theirs->symbol, value});
+                if (introduced) introduced->push_back(theirs->symbol);
+            }
+            ++theirs;
+        }
+        else
+        {
+            double value = mine->coefficient + theirs->coefficient * coefficient;
+            if (!nearZero(value)) merged.push_back(Cell{mine->symbol, value});
+            ++mine;
+            ++theirs;
+        }
+    }
+    cells.swap(merged);
+}
+
+void Solver::Row::remove(Symbol symbol)
+{
+    auto found = std::lower_bound(cells.begin(), cells.end(), symbol,
+                                  [](const Cell &cell, Symbol value) { return cell.symbol < value; });
+    if (found != cells.end() && found->symbol == symbol) cells.erase(found);
+}
+
+void Solver::Row::reverseSign()
+{
+    constant = -constant;
+    for (Cell &cell : cells) cell.coefficient = -cell.coefficient;
+}
+
+void Solver::Row::solveFor(Symbol symbol)
+{
+    double coefficient = -1.0 / coefficientFor(symbol);
+    remove(symbol);
+    constant *= coefficient;
+    for (Cell &cell : cells) cell.coefficient *= coefficient;
+}
+
+void Solver::Row::solveFor(Symbol lhs, Symbol rhs)
+{
+    insert(lhs, -1.0);
+    solveFor(rhs);
+}
+
+bool Solver::Row::substitute(Symbol symbol, const Row &row, Cells &scratch, std::vector<Symbol> *introduced)
+{
+    double coefficient = coefficientFor(symbol);
+    if (coefficient == 0.0) return false;
+
+    remove(symbol);
+    insert(row, coefficient, scratch, introduced);
+    return true;
+}
+
+Solver::Solver(LayoutArena *arena)
+: arena_(arena),
+  candidates_(arena),
+  scratch_(arena),
+  objective_(newRow(0.0)),
+  artificial_(newRow(0.0))
+{
+    reset();
+}
+
+void Solver::reset()
+{
+    symbolTypes_.assign(1, SymbolInvalid);
+    rowIndex_.assign(1, -1);
+    rows_.clear();
+    columns_.clear();
+    columns_.push_back(Column{Basics(arena_), 32});
+    variableSymbols_.clear();
+    values_.clear();
+    tags_.clear();
+    edits_.clear();
+    infeasibleRows_.clear();
+    introducedSymbols_.clear();
+    candidates_ = Basics(arena_);
+    scratch_ = Cells(arena_);
+    objective_ = newRow(0.0);
+    artificial_ = newRow(0.0);
+    hasArtificial_ = false;
+    liveConstraintCount_ = 0;
+    pivotCount_ = 0;
+}
+
+Solver::Variable Solver::addVariable()
+{
+    Variable variable = (Variable)variableSymbols_.size();
+    variableSymbols_.push_back(newSymbol(SymbolExternal));
+    values_.push_back(0.0);
+    edits_.push_back(EditInfo{0, 0.0, false});
+    return variable;
+}
+
+Solver::Status Solver::addConstraint(const Term *terms,
+                                     size_t termCount,
+                                     double constant,
+                                     CHALayoutRelation relation,
+                                     double strength,
+                                     Constraint *constraint)
+{
+    Tag tag = {InvalidSymbol, InvalidSymbol, clipStrength(strength), constant, 1.0, true};
+    Row row = createRow(terms, termCount, constant, relation, tag.strength, tag);
+
+    Symbol subject = chooseSubject(row, tag);
+    if (subject == InvalidSymbol && allDummies(row))
+    {
+        if (!nearZero(row.constant))
+        {
+            removeConstraintEffects(tag);
+            return StatusUnsatisfiable;
+        }
+        subject = tag.marker;
+    }
+
+    if (subject == InvalidSymbol)
+    {
+        if (!addWithArtificialVariable(row))
+        {
+            // The row is already part of the tableau, so back it out the same way a live constraint is removed.
+            tags_.push_back(tag);
+            liveConstraintCount_++;
+            removeConstraint((Constraint)tags_.size() - 1);
+            return StatusUnsatisfiable;
+        }
+    }
+    else
+    {
+        row.solveFor(subject);
+        substitute(subject, row);
+        row.basic = subject;
+        insertRow(std::move(row));
+    }
+
+    Constraint identifier = (Constraint)tags_.size();
+    tags_.push_back(tag);
+    liveConstraintCount_++;
+    if (constraint) *constraint = identifier;
+
+    return optimize(objective_);
+}
+
+Solver::Status Solver::removeConstraint(Constraint constraint)
+{
+    if (!hasConstraint(constraint)) return StatusUnknownConstraint;
+
+    Tag tag = tags_[constraint];
+    tags_[constraint].live = false;
+    liveConstraintCount_--;
+
+    removeConstraintEffects(tag);
+
+    if (rowFor(tag.marker))
+    {
+        takeRow(tag.marker);
+    }
+    else
+    {
+        Symbol leaving = markerLeavingRow(tag.marker);
+        if (leaving == InvalidSymbol) return StatusInternalError;
+
+        // Pivot the marker in and drop its row, which takes the constraint out of the tableau.
+        Row row = takeRow(leaving);
+        row.solveFor(leaving, tag.marker);
+        substitute(tag.marker, row);
+        pivotCount_++;
+    }
+
+    return optimize(objective_);
+}
+
+bool Solver::hasConstraint(Constraint constraint) const
+{
+    return constraint < tags_.size() && tags_[constraint].live;
+}
+
+Solver::Status Solver::addEditVariable(Variable variable, double strength)
+{
+    if (edits_[variable].live) return StatusDuplicateEditVariable;
+
+    strength = clipStrength(strength);
+    if (strength == Strength::required) return StatusBadRequiredStrength;
+
+    Term term = {variable, 1.0};
+    Constraint constraint;
+    Status status = addConstraint(&term, 1, 0.0, CHALayoutRelationEqual, strength, &constraint);
+    if (status != StatusOK) return status;
+
+    edits_[variable] = EditInfo{constraint, 0.0, true};
+    return StatusOK;
+}
+
+Solver::Status Solver::removeEditVariable(Variable variable)
+{
+    if (!edits_[variable].live) return StatusUnknownEditVariable;
+
+    edits_[variable].live = false;
+    return removeConstraint(edits_[variable].constraint);
+}
+
+bool Solver::hasEditVariable(Variable variable) const
+{
+    return variable < edits_.size() && edits_[variable].live;
+}
+
+Solver::Status Solver::suggestValue(Variable variable, double value)
+{
+    EditInfo &info = edits_[variable];
+    if (!info.live) return StatusUnknownEditVariable;
+
+    // The edit row is variable - e+ + e- = 0, so moving its target by delta moves e+ by delta.
+    double delta = value - info.constant;
+    info.constant = value;
+    shiftMarker(tags_[info.constraint], delta);
+    return dualOptimize();
+}
+
+Solver::Status Solver::setConstant(Constraint constraint, double constant)
+{
+    return setConstants(&constraint, &constant, 1);
+}
+
+Solver::Status Solver::setConstants(const Constraint *constraints, const double *constants, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!hasConstraint(constraints[i])) return StatusUnknownConstraint;
+    }
+
+    // With the marker's coefficient m, expr + c + m * marker = 0 keeps holding for c + dc once the marker moves by dc / m.
+    redundantRows_.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        const Tag &tag = tags_[constraints[i]];
+        shiftMarker(tag, (constants[i] - tag.constant) * tag.markerCoefficient);
+    }
+
+    // A redundant required equality must still agree with the ones it duplicates, which only holds once the whole batch moved.
+    bool satisfiable = true;
+    for (Symbol basic : redundantRows_)
+    {
+        if (!nearZero(rowFor(basic)->constant)) satisfiable = false;
+    }
+    if (satisfiable && dualOptimize() == StatusOK)
+    {
+        for (size_t i = 0; i < count; i++) tags_[constraints[i]].constant = constants[i];
+        return StatusOK;
+    }
+
+    // Shifting back restores the previous system in whatever basis the tableau is now in.
+    for (size_t i = count; i-- > 0;)
+    {
+        const Tag &tag = tags_[constraints[i]];
+        shiftMarker(tag, (tag.constant - constants[i]) * tag.markerCoefficient);
+    }
+    infeasibleRows_.clear();
+    queueInfeasibleRows();
+    return dualOptimize() == StatusOK ? StatusUnsatisfiable : StatusInternalError;
+}
+
+void Solver::updateVariables()
+{
+    for (size_t variable = 0; variable < variableSymbols_.size(); variable++)
+    {
+        const Row *row = rowFor(variableSymbols_[variable]);
+        values_[variable] = row ? row->constant : 0.0;
+    }
+}
+
+double Solver::currentValue(Variable variable) const
+{
+    const Row *row = rowFor(variableSymbols_[variable]);
+    return row ? row->constant : 0.0;
+}
+
+bool Solver::isDetermined(Variable variable) const
+{
+    const Row *row = rowFor(variableSymbols_[variable]);
+    return row && allDummies(*row);
+}
+
+size_t Solver::cellCount() const
+{
+    size_t cells = 0;
+    for (const Row &row : rows_) cells += row.cells.size();
+    return cells;
+}
+
+Solver::Symbol Solver::newSymbol(SymbolType type)
+{
+    Symbol symbol = (Symbol)symbolTypes_.size();
+    symbolTypes_.push_back(type);
+    rowIndex_.push_back(-1);
+    columns_.push_back(Column{Basics(arena_), 32});
+    return symbol;
+}
+
+Solver::Row *Solver::rowFor(Symbol symbol)
+{
+    if (symbol == InvalidSymbol) return nullptr;
+    int32_t index = rowIndex_[symbol];
+    return index < 0 ? nullptr : &rows_[index];
+}
+
+const Solver::Row *Solver::rowFor(Symbol symbol) const
+{
+    if (symbol == InvalidSymbol) return nullptr;
+    int32_t index = rowIndex_[symbol];
+    return index < 0 ? nullptr : &rows_[index];
+}
+
+void Solver::insertRow(Row &&row)
+{
+    // The row must be in the tableau before its columns are noted; a compaction triggered by noteColumn drops entries
+    // whose row it cannot find.
+    Symbol basic = row.basic;
+    rowIndex_[basic] = (int32_t)rows_.size();
+    rows_.push_back(std::move(row));
+    for (const Cell &cell : rows_.back().cells) noteColumn(cell.symbol, basic);
+}
+
+void Solver::noteColumn(Symbol symbol, Symbol basic)
+{
+    Column &column = columns_[symbol];
+    column.basics.push_back(basic);
+
+    // Entries go stale or repeat as rows are pivoted; prune them whenever the column doubles since the last pass.
+    if (column.basics.size() >= column.compactionLimit)
+    {
+        compactColumn(symbol);
+        column.compactionLimit = std::max<size_t>(32, 2 * column.basics.size());
+    }
+}
+
+const Solver::Basics &Solver::compactColumn(Symbol symbol)
+{
+    Basics &column = columns_[symbol].basics;
+    std::sort(column.begin(), column.end());
+    column.erase(std::unique(column.begin(), column.end()), column.end());
+    column.erase(std::remove_if(column.begin(), column.end(), [this, symbol](Symbol basic) {
+                     const Row *row = rowFor(basic);
+                     return !row || row->coefficientFor(symbol) == 0.0;
+                 }),
+                 column.end());
+    return column;
+}
+
+Solver::Row Solver::takeRow(Symbol basic)
+{
+    int32_t index = rowIndex_[basic];
+    Row row = std::move(rows_[index]);
+    rowIndex_[basic] = -1;
+
+    if ((size_t)index != rows_.size() - 1)
+    {
+        rows_[index] = std::move(rows_.back());
+        rowIndex_[rows_[index].basic] = index;
+    }
+    rows_.pop_back();
+    return row;
+}
+
+Solver::Row Solver::createRow(const Term *terms,
+                              size_t termCount,
+                              double constant,
+                              CHALayoutRelation relation,
+                              double strength,
+                              Tag &tag)
+{
+    Row row = newRow(constant);
+
+    for (size_t i = 0; i < termCount; i++)
+    {
+        if (nearZero(terms[i].coefficient)) continue;
+
+        Symbol symbol = variableSymbols_[terms[i].variable];
+        if (const Row *basicRow = rowFor(symbol)) row.insert(*basicRow, terms[i].coefficient, scratch_);
+        else row.insert(symbol, terms[i].coefficient);
+    }
+
+    if (relation != CHALayoutRelationEqual)
+    {
+        double coefficient = relation == CHALayoutRelationLessThanOrEqual ? 1.0 : -1.0;
+        Symbol slack = newSymbol(SymbolSlack);
+        tag.marker = slack;
+        tag.markerCoefficient = coefficient;
+        row.insert(slack, coefficient);
+
+        if (strength < Strength::required)
+        {
+            Symbol error = newSymbol(SymbolError);
+            tag.other = error;
+            row.insert(error, -coefficient);
+            objective_.insert(error, strength);
+        }
+    }
+    else if (strength < Strength::required)
+    {
+        Symbol errorPlus = newSymbol(SymbolError);
+        Symbol errorMinus = newSymbol(SymbolError);
+        tag.marker = errorPlus;
+        tag.other = errorMinus;
+        tag.markerCoefficient = -1.0;
+        row.insert(errorPlus, -1.0);
+        row.insert(errorMinus, 1.0);
+        objective_.insert(errorPlus, strength);
+        objective_.insert(errorMinus, strength);
+    }
+    else
+    {
+        Symbol dummy = newSymbol(SymbolDummy);
+        tag.marker = dummy;
+        row.insert(dummy, 1.0);
+    }
+
+    if (row.constant < 0.0) row.reverseSign();
+    return row;
+}
+
+Solver::Symbol Solver::chooseSubject(const Row &row, const Tag &tag) const
+{
+    for (const Cell &cell : row.cells)
+    {
+        if (typeOf(cell.symbol) == SymbolExternal) return cell.symbol;
+    }
+
+    SymbolType markerType = typeOf(tag.marker);
+    if ((markerType == SymbolSlack || markerType == SymbolError) && row.coefficientFor(tag.marker) < 0.0)
+    {
+        return tag.marker;
+    }
+
+    if (tag.other != InvalidSymbol)
+    {
+        SymbolType otherType = typeOf(tag.other);
+        if ((otherType == SymbolSlack || otherType == SymbolError) && row.coefficientFor(tag.other) < 0.0)
+        {
+            return tag.other;
+        }
+    }
+
+    return InvalidSymbol;
+}
+
+bool Solver::allDummies(const Row &row) const
+{
+    for (const Cell &cell : row.cells)
+    {
+        if (typeOf(cell.symbol) != SymbolDummy) return false;
+    }
+    return true;
+}
+
+bool Solver::addWithArtificialVariable(Row &row)
+{
+    Symbol artificial = newSymbol(SymbolSlack);
+    row.basic = artificial;
+    artificial_ = row;
+    insertRow(std::move(row));
+
+    hasArtificial_ = true;
+    optimize(artificial_);
+    bool success = nearZero(artificial_.constant);
+    hasArtificial_ = false;
+    artificial_.cells.clear();
+    artificial_.constant = 0.0;
+
+    if (rowFor(artificial))
+    {
+        Row basicRow = takeRow(artificial);
+        if (basicRow.cells.empty()) return success;
+
+        Symbol entering = pivotableSymbol(basicRow);
+        if (entering == InvalidSymbol) return false;
+
+        basicRow.solveFor(artificial, entering);
+        substitute(entering, basicRow);
+        basicRow.basic = entering;
+        insertRow(std::move(basicRow));
+        pivotCount_++;
+    }
+
+    for (Symbol basic : compactColumn(artificial)) rowFor(basic)->remove(artificial);
+    columns_[artificial].basics.clear();
+    objective_.remove(artificial);
+    return success;
+}
+
+void Solver::substitute(Symbol symbol, const Row &row)
+{
+    // The column is rebuilt by noteColumn as rows are rewritten, so its entries move to a reused scratch list.
+    candidates_.clear();
+    candidates_.swap(columns_[symbol].basics);
+
+    for (Symbol basic : candidates_)
+    {
+        Row *basicRow = rowFor(basic);
+        introducedSymbols_.clear();
+        if (!basicRow || !basicRow->substitute(symbol, row, scratch_, &introducedSymbols_)) continue;
+
+        for (Symbol introduced : introducedSymbols_) noteColumn(introduced, basic);
+        if (typeOf(basic) != SymbolExternal && basicRow->constant < 0.0) infeasibleRows_.push_back(basic);
+    }
+
+    objective_.substitute(symbol, row, scratch_);
+    if (hasArtificial_) artificial_.substitute(symbol, row, scratch_);
+}
+
+Solver::Status Solver::optimize(Row &objective)
+{
+    for (;;)
+    {
+        Symbol entering = enteringSymbol(objective);
+        if (entering == InvalidSymbol) return StatusOK;
+
+        Symbol leaving = leavingRow(entering);
+        if (leaving == InvalidSymbol) return StatusInternalError;
+
+        Row row = takeRow(leaving);
+        row.solveFor(leaving, entering);
+        substitute(entering, row);
+        row.basic = entering;
+        insertRow(std::move(row));
+        pivotCount_++;
+    }
+}
+
+void Solver::shiftMarker(const Tag &tag, double shift)
+{
+    if (Row *row = rowFor(tag.marker))
+    {
+        row->add(-shift);
+        if (typeOf(tag.marker) == SymbolDummy) redundantRows_.push_back(tag.marker);
+        else if (row->constant < 0.0) infeasibleRows_.push_back(tag.marker);
+        return;
+    }
+
+    if (Row *row = rowFor(tag.other))
+    {
+        row->add(shift);
+        if (row->constant < 0.0) infeasibleRows_.push_back(tag.other);
+        return;
+    }
+
+    for (Symbol basic : compactColumn(tag.marker))
+    {
+        Row &row = *rowFor(basic);
+        row.add(shift * row.coefficientFor(tag.marker));
+        if (typeOf(basic) == SymbolDummy) redundantRows_.push_back(basic);
+        else if (row.constant < 0.0 && typeOf(basic) != SymbolExternal) infeasibleRows_.push_back(basic);
+    }
+}
+
+void Solver::queueInfeasibleRows()
+{
+    for (const Row &row : rows_)
+    {
+        const SymbolType type = typeOf(row.basic);
+        if (row.constant < 0.0 && type != SymbolExternal && type != SymbolDummy) infeasibleRows_.push_back(row.basic);
+    }
+}
+
+Solver::Status Solver::dualOptimize()
+{
+    while (!infeasibleRows_.empty())
+    {
+        Symbol leaving = infeasibleRows_.back();
+        infeasibleRows_.pop_back();
+
+        Row *row = rowFor(leaving);
+        if (!row || row->constant >= 0.0) continue;
+
+        Symbol entering = dualEnteringSymbol(*row);
+        if (entering == InvalidSymbol) return StatusInternalError;
+
+        Row pivotRow = takeRow(leaving);
+        pivotRow.solveFor(leaving, entering);
+        substitute(entering, pivotRow);
+        pivotRow.basic = entering;
+        insertRow(std::move(pivotRow));
+        pivotCount_++;
+    }
+    return StatusOK;
+}
+
+Solver::Symbol Solver::enteringSymbol(const Row &objective) const
+{
+    for (const Cell &cell : objective.cells)
+    {
+        if (typeOf(cell.symbol) != SymbolDummy && cell.coefficient < 0.0) return cell.symbol;
+    }
+    return InvalidSymbol;
+}
+
+Solver::Symbol Solver::dualEnteringSymbol(const Row &row) const
+{
+    Symbol entering = InvalidSymbol;
+    double ratio = std::numeric_limits<double>::max();
+
+    for (const Cell &cell : row.cells)
+    {
+        if (cell.coefficient > 0.0 && typeOf(cell.symbol) != SymbolDummy)
+        {
+            double candidate = objective_.coefficientFor(cell.symbol) / cell.coefficient;
+            if (candidate < ratio)
+            {
+                ratio = candidate;
+                entering = cell.symbol;
+            }
+        }
+    }
+    return entering;
+}
+
+Solver::Symbol Solver::pivotableSymbol(const Row &row) const
+{
+    for (const Cell &cell : row.cells)
+    {
+        SymbolType type = typeOf(cell.symbol);
+        if (type == SymbolSlack || type == SymbolError) return cell.symbol;
+    }
+    return InvalidSymbol;
+}
+
+Solver::Symbol Solver::leavingRow(Symbol entering) const
+{
+    double ratio = std::numeric_limits<double>::max();
+    Symbol leaving = InvalidSymbol;
+
+    for (Symbol basic : columns_[entering].basics)
+    {
+        const Row *row = rowFor(basic);
+        if (!row || typeOf(basic) == SymbolExternal) continue;
+
+        double coefficient = row->coefficientFor(entering);
+        if (coefficient < 0.0)
+        {
+            double candidate = -row->constant / coefficient;
+            if (candidate < ratio)
+            {
+                ratio = candidate;
+                leaving = basic;
+            }
+        }
+    }
+    return leaving;
+}
+
+Solver::Symbol Solver::markerLeavingRow(Symbol marker) const
+{
+    double firstRatio = std::numeric_limits<double>::max();
+    double secondRatio = firstRatio;
+    Symbol first = InvalidSymbol, second = InvalidSymbol, third = InvalidSymbol;
+
+    for (Symbol basic : columns_[marker].basics)
+    {
+        const Row *row = rowFor(basic);
+        double coefficient = row ? row->coefficientFor(marker) : 0.0;
+        if (coefficient == 0.0) continue;
+
+        if (typeOf(basic) == SymbolExternal)
+        {
+            third = basic;
+        }
+        else if (coefficient < 0.0)
+        {
+            double ratio = -row->constant / coefficient;
+            if (ratio < firstRatio)
+            {
+                firstRatio = ratio;
+                first = basic;
+            }
+        }
+        else
+        {
+            double ratio = row->constant / coefficient;
+            if (ratio < secondRatio)
+            {
+                secondRatio = ratio;
+                second = basic;
+            }
+        }
+    }
+
+    if (first != InvalidSymbol) return first;
+    if (second != InvalidSymbol) return second;
+    return third;
+}
+
+void Solver::removeConstraintEffects(const Tag &tag)
+{
+    if (typeOf(tag.marker) == SymbolError) removeMarkerEffects(tag.marker, tag.strength);
+    if (tag.other != InvalidSymbol && typeOf(tag.other) == SymbolError) removeMarkerEffects(tag.other, tag.strength);
+}
+
+void Solver::removeMarkerEffects(Symbol marker, double strength)
+{
+    if (const Row *row = rowFor(marker)) objective_.insert(*row, -strength, scratch_);
+    else objective_.insert(marker, -strength);
+}
+
+}
@@ -0,0 +1,264 @@
+//
+//  CHASimplexSolver.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHASimplexSolver_h
+#define CHAAutolayoutCategories_CHASimplexSolver_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+#include "CHALayoutArena.h"
+
+namespace cha {
+
+/**
+ @description Constraint strengths. Anything below required is an optional constraint whose error is minimized with the given
+ weight; required constraints must hold exactly.
+ */
+namespace Strength {
+const double required = 1001001000.0;
+const double strong = 1000000.0;
+const double medium = 1000.0;
+const double weak = 1.0;
+
+/**
+ @description Map an NSLayoutPriority-style value (1...1000) onto a solver strength
+ */
+inline double forPriority(float priority)
+{
+    return priority >= CHALayoutPriorityRequired ? required : (double)priority * medium;
+}
+}
+
+/**
+ @description An incremental Cassowary solver.
+ @discussion Rows are kept in a dense array and each row stores its cells as a vector of (symbol, coefficient) pairs sorted by
+ symbol, so row arithmetic is a linear merge over contiguous memory. A column index records which rows may mention each
+ symbol, so a pivot only visits the rows it changes instead of the whole tableau. Adding or removing a constraint pivots
+ only as much as needed to restore optimality, and suggesting a value for an edit variable re-optimizes with the dual
+ simplex method.
+ Given an arena, row cells and column indexes are allocated from it and reset() leaves the heap-backed arrays at their
+ capacity, so re-solving a screen of the same size on a reset solver allocates nothing from the heap.
+ Methods report failure through Status rather than throwing.
+ */
+class Solver
+{
+public:
+    typedef uint32_t Variable;
+    typedef uint32_t Constraint;
+
+    enum Status
+    {
+        StatusOK = 0,
+        StatusUnsatisfiable,
+        StatusUnknownConstraint,
+        StatusDuplicateEditVariable,
+        StatusUnknownEditVariable,
+        StatusBadRequiredStrength,
+        StatusInternalError
+    };
+
+    struct Term
+    {
+        Variable variable;
+        double coefficient;
+    };
+
+    /**
+     @param arena Backs the row and column storage until reset() or destruction; may be null for the heap
+     */
+    explicit Solver(LayoutArena *arena = nullptr);
+
+    /**
+     @description Drop every variable and constraint. Reset the arena, if any, only after this.
+     */
+    void reset();
+
+    /**
+     @description Create a new external variable with an initial value of 0
+     */
+    Variable addVariable();
+    size_t variableCount() const { return variableSymbols_.size(); }
+
+    /**
+     @description Add the constraint (sum of terms + constant) relation 0
+     @param constraint Receives an identifier for later removal when the constraint is added; may be null
+     */
+    Status addConstraint(const Term *terms,
+                         size_t termCount,
+                         double constant,
+                         CHALayoutRelation relation,
+                         double strength,
+                         Constraint *constraint);
+    Status removeConstraint(Constraint constraint);
+    bool hasConstraint(Constraint constraint) const;
+    size_t constraintCount() const { return liveConstraintCount_; }
+
+    /**
+     @description Make a variable editable at a non-required strength
+     */
+    Status addEditVariable(Variable variable, double strength);
+    Status removeEditVariable(Variable variable);
+    bool hasEditVariable(Variable variable) const;
+
+    /**
+     @description Suggest a value for an edit variable and re-optimize the rows it affects
+     */
+    Status suggestValue(Variable variable, double value);
+
+    /**
+     @description Change a constraint's constant in place, as suggestValue does for an edit variable: the constant's change is
+     carried into the rows that mention the constraint and only those rows are re-optimized, with no pivots elsewhere.
+     @return StatusOK, StatusUnknownConstraint, or StatusUnsatisfiable with the constant left unchanged when the new value
+     conflicts with the required constraints
+     */
+    Status setConstant(Constraint constraint, double constant);
+    /**
+     @description Change several constants and re-optimize once. Either every constant changes or, on failure, none does.
+     @param constraints Each constraint may appear once
+     */
+    Status setConstants(const Constraint *constraints, const double *constants, size_t count);
+
+    /**
+     @description Copy the solution into the variables so value() reflects the latest solve
+     */
+    void updateVariables();
+    double value(Variable variable) const { return values_[variable]; }
+    /**
+     @description The variable's value read straight from the tableau, without copying every variable out first
+     */
+    double currentValue(Variable variable) const;
+    /**
+     @description Whether required equalities alone fix the variable's value, so that constraints added later can only agree
+     with it or be unsatisfiable. Conservative: a variable that is parametric in the tableau reports false even if it is fixed.
+     */
+    bool isDetermined(Variable variable) const;
+
+    /**
+     @description Structural counters, useful when profiling a layout
+     */
+    size_t rowCount() const { return rows_.size(); }
+    size_t cellCount() const;
+    uint64_t pivotCount() const { return pivotCount_; }
+
+private:
+    enum SymbolType : uint8_t
+    {
+        SymbolInvalid = 0,
+        SymbolExternal,
+        SymbolSlack,
+        SymbolError,
+        SymbolDummy
+    };
+
+    typedef uint32_t Symbol;
+    static const Symbol InvalidSymbol = 0;
+
+    struct Cell
+    {
+        Symbol symbol;
+        double coefficient;
+    };
+
+    typedef std::vector<Cell, ArenaAllocator<Cell>> Cells;
+    typedef std::vector<Symbol, ArenaAllocator<Symbol>> Basics;
+
+    struct Row
+    {
+        Symbol basic;
+        double constant;
+        Cells cells;
+
+        double coefficientFor(Symbol symbol) const;
+        void add(double value) { constant += value; }
+        void insert(Symbol symbol, double coefficient);
+        // Merges through scratch, which is left holding the row's previous cells for the next merge to reuse.
+        void insert(const Row &other, double coefficient, Cells &scratch, std::vector<Symbol> *introduced = nullptr);
+        void remove(Symbol symbol);
+        void reverseSign();
+        void solveFor(Symbol symbol);
+        void solveFor(Symbol lhs, Symbol rhs);
+        bool substitute(Symbol symbol, const Row &row, Cells &scratch, std::vector<Symbol> *introduced = nullptr);
+    };
+
+    struct Tag
+    {
+        Symbol marker;
+        Symbol other;
+        double strength;
+        // The constant the constraint was added or last set with, and the marker's coefficient in the constraint's row.
+        double constant;
+        double markerCoefficient;
+        bool live;
+    };
+
+    struct Column
+    {
+        Basics basics;
+        size_t compactionLimit;
+    };
+
+    struct EditInfo
+    {
+        Constraint constraint;
+        double constant;
+        bool live;
+    };
+
+    Symbol newSymbol(SymbolType type);
+    SymbolType typeOf(Symbol symbol) const { return symbolTypes_[symbol]; }
+    Row *rowFor(Symbol symbol);
+    const Row *rowFor(Symbol symbol) const;
+    void noteColumn(Symbol symbol, Symbol basic);
+    const Basics &compactColumn(Symbol symbol);
+    Row newRow(double constant) const { return Row{InvalidSymbol, constant, Cells(arena_)}; }
+    void insertRow(Row &&row);
+    Row takeRow(Symbol basic);
+
+    Row createRow(const Term *terms, size_t termCount, double constant, CHALayoutRelation relation, double strength, Tag &tag);
+    Symbol chooseSubject(const Row &row, const Tag &tag) const;
+    bool allDummies(const Row &row) const;
+    bool addWithArtificialVariable(Row &row);
+    void substitute(Symbol symbol, const Row &row);
+    Status optimize(Row &objective);
+    Status dualOptimize();
+    Symbol enteringSymbol(const Row &objective) const;
+    Symbol dualEnteringSymbol(const Row &row) const;
+    Symbol pivotableSymbol(const Row &row) const;
+    Symbol leavingRow(Symbol entering) const;
+    Symbol markerLeavingRow(Symbol marker) const;
+    void shiftMarker(const Tag &tag, double shift);
+    void queueInfeasibleRows();
+    void removeConstraintEffects(const Tag &tag);
+    void removeMarkerEffects(Symbol marker, double strength);
+
+    LayoutArena *arena_;
+    std::vector<SymbolType> symbolTypes_;
+    std::vector<int32_t> rowIndex_;
+    std::vector<Row> rows_;
+    std::vector<Column> columns_;
+    std::vector<Symbol> variableSymbols_;
+    std::vector<double> values_;
+    std::vector<Tag> tags_;
+    std::vector<EditInfo> edits_;
+    std::vector<Symbol> infeasibleRows_;
+    std::vector<Symbol> redundantRows_;
+    std::vector<Symbol> introducedSymbols_;
+    Basics candidates_;
+    Cells scratch_;
+    Row objective_;
+    Row artificial_;
+    bool hasArtificial_;
+    size_t liveConstraintCount_;
+    uint64_t pivotCount_;
+};
+
+}
+
+#endif
@@ -0,0 +1,333 @@
+//
+//  CHAStackLayout.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAStackLayout.h"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace cha {
+
+namespace {
+
+const double kTolerance = 1e-9;
+
+struct AxisAttributes
+{
+    CHALayoutAttribute start;
+    CHALayoutAttribute end;
+    CHALayoutAttribute length;
+    CHALayoutAttribute crossStart;
+    CHALayoutAttribute crossEnd;
+};
+
+AxisAttributes attributesForAxis(CHAStackAxis axis)
+{
+    if (axis == CHAStackAxisVertical)
+    {
+        return AxisAttributes{CHALayoutAttributeTop, CHALayoutAttributeBottom, CHALayoutAttributeHeight,
+                              CHALayoutAttributeLeading, CHALayoutAttributeTrailing};
+    }
+    return AxisAttributes{CHALayoutAttributeLeading, CHALayoutAttributeTrailing, CHALayoutAttributeWidth,
+                          CHALayoutAttributeTop, CHALayoutAttributeBottom};
+}
+
+// The layout system resolves left/right like leading/trailing, so the recognizer does too.
+CHALayoutAttribute normalized(CHALayoutAttribute attribute)
+{
+    if (attribute == CHALayoutAttributeLeft) return CHALayoutAttributeLeading;
+    if (attribute == CHALayoutAttributeRight) return CHALayoutAttributeTrailing;
+    return attribute;
+}
+
+CHAConstraintDescriptor makeDescriptor(const void *item, CHALayoutAttribute attribute, const void *toItem,
+                                       CHALayoutAttribute toAttribute, double multiplier, double constant)
+{
+    return CHAConstraintDescriptor{item, toItem, multiplier, constant, CHALayoutPriorityRequired, attribute, toAttribute,
+                                   CHALayoutRelationEqual, 0};
+}
+
+struct Pin
+{
+    bool set;
+    double constant;
+};
+
+struct Ratio
+{
+    const void *toItem;
+    double multiplier;
+};
+
+struct StackNode
+{
+    const void *previous;
+    const void *next;
+    double spacing;
+    Pin start;
+    Pin end;
+    Pin crossStart;
+    Pin crossEnd;
+    Pin length;
+    std::vector<Ratio> ratios;
+    // Filled in while resolving lengths.
+    int component;
+    double weight;
+};
+
+bool setPin(Pin &pin, double constant)
+{
+    if (pin.set) return false;
+    pin = Pin{true, constant};
+    return true;
+}
+
+bool link(std::unordered_map<const void *, StackNode> &nodes, const void *previous, const void *next, double spacing)
+{
+    StackNode &nextNode = nodes[next];
+    StackNode &previousNode = nodes[previous];
+    if (previous == next || nextNode.previous || previousNode.next) return false;
+    nextNode.previous = previous;
+    nextNode.spacing = spacing;
+    previousNode.next = next;
+    return true;
+}
+
+bool classify(const CHAConstraintDescriptor &descriptor,
+              const void *container,
+              const AxisAttributes &axis,
+              std::unordered_map<const void *, StackNode> &nodes)
+{
+    if (descriptor.relation != CHALayoutRelationEqual || descriptor.priority < CHALayoutPriorityRequired) return false;
+    if (!descriptor.item || descriptor.item == container) return false;
+
+    const CHALayoutAttribute attribute = normalized(descriptor.attribute);
+    const CHALayoutAttribute toAttribute = normalized(descriptor.toAttribute);
+    StackNode &node = nodes[descriptor.item];
+
+    if (!descriptor.toItem || toAttribute == CHALayoutAttributeNotAnAttribute)
+    {
+        return attribute == axis.length && setPin(node.length, descriptor.constant);
+    }
+
+    if (descriptor.toItem == container)
+    {
+        if (descriptor.multiplier != 1.0 || attribute != toAttribute) return false;
+        if (attribute == axis.start) return setPin(node.start, descriptor.constant);
+        if (attribute == axis.end) return setPin(node.end, -descriptor.constant);
+        if (attribute == axis.crossStart) return setPin(node.crossStart, descriptor.constant);
+        if (attribute == axis.crossEnd) return setPin(node.crossEnd, -descriptor.constant);
+        return false;
+    }
+
+    if (attribute == axis.length && toAttribute == axis.length)
+    {
+        if (descriptor.constant != 0.0 || descriptor.multiplier == 0.0) return false;
+        node.ratios.push_back(Ratio{descriptor.toItem, descriptor.multiplier});
+        nodes[descriptor.toItem].ratios.push_back(Ratio{descriptor.item, 1.0 / descriptor.multiplier});
+        return true;
+    }
+
+    if (descriptor.multiplier != 1.0) return false;
+    // item.start = previous.end + spacing, or the same gap written from the other side as item.end = next.start - spacing.
+    if (attribute == axis.start && toAttribute == axis.end) return link(nodes, descriptor.toItem, descriptor.item, descriptor.constant);
+    if (attribute == axis.end && toAttribute == axis.start) return link(nodes, descriptor.item, descriptor.toItem, -descriptor.constant);
+    return false;
+}
+
+// Propagate weights through the length ratios. Each connected component either contains a fixed length, which fixes every
+// length in it, or is left weighted; the chain can absorb at most one weighted component.
+bool resolveLengths(std::unordered_map<const void *, StackNode> &nodes, const std::vector<const void *> &order, bool pinTrailing,
+                    std::vector<ChainItem> &items)
+{
+    std::vector<double> componentUnit;
+    std::vector<const void *> pending;
+    for (const void *root : order)
+    {
+        StackNode &rootNode = nodes[root];
+        if (rootNode.component >= 0) continue;
+
+        const int component = (int)componentUnit.size();
+        componentUnit.push_back(NAN);
+        rootNode.component = component;
+        rootNode.weight = 1.0;
+        pending.assign(1, root);
+
+        while (!pending.empty())
+        {
+            StackNode &node = nodes[pending.back()];
+            pending.pop_back();
+
+            if (node.length.set)
+            {
+                const double unit = node.length.constant / node.weight;
+                if (std::isnan(componentUnit[component])) componentUnit[component] = unit;
+                else if (std::fabs(componentUnit[component] - unit) > kTolerance * std::fmax(1.0, std::fabs(unit))) return false;
+            }
+
+            for (const Ratio &ratio : node.ratios)
+            {
+                StackNode &other = nodes[ratio.toItem];
+                const double weight = node.weight / ratio.multiplier;
+                if (other.component < 0)
+                {
+                    other.component = component;
+                    other.weight = weight;
+                    pending.push_back(ratio.toItem);
+                }
+                else if (std::fabs(other.weight - weight) > kTolerance * std::fmax(1.0, std::fabs(weight))) return false;
+            }
+        }
+    }
+
+    int weightedComponent = -1;
+    for (size_t component = 0; component < componentUnit.size(); component++)
+    {
+        if (!std::isnan(componentUnit[component])) continue;
+        if (weightedComponent >= 0 || !pinTrailing) return false;
+        weightedComponent = (int)component;
+    }
+
+    items.clear();
+    items.reserve(order.size());
+    for (const void *item : order)
+    {
+        const StackNode &node = nodes[item];
+        const double unit = componentUnit[node.component];
+        if (std::isnan(unit)) items.push_back(ChainItem{ChainSizingWeighted, node.weight, node.spacing});
+        else items.push_back(ChainItem{ChainSizingFixed, node.weight * unit, node.spacing});
+    }
+    return true;
+}
+
+bool recognizeAxis(const CHAConstraintDescriptor *descriptors, size_t count, const void *container, CHAStackAxis axis,
+                   StackLayout &stack)
+{
+    const AxisAttributes attributes = attributesForAxis(axis);
+    std::unordered_map<const void *, StackNode> nodes;
+    nodes.reserve(count / 2);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!classify(descriptors[i], container, attributes, nodes)) return false;
+    }
+    if (nodes.empty()) return false;
+
+    const void *head = nullptr;
+    for (auto &entry : nodes)
+    {
+        StackNode &node = entry.second;
+        node.component = -1;
+        if (!node.crossStart.set || !node.crossEnd.set) return false;
+        if (node.crossStart.constant != nodes.begin()->second.crossStart.constant ||
+            node.crossEnd.constant != nodes.begin()->second.crossEnd.constant) return false;
+        if ((node.start.set && node.previous) || (node.end.set && node.next)) return false;
+        if (node.start.set)
+        {
+            if (head) return false;
+            head = entry.first;
+        }
+    }
+    if (!head) return false;
+
+    std::vector<const void *> order;
+    order.reserve(nodes.size());
+    for (const void *item = head; item; item = nodes[item].next)
+    {
+        // A cycle would revisit the head, which has no predecessor, so the walk always ends.
+        order.push_back(item);
+    }
+    if (order.size() != nodes.size()) return false;
+
+    const StackNode &first = nodes[order.front()];
+    const StackNode &last = nodes[order.back()];
+    stack.axis = axis;
+    stack.chain.leadingMargin = first.start.constant;
+    stack.chain.pinTrailing = last.end.set;
+    stack.chain.trailingMargin = last.end.set ? last.end.constant : 0.0;
+    stack.crossLeadingMargin = first.crossStart.constant;
+    stack.crossTrailingMargin = first.crossEnd.constant;
+    if (!resolveLengths(nodes, order, stack.chain.pinTrailing, stack.chain.items)) return false;
+
+    stack.items.swap(order);
+    return true;
+}
+
+}
+
+void appendStackDescriptors(const StackSpec &spec,
+                            const void *container,
+                            const void *const *items,
+                            const double *weights,
+                            size_t count,
+                            std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    if (count == 0) return;
+
+    const AxisAttributes axis = attributesForAxis(spec.axis);
+    const bool vertical = spec.axis == CHAStackAxisVertical;
+    const double leadingMargin = vertical ? spec.top : spec.leading;
+    const double trailingMargin = vertical ? spec.bottom : spec.trailing;
+    const double crossLeadingMargin = vertical ? spec.leading : spec.top;
+    const double crossTrailingMargin = vertical ? spec.trailing : spec.bottom;
+    const bool pinTrailing = spec.distribution != CHAStackDistributionLeading;
+
+    descriptors.reserve(descriptors.size() + 4 * count + 1);
+    descriptors.push_back(makeDescriptor(items[0], axis.start, container, axis.start, 1, leadingMargin));
+    for (size_t i = 1; i < count; i++)
+    {
+        descriptors.push_back(makeDescriptor(items[i], axis.start, items[i - 1], axis.end, 1, spec.spacing));
+    }
+    if (pinTrailing) descriptors.push_back(makeDescriptor(items[count - 1], axis.end, container, axis.end, 1, -trailingMargin));
+
+    for (size_t i = 1; i < count; i++)
+    {
+        if (spec.distribution == CHAStackDistributionFillEqually)
+        {
+            descriptors.push_back(makeDescriptor(items[i], axis.length, items[0], axis.length, 1, 0));
+        }
+        else if (spec.distribution == CHAStackDistributionFillProportionally && weights)
+        {
+            descriptors.push_back(makeDescriptor(items[i], axis.length, items[0], axis.length, weights[i] / weights[0], 0));
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        descriptors.push_back(makeDescriptor(items[i], axis.crossStart, container, axis.crossStart, 1, crossLeadingMargin));
+        descriptors.push_back(makeDescriptor(items[i], axis.crossEnd, container, axis.crossEnd, 1, -crossTrailingMargin));
+    }
+}
+
+bool recognizeStack(const CHAConstraintDescriptor *descriptors, size_t count, const void *container, StackLayout &stack)
+{
+    return recognizeAxis(descriptors, count, container, CHAStackAxisVertical, stack) ||
+           recognizeAxis(descriptors, count, container, CHAStackAxisHorizontal, stack);
+}
+
+bool solveStack(const StackLayout &stack, double width, double height, std::vector<Frame> &frames, Frame *containerFrame)
+{
+    const bool vertical = stack.axis == CHAStackAxisVertical;
+    const double crossLength = vertical ? width : height;
+    if (crossLength < 0.0) return false;
+
+    std::vector<ChainSpan> spans;
+    double mainLength = 0.0;
+    if (solveChain(stack.chain, vertical ? height : width, spans, &mainLength) != ChainStatusOK) return false;
+
+    const double crossSpan = crossLength - stack.crossLeadingMargin - stack.crossTrailingMargin;
+    frames.resize(spans.size());
+    for (size_t i = 0; i < spans.size(); i++)
+    {
+        if (vertical) frames[i] = Frame{stack.crossLeadingMargin, spans[i].offset, crossSpan, spans[i].length};
+        else frames[i] = Frame{spans[i].offset, stack.crossLeadingMargin, spans[i].length, crossSpan};
+    }
+
+    if (containerFrame) *containerFrame = vertical ? Frame{0, 0, width, mainLength} : Frame{0, 0, mainLength, height};
+    return true;
+}
+
+}
@@ -0,0 +1,106 @@
+//
+//  CHAStackLayout.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAStackLayout_h
+#define CHAAutolayoutCategories_CHAStackLayout_h
+
+#include <stdint.h>
+
+/**
+ @description The axis views are stacked along. The raw values match UILayoutConstraintAxis.
+ */
+typedef int8_t CHAStackAxis;
+enum
+{
+    CHAStackAxisHorizontal = 0,
+    CHAStackAxisVertical = 1
+};
+
+/**
+ @description How a stack sizes its views along the axis
+ */
+typedef int8_t CHAStackDistribution;
+enum
+{
+    // Packed from the leading margin; each view's length comes from its own constraints.
+    CHAStackDistributionLeading = 0,
+    // Pinned to both margins; each view's length comes from its own constraints, except that a single unsized view absorbs
+    // the remaining space.
+    CHAStackDistributionFill,
+    // Pinned to both margins with equal lengths.
+    CHAStackDistributionFillEqually,
+    // Pinned to both margins with lengths proportional to per-view weights.
+    CHAStackDistributionFillProportionally
+};
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <vector>
+
+#include "CHAChainSolver.h"
+#include "CHAConstraintDescriptor.h"
+#include "CHALayoutSystem.h"
+
+namespace cha {
+
+struct StackSpec
+{
+    CHAStackAxis axis;
+    CHAStackDistribution distribution;
+    double spacing;
+    double top;
+    double leading;
+    double bottom;
+    double trailing;
+};
+
+/**
+ @description Append the minimal chain for a stack: one record for the leading margin, one per gap, one for the trailing
+ margin when pinned, one per view after the first for equal or proportional lengths, and two cross-axis pins per view.
+ @param weights Per-view weights for CHAStackDistributionFillProportionally; may be null otherwise
+ */
+void appendStackDescriptors(const StackSpec &spec,
+                            const void *container,
+                            const void *const *items,
+                            const double *weights,
+                            size_t count,
+                            std::vector<CHAConstraintDescriptor> &descriptors);
+
+/**
+ @description A set of descriptors recognized as a pure stack: a main-axis chain plus fixed cross-axis margins
+ */
+struct StackLayout
+{
+    CHAStackAxis axis;
+    std::vector<const void *> items;
+    Chain chain;
+    double crossLeadingMargin;
+    double crossTrailingMargin;
+};
+
+/**
+ @description Recognize descriptors, in any order, that form a pure stack in container.
+ @discussion Every record must be a required equality that belongs to the chain: container margins, item-to-item gaps,
+ fixed lengths, length ratios between items, or both cross-axis pins. Anything else, or a chain whose lengths the
+ records leave ambiguous, is rejected so the caller can fall back to the general solver.
+ */
+bool recognizeStack(const CHAConstraintDescriptor *descriptors, size_t count, const void *container, StackLayout &stack);
+
+/**
+ @description Frames for a recognized stack in a container of the given size (a negative height or width is derived)
+ @param frames Receives one frame per item of stack.items
+ @param containerFrame Receives the container's frame; may be null
+ @return false if the chain cannot be resolved without the general solver
+ */
+bool solveStack(const StackLayout &stack, double width, double height, std::vector<Frame> &frames, Frame *containerFrame = nullptr);
+
+}
+
+#endif
+
+#endif
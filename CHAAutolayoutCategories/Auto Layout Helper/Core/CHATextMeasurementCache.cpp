@@ -0,0 +1,178 @@
+//
+//  CHATextMeasurementCache.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHATextMeasurementCache.h"
+
+#include <cstring>
+#include <utility>
+
+namespace cha {
+
+// A list node (two links plus the pair) and an index node (next link, cached hash, key and iterator), plus one bucket.
+const size_t TextMeasurementCache::kEntryFootprint =
+    2 * sizeof(void *) + sizeof(std::pair<TextMeasurementKey, TextSize>) +
+    3 * sizeof(void *) + sizeof(size_t) + sizeof(TextMeasurementKey);
+
+uint64_t hashBytes(const void *bytes, size_t length, uint64_t seed)
+{
+    const unsigned char *data = static_cast<const unsigned char *>(bytes);
+    uint64_t hash = seed;
+    for (size_t index = 0; index < length; index++)
+    {
+        hash ^= data[index];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+size_t TextMeasurementKeyHash::operator()(const TextMeasurementKey &key) const
+{
+    uint64_t widthBits;
+    std::memcpy(&widthBits, &key.width, sizeof(widthBits));
+
+    uint64_t hash = key.textHash;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ key.fontHash;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ widthBits;
+    hash = hash * 0x9e3779b97f4a7c15ULL ^ key.lineLimit;
+    return std::hash<uint64_t>()(hash);
+}
+
+TextMeasurementCache::TextMeasurementCache(size_t byteBudget, TextMeasureFunction measurer)
+: measurer_(std::move(measurer)),
+  byteBudget_(byteBudget),
+  hits_(0),
+  misses_(0),
+  evictions_(0)
+{
+}
+
+TextSize TextMeasurementCache::measure(const TextMeasurementKey &key, const void *context)
+{
+    TextSize size;
+    if (find(key, &size)) return size;
+
+    size = measurer_(key, context);
+    insert(key, size);
+    return size;
+}
+
+bool TextMeasurementCache::find(const TextMeasurementKey &key, TextSize *size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = index_.find(key);
+    if (found == index_.end())
+    {
+        misses_++;
+        return false;
+    }
+
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    if (size) *size = found->second->second;
+    return true;
+}
+
+void TextMeasurementCache::insert(const TextMeasurementKey &key, const TextSize &size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertLocked(key, size);
+}
+
+void TextMeasurementCache::insertLocked(const TextMeasurementKey &key, const TextSize &size)
+{
+    if (byteBudget_ < kEntryFootprint) return;
+
+    auto found = index_.find(key);
+    if (found != index_.end())
+    {
+        found->second->second = size;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+
+    entries_.emplace_front(key, size);
+    index_[key] = entries_.begin();
+    evictLocked();
+}
+
+void TextMeasurementCache::evictLocked()
+{
+    while (!entries_.empty() && entries_.size() * kEntryFootprint > byteBudget_)
+    {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        evictions_++;
+    }
+}
+
+void TextMeasurementCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+void TextMeasurementCache::setByteBudget(size_t byteBudget)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    byteBudget_ = byteBudget;
+    evictLocked();
+}
+
+size_t TextMeasurementCache::byteBudget() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return byteBudget_;
+}
+
+size_t TextMeasurementCache::bytesInUse() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size() * kEntryFootprint;
+}
+
+size_t TextMeasurementCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t TextMeasurementCache::hitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t TextMeasurementCache::missCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+uint64_t TextMeasurementCache::evictionCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+double TextMeasurementCache::hitRate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t lookups = hits_ + misses_;
+    return lookups ? (double)hits_ / (double)lookups : 0.0;
+}
+
+void TextMeasurementCache::resetCounters()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+}
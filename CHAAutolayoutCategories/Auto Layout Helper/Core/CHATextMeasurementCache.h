@@ -0,0 +1,124 @@
+//
+//  CHATextMeasurementCache.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHATextMeasurementCache_h
+#define CHAAutolayoutCategories_CHATextMeasurementCache_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace cha {
+
+/**
+ @description 64-bit FNV-1a over raw bytes. Use it for text keys rather than NSString -hash, which only samples long strings.
+ */
+uint64_t hashBytes(const void *bytes, size_t length, uint64_t seed = 0xcbf29ce484222325ULL);
+
+/**
+ @description Identifies one measurement: the text, the font, the width it wraps at and the line limit
+ @field fontHash A hash of the font descriptor (family, size, traits), so equal fonts from different objects share entries
+ @field width The width the text wraps at; a non-positive width means unconstrained
+ @field lineLimit The maximum number of lines, or 0 for no limit
+ */
+struct TextMeasurementKey
+{
+    uint64_t textHash;
+    uint64_t fontHash;
+    double width;
+    uint32_t lineLimit;
+
+    bool operator==(const TextMeasurementKey &other) const
+    {
+        return textHash == other.textHash && fontHash == other.fontHash && width == other.width &&
+               lineLimit == other.lineLimit;
+    }
+};
+
+struct TextMeasurementKeyHash
+{
+    size_t operator()(const TextMeasurementKey &key) const;
+};
+
+struct TextSize
+{
+    double width;
+    double height;
+};
+
+/**
+ @description Measures text on a miss. context is whatever the caller passed to TextMeasurementCache::measure, e.g. the
+ attributed string the key was made from.
+ */
+typedef std::function<TextSize(const TextMeasurementKey &key, const void *context)> TextMeasureFunction;
+
+/**
+ @description A thread-safe LRU cache of text sizes held to a memory budget.
+ @discussion Every entry costs kEntryFootprint bytes, list and index nodes included, and entries are evicted least recently
+ used first once the budget is exceeded. The measurer runs outside the lock, so two threads that miss on the same key at
+ once may both measure it; the second result simply replaces the first.
+ */
+class TextMeasurementCache
+{
+public:
+    static const size_t kEntryFootprint;
+
+    TextMeasurementCache(size_t byteBudget, TextMeasureFunction measurer);
+
+    TextMeasurementCache(const TextMeasurementCache &) = delete;
+    TextMeasurementCache &operator=(const TextMeasurementCache &) = delete;
+
+    /**
+     @description The cached size for key, measuring and caching it on a miss
+     */
+    TextSize measure(const TextMeasurementKey &key, const void *context);
+    /**
+     @description The cached size without measuring. A hit marks the entry most recently used.
+     */
+    bool find(const TextMeasurementKey &key, TextSize *size);
+    void insert(const TextMeasurementKey &key, const TextSize &size);
+    void clear();
+
+    /**
+     @description Shrink or grow the budget, evicting at once if the cache is over it
+     */
+    void setByteBudget(size_t byteBudget);
+    size_t byteBudget() const;
+    size_t bytesInUse() const;
+    size_t size() const;
+
+    uint64_t hitCount() const;
+    uint64_t missCount() const;
+    uint64_t evictionCount() const;
+    /**
+     @description Hits over lookups, or 0 before the first lookup
+     */
+    double hitRate() const;
+    void resetCounters();
+
+private:
+    typedef std::list<std::pair<TextMeasurementKey, TextSize>> Entries;
+
+    void insertLocked(const TextMeasurementKey &key, const TextSize &size);
+    void evictLocked();
+
+    TextMeasureFunction measurer_;
+    size_t byteBudget_;
+    Entries entries_;
+    std::unordered_map<TextMeasurementKey, Entries::iterator, TextMeasurementKeyHash> index_;
+    mutable std::mutex mutex_;
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t evictions_;
+};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+//
+//  CHATrace.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHATrace.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CHATraceExporter.h"
+#include "CHATraceRecorder.h"
+
+namespace {
+
+const size_t kSummaryItemLimit = 10;
+
+void printTally(const char *name, const cha::TraceTally &tally)
+{
+    std::printf("  %-48s %8" PRIu64 " calls %8" PRIu64 " created %8" PRIu64 " reused %10.3f ms\n",
+                name, tally.calls, tally.created, tally.reused, tally.nanoseconds / 1e6);
+}
+
+}
+
+void CHATraceSetEnabled(bool enabled)
+{
+    cha::TraceRecorder::shared().setEnabled(enabled);
+}
+
+bool CHATraceIsEnabled(void)
+{
+    return cha::TraceRecorder::shared().enabled();
+}
+
+void CHATraceReset(void)
+{
+    cha::TraceRecorder::shared().reset();
+}
+
+CHATraceSite CHATraceSiteBegin(const char *label)
+{
+    CHATraceSite site;
+    cha::beginTraceSite(site, label);
+    return site;
+}
+
+void CHATraceSiteEnd(CHATraceSite *site)
+{
+    cha::endTraceSite(*site);
+}
+
+bool CHATraceWriteChromeJSON(const char *path)
+{
+    std::vector<cha::TraceEvent> events;
+    cha::TraceRecorder::shared().snapshot(events);
+
+    std::string json;
+    cha::writeChromeTrace(events.data(), events.size(), json);
+
+    FILE *file = std::fopen(path, "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    return std::fclose(file) == 0 && written;
+}
+
+void CHATracePrintSummary(void)
+{
+    std::vector<cha::TraceEvent> events;
+    cha::TraceRecorder::shared().snapshot(events);
+    const cha::TraceSummary summary = cha::summarizeTrace(events.data(), events.size());
+
+    std::printf("Constraint trace: %zu events, %" PRIu64 " dropped\n", events.size(), cha::TraceRecorder::shared().droppedCount());
+    printTally("total", summary.total);
+
+    std::printf("By helper\n");
+    for (const auto &helper : summary.byHelper) printTally(helper.first.c_str(), helper.second);
+
+    std::printf("By install site\n");
+    for (const auto &site : summary.bySite) printTally(site.first.c_str(), site.second);
+
+    std::vector<std::pair<const void *, cha::TraceTally>> items(summary.byItem.begin(), summary.byItem.end());
+    std::sort(items.begin(), items.end(), [](const std::pair<const void *, cha::TraceTally> &a,
+                                             const std::pair<const void *, cha::TraceTally> &b) {
+        return a.second.created + a.second.reused > b.second.created + b.second.reused;
+    });
+    if (items.size() > kSummaryItemLimit) items.resize(kSummaryItemLimit);
+
+    std::printf("Busiest views\n");
+    for (const auto &item : items)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%p", item.first);
+        printTally(name, item.second);
+    }
+}
@@ -0,0 +1,80 @@
+//
+//  CHATrace.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHATrace_h
+#define CHAAutolayoutCategories_CHATrace_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ @description Set CHA_INSTRUMENTATION=1 in the preprocessor definitions to compile the tracing hooks into the helpers.
+ Without it the hooks and CHA_TRACE_SITE expand to nothing.
+ */
+#ifndef CHA_INSTRUMENTATION
+#define CHA_INSTRUMENTATION 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ @description An open install site. Filled in by CHATraceSiteBegin; treat the fields as private.
+ */
+typedef struct CHATraceSite
+{
+    void *recorder;
+    const char *label;
+    const char *outerLabel;
+    uint64_t start;
+    uint32_t created;
+    uint32_t reused;
+} CHATraceSite;
+
+/**
+ @description Start or stop recording. Recording starts disabled even when the hooks are compiled in.
+ */
+void CHATraceSetEnabled(bool enabled);
+bool CHATraceIsEnabled(void);
+
+/**
+ @description Discard every recorded event. Do not call while other threads are creating constraints.
+ */
+void CHATraceReset(void);
+
+/**
+ @description Label every helper call made on this thread until the matching CHATraceSiteEnd
+ @param label A string that outlives the trace, normally a literal
+ */
+CHATraceSite CHATraceSiteBegin(const char *label);
+void CHATraceSiteEnd(CHATraceSite *site);
+
+/**
+ @description Write the recorded events as Chrome trace-event JSON
+ @return false if the file could not be written
+ */
+bool CHATraceWriteChromeJSON(const char *path);
+
+/**
+ @description Print constraint counts and time per helper, per install site and for the busiest views
+ */
+void CHATracePrintSummary(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if CHA_INSTRUMENTATION
+#define CHA_TRACE_SITE(label) \
+    CHATraceSite chaTraceSite __attribute__((cleanup(CHATraceSiteEnd), unused)) = CHATraceSiteBegin(label)
+#else
+#define CHA_TRACE_SITE(label)
+#endif
+
+#endif
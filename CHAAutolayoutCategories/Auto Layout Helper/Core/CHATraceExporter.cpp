@@ -0,0 +1,195 @@
+//
+//  CHATraceExporter.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHATraceExporter.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+namespace cha {
+
+namespace {
+
+void tally(TraceTally &tally, const TraceEvent &event)
+{
+    tally.calls++;
+    tally.created += event.created;
+    tally.reused += event.reused;
+    tally.nanoseconds += event.duration;
+}
+
+// Length of the well-formed UTF-8 sequence at s, or 0 if it is malformed.
+size_t utf8SequenceLength(const unsigned char *s)
+{
+    if (s[0] < 0x80) return 1;
+
+    size_t length;
+    uint32_t minimum;
+    if ((s[0] & 0xE0) == 0xC0) { length = 2; minimum = 0x80; }
+    else if ((s[0] & 0xF0) == 0xE0) { length = 3; minimum = 0x800; }
+    else if ((s[0] & 0xF8) == 0xF0) { length = 4; minimum = 0x10000; }
+    else return 0;
+
+    uint32_t codePoint = s[0] & (0x7F >> length);
+    for (size_t i = 1; i < length; i++)
+    {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        codePoint = (codePoint << 6) | (s[i] & 0x3F);
+    }
+    if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) return 0;
+    return length;
+}
+
+void appendMicroseconds(uint64_t nanoseconds, std::string &out)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%" PRIu64 ".%03u", nanoseconds / 1000, (unsigned)(nanoseconds % 1000));
+    out += buffer;
+}
+
+void appendUnsigned(uint64_t value, std::string &out)
+{
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+    out += buffer;
+}
+
+void appendPointer(const void *pointer, std::string &out)
+{
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "\"0x%" PRIxPTR "\"", (uintptr_t)pointer);
+    out += buffer;
+}
+
+}
+
+TraceSummary summarizeTrace(const TraceEvent *events, size_t count)
+{
+    TraceSummary summary = {};
+    for (size_t i = 0; i < count; i++)
+    {
+        const TraceEvent &event = events[i];
+        if (event.kind == TraceEventSite)
+        {
+            tally(summary.bySite[event.name ? event.name : ""], event);
+            continue;
+        }
+
+        tally(summary.total, event);
+        tally(summary.byHelper[event.name ? event.name : ""], event);
+        tally(summary.byItem[event.item], event);
+    }
+    return summary;
+}
+
+void appendJSONString(const char *s, std::string &out)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(s ? s : "");
+    while (*p)
+    {
+        const unsigned char c = *p;
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += (char)c;
+            p++;
+        }
+        else if (c < 0x20)
+        {
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xF];
+            p++;
+        }
+        else
+        {
+            const size_t length = utf8SequenceLength(p);
+            if (length == 0)
+            {
+                out += "\\ufffd";
+                p++;
+            }
+            else
+            {
+                out.append(reinterpret_cast<const char *>(p), length);
+                p += length;
+            }
+        }
+    }
+    out += '"';
+}
+
+void writeChromeTrace(const TraceEvent *events, size_t count, std::string &out)
+{
+    // Counter samples must be in time order for the running totals to make sense.
+    std::vector<const TraceEvent *> helpers;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (events[i].kind == TraceEventHelper) helpers.push_back(&events[i]);
+    }
+    std::sort(helpers.begin(), helpers.end(), [](const TraceEvent *a, const TraceEvent *b) {
+        return a->start + a->duration < b->start + b->duration;
+    });
+
+    out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        const TraceEvent &event = events[i];
+        out += first ? "\n" : ",\n";
+        first = false;
+
+        out += "{\"name\":";
+        appendJSONString(event.name, out);
+        out += event.kind == TraceEventSite ? ",\"cat\":\"site\"" : ",\"cat\":\"helper\"";
+        out += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        appendUnsigned(event.thread, out);
+        out += ",\"ts\":";
+        appendMicroseconds(event.start, out);
+        out += ",\"dur\":";
+        appendMicroseconds(event.duration, out);
+        out += ",\"args\":{\"created\":";
+        appendUnsigned(event.created, out);
+        out += ",\"reused\":";
+        appendUnsigned(event.reused, out);
+        if (event.item)
+        {
+            out += ",\"view\":";
+            appendPointer(event.item, out);
+        }
+        if (event.site && event.kind == TraceEventHelper)
+        {
+            out += ",\"site\":";
+            appendJSONString(event.site, out);
+        }
+        out += "}}";
+    }
+
+    uint64_t created = 0, reused = 0;
+    for (const TraceEvent *event : helpers)
+    {
+        created += event->created;
+        reused += event->reused;
+        out += first ? "\n" : ",\n";
+        first = false;
+
+        out += "{\"name\":\"constraints\",\"ph\":\"C\",\"pid\":1,\"ts\":";
+        appendMicroseconds(event->start + event->duration, out);
+        out += ",\"args\":{\"created\":";
+        appendUnsigned(created, out);
+        out += ",\"reused\":";
+        appendUnsigned(reused, out);
+        out += "}}";
+    }
+    out += "\n]}\n";
+}
+
+}
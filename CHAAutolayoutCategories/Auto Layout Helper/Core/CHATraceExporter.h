@@ -0,0 +1,56 @@
+//
+//  CHATraceExporter.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHATraceExporter_h
+#define CHAAutolayoutCategories_CHATraceExporter_h
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "CHATraceRecorder.h"
+
+namespace cha {
+
+struct TraceTally
+{
+    uint64_t calls;
+    uint64_t created;
+    uint64_t reused;
+    uint64_t nanoseconds;
+};
+
+/**
+ @description Recorded helper calls grouped three ways. Reused constraints are requests that duplicated a live constraint.
+ */
+struct TraceSummary
+{
+    TraceTally total;
+    std::map<std::string, TraceTally> byHelper;
+    std::map<std::string, TraceTally> bySite;
+    std::map<const void *, TraceTally> byItem;
+};
+
+TraceSummary summarizeTrace(const TraceEvent *events, size_t count);
+
+/**
+ @description Write events in the Chrome trace-event JSON format, loadable in chrome://tracing and Perfetto.
+ @discussion Helper and site spans become complete ("X") events with their counts in args, and a counter ("C") track
+ follows the running totals of created and reused constraints. Names are escaped and invalid UTF-8 is replaced, so any
+ byte string produces valid JSON.
+ */
+void writeChromeTrace(const TraceEvent *events, size_t count, std::string &out);
+
+/**
+ @description Append s to out as a quoted JSON string
+ */
+void appendJSONString(const char *s, std::string &out);
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+//
+//  CHATraceRecorder.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHATraceRecorder.h"
+
+#include <chrono>
+
+namespace cha {
+
+namespace {
+
+const size_t kSharedCapacity = 1 << 16;
+
+uint64_t steadyNanoseconds()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ThreadTraceState
+{
+    uint32_t depth;
+    const char *helper;
+    const void *item;
+    const char *site;
+    uint32_t created;
+    uint32_t reused;
+    uint32_t totalCreated;
+    uint32_t totalReused;
+};
+
+thread_local ThreadTraceState threadState = {0, nullptr, nullptr, nullptr, 0, 0, 0, 0};
+
+}
+
+TraceRecorder::TraceRecorder(size_t capacity)
+: capacity_(capacity),
+  slots_(new Slot[capacity]),
+  next_(0),
+  generation_(1),
+  dropped_(0),
+  enabled_(false),
+  epoch_(steadyNanoseconds())
+{
+    for (size_t i = 0; i < capacity_; i++) slots_[i].generation.store(0, std::memory_order_relaxed);
+}
+
+TraceRecorder &TraceRecorder::shared()
+{
+    static TraceRecorder recorder(kSharedCapacity);
+    return recorder;
+}
+
+uint64_t TraceRecorder::now() const
+{
+    return steadyNanoseconds() - epoch_;
+}
+
+uint32_t TraceRecorder::currentThread()
+{
+    static std::atomic<uint32_t> nextThread(1);
+    thread_local uint32_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return thread;
+}
+
+bool TraceRecorder::record(const TraceEvent &event)
+{
+    const size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= capacity_)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot &slot = slots_[index];
+    slot.event = event;
+    slot.generation.store(generation_.load(std::memory_order_relaxed), std::memory_order_release);
+    return true;
+}
+
+size_t TraceRecorder::snapshot(std::vector<TraceEvent> &events) const
+{
+    const uint32_t generation = generation_.load(std::memory_order_relaxed);
+    size_t end = next_.load(std::memory_order_acquire);
+    if (end > capacity_) end = capacity_;
+
+    size_t appended = 0;
+    for (size_t i = 0; i < end; i++)
+    {
+        // A claimed slot whose writer has not published yet is skipped rather than waited for.
+        if (slots_[i].generation.load(std::memory_order_acquire) != generation) continue;
+        events.push_back(slots_[i].event);
+        appended++;
+    }
+    return appended;
+}
+
+void TraceRecorder::reset()
+{
+    // Bumping the generation invalidates every published slot without touching them.
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    next_.store(0, std::memory_order_release);
+    dropped_.store(0, std::memory_order_relaxed);
+}
+
+HelperTraceScope::HelperTraceScope(const char *name, const void *item, TraceRecorder &recorder)
+: recorder_(nullptr),
+  name_(name),
+  start_(0),
+  entered_(false)
+{
+    if (!recorder.enabled()) return;
+
+    entered_ = true;
+    if (threadState.depth++ > 0) return;
+
+    recorder_ = &recorder;
+    threadState.helper = name;
+    threadState.item = item;
+    threadState.created = 0;
+    threadState.reused = 0;
+    start_ = recorder.now();
+}
+
+HelperTraceScope::~HelperTraceScope()
+{
+    if (!entered_) return;
+
+    threadState.depth--;
+    if (!recorder_) return;
+    threadState.helper = nullptr;
+
+    TraceEvent event = {name_, threadState.site, threadState.item, start_, recorder_->now() - start_,
+                        TraceRecorder::currentThread(), threadState.created, threadState.reused, TraceEventHelper};
+    recorder_->record(event);
+}
+
+const char *HelperTraceScope::currentHelper()
+{
+    return threadState.depth > 0 ? threadState.helper : nullptr;
+}
+
+const char *HelperTraceScope::currentSite()
+{
+    return threadState.site;
+}
+
+void HelperTraceScope::noteConstraint(bool created, const void *item)
+{
+    if (threadState.depth == 0) return;
+
+    if (!threadState.item) threadState.item = item;
+    if (created)
+    {
+        threadState.created++;
+        threadState.totalCreated++;
+    }
+    else
+    {
+        threadState.reused++;
+        threadState.totalReused++;
+    }
+}
+
+void beginTraceSite(CHATraceSite &site, const char *label, TraceRecorder &recorder)
+{
+    site.recorder = nullptr;
+    site.label = label;
+    if (!recorder.enabled()) return;
+
+    site.recorder = &recorder;
+    site.outerLabel = threadState.site;
+    site.created = threadState.totalCreated;
+    site.reused = threadState.totalReused;
+    site.start = recorder.now();
+    threadState.site = label;
+}
+
+void endTraceSite(CHATraceSite &site)
+{
+    TraceRecorder *recorder = static_cast<TraceRecorder *>(site.recorder);
+    if (!recorder) return;
+
+    threadState.site = site.outerLabel;
+    TraceEvent event = {site.label, site.label, nullptr, site.start, recorder->now() - site.start,
+                        TraceRecorder::currentThread(), threadState.totalCreated - site.created,
+                        threadState.totalReused - site.reused, TraceEventSite};
+    recorder->record(event);
+}
+
+}
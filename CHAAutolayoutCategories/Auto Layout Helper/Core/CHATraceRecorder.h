@@ -0,0 +1,169 @@
+//
+//  CHATraceRecorder.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHATraceRecorder_h
+#define CHAAutolayoutCategories_CHATraceRecorder_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CHATrace.h"
+
+namespace cha {
+
+enum TraceEventKind : uint8_t
+{
+    // One outermost helper call; nested helper calls are folded into it.
+    TraceEventHelper = 0,
+    // A labelled install site such as -setupConstraints, spanning every helper call made inside it.
+    TraceEventSite
+};
+
+/**
+ @description One recorded span. Strings must outlive the recorder, e.g. selector names or string literals.
+ */
+struct TraceEvent
+{
+    const char *name;
+    const char *site;
+    const void *item;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t thread;
+    uint32_t created;
+    uint32_t reused;
+    TraceEventKind kind;
+};
+
+/**
+ @description A fixed-capacity, lock-free event log.
+ @discussion Writers claim a slot with one atomic increment and publish it with a release store, so recording never blocks
+ and never allocates. Once the log is full further events are counted as dropped. Readers take a snapshot of the published
+ slots at any time; reset() must not race with writers.
+ */
+class TraceRecorder
+{
+public:
+    explicit TraceRecorder(size_t capacity);
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    /**
+     @description The process-wide recorder the category reports into
+     */
+    static TraceRecorder &shared();
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     @return Nanoseconds since the recorder was created
+     */
+    uint64_t now() const;
+
+    /**
+     @description A small, stable number for the calling thread
+     */
+    static uint32_t currentThread();
+
+    /**
+     @return false if the log was full and the event was dropped
+     */
+    bool record(const TraceEvent &event);
+
+    /**
+     @description Append every published event to events
+     @return The number of events appended
+     */
+    size_t snapshot(std::vector<TraceEvent> &events) const;
+
+    void reset();
+
+    size_t capacity() const { return capacity_; }
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> generation;
+        TraceEvent event;
+    };
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> next_;
+    std::atomic<uint32_t> generation_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<bool> enabled_;
+    uint64_t epoch_;
+};
+
+/**
+ @description Times one helper call on the current thread. Only the outermost scope records; constraints noted while any
+ scope is open are attributed to it. Does nothing when the recorder is disabled.
+ */
+class HelperTraceScope
+{
+public:
+    HelperTraceScope(const char *name, const void *item, TraceRecorder &recorder = TraceRecorder::shared());
+    ~HelperTraceScope();
+
+    HelperTraceScope(const HelperTraceScope &) = delete;
+    HelperTraceScope &operator=(const HelperTraceScope &) = delete;
+
+    /**
+     @description Attribute a created or reused constraint to the innermost open scope on this thread
+     */
+    static void noteConstraint(bool created, const void *item);
+
+    /**
+     @description The outermost helper and the innermost site open on this thread, or null. Both are only tracked while
+     the recorder is enabled.
+     */
+    static const char *currentHelper();
+    static const char *currentSite();
+
+private:
+    TraceRecorder *recorder_;
+    const char *name_;
+    uint64_t start_;
+    bool entered_;
+};
+
+/**
+ @description Open and close an install site on the current thread. Sites nest; helper calls are attributed to the
+ innermost one, and the site's own span counts every constraint created or reused while it was open.
+ */
+void beginTraceSite(CHATraceSite &site, const char *label, TraceRecorder &recorder = TraceRecorder::shared());
+void endTraceSite(CHATraceSite &site);
+
+/**
+ @description Labels the helper calls made on the current thread until it goes out of scope
+ */
+class SiteTraceScope
+{
+public:
+    explicit SiteTraceScope(const char *label, TraceRecorder &recorder = TraceRecorder::shared())
+    {
+        beginTraceSite(site_, label, recorder);
+    }
+    ~SiteTraceScope() { endTraceSite(site_); }
+
+    SiteTraceScope(const SiteTraceScope &) = delete;
+    SiteTraceScope &operator=(const SiteTraceScope &) = delete;
+
+private:
+    CHATraceSite site_;
+};
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+//
+//  CHAWorkerPool.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAWorkerPool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace cha {
+
+WorkerPool::WorkerPool(size_t threadCount)
+: queued_(0),
+  unfinished_(0),
+  stopping_(false),
+  nextQueue_(0),
+  steals_(0)
+{
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    queues_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) queues_.emplace_back(new Queue());
+
+    threads_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) threads_.emplace_back(&WorkerPool::run, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+    for (std::thread &thread : threads_) thread.join();
+}
+
+size_t WorkerPool::currentWorker() const
+{
+    // Thread-local storage needs iOS 9, so look the thread up instead; pools are a handful of threads.
+    const std::thread::id current = std::this_thread::get_id();
+    for (size_t i = 0; i < threads_.size(); i++)
+    {
+        if (threads_[i].get_id() == current) return i;
+    }
+    return threads_.size();
+}
+
+void WorkerPool::submit(Task task)
+{
+    size_t index = currentWorker();
+    if (index == threads_.size()) index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_++;
+        unfinished_++;
+    }
+    available_.notify_one();
+}
+
+void WorkerPool::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return unfinished_ == 0; });
+}
+
+bool WorkerPool::take(size_t index, Task &task)
+{
+    {
+        Queue &own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues_.size(); offset++)
+    {
+        Queue &victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::run(size_t index)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (queued_ == 0) return;
+        }
+
+        // Another worker woken for the same task may have taken it first; coming back empty simply waits again.
+        Task task;
+        if (!take(index, task)) continue;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_--;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            unfinished_--;
+            if (unfinished_ == 0) idle_.notify_all();
+        }
+    }
+}
+
+}
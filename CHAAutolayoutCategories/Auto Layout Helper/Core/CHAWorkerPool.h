@@ -0,0 +1,82 @@
+//
+//  CHAWorkerPool.h
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#ifndef CHAAutolayoutCategories_CHAWorkerPool_h
+#define CHAAutolayoutCategories_CHAWorkerPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cha {
+
+/**
+ @description A fixed set of worker threads, each with its own deque of tasks, that steal from one another when idle.
+ @discussion A task submitted from a worker goes on the back of that worker's deque and is taken back last-in, first-out, so
+ a task that fans out into subtasks keeps its working set warm; idle workers steal from the front of the other deques.
+ Tasks submitted from any other thread are dealt round-robin across the workers.
+ */
+class WorkerPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     @param threadCount Number of workers; 0 uses the hardware concurrency
+     */
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void submit(Task task);
+
+    /**
+     @description Block until every submitted task has finished, including tasks submitted by tasks
+     */
+    void waitUntilIdle();
+
+    size_t threadCount() const { return threads_.size(); }
+    /**
+     @description How many tasks were taken from another worker's deque
+     */
+    uint64_t stealCount() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+    bool take(size_t index, Task &task);
+    size_t currentWorker() const;
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::condition_variable idle_;
+    size_t queued_;
+    size_t unfinished_;
+    bool stopping_;
+    std::atomic<size_t> nextQueue_;
+    std::atomic<uint64_t> steals_;
+};
+
+}
+
+#endif
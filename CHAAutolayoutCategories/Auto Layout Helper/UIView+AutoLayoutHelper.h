@@ -6,6 +6,35 @@
 //
 
 #import <UIKit/UIKit.h>
+#import "CHAConstraintDescriptor.h"
+#import "CHAConstraintEditHandle.h"
+#import "CHAGridLayout.h"
+#import "CHAStackLayout.h"
+#import "CHATrace.h"
+
+/**
+ @description Set CHA_CONSTRAINT_ANALYSIS=1 or 0 in the preprocessor definitions to turn the analysis in +activateConstraints:inContainer: on or off. It is on in DEBUG builds by default.
+ */
+#ifndef CHA_CONSTRAINT_ANALYSIS
+#if defined(DEBUG) && DEBUG
+#define CHA_CONSTRAINT_ANALYSIS 1
+#else
+#define CHA_CONSTRAINT_ANALYSIS 0
+#endif
+#endif
+
+/**
+ @description Running totals kept by the constraint registry
+ @field created Constraints that had no live match and were newly created
+ @field reused Requests answered with an existing constraint
+ @field updated The subset of reused requests whose constant was changed in place
+ */
+typedef struct CHAConstraintRegistryCounters
+{
+    NSUInteger created;
+    NSUInteger reused;
+    NSUInteger updated;
+} CHAConstraintRegistryCounters;
 
 @interface UIView (AutoLayoutHelper)
  
@@ -123,10 +152,18 @@
  @description Pin the receiving view's edges equally to the superview's corresponding edges
  @param viewSides An array of NSLayoutAttribute's as NSNumbers 
  @param constant CGFloat representation of the distance between the intended view's NSLayoutAttribute's and the superview's NSLayoutAttribute's
- @return An array of constraint items that relates the receiving view's NSLayoutAttribute's with the superview's NSLayoutAttribute's
+ @return An array of constraint items that relates the receiving view's NSLayoutAttribute's with the superview's NSLayoutAttribute's, one per side in the order given
  */
 - (NSArray *)pinSides:(NSArray *)viewSides
              constant:(CGFloat)constant;
+/**
+ @description Pin the receiving view's edges equally to the superview's corresponding edges without boxing each edge
+ @param edges A bitmask of CHAEdgeMask values
+ @param constant CGFloat representation of the distance between the receiving view's edges and the superview's edges. Bottom and trailing edges are inset by the same amount.
+ @return An array of constraint items ordered top, bottom, leading, trailing, left, right
+ */
+- (NSArray *)pinEdges:(CHAEdgeMask)edges
+             constant:(CGFloat)constant;
 
 /**
  @description Pin the receiving view's NSLayoutAttribute to second view's selected NSLayoutAttribute
@@ -310,6 +347,17 @@
  @return A constraint item defining a view's percent-based height
  */
 - (NSLayoutConstraint *)height:(NSLayoutRelation)constraintRelation multiplier:(CGFloat)multiplier;
+/**
+ @description Set a view's height to the height of text wrapped at a width, measured through the shared CHATextMeasurer
+ @discussion Identical text at an identical width is measured once, however often the constraint is rebuilt. For a
+ UITextView the text container's insets and line fragment padding are taken into account.
+ @param text The text the view shows
+ @param font The font the text is drawn in
+ @param width The view's width, or 0 for a single unbounded line
+ @param lineLimit The maximum number of lines, or 0 for no limit
+ @return A constraint item defining a view's constant height in points
+ */
+- (NSLayoutConstraint *)heightForText:(NSString *)text font:(UIFont *)font width:(CGFloat)width lineLimit:(NSUInteger)lineLimit;
 
 /**
  @description Set the receiving view's width equal to its superview's width
@@ -378,22 +426,36 @@
                multiplier:(CGFloat)multiplier;
 
 /**
- @description Set a view's width proportional to a specified height
+ @description Set a view's width proportional to a specified height, against the view's intrinsic width
  @param height The height that determines a view's width
- @return A constraint item that relates a view's width to its height
+ @return A constraint item that relates a view's width to its height, or nil while the view has no intrinsic width
  */
 - (NSLayoutConstraint *)proportionalWidthForHeight:(CGFloat)height;
 /**
- @description Set a view's height proportional to a specified width
+ @description Set a view's height proportional to a specified width, against the view's intrinsic height
  @param height The width that determines a view's height
- @return A constraint item that relates a view's height to its width
+ @return A constraint item that relates a view's height to its width, or nil while the view has no intrinsic height
  */
 - (NSLayoutConstraint *)proportionalHeightForWidth:(CGFloat)width;
 /**
- @description Set a relationship between a view's width and height
- @return A constraint item that relates a view's width and height
+ @description Keep a view's width and height at the ratio of its intrinsic content size, e.g. the image of a UIImageView
+ @discussion The ratio never comes from the current frame, so there is no need to lay out first. A view without an intrinsic
+ content size yet has no ratio to keep; call again once its content is set.
+ @return A constraint item that relates a view's width and height, or nil while the view has no intrinsic content size
  */
 - (NSLayoutConstraint *)aspectRatio;
+/**
+ @description Keep a view's width and height at a declared ratio
+ @param ratio Width divided by height, e.g. 16.f/9.f
+ @return A constraint item that relates a view's width and height
+ */
+- (NSLayoutConstraint *)aspectRatio:(CGFloat)ratio;
+/**
+ @description Keep a view's width and height at the ratio of an image it will show, before the image is set
+ @param imageSize The image's size, e.g. from the metadata of an image that is still loading
+ @return A constraint item that relates a view's width and height, or nil for a zero size
+ */
+- (NSLayoutConstraint *)aspectRatioForImageSize:(CGSize)imageSize;
 
 #pragma mark - View Grouping
 /**
@@ -416,17 +478,186 @@
             superviewMargin:(CGFloat)outerEdgeMargin
            interViewSpacing:(CGFloat)viewMargin;
 
+/**
+ @description Stack any number of subviews along an axis of the receiver, pinned to its edges with margins of 0 and filling the receiver
+ @param views An ordered collection of the receiver's subviews
+ @param axis The axis to stack along
+ @param spacing A CGFloat that represents the distance between neighbouring views
+ @return An array of constraints that represents the stack
+ */
+- (NSArray *)stackViews:(NSArray *)views
+                   axis:(UILayoutConstraintAxis)axis
+                spacing:(CGFloat)spacing;
 
+/**
+ @description Stack any number of subviews along an axis of the receiver with the minimal chain of constraints: one per margin, one per gap, one per view for its length when the distribution sets it, and two cross-axis pins per view
+ @discussion A stack built this way is recognized by the layout precomputer and solved in a single linear pass instead of by the general solver.
+ @param views An ordered collection of the receiver's subviews
+ @param axis The axis to stack along
+ @param spacing A CGFloat that represents the distance between neighbouring views
+ @param margins The insets between the views and the receiver's edges
+ @param distribution How the views are sized along the axis. CHAStackDistributionFillProportionally weighs each view by its intrinsic content size along the axis.
+ @return An array of constraints that represents the stack
+ */
+- (NSArray *)stackViews:(NSArray *)views
+                   axis:(UILayoutConstraintAxis)axis
+                spacing:(CGFloat)spacing
+                margins:(UIEdgeInsets)margins
+           distribution:(CHAStackDistribution)distribution;
 
+#pragma mark - Grid Layout
+/**
+ @description Lay subviews out in a grid of square cells inside the receiver's bounds
+ @param views The receiver's subviews, filled row by row
+ @param columns The number of columns
+ @param spacing A CGFloat that represents the distance between neighbouring cells in both directions
+ @param edgeInsets The insets between the grid and the receiver's edges
+ @return The height the grid occupies, including its top and bottom insets
+ */
+- (CGFloat)layoutGridViews:(NSArray *)views
+                   columns:(NSUInteger)columns
+                   spacing:(CGFloat)spacing
+                    insets:(UIEdgeInsets)edgeInsets;
 
+/**
+ @description Set the frames of subviews arranged as a grid inside the receiver's bounds in a single pass, instead of relating every view to a reference view with -equalWidths: and -equalHeights:
+ @discussion Frames are computed in closed form and written with vector stores where the build targets them. Call from -layoutSubviews; views laid out this way should not also carry active constraints.
+ @param views The receiver's subviews, filled row by row
+ @param spec Track counts, weights, spacing and insets of the grid
+ @return The height the grid occupies, including its top and bottom insets
+ */
+- (CGFloat)layoutGridViews:(NSArray *)views spec:(CHAGridSpec)spec;
 
+#pragma mark - Constraint Registry
+/**
+ @description Every helper creates its constraints through this method. A constraint is registered on its first item under (second item, first attribute, second attribute, relation); a repeat request with the same key, multiplier and priority returns the live constraint and updates its constant in place instead of creating a duplicate.
+ @discussion The registry holds constraints weakly, so a constraint that was never installed or was released by its owner is created again on the next request.
+ @return A new or previously registered constraint item
+ */
++ (NSLayoutConstraint *)registeredConstraintWithItem:(id)firstItem
+                                           attribute:(NSLayoutAttribute)firstAttribute
+                                           relatedBy:(NSLayoutRelation)relation
+                                              toItem:(id)secondItem
+                                           attribute:(NSLayoutAttribute)secondAttribute
+                                          multiplier:(CGFloat)multiplier
+                                            constant:(CGFloat)constant;
+/**
+ @description As above, at the given priority. A registered constraint that is active is only reused at the priority it already has, since UIKit cannot move an installed constraint between required and optional; otherwise a new constraint replaces it in the registry. An inactive one is reused and takes the priority.
+ @return A new or previously registered constraint item at the requested priority
+ */
++ (NSLayoutConstraint *)registeredConstraintWithItem:(id)firstItem
+                                           attribute:(NSLayoutAttribute)firstAttribute
+                                           relatedBy:(NSLayoutRelation)relation
+                                              toItem:(id)secondItem
+                                           attribute:(NSLayoutAttribute)secondAttribute
+                                          multiplier:(CGFloat)multiplier
+                                            constant:(CGFloat)constant
+                                            priority:(UILayoutPriority)priority;
+/**
+ @description Created, reused and updated totals since launch or the last reset
+ */
++ (CHAConstraintRegistryCounters)constraintRegistryCounters;
+/**
+ @description Zero the registry counters
+ */
++ (void)resetConstraintRegistryCounters;
+
+#pragma mark - Batch Descriptors
+/**
+ @description Materialize every record of a descriptor batch as a constraint in a single pass
+ @param batch A batch whose items are UIView's (or layout guides) bridged to const void *
+ @return An array of constraint items in the same order as the batch's records
+ */
++ (NSArray *)constraintsWithDescriptorBatch:(const CHADescriptorBatch *)batch;
+/**
+ @description Materialize a run of descriptor records of any length, for callers that collect more than one batch holds
+ @param records Records whose items are UIView's (or layout guides) bridged to const void *
+ @param count The number of records
+ @return An array of constraint items in the same order as the records
+ */
++ (NSArray *)constraintsWithDescriptors:(const CHAConstraintDescriptor *)records count:(NSUInteger)count;
+
+#pragma mark - Constraint Diffing
+/**
+ @description Turn a set of constraints into the set described by a descriptor array, touching only what changed
+ @discussion Old constraints are matched to records by items, attributes, relation and multiplier. Matches keep their constraint and only have a changed constant or priority written; unmatched old constraints are deactivated and unmatched records created, in one batched deactivate/activate. A priority change across required is applied while the constraint is briefly deactivated, as UIKit requires.
+ @param oldConstraints The constraints that describe the current layout, such as the array returned by the previous call
+ @param descriptors Records whose items are UIView's (or layout guides) bridged to const void *
+ @param count The number of records
+ @return The active constraints of the new set, in the same order as the records
+ */
++ (NSArray *)updateConstraints:(NSArray *)oldConstraints
+                 toDescriptors:(const CHAConstraintDescriptor *)descriptors
+                         count:(NSUInteger)count;
+
+/**
+ @description Turn a set of constraints into the set described by a descriptor batch, touching only what changed
+ @param oldConstraints The constraints that describe the current layout, such as the array returned by the previous call
+ @param batch A batch whose items are UIView's (or layout guides) bridged to const void *
+ @return The active constraints of the new set, in the same order as the batch's records
+ */
++ (NSArray *)updateConstraints:(NSArray *)oldConstraints toDescriptorBatch:(const CHADescriptorBatch *)batch;
+
+#pragma mark - Constraint Analysis
+/**
+ @description Check a constraint set for required conflicts, redundant required equalities and ambiguous items before it is installed
+ @discussion Views are named by their accessibilityIdentifier when they have one. With CHA_INSTRUMENTATION=1 every constraint a helper creates carries the helper call (and install site) that made it in its identifier, and each issue names it.
+ @param constraints The constraints to check, not yet active
+ @param container The view the constraints lay out within. Its size is held fixed when it has been laid out and left to the constraints otherwise.
+ @return One line per issue; an empty array if the set is sound
+ */
++ (NSArray *)analyzeConstraints:(NSArray *)constraints inContainer:(UIView *)container;
+
+/**
+ @description A text recording of a constraint set that the cha_analyze tool can check off the device
+ @param constraints The constraints to record
+ @param container The view the constraints lay out within
+ @return The recording text
+ */
++ (NSString *)recordingForConstraints:(NSArray *)constraints inContainer:(UIView *)container;
 
+/**
+ @description Activate a constraint set in a single call, analyzing it first when CHA_CONSTRAINT_ANALYSIS is set
+ @discussion CHA_CONSTRAINT_ANALYSIS defaults to on in DEBUG builds. Issues are logged and a conflict asserts, so it is caught before UIKit breaks a constraint at runtime.
+ @param constraints The constraints to activate
+ @param container The view the constraints lay out within
+ */
++ (void)activateConstraints:(NSArray *)constraints inContainer:(UIView *)container;
 
+#pragma mark - Edit Handles
+/**
+ @description A handle for animating the constant of a constraint made by one of the helpers, such as the margin from pinLeading: or the spacing from stackAboveView:superviewMargin:interViewSpacing:, without removing or recreating it
+ @param constraint A constraint with the receiver as one of its items
+ @return A handle whose suggested values are written to the constraint's constant
+ */
+- (CHAConstraintEditHandle *)editHandleForConstraint:(NSLayoutConstraint *)constraint;
+
+#pragma mark - Compiled Layouts
+/**
+ @description Compile a constraint set into a compact binary layout that can be saved, shipped in the bundle, and loaded later without building the constraints again helper by helper
+ @discussion Views are stored as slots: slot 0 is the container and slot i + 1 is views[i]. Slots are named by their view's accessibilityIdentifier, so the cha_layoutc tool can print and check the layout off the device. Margin attributes cannot be compiled.
+ @param constraints The constraints to compile, relating only the container and the views
+ @param container The view the constraints lay out within
+ @param views The views the constraints lay out
+ @return The compiled layout, or nil if any constraint relates other views or uses a margin attribute, so that a partial layout is never written
+ */
++ (NSData *)compiledLayoutWithConstraints:(NSArray *)constraints container:(UIView *)container views:(NSArray *)views;
+
+/**
+ @description Create the constraints of a compiled layout for a container and its views in a single pass
+ @discussion The layout is validated before anything is read from it. Load it with NSDataReadingMappedIfSafe so that it is read in place from the file rather than copied into memory. Constraints are created through the constraint registry, as every helper's are.
+ @param layout A layout from compiledLayoutWithConstraints:container:views:
+ @param container The view to take slot 0
+ @param views The views to take the remaining slots, in the order they were compiled
+ @return The constraints, not yet active, in the order they were compiled; nil when the layout is damaged, from an unsupported version, or compiled for a different number of views
+ */
++ (NSArray *)constraintsWithCompiledLayout:(NSData *)layout container:(UIView *)container views:(NSArray *)views;
 
 #pragma mark - Remove Superviews
 /**
- @description Remove constraints from the receiving view's superview for a collection of views
- @param views A collection of views whose constraints should be removed from the recipient's superviews
+ @description Remove the constraints that reference any of a collection of views: every helper-created one, on whichever ancestor it is installed, and every other one installed on a view's superview
+ @discussion Helper-created constraints are looked up in an ownership index maintained when they are created, so finding them costs only the number removed. Constraints added by hand or in a storyboard are not in the index, so each distinct superview's constraints are also scanned once for them.
+ @param views A collection of views whose constraints should be removed
  */
 - (void)removeSuperviewConstraintsForViews:(NSArray *)views;
 
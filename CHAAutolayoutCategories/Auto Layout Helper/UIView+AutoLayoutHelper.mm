@@ -0,0 +1,1546 @@
+//
+//  UIView+AutoLayoutHelper.mm
+//  ScrollViewMap
+//
+//  Created by Michael Thongvanh on 3/25/15.
+//  Copyright (c) 2015 Chisel Apps. All rights reserved.
+//
+
+#import "UIView+AutoLayoutHelper.h"
+#import <objc/runtime.h>
+#import "CHATextMeasurer.h"
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "CHAAspectRatio.h"
+#include "CHACompiledLayout.h"
+#include "CHAConstraintAnalyzer.h"
+#include "CHAConstraintDiff.h"
+#include "CHAConstraintOwnershipIndex.h"
+#include "CHAConstraintRecording.h"
+#include "CHATraceRecorder.h"
+
+#if CHA_INSTRUMENTATION
+// Times the outermost helper on the stack and attributes the constraints it creates or reuses to it.
+#define CHA_TRACE_HELPER(item) cha::HelperTraceScope chaHelperTrace(sel_getName(_cmd), (__bridge const void *)(item))
+#define CHA_TRACE_CONSTRAINT(created, item) cha::HelperTraceScope::noteConstraint((created), (__bridge const void *)(item))
+#else
+#define CHA_TRACE_HELPER(item)
+#define CHA_TRACE_CONSTRAINT(created, item)
+#endif
+
+static const void *CHAConstraintRegistryAssociationKey = &CHAConstraintRegistryAssociationKey;
+static const void *CHAConstraintOwnershipAssociationKey = &CHAConstraintOwnershipAssociationKey;
+static CHAConstraintRegistryCounters CHARegistryCounters;
+
+typedef struct CHAConstraintRegistryKey
+{
+    const void *secondItem;
+    NSInteger firstAttribute;
+    NSInteger secondAttribute;
+    NSInteger relation;
+} CHAConstraintRegistryKey;
+
+static cha::ConstraintOwnershipIndex &CHAOwnershipIndex()
+{
+    static cha::ConstraintOwnershipIndex ownershipIndex;
+    return ownershipIndex;
+}
+
+// Guards the ownership index: sentinels deallocate on whichever thread releases the last reference to their constraint.
+// The helpers, and the registry they share, are still main-thread only.
+static std::mutex &CHAOwnershipIndexMutex()
+{
+    static std::mutex ownershipIndexMutex;
+    return ownershipIndexMutex;
+}
+
+static NSArray *CHAConstraintsWithDescriptors(const CHAConstraintDescriptor *records, size_t count);
+
+/**
+ @description Attached to every registered constraint so the ownership index forgets the constraint when it is deallocated
+ */
+@interface CHAConstraintOwnershipSentinel : NSObject
+@property (nonatomic, assign) const void *constraint;
+@end
+
+@implementation CHAConstraintOwnershipSentinel
+
+- (void)dealloc
+{
+    std::lock_guard<std::mutex> lock(CHAOwnershipIndexMutex());
+    CHAOwnershipIndex().remove(_constraint);
+}
+
+@end
+
+@implementation UIView (AutoLayoutHelper)
+
+- (NSLayoutConstraint *)pinLeading
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinLeading:0];
+}
+
+- (NSLayoutConstraint *)pinLeading:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeLeading constant:constant];
+}
+
+
+- (NSLayoutConstraint *)pinTrailing
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinTrailing:0];
+}
+
+- (NSLayoutConstraint *)pinTrailing:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeTrailing constant:-constant];
+}
+
+
+- (NSArray *)pinLeadingTrailing
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinLeadingTrailing:0];
+}
+
+- (NSArray *)pinLeadingTrailing:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return @[[self pinLeading:constant],
+             [self pinTrailing:constant]];
+}
+
+- (NSLayoutConstraint *)pinToTopLayoutGuide:(UIViewController *)containerViewController
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert([containerViewController isKindOfClass:[UIViewController class]], @"Container View must be a view controller.");
+    if (!containerViewController.topLayoutGuide) return nil;
+    
+    NSLayoutConstraint *topLayoutGuide = [UIView
+                                          registeredConstraintWithItem:self
+                                          attribute:NSLayoutAttributeTop
+                                          relatedBy:NSLayoutRelationEqual
+                                          toItem:containerViewController.topLayoutGuide
+                                          attribute:NSLayoutAttributeBottom
+                                          multiplier:1
+                                          constant:0];
+    return topLayoutGuide;
+}
+
+- (NSLayoutConstraint *)pinToTopSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeTop constant:0];
+}
+
+- (NSLayoutConstraint *)pinToTopSuperview:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeTop constant:constant];
+}
+
+- (NSLayoutConstraint *)pinToBottomLayoutGuide:(UIViewController *)containerViewController
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert([containerViewController isKindOfClass:[UIViewController class]], @"Container View must be a view controller.");
+    if (!containerViewController.bottomLayoutGuide) return nil;
+    
+    NSLayoutConstraint *topLayoutGuide = [UIView
+                                          registeredConstraintWithItem:self
+                                          attribute:NSLayoutAttributeBottom
+                                          relatedBy:NSLayoutRelationEqual
+                                          toItem:containerViewController.bottomLayoutGuide
+                                          attribute:NSLayoutAttributeTop
+                                          multiplier:1
+                                          constant:0];
+
+    return topLayoutGuide;
+}
+
+- (NSLayoutConstraint *)pinToBottomSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeBottom constant:0];
+}
+
+- (NSLayoutConstraint *)pinToBottomSuperview:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:NSLayoutAttributeBottom constant:-constant];
+}
+
+- (NSArray *)pinToSuperviewBounds
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinToSuperviewBoundsConstant:0];
+}
+
+- (NSArray *)pinToSuperviewBoundsConstant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinEdges:(CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeft | CHAEdgeRight) constant:constant];
+}
+
+- (NSArray *)pinToSuperviewBoundsInsets:(UIEdgeInsets)edgeInsets
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendInsets(&batch,
+                                   (__bridge const void *)self,
+                                   (__bridge const void *)self.superview,
+                                   edgeInsets.top,
+                                   edgeInsets.left,
+                                   edgeInsets.bottom,
+                                   edgeInsets.right);
+    
+    return [UIView constraintsWithDescriptorBatch:&batch];
+}
+
+- (NSLayoutConstraint *)pinSide:(NSLayoutAttribute)viewSide
+                       constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    
+    return [self pin:self side:viewSide toView:self.superview secondSide:viewSide constant:constant multiplier:1];
+}
+
+- (NSLayoutConstraint *)pinSide:(NSLayoutAttribute)viewSide
+                       relation:(NSLayoutRelation)layoutRelation
+                       constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    
+    return [self pin:self
+                side:viewSide
+      layoutRelation:layoutRelation
+              toView:self.superview
+          secondSide:viewSide
+            constant:constant
+          multiplier:1];
+}
+
+- (NSArray *)pinSides:(NSArray *)viewSides
+             constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    NSAssert(viewSides.count > 0, @"No view sides found. Please provide one or more view sides");
+    
+    // One constraint per entry, in the caller's order, as callers index the result.
+    NSMutableArray *constraints = [NSMutableArray arrayWithCapacity:viewSides.count];
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    
+    for (NSNumber *viewSide in viewSides)
+    {
+        CHAEdgeMask edge;
+        switch (viewSide.integerValue)
+        {
+            case NSLayoutAttributeLeft:
+            {
+                edge = CHAEdgeLeading;
+                break;
+            }
+            case NSLayoutAttributeRight:
+            {
+                edge = CHAEdgeTrailing;
+                break;
+            }
+            default:
+                edge = CHAEdgeMaskForAttribute((CHALayoutAttribute)viewSide.integerValue);
+                break;
+        }
+        if (edge == 0) continue;
+        
+        if (batch.count == CHA_DESCRIPTOR_BATCH_CAPACITY)
+        {
+            [constraints addObjectsFromArray:[UIView constraintsWithDescriptorBatch:&batch]];
+            CHADescriptorBatchReset(&batch);
+        }
+        CHADescriptorBatchAppendEdges(&batch,
+                                      (__bridge const void *)self,
+                                      (__bridge const void *)self.superview,
+                                      edge,
+                                      constant);
+    }
+    [constraints addObjectsFromArray:[UIView constraintsWithDescriptorBatch:&batch]];
+
+    return constraints;
+}
+
+- (NSArray *)pinEdges:(CHAEdgeMask)edges
+             constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch,
+                                  (__bridge const void *)self,
+                                  (__bridge const void *)self.superview,
+                                  edges,
+                                  constant);
+    
+    return [UIView constraintsWithDescriptorBatch:&batch];
+}
+
+- (NSLayoutConstraint *)pinSide:(NSLayoutAttribute)viewSide
+                         toView:(UIView *)secondView
+                 secondViewSide:(NSLayoutAttribute)secondViewSide
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No second view provided. Please provide a reference view on which to pin a first view.");
+    return [self pin:self side:viewSide toView:secondView secondSide:secondViewSide constant:0 multiplier:1];
+}
+
+- (NSLayoutConstraint *)pinSide:(NSLayoutAttribute)viewSide
+                         toView:(UIView *)secondView
+                 secondViewSide:(NSLayoutAttribute)secondViewSide
+                       constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No second view provided. Please provide a reference view on which to pin a first view.");
+    return [self pin:self side:viewSide toView:secondView secondSide:secondViewSide constant:constant multiplier:1];
+}
+
+- (NSLayoutConstraint *)pin:(UIView *)firstView
+                       side:(NSLayoutAttribute)viewSide
+                     toView:(UIView *)secondView
+                 secondSide:(NSLayoutAttribute)secondSide
+                   constant:(CGFloat)constant
+                 multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(firstView != nil, @"No first view provided. Please provide a view to pin.");
+    NSAssert(secondView != nil, @"No second view provided. Please provide a reference view on which to pin a first view.");
+
+    return [self pin:firstView
+                side:viewSide
+      layoutRelation:NSLayoutRelationEqual
+              toView:secondView
+          secondSide:secondSide
+            constant:constant
+          multiplier:multiplier];
+}
+
+- (NSLayoutConstraint *)pin:(UIView *)firstView
+                       side:(NSLayoutAttribute)viewSide
+             layoutRelation:(NSLayoutRelation)relation
+                     toView:(UIView *)secondView
+                 secondSide:(NSLayoutAttribute)secondSide
+                   constant:(CGFloat)constant
+                 multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(firstView != nil, @"No first view provided. Please provide a view to pin.");
+    NSAssert(secondView != nil, @"No second view provided. Please provide a reference view on which to pin a first view.");
+    
+    NSLayoutConstraint *pinningConstraint = [UIView
+                                             registeredConstraintWithItem:firstView
+                                             attribute:viewSide
+                                             relatedBy:relation
+                                             toItem:secondView
+                                             attribute:secondSide
+                                             multiplier:multiplier
+                                             constant:constant];
+    return pinningConstraint;
+}
+
+#pragma mark - Alignment
+- (NSLayoutConstraint *)alignCenterVerticalSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeCenterY
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeCenterY
+            multiplier:1
+            constant:0];
+}
+
+- (NSLayoutConstraint *)alignCenterHorizontalSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeCenterX
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeCenterX
+            multiplier:1
+            constant:0];
+}
+
+- (NSLayoutConstraint *)alignLeftSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self alignSide:NSLayoutAttributeLeft constant:0];
+}
+
+- (NSLayoutConstraint *)alignRightSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self alignSide:NSLayoutAttributeRight constant:0];
+}
+
+- (NSLayoutConstraint *)alignTopSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self alignSide:NSLayoutAttributeTop constant:0];
+}
+
+- (NSLayoutConstraint *)alignTopLayoutGuide:(UIViewController *)containerViewController
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert([containerViewController isKindOfClass:[UIViewController class]], @"Container View must be a view controller.");
+    if (!containerViewController.topLayoutGuide) return nil;
+    
+    return [self pinToTopLayoutGuide:containerViewController];
+}
+
+- (NSLayoutConstraint *)alignBottomSuperview
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self alignSide:NSLayoutAttributeBottom constant:0];
+}
+
+- (NSLayoutConstraint *)alignBottomLayoutGuide:(UIViewController *)containerViewController
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert([containerViewController isKindOfClass:[UIViewController class]], @"Container View must be a view controller.");
+    if (!containerViewController.bottomLayoutGuide) return nil;
+    
+    return [self pinToBottomLayoutGuide:containerViewController];
+}
+
+- (NSArray *)alignCenterHorizontal:(NSArray *)viewsForCenterHorizontalAlignment
+                     referenceView:(UIView *)referenceView
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForCenterHorizontalAlignment.count > 0, @"No views provided for horizontal center alignment.");
+    NSAssert(referenceView != nil, @"No reference view found. Please provide a reference view.");
+    
+    return [self alignCenter:NSLayoutAttributeCenterX
+                       views:viewsForCenterHorizontalAlignment
+               referenceView:referenceView];
+}
+
+- (NSArray *)alignCenterVertical:(NSArray *)viewsForCenterVerticalAlignment
+                   referenceView:(UIView *)referenceView
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForCenterVerticalAlignment.count > 0, @"No views provided for vertical center alignment.");
+    NSAssert(referenceView != nil, @"No reference view found. Please provide a reference view.");
+    
+    return [self alignCenter:NSLayoutAttributeCenterY
+                       views:viewsForCenterVerticalAlignment
+               referenceView:referenceView];
+}
+
+- (NSArray *)alignCenter:(NSLayoutAttribute)centerType
+              views:(NSArray *)viewsForAlignment
+      referenceView:(UIView *)referenceView
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForAlignment.count > 0, @"No views provided for center alignment.");
+    NSAssert(referenceView != nil, @"No reference view found. Please provide a reference view.");
+    
+    NSMutableArray *constraints = [NSMutableArray array];
+    
+    for (UIView *alignmentView in viewsForAlignment)
+    {
+        if ([alignmentView isEqual:referenceView]) return nil;
+        
+        NSLayoutConstraint *alignCenter = [UIView
+                                           registeredConstraintWithItem:alignmentView
+                                           attribute:centerType
+                                           relatedBy:NSLayoutRelationEqual
+                                           toItem:referenceView
+                                           attribute:centerType
+                                           multiplier:1
+                                           constant:0];
+        
+        [constraints addObject:alignCenter];
+    }
+    return constraints;
+}
+
+- (NSLayoutConstraint *)alignSide:(NSLayoutAttribute)firstSide
+                         constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self pinSide:firstSide constant:constant];
+}
+
+- (NSLayoutConstraint *)alignSide:(NSLayoutAttribute)firstSide
+                           toView:(UIView *)secondView
+                       secondSide:(NSLayoutAttribute)secondViewSide
+                         constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No Second view provided. Please provide a second view on which to pin the receiving view.");
+
+    return [self align:self
+                  side:firstSide
+                toView:secondView
+            secondSide:secondViewSide
+              constant:constant
+            multiplier:1];
+}
+
+- (NSLayoutConstraint *)align:(UIView *)firstView
+                         side:(NSLayoutAttribute)firstSide
+                       toView:(UIView *)secondView
+                   secondSide:(NSLayoutAttribute)secondSide
+                     constant:(CGFloat)constant
+                   multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(firstView != nil, @"No first view provided. Please provide a view to pin.");
+    NSAssert(secondView != nil, @"No second view provided. Please provide a reference view on which to pin a first view.");
+    
+    return [self pin:firstView
+                side:firstSide
+              toView:secondView
+          secondSide:secondSide
+            constant:constant
+          multiplier:multiplier];
+}
+
+#pragma mark - Width and Height
+- (NSLayoutConstraint *)width:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:NSLayoutRelationEqual
+            toItem:nil
+            attribute:NSLayoutAttributeNotAnAttribute
+            multiplier:1
+            constant:constant];
+}
+
+- (NSLayoutConstraint *)width:(NSLayoutRelation)constraintRelation
+                     constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:constraintRelation
+            toItem:nil
+            attribute:NSLayoutAttributeNotAnAttribute
+            multiplier:1
+            constant:constant];
+}
+
+- (NSLayoutConstraint *)width:(NSLayoutRelation)constraintRelation
+                    multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:constraintRelation
+            toItem:self.superview
+            attribute:NSLayoutAttributeWidth
+            multiplier:multiplier
+            constant:0];
+}
+
+
+- (NSLayoutConstraint *)height:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:nil
+            attribute:NSLayoutAttributeNotAnAttribute
+            multiplier:1
+            constant:constant];
+}
+
+- (NSLayoutConstraint *)height:(NSLayoutRelation)constraintRelation
+                      constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:constraintRelation
+            toItem:nil
+            attribute:NSLayoutAttributeNotAnAttribute
+            multiplier:1
+            constant:constant];
+}
+
+- (NSLayoutConstraint *)height:(NSLayoutRelation)constraintRelation
+                    multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:constraintRelation
+            toItem:self.superview
+            attribute:NSLayoutAttributeHeight
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSLayoutConstraint *)heightForText:(NSString *)text font:(UIFont *)font width:(CGFloat)width lineLimit:(NSUInteger)lineLimit
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(font != nil, @"No font provided. Please provide the font the text is drawn in.");
+    
+    CGFloat verticalInsets = 0;
+    if ([self isKindOfClass:[UITextView class]])
+    {
+        UITextView *textView = (UITextView *)self;
+        UIEdgeInsets insets = textView.textContainerInset;
+        CGFloat padding = 2 * textView.textContainer.lineFragmentPadding;
+        if (width > 0) width = MAX(1, width - insets.left - insets.right - padding);
+        verticalInsets = insets.top + insets.bottom;
+    }
+    
+    CGSize size = [[CHATextMeasurer sharedMeasurer] sizeForText:text font:font width:width lineLimit:lineLimit];
+    return [self height:size.height + verticalInsets];
+}
+
+- (NSLayoutConstraint *)equalWidth
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self equalWidth:1];
+}
+
+- (NSLayoutConstraint *)equalWidth:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeWidth
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSLayoutConstraint *)equalWidthToView:(UIView *)secondView
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No Second view provided. Please provide a second view on which to pin the receiving view.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:NSLayoutRelationEqual
+            toItem:secondView
+            attribute:NSLayoutAttributeWidth
+            multiplier:1
+            constant:0];
+}
+
+- (NSLayoutConstraint *)equalWidthToView:(UIView *)secondView
+                              multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No Second view provided. Please provide a second view on which to pin the receiving view.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:NSLayoutRelationEqual
+            toItem:secondView
+            attribute:NSLayoutAttributeWidth
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSLayoutConstraint *)equalHeight
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [self equalHeight:1];
+}
+
+- (NSLayoutConstraint *)equalHeight:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeHeight
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSLayoutConstraint *)equalHeightToView:(UIView *)secondView
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No Second view provided. Please provide a second view on which to pin the receiving view.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:secondView
+            attribute:NSLayoutAttributeHeight
+            multiplier:1
+            constant:0];
+}
+
+- (NSLayoutConstraint *)equalHeightToView:(UIView *)secondView
+                               multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(secondView != nil, @"No Second view provided. Please provide a second view on which to pin the receiving view.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:secondView
+            attribute:NSLayoutAttributeHeight
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSArray *)equalWidths:(NSArray *)viewsForAlignment
+              multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForAlignment.count > 0, @"No second view provided to create equal width constraint.");
+    return [self equalWidths:viewsForAlignment referenceView:self multiplier:multiplier];
+}
+
+- (NSArray *)equalWidths:(NSArray *)viewsForAlignment
+           referenceView:(UIView *)referenceView
+              multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForAlignment.count > 0, @"No views provided for center alignment.");
+    NSAssert(referenceView != nil, @"No reference view found. Please provide a reference view.");
+    
+    NSMutableArray *constraints = [NSMutableArray array];
+    
+    for (UIView *alignmentView in viewsForAlignment)
+    {
+        if (![alignmentView isEqual:referenceView])
+        {
+            NSLayoutConstraint *dimensionConstraint =
+            [UIView registeredConstraintWithItem:alignmentView
+                                       attribute:NSLayoutAttributeWidth
+                                       relatedBy:NSLayoutRelationEqual
+                                          toItem:referenceView
+                                       attribute:NSLayoutAttributeWidth
+                                      multiplier:multiplier
+                                        constant:0];
+            
+            [constraints addObject:dimensionConstraint];
+        }
+    }
+    
+    return constraints;
+}
+
+- (NSArray *)equalHeights:(NSArray *)viewsForAlignment multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForAlignment.count > 0, @"No second view provided to create equal height constraint.");
+    return [self equalHeights:viewsForAlignment referenceView:self multiplier:multiplier];
+}
+
+- (NSArray *)equalHeights:(NSArray *)viewsForAlignment
+            referenceView:(UIView *)referenceView
+               multiplier:(CGFloat)multiplier
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(viewsForAlignment.count > 0, @"No views provided for center alignment.");
+    NSAssert(referenceView != nil, @"No reference view found. Please provide a reference view.");
+ 
+    NSMutableArray *constraints = [NSMutableArray array];
+    
+    for (UIView *alignmentView in viewsForAlignment)
+    {
+        if (![alignmentView isEqual:referenceView])
+        {
+            NSLayoutConstraint *dimensionConstraint =
+            [UIView registeredConstraintWithItem:alignmentView
+                                       attribute:NSLayoutAttributeHeight
+                                       relatedBy:NSLayoutRelationEqual
+                                          toItem:referenceView
+                                       attribute:NSLayoutAttributeHeight
+                                      multiplier:multiplier
+                                        constant:0];
+            
+            [constraints addObject:dimensionConstraint];
+        }
+    }
+    
+    return constraints;
+}
+
+- (NSLayoutConstraint *)proportionalWidth
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeWidth
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeWidth
+            multiplier:(MAX(1,self.bounds.size.width))/(MAX(1,self.superview.bounds.size.width))
+            constant:0];
+    
+}
+
+static NSLayoutConstraint *CHAAspectRatioConstraint(UIView *view, const cha::RatioSpec &spec)
+{
+    // The intrinsic content size comes from the view's content, so reading it never triggers a layout pass.
+    CGSize intrinsicSize = spec.source == cha::RatioSourceIntrinsicSize ? view.intrinsicContentSize : CGSizeZero;
+    double multiplier = 1;
+    cha::RatioStatus status = cha::resolveRatio(spec, intrinsicSize.width, intrinsicSize.height, &multiplier);
+    NSCAssert(status != cha::RatioStatusInvalid, @"A declared ratio needs a positive width and height.");
+    // A pending ratio has no right multiplier yet, and any stand-in would be installed as if it were the real one.
+    if (status != cha::RatioStatusResolved) return nil;
+    
+    return [UIView
+            registeredConstraintWithItem:view
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:view
+            attribute:NSLayoutAttributeWidth
+            multiplier:multiplier
+            constant:0];
+}
+
+- (NSLayoutConstraint *)proportionalWidthForHeight:(CGFloat)height
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(height >= 1, @"Height must be greater than or equal to 1");
+    CGFloat intrinsicWidth = self.intrinsicContentSize.width;
+    // UIViewNoIntrinsicMetric, or no content yet: the ratio is pending, as in CHAAspectRatioConstraint.
+    if (!(intrinsicWidth > 0)) return nil;
+    return CHAAspectRatioConstraint(self, cha::RatioSpec::declared(intrinsicWidth, height));
+}
+
+- (NSLayoutConstraint *)proportionalHeight
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(self.superview != nil, @"Superview not found. The receiving view must already be part of the view hierarchy.");
+    return [UIView
+            registeredConstraintWithItem:self
+            attribute:NSLayoutAttributeHeight
+            relatedBy:NSLayoutRelationEqual
+            toItem:self.superview
+            attribute:NSLayoutAttributeHeight
+            multiplier:(MAX(1,self.bounds.size.width))/(MAX(1,self.superview.bounds.size.width))
+            constant:0];
+}
+
+- (NSLayoutConstraint *)proportionalHeightForWidth:(CGFloat)width
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(width >= 1, @"Width must be greater than or equal to 1");
+    CGFloat intrinsicHeight = self.intrinsicContentSize.height;
+    if (!(intrinsicHeight > 0)) return nil;
+    return CHAAspectRatioConstraint(self, cha::RatioSpec::declared(width, intrinsicHeight));
+}
+
+- (NSLayoutConstraint *)aspectRatio
+{
+    CHA_TRACE_HELPER(self);
+    return CHAAspectRatioConstraint(self, cha::RatioSpec::intrinsicSize());
+}
+
+- (NSLayoutConstraint *)aspectRatio:(CGFloat)ratio
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(ratio > 0, @"Ratio must be greater than 0");
+    return CHAAspectRatioConstraint(self, cha::RatioSpec::declared(ratio, 1));
+}
+
+- (NSLayoutConstraint *)aspectRatioForImageSize:(CGSize)imageSize
+{
+    CHA_TRACE_HELPER(self);
+    return CHAAspectRatioConstraint(self, cha::RatioSpec::imageSize(imageSize.width, imageSize.height));
+}
+
+
+#pragma mark - View Grouping
+- (NSArray *)stackAboveView:(UIView *)bottomView
+{
+    CHA_TRACE_HELPER(self);
+    return [self stackAboveView:bottomView superviewMargin:0 interViewSpacing:0];
+}
+
+- (NSArray *)stackAboveView:(UIView *)bottomView
+            superviewMargin:(CGFloat)outerEdgeMargin
+           interViewSpacing:(CGFloat)viewMargin
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(bottomView != nil, @"No bottom view provided. Please provide a lower view");
+    
+    NSArray *pinTopView = [self pinSides:@[@(NSLayoutAttributeTop),@(NSLayoutAttributeLeading),@(NSLayoutAttributeTrailing)]
+                                constant:outerEdgeMargin];
+    
+    NSArray *pinBottomView = [bottomView pinSides:@[@(NSLayoutAttributeBottom),@(NSLayoutAttributeLeading),@(NSLayoutAttributeTrailing)]
+                                         constant:outerEdgeMargin];
+    
+    NSLayoutConstraint *interViewSpace = [UIView registeredConstraintWithItem:self
+                                                                    attribute:NSLayoutAttributeBottom
+                                                                    relatedBy:NSLayoutRelationEqual
+                                                                       toItem:bottomView
+                                                                    attribute:NSLayoutAttributeTop
+                                                                   multiplier:1
+                                                                     constant:viewMargin];
+    
+    NSMutableArray *constraints = [NSMutableArray arrayWithCapacity:pinTopView.count + pinBottomView.count + 1];
+    [constraints addObjectsFromArray:pinTopView];
+    [constraints addObjectsFromArray:pinBottomView];
+    [constraints addObject:interViewSpace];
+    
+    return constraints;
+}
+
+- (NSArray *)stackViews:(NSArray *)views
+                   axis:(UILayoutConstraintAxis)axis
+                spacing:(CGFloat)spacing
+{
+    CHA_TRACE_HELPER(self);
+    return [self stackViews:views axis:axis spacing:spacing margins:UIEdgeInsetsZero distribution:CHAStackDistributionFill];
+}
+
+- (NSArray *)stackViews:(NSArray *)views
+                   axis:(UILayoutConstraintAxis)axis
+                spacing:(CGFloat)spacing
+                margins:(UIEdgeInsets)margins
+           distribution:(CHAStackDistribution)distribution
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(views.count > 0, @"No views found. Please provide one or more views to stack");
+    
+    std::vector<const void *> items;
+    std::vector<double> weights;
+    items.reserve(views.count);
+    weights.reserve(views.count);
+    
+    for (UIView *view in views)
+    {
+        NSAssert(view.superview == self, @"Stacked views must be subviews of the receiving view.");
+        items.push_back((__bridge const void *)view);
+        
+        CGSize intrinsicSize = view.intrinsicContentSize;
+        CGFloat weight = axis == UILayoutConstraintAxisVertical ? intrinsicSize.height : intrinsicSize.width;
+        weights.push_back(weight > 0 ? weight : 1);
+    }
+    
+    cha::StackSpec spec = {
+        axis == UILayoutConstraintAxisVertical ? CHAStackAxisVertical : CHAStackAxisHorizontal,
+        distribution,
+        spacing,
+        margins.top,
+        margins.left,
+        margins.bottom,
+        margins.right
+    };
+    
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::appendStackDescriptors(spec, (__bridge const void *)self, items.data(), weights.data(), items.size(), descriptors);
+    
+    return CHAConstraintsWithDescriptors(descriptors.data(), descriptors.size());
+}
+
+#pragma mark - Grid Layout
+- (CGFloat)layoutGridViews:(NSArray *)views
+                   columns:(NSUInteger)columns
+                   spacing:(CGFloat)spacing
+                    insets:(UIEdgeInsets)edgeInsets
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(columns > 0, @"No columns provided. Please provide one or more columns");
+    
+    CGFloat availableWidth = CGRectGetWidth(self.bounds) - edgeInsets.left - edgeInsets.right - spacing * (columns - 1);
+    
+    CHAGridSpec spec = {0};
+    spec.columns = (uint32_t)columns;
+    spec.rowSpacing = spacing;
+    spec.columnSpacing = spacing;
+    spec.top = edgeInsets.top;
+    spec.leading = edgeInsets.left;
+    spec.bottom = edgeInsets.bottom;
+    spec.trailing = edgeInsets.right;
+    spec.rowHeight = MAX(availableWidth / columns, 0);
+    
+    return [self layoutGridViews:views spec:spec];
+}
+
+- (CGFloat)layoutGridViews:(NSArray *)views spec:(CHAGridSpec)spec
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(spec.columns > 0, @"No columns provided. Please provide one or more columns");
+    
+    cha::FrameBuffer frames;
+    double contentHeight = 0;
+    if (!cha::layoutGrid(spec, CGRectGetWidth(self.bounds), CGRectGetHeight(self.bounds), views.count, frames,
+                         cha::preferredGridKernel(), &contentHeight))
+    {
+        NSAssert(NO, @"The grid cannot hold the views. Please provide enough rows, or a row height for a grid that sets its own height");
+        return 0;
+    }
+    
+    NSUInteger index = 0;
+    for (UIView *view in views)
+    {
+        view.frame = CGRectMake(frames.x[index], frames.y[index], frames.width[index], frames.height[index]);
+        index++;
+    }
+    
+    return contentHeight;
+}
+
+#pragma mark - Constraint Registry
++ (NSLayoutConstraint *)registeredConstraintWithItem:(id)firstItem
+                                           attribute:(NSLayoutAttribute)firstAttribute
+                                           relatedBy:(NSLayoutRelation)relation
+                                              toItem:(id)secondItem
+                                           attribute:(NSLayoutAttribute)secondAttribute
+                                          multiplier:(CGFloat)multiplier
+                                            constant:(CGFloat)constant
+{
+    CHA_TRACE_HELPER(nil);
+    return [UIView registeredConstraintWithItem:firstItem
+                                      attribute:firstAttribute
+                                      relatedBy:relation
+                                         toItem:secondItem
+                                      attribute:secondAttribute
+                                     multiplier:multiplier
+                                       constant:constant
+                                       priority:UILayoutPriorityRequired];
+}
+
++ (NSLayoutConstraint *)registeredConstraintWithItem:(id)firstItem
+                                           attribute:(NSLayoutAttribute)firstAttribute
+                                           relatedBy:(NSLayoutRelation)relation
+                                              toItem:(id)secondItem
+                                           attribute:(NSLayoutAttribute)secondAttribute
+                                          multiplier:(CGFloat)multiplier
+                                            constant:(CGFloat)constant
+                                            priority:(UILayoutPriority)priority
+{
+    CHA_TRACE_HELPER(nil);
+    NSAssert(firstItem != nil, @"No first item provided. Please provide an item to constrain.");
+    
+    NSMapTable *registry = objc_getAssociatedObject(firstItem, CHAConstraintRegistryAssociationKey);
+    if (!registry)
+    {
+        registry = [NSMapTable strongToWeakObjectsMapTable];
+        objc_setAssociatedObject(firstItem, CHAConstraintRegistryAssociationKey, registry, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    
+    CHAConstraintRegistryKey key = {(__bridge const void *)secondItem, firstAttribute, secondAttribute, relation};
+    NSValue *registryKey = [NSValue valueWithBytes:&key objCType:@encode(CHAConstraintRegistryKey)];
+    
+    // UIKit throws when an installed constraint moves between required and optional, so an active constraint is only
+    // reused at the priority it already has; an inactive one can take any priority.
+    NSLayoutConstraint *existingConstraint = [registry objectForKey:registryKey];
+    if (existingConstraint &&
+        existingConstraint.secondItem == secondItem &&
+        existingConstraint.multiplier == multiplier &&
+        (existingConstraint.priority == priority || !existingConstraint.active))
+    {
+        {
+            std::lock_guard<std::mutex> lock(CHAOwnershipIndexMutex());
+            CHAOwnershipIndex().add((__bridge const void *)existingConstraint,
+                                    (__bridge const void *)firstItem,
+                                    (__bridge const void *)secondItem);
+        }
+        CHARegistryCounters.reused++;
+        CHA_TRACE_CONSTRAINT(false, firstItem);
+        if (existingConstraint.constant != constant)
+        {
+            existingConstraint.constant = constant;
+            CHARegistryCounters.updated++;
+        }
+        existingConstraint.priority = priority;
+        return existingConstraint;
+    }
+    
+    NSLayoutConstraint *constraint = [NSLayoutConstraint
+                                      constraintWithItem:firstItem
+                                      attribute:firstAttribute
+                                      relatedBy:relation
+                                      toItem:secondItem
+                                      attribute:secondAttribute
+                                      multiplier:multiplier
+                                      constant:constant];
+    constraint.priority = priority;
+    [registry setObject:constraint forKey:registryKey];
+    CHARegistryCounters.created++;
+    CHA_TRACE_CONSTRAINT(true, firstItem);
+#if CHA_INSTRUMENTATION
+    const char *helper = cha::HelperTraceScope::currentHelper();
+    const char *site = cha::HelperTraceScope::currentSite();
+    if (helper && site)
+    {
+        constraint.identifier = [NSString stringWithFormat:@"%s > %s", site, helper];
+    }
+    else if (helper)
+    {
+        constraint.identifier = @(helper);
+    }
+#endif
+    
+    CHAConstraintOwnershipSentinel *sentinel = [CHAConstraintOwnershipSentinel new];
+    sentinel.constraint = (__bridge const void *)constraint;
+    objc_setAssociatedObject(constraint, CHAConstraintOwnershipAssociationKey, sentinel, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    {
+        std::lock_guard<std::mutex> lock(CHAOwnershipIndexMutex());
+        CHAOwnershipIndex().add((__bridge const void *)constraint,
+                                (__bridge const void *)firstItem,
+                                (__bridge const void *)secondItem);
+    }
+    
+    return constraint;
+}
+
++ (CHAConstraintRegistryCounters)constraintRegistryCounters
+{
+    return CHARegistryCounters;
+}
+
++ (void)resetConstraintRegistryCounters
+{
+    CHARegistryCounters = (CHAConstraintRegistryCounters){0, 0, 0};
+}
+
+#pragma mark - Batch Descriptors
++ (NSArray *)constraintsWithDescriptorBatch:(const CHADescriptorBatch *)batch
+{
+    CHA_TRACE_HELPER(nil);
+    NSAssert(batch != NULL, @"No descriptor batch provided.");
+    
+    __strong id constraints[CHA_DESCRIPTOR_BATCH_CAPACITY];
+    NSUInteger count = 0;
+    
+    for (uint32_t index = 0; index < batch->count; index++)
+    {
+        const CHAConstraintDescriptor *record = &batch->records[index];
+        
+        NSLayoutConstraint *constraint = [UIView
+                                          registeredConstraintWithItem:(__bridge id)record->item
+                                          attribute:(NSLayoutAttribute)record->attribute
+                                          relatedBy:(NSLayoutRelation)record->relation
+                                          toItem:(__bridge id)record->toItem
+                                          attribute:(NSLayoutAttribute)record->toAttribute
+                                          multiplier:record->multiplier
+                                          constant:record->constant
+                                          priority:record->priority];
+        constraints[count++] = constraint;
+    }
+    
+    return [NSArray arrayWithObjects:constraints count:count];
+}
+
++ (NSArray *)constraintsWithDescriptors:(const CHAConstraintDescriptor *)records count:(NSUInteger)count
+{
+    CHA_TRACE_HELPER(nil);
+    NSAssert(records != NULL || count == 0, @"No descriptor records provided.");
+    
+    return CHAConstraintsWithDescriptors(records, count);
+}
+
+static NSArray *CHAConstraintsWithDescriptors(const CHAConstraintDescriptor *records, size_t count)
+{
+    NSMutableArray *constraints = [NSMutableArray arrayWithCapacity:count];
+    
+    for (size_t index = 0; index < count; index++)
+    {
+        const CHAConstraintDescriptor *record = &records[index];
+        
+        NSLayoutConstraint *constraint = [UIView
+                                          registeredConstraintWithItem:(__bridge id)record->item
+                                          attribute:(NSLayoutAttribute)record->attribute
+                                          relatedBy:(NSLayoutRelation)record->relation
+                                          toItem:(__bridge id)record->toItem
+                                          attribute:(NSLayoutAttribute)record->toAttribute
+                                          multiplier:record->multiplier
+                                          constant:record->constant
+                                          priority:record->priority];
+        [constraints addObject:constraint];
+    }
+    
+    return constraints;
+}
+
+static CHAConstraintDescriptor CHADescriptorForConstraint(NSLayoutConstraint *constraint)
+{
+    return CHAConstraintDescriptor{(__bridge const void *)constraint.firstItem,
+                                   (__bridge const void *)constraint.secondItem,
+                                   constraint.multiplier,
+                                   constraint.constant,
+                                   constraint.priority,
+                                   (CHALayoutAttribute)constraint.firstAttribute,
+                                   (CHALayoutAttribute)constraint.secondAttribute,
+                                   (CHALayoutRelation)constraint.relation,
+                                   0};
+}
+
+#pragma mark - Constraint Diffing
++ (NSArray *)updateConstraints:(NSArray *)oldConstraints
+                 toDescriptors:(const CHAConstraintDescriptor *)descriptors
+                         count:(NSUInteger)count
+{
+    CHA_TRACE_HELPER(nil);
+    NSAssert(descriptors != NULL || count == 0, @"No descriptors provided.");
+    
+    std::vector<CHAConstraintDescriptor> oldRecords;
+    oldRecords.reserve(oldConstraints.count);
+    for (NSLayoutConstraint *constraint in oldConstraints)
+    {
+        oldRecords.push_back(CHADescriptorForConstraint(constraint));
+    }
+    
+    cha::ConstraintDiff diff;
+    cha::diffConstraints(oldRecords.data(), oldRecords.size(), descriptors, count, diff);
+    
+    NSMutableArray *deactivated = [NSMutableArray arrayWithCapacity:diff.removals.size()];
+    NSMutableArray *activated = [NSMutableArray arrayWithCapacity:diff.additions.size()];
+    for (uint32_t index : diff.removals)
+    {
+        [deactivated addObject:oldConstraints[index]];
+    }
+    for (const cha::DiffMatch &match : diff.matches)
+    {
+        if (match.changes & cha::DiffChangeReinstall)
+        {
+            [deactivated addObject:oldConstraints[match.oldIndex]];
+        }
+    }
+    [NSLayoutConstraint deactivateConstraints:deactivated];
+    
+    NSMutableArray *constraints = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger index = 0; index < count; index++)
+    {
+        [constraints addObject:[NSNull null]];
+    }
+    
+    for (const cha::DiffMatch &match : diff.matches)
+    {
+        NSLayoutConstraint *constraint = oldConstraints[match.oldIndex];
+        const CHAConstraintDescriptor *record = &descriptors[match.newIndex];
+        if (match.changes & cha::DiffChangeConstant)
+        {
+            constraint.constant = record->constant;
+        }
+        if (match.changes & cha::DiffChangePriority)
+        {
+            constraint.priority = record->priority;
+        }
+        if (match.changes & cha::DiffChangeReinstall)
+        {
+            [activated addObject:constraint];
+        }
+        constraints[match.newIndex] = constraint;
+    }
+    
+    for (uint32_t index : diff.additions)
+    {
+        NSLayoutConstraint *constraint = CHAConstraintsWithDescriptors(&descriptors[index], 1).firstObject;
+        [activated addObject:constraint];
+        constraints[index] = constraint;
+    }
+    [NSLayoutConstraint activateConstraints:activated];
+    
+    return constraints;
+}
+
++ (NSArray *)updateConstraints:(NSArray *)oldConstraints toDescriptorBatch:(const CHADescriptorBatch *)batch
+{
+    CHA_TRACE_HELPER(nil);
+    NSAssert(batch != NULL, @"No descriptor batch provided.");
+    return [UIView updateConstraints:oldConstraints toDescriptors:batch->records count:batch->count];
+}
+
+#pragma mark - Constraint Analysis
+static std::string CHARecordingNameForItem(id item)
+{
+    NSString *name = nil;
+    if ([item isKindOfClass:[UIView class]] && [item accessibilityIdentifier].length > 0)
+    {
+        name = [item accessibilityIdentifier];
+    }
+    else
+    {
+        name = [NSString stringWithFormat:@"%@:%p", NSStringFromClass([item class]), item];
+    }
+    return std::string(name.UTF8String);
+}
+
+static void CHARecordConstraints(NSArray *constraints, UIView *container, cha::ConstraintRecording &recording)
+{
+    const CGSize size = container.bounds.size;
+    recording.width = size.width > 0 ? size.width : -1;
+    recording.height = size.height > 0 ? size.height : -1;
+    
+    // Items are keyed by pointer so that two views sharing an accessibilityIdentifier stay distinct.
+    std::unordered_map<const void *, const void *> recordedItems;
+    auto recordedItem = [&](id item) -> const void * {
+        if (!item) return nullptr;
+        auto found = recordedItems.find((__bridge const void *)item);
+        if (found != recordedItems.end()) return found->second;
+        
+        std::string name = CHARecordingNameForItem(item);
+        for (const std::string &existing : recording.itemNames)
+        {
+            if (existing == name)
+            {
+                name += [NSString stringWithFormat:@":%p", item].UTF8String;
+                break;
+            }
+        }
+        recording.itemNames.push_back(name);
+        const void *recorded = cha::ConstraintRecording::item(recording.itemNames.size() - 1);
+        recordedItems[(__bridge const void *)item] = recorded;
+        return recorded;
+    };
+    recordedItem(container);
+    
+    for (NSLayoutConstraint *constraint in constraints)
+    {
+        CHAConstraintDescriptor record = CHADescriptorForConstraint(constraint);
+        record.item = recordedItem(constraint.firstItem);
+        record.toItem = recordedItem(constraint.secondItem);
+        recording.records.push_back(record);
+        recording.origins.push_back(constraint.identifier ? std::string(constraint.identifier.UTF8String) : std::string());
+    }
+}
+
+static NSArray *CHAAnalyzeConstraints(NSArray *constraints, UIView *container, size_t *conflicts)
+{
+    cha::ConstraintRecording recording;
+    CHARecordConstraints(constraints, container, recording);
+    
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(recording.records.data(), recording.records.size(), recording.container(), recording.width,
+                            recording.height, report);
+    if (conflicts) *conflicts = report.countOf(cha::AnalysisIssueConflict);
+    
+    const std::vector<const char *> origins = recording.originPointers();
+    NSMutableArray *issues = [NSMutableArray arrayWithCapacity:report.issues.size()];
+    for (const cha::AnalysisIssue &issue : report.issues)
+    {
+        std::string description = cha::describeIssue(issue, recording.records.data(), origins.data(),
+                                                     [&recording](const void *item) { return recording.nameOfItem(item); });
+        [issues addObject:@(description.c_str())];
+    }
+    return issues;
+}
+
++ (NSArray *)analyzeConstraints:(NSArray *)constraints inContainer:(UIView *)container
+{
+    CHA_TRACE_HELPER(container);
+    NSAssert(container != nil, @"No container provided. Please provide the view the constraints lay out within.");
+    return CHAAnalyzeConstraints(constraints, container, NULL);
+}
+
++ (NSString *)recordingForConstraints:(NSArray *)constraints inContainer:(UIView *)container
+{
+    CHA_TRACE_HELPER(container);
+    NSAssert(container != nil, @"No container provided. Please provide the view the constraints lay out within.");
+    
+    cha::ConstraintRecording recording;
+    CHARecordConstraints(constraints, container, recording);
+    return @(cha::writeConstraintRecording(recording).c_str());
+}
+
++ (void)activateConstraints:(NSArray *)constraints inContainer:(UIView *)container
+{
+    CHA_TRACE_HELPER(container);
+#if CHA_CONSTRAINT_ANALYSIS
+    NSAssert(container != nil, @"No container provided. Please provide the view the constraints lay out within.");
+    size_t conflicts = 0;
+    for (NSString *issue in CHAAnalyzeConstraints(constraints, container, &conflicts))
+    {
+        NSLog(@"%@", issue);
+    }
+    NSAssert(conflicts == 0, @"Required constraints conflict. See the log for the constraints involved.");
+#endif
+    [NSLayoutConstraint activateConstraints:constraints];
+}
+
+#pragma mark - Edit Handles
+- (CHAConstraintEditHandle *)editHandleForConstraint:(NSLayoutConstraint *)constraint
+{
+    CHA_TRACE_HELPER(self);
+    NSAssert(constraint != nil, @"No constraint provided. Please provide a constraint returned by one of the helpers.");
+    NSAssert(constraint.firstItem == self || constraint.secondItem == self, @"Invalid constraint provided. The receiving view must be one of the constraint's items.");
+    return [[CHAConstraintEditHandle alloc] initWithConstraint:constraint];
+}
+
+#pragma mark - Compiled Layouts
++ (NSData *)compiledLayoutWithConstraints:(NSArray *)constraints container:(UIView *)container views:(NSArray *)views
+{
+    CHA_TRACE_HELPER(container);
+    NSAssert(container != nil, @"No container provided. Please provide the view the constraints lay out within.");
+    
+    cha::CompiledLayoutWriter writer((uint32_t)views.count + 1);
+    std::unordered_map<const void *, const void *> slots;
+    for (NSUInteger index = 0; index <= views.count; index++)
+    {
+        UIView *view = index == 0 ? container : views[index - 1];
+        slots[(__bridge const void *)view] = cha::CompiledLayoutWriter::slotHandle((uint32_t)index);
+        // Only identifiers are kept; a pointer means nothing once the layout is saved.
+        writer.setSlotName((uint32_t)index, view.accessibilityIdentifier.length > 0 ? view.accessibilityIdentifier.UTF8String : "");
+    }
+    
+    for (NSLayoutConstraint *constraint in constraints)
+    {
+        auto item = slots.find((__bridge const void *)constraint.firstItem);
+        auto toItem = slots.find((__bridge const void *)constraint.secondItem);
+        BOOL related = item != slots.end() && (toItem != slots.end() || constraint.secondItem == nil);
+        NSAssert(related, @"Compiled constraints may only relate the container and the views: %@", constraint);
+        if (!related) return nil;
+        
+        CHAConstraintDescriptor descriptor = CHADescriptorForConstraint(constraint);
+        descriptor.item = item->second;
+        descriptor.toItem = toItem != slots.end() ? toItem->second : NULL;
+        if (!writer.addDescriptor(descriptor))
+        {
+            NSAssert(NO, @"Invalid constraint provided. Margin attributes cannot be compiled: %@", constraint);
+            return nil;
+        }
+    }
+    
+    std::vector<uint8_t> bytes;
+    writer.write(bytes);
+    return [NSData dataWithBytes:bytes.data() length:bytes.size()];
+}
+
++ (NSArray *)constraintsWithCompiledLayout:(NSData *)layout container:(UIView *)container views:(NSArray *)views
+{
+    CHA_TRACE_HELPER(container);
+    NSAssert(container != nil, @"No container provided. Please provide the view to take the layout's first slot.");
+    
+    cha::CompiledLayout compiled;
+    const cha::CompiledLayoutStatus status = compiled.open(layout.bytes, layout.length);
+    if (status != cha::CompiledLayoutStatusOK)
+    {
+        NSLog(@"Compiled layout not loaded: %s", cha::describeCompiledLayoutStatus(status));
+        return nil;
+    }
+    if (compiled.slotCount() != views.count + 1)
+    {
+        NSLog(@"Compiled layout not loaded: compiled for %u views, given %lu", compiled.slotCount() - 1, (unsigned long)views.count);
+        return nil;
+    }
+    
+    std::vector<const void *> items;
+    items.reserve(views.count + 1);
+    items.push_back((__bridge const void *)container);
+    for (UIView *view in views)
+    {
+        items.push_back((__bridge const void *)view);
+    }
+    std::vector<CHAConstraintDescriptor> descriptors(compiled.recordCount());
+    compiled.instantiate(items.data(), descriptors.data());
+    return CHAConstraintsWithDescriptors(descriptors.data(), descriptors.size());
+}
+
+#pragma mark - Constraint Removal
+- (void)removeSuperviewConstraintsForViews:(NSArray *)views
+{
+    CHA_TRACE_HELPER(self);
+    std::vector<const void *> items;
+    items.reserve(views.count);
+    
+    for (id view in views)
+    {
+        NSAssert([view isKindOfClass:[UIView class]], @"Invalid object type provided. Only view objects should be provided");
+        items.push_back((__bridge const void *)view);
+    }
+    
+    // Retained under the lock, so no entry is removed by a sentinel while it is being read.
+    std::vector<const void *> ownedConstraints;
+    NSMutableArray *constraints = [NSMutableArray array];
+    {
+        std::lock_guard<std::mutex> lock(CHAOwnershipIndexMutex());
+        CHAOwnershipIndex().takeConstraintsForItems(items.data(), items.size(), ownedConstraints);
+        for (const void *constraint : ownedConstraints)
+        {
+            [constraints addObject:(__bridge NSLayoutConstraint *)constraint];
+        }
+    }
+    [NSLayoutConstraint deactivateConstraints:constraints];
+    
+    // Constraints added without the helpers are not in the index; find those on each superview in one pass over it.
+    NSHashTable *remainingViews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    NSHashTable *superviews = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    for (UIView *view in views)
+    {
+        [remainingViews addObject:view];
+        if (view.superview) [superviews addObject:view.superview];
+    }
+    for (UIView *superview in superviews)
+    {
+        for (NSLayoutConstraint *constraint in superview.constraints)
+        {
+            if ([remainingViews containsObject:constraint.firstItem] || [remainingViews containsObject:constraint.secondItem])
+            {
+                [superview removeConstraint:constraint];
+            }
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+
+@end
@@ -8,6 +8,8 @@
 
 #import "ViewController.h"
 #import "UIView+AutoLayoutHelper.h"
+#import "CHAConstraintCommitter.h"
+#import "CHATextMeasurer.h"
 
 #pragma mark - CHAHeaderView
 @interface CHAHeaderView : UIView <UITextViewDelegate>
@@ -17,7 +19,10 @@
 @property (nonatomic, strong) UILabel *fullnameLabel;
 @property (nonatomic, strong) UITextView *biographyTextView;
 @property (nonatomic, assign) BOOL laidOutConstraints;
+@property (nonatomic, copy) NSArray *detailConstraints;
+@property (nonatomic, assign) BOOL widenedMargins;
 - (void)setupConstraints;
+- (void)modifyConstraints;
 @end
 
 @implementation CHAHeaderView
@@ -53,36 +58,51 @@ const CGFloat defaultMargin = 10.f;
         _biographyTextView.backgroundColor = [UIColor yellowColor];
         _biographyTextView.text = @"Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic!";
         [_userDetailsContainer addSubview:_biographyTextView];
+        
+        // Tapping the header toggles the details' margins through the constraint diff.
+        [self addGestureRecognizer:[[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(modifyConstraints)]];
     }
     return self;
 }
 
 - (void)updateConstraints
 {
-    [self setupConstraints];
+    if (!self.laidOutConstraints)
+    {
+        [self setupConstraints];
+        self.laidOutConstraints = YES;
+    }
 
     [super updateConstraints];
 }
 
 - (void)setupConstraints
 {
-    [self addConstraints:[self profilePictureConstraints]];
-    [self addConstraints:[self userDetailsContainerConstraints]];
-    [self addConstraints:[self fullnameLabelConstraints]];
-    [self addConstraints:[self biographyTextViewConstraints]];
+    CHA_TRACE_SITE("CHAHeaderView -setupConstraints");
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    [self appendDetailDescriptors:&batch margin:defaultMargin];
+    self.detailConstraints = [UIView constraintsWithDescriptorBatch:&batch];
+    
+    NSArray *constraints = [[self profilePictureConstraints] arrayByAddingObjectsFromArray:self.detailConstraints];
+    [UIView activateConstraints:constraints inContainer:self];
 }
 
 - (void)modifyConstraints
 {
-    NSLog(@"%s\n[%s]: Line %i] %@",__FILE__,__PRETTY_FUNCTION__,__LINE__,
-          @"Modify existing constraints here");
+    CHA_TRACE_SITE("CHAHeaderView -modifyConstraints");
+    self.widenedMargins = !self.widenedMargins;
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    [self appendDetailDescriptors:&batch margin:self.widenedMargins ? 2 * defaultMargin : defaultMargin];
+    self.detailConstraints = [UIView updateConstraints:self.detailConstraints toDescriptorBatch:&batch];
 }
 
 - (NSArray *)profilePictureConstraints
 {
     NSLayoutConstraint *leading = [self.profilePicture pinLeading:defaultMargin];
     NSLayoutConstraint *centerY = [self.profilePicture alignCenterVerticalSuperview];
-    NSLayoutConstraint *aspectRatio = [self.profilePicture aspectRatio];
+    NSLayoutConstraint *aspectRatio = [self.profilePicture aspectRatio:1.f];
     NSLayoutConstraint *heightMax = [self.profilePicture height:NSLayoutRelationEqual multiplier:0.35f];
     NSLayoutConstraint *top = [self.profilePicture pinSide:NSLayoutAttributeTop
                                                   relation:NSLayoutRelationGreaterThanOrEqual
@@ -91,41 +111,44 @@ const CGFloat defaultMargin = 10.f;
     return @[leading,centerY,aspectRatio,heightMax,top];
 }
 
-- (NSArray *)userDetailsContainerConstraints
+- (void)appendDetailDescriptors:(CHADescriptorBatch *)batch margin:(CGFloat)margin
 {
-    return [[self.userDetailsContainer pinSides:@[@(NSLayoutAttributeTrailing)] constant:defaultMargin]
-            arrayByAddingObjectsFromArray:@[[self.userDetailsContainer pinSide:NSLayoutAttributeLeading
-                                                                        toView:self.profilePicture
-                                                                secondViewSide:NSLayoutAttributeTrailing
-                                                                      constant:defaultMargin],
-                                            [self.userDetailsContainer alignSide:NSLayoutAttributeTop
-                                                                          toView:self.profilePicture
-                                                                      secondSide:NSLayoutAttributeTop
-                                                                        constant:0],
-                                            [self.userDetailsContainer alignSide:NSLayoutAttributeBottom
-                                                                          toView:self.profilePicture
-                                                                      secondSide:NSLayoutAttributeBottom
-                                                                        constant:0]]];
-}
-
-- (NSArray *)fullnameLabelConstraints
-{
-    return [[self.fullnameLabel pinSides:@[@(NSLayoutAttributeLeading),@(NSLayoutAttributeTop),@(NSLayoutAttributeTrailing)] constant:0]
-            arrayByAddingObjectsFromArray:@[[self.fullnameLabel equalHeight:0.33f]]];
-}
-
-- (NSArray *)biographyTextViewConstraints
-{
-    return [[self.biographyTextView pinSides:@[@(NSLayoutAttributeLeading),@(NSLayoutAttributeTrailing),@(NSLayoutAttributeBottom)] constant:0]
-            arrayByAddingObject:[self.biographyTextView
-                                 pinSide:NSLayoutAttributeTop
-                                 toView:self.fullnameLabel
-                                 secondViewSide:NSLayoutAttributeBottom]];
+    // Twelve records; a batch holds CHA_DESCRIPTOR_BATCH_CAPACITY.
+    const void *container = (__bridge const void *)self.userDetailsContainer;
+    const void *picture = (__bridge const void *)self.profilePicture;
+    const void *label = (__bridge const void *)self.fullnameLabel;
+    const void *biography = (__bridge const void *)self.biographyTextView;
+    
+    CHADescriptorBatchAppendEdges(batch, container, (__bridge const void *)self, CHAEdgeTrailing, margin);
+    CHADescriptorBatchAppend(batch, container, CHALayoutAttributeLeading, CHALayoutRelationEqual,
+                             picture, CHALayoutAttributeTrailing, 1, margin);
+    CHADescriptorBatchAppend(batch, container, CHALayoutAttributeTop, CHALayoutRelationEqual,
+                             picture, CHALayoutAttributeTop, 1, 0);
+    CHADescriptorBatchAppend(batch, container, CHALayoutAttributeBottom, CHALayoutRelationEqual,
+                             picture, CHALayoutAttributeBottom, 1, 0);
+    
+    CHADescriptorBatchAppendEdges(batch, label, container, CHAEdgeLeading | CHAEdgeTop | CHAEdgeTrailing, 0);
+    // One line of the name; measured once, then served from the cache on every rebuild.
+    CGSize nameSize = [[CHATextMeasurer sharedMeasurer] sizeForText:self.fullnameLabel.text
+                                                               font:self.fullnameLabel.font
+                                                              width:0
+                                                          lineLimit:1];
+    CHADescriptorBatchAppend(batch, label, CHALayoutAttributeHeight, CHALayoutRelationEqual,
+                             NULL, CHALayoutAttributeNotAnAttribute, 1, nameSize.height);
+    
+    CHADescriptorBatchAppendEdges(batch, biography, container, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeBottom, 0);
+    CHADescriptorBatchAppend(batch, biography, CHALayoutAttributeTop, CHALayoutRelationEqual,
+                             label, CHALayoutAttributeBottom, 1, 0);
 }
 
 @end
 
 #pragma mark - ViewController
+@interface ViewController ()
+@property (nonatomic, strong) UIView *contentContainer;
+@property (nonatomic, strong) UIView *footerView;
+@end
+
 @implementation ViewController
 
 - (void)viewDidLoad
@@ -138,21 +161,60 @@ const CGFloat defaultMargin = 10.f;
 - (void)viewDidAppear:(BOOL)animated
 {
     [super viewDidAppear:animated];
+    if (!self.footerView)
+    {
+        [self setupFooter];
+    }
 }
 
 - (void)setupMainContainers
 {
+    CHA_TRACE_SITE("ViewController -setupMainContainers");
+    UIView *container = self.view;
     CHAHeaderView *headerView = [self headerView];
-    [self.view addSubview:headerView];
-    [self.view addConstraints:[self headerViewConstraints:headerView]];
-    
+    [container addSubview:headerView];
     UIView *contentView = [self contentView];
-    [self.view addSubview:contentView];
-    [self.view addConstraint:[contentView pinSide:NSLayoutAttributeTop
-                                           toView:headerView
-                                   secondViewSide:NSLayoutAttributeBottom]];
-    [self.view addConstraints:[contentView pinLeadingTrailing]];
-    [self.view addConstraint:[contentView pinToBottomSuperview]];
+    [container addSubview:contentView];
+    self.contentContainer = contentView;
+    
+    // The first frame depends on these, so they are installed before viewDidLoad returns.
+    const void *containerItem = (__bridge const void *)container;
+    const void *headerItem = (__bridge const void *)headerView;
+    const void *contentItem = (__bridge const void *)contentView;
+    
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, headerItem, containerItem, CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing, 0);
+    CHADescriptorBatchAppend(&batch, headerItem, CHALayoutAttributeHeight, CHALayoutRelationEqual,
+                             containerItem, CHALayoutAttributeHeight, 1.f/3.f, 0);
+    CHADescriptorBatchAppend(&batch, contentItem, CHALayoutAttributeTop, CHALayoutRelationEqual,
+                             headerItem, CHALayoutAttributeBottom, 1, 0);
+    CHADescriptorBatchAppendEdges(&batch, contentItem, containerItem, CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing, 0);
+    [UIView activateConstraints:[UIView constraintsWithDescriptorBatch:&batch] inContainer:container];
+}
+
+- (void)setupFooter
+{
+    CHA_TRACE_SITE("ViewController -setupFooter");
+    UIView *contentView = self.contentContainer;
+    self.footerView = [UIView new];
+    self.footerView.translatesAutoresizingMaskIntoConstraints = false;
+    self.footerView.backgroundColor = [UIColor purpleColor];
+    [contentView addSubview:self.footerView];
+    UIView *footerView = self.footerView;
+    
+    // Added after the first frame, so it is described off the main thread and installed on the next runloop turn.
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
+        const void *contentItem = (__bridge const void *)contentView;
+        const void *footerItem = (__bridge const void *)footerView;
+        
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, footerItem, contentItem, CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing, defaultMargin);
+        CHADescriptorBatchAppend(&batch, footerItem, CHALayoutAttributeHeight, CHALayoutRelationEqual,
+                                 NULL, CHALayoutAttributeNotAnAttribute, 1, 44);
+        [[CHAConstraintCommitter mainCommitter] commitDescriptorBatch:&batch];
+    });
 }
 
 - (CHAHeaderView *)headerView
@@ -162,17 +224,6 @@ const CGFloat defaultMargin = 10.f;
     return customHeaderView;
 }
 
-- (NSArray *)headerViewConstraints:(UIView *)headerView
-{
-    NSMutableArray *headerConstraints = [NSMutableArray new];
-    
-    [headerConstraints addObjectsFromArray:[headerView pinLeadingTrailing]];
-    [headerConstraints addObject:[headerView pinToTopSuperview]];
-    [headerConstraints addObject:[headerView equalHeight:(1.f/3.f)]];
-    
-    return headerConstraints;
-}
-
 - (UIView *)contentView
 {
     UIView *contentView = [UIView new];
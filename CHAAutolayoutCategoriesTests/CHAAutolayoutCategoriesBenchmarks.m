@@ -0,0 +1,188 @@
+//
+//  CHAAutolayoutCategoriesBenchmarks.m
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import <XCTest/XCTest.h>
+#import <QuartzCore/QuartzCore.h>
+#import "UIView+AutoLayoutHelper.h"
+
+static const NSUInteger CHABenchmarkViewCount = 1000;
+
+/**
+ @description Per-run samples in nanoseconds, keyed by benchmark name, written out as JSON when the class finishes
+ */
+static NSMutableDictionary *CHABenchmarkSamples;
+
+@interface CHAAutolayoutCategoriesBenchmarks : XCTestCase
+
+@property (nonatomic, strong) UIView *container;
+@property (nonatomic, strong) NSArray *views;
+
+@end
+
+@implementation CHAAutolayoutCategoriesBenchmarks
+
++ (void)setUp {
+    [super setUp];
+    CHABenchmarkSamples = [NSMutableDictionary dictionary];
+}
+
++ (void)tearDown {
+    [self writeBenchmarkResults];
+    [super tearDown];
+}
+
+- (void)setUp {
+    [super setUp];
+    [self makeViews];
+}
+
+/**
+ @description Replace the container and its views with new ones, which have no constraints in the registry yet
+ */
+- (void)makeViews {
+    self.container = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    NSMutableArray *views = [NSMutableArray arrayWithCapacity:CHABenchmarkViewCount];
+    for (NSUInteger i = 0; i < CHABenchmarkViewCount; i++) {
+        UIView *view = [UIView new];
+        view.translatesAutoresizingMaskIntoConstraints = NO;
+        [self.container addSubview:view];
+        [views addObject:view];
+    }
+    self.views = views;
+}
+
+#pragma mark - Helpers
+// Each run gets new views, untimed, so the registry has nothing to hand back and every constraint is built.
+
+- (void)testPinToSuperviewBoundsInsetsPerformance {
+    UIEdgeInsets insets = UIEdgeInsetsMake(8, 16, 8, 16);
+    [self measureFreshViewsBenchmark:@"helpers/pinToSuperviewBoundsInsets" block:^{
+        for (UIView *view in self.views) {
+            [view pinToSuperviewBoundsInsets:insets];
+        }
+    }];
+}
+
+- (void)testPinSidesPerformance {
+    NSArray *sides = @[@(NSLayoutAttributeLeading), @(NSLayoutAttributeTrailing), @(NSLayoutAttributeTop)];
+    [self measureFreshViewsBenchmark:@"helpers/pinSides" block:^{
+        for (UIView *view in self.views) {
+            [view pinSides:sides constant:10];
+        }
+    }];
+}
+
+- (void)testEqualWidthsPerformance {
+    [self measureFreshViewsBenchmark:@"helpers/equalWidths" block:^{
+        UIView *reference = self.views.firstObject;
+        [reference equalWidths:[self.views subarrayWithRange:NSMakeRange(1, self.views.count - 1)] multiplier:0.5];
+    }];
+}
+
+- (void)testStackAboveViewPerformance {
+    [self measureFreshViewsBenchmark:@"helpers/stackAboveView" block:^{
+        for (NSUInteger i = 1; i < self.views.count; i++) {
+            [self.views[i - 1] stackAboveView:self.views[i] superviewMargin:8 interViewSpacing:4];
+        }
+    }];
+}
+
+#pragma mark - End to End
+
+- (void)testChainLayoutPerformance {
+    NSMutableArray *constraints = [NSMutableArray array];
+    [self.views enumerateObjectsUsingBlock:^(UIView *view, NSUInteger index, BOOL *stop) {
+        [constraints addObjectsFromArray:[view pinEdges:(CHAEdgeLeading | CHAEdgeTrailing) constant:8]];
+        [constraints addObject:[view height:44]];
+        if (index == 0) {
+            [constraints addObject:[view pinToTopSuperview]];
+        } else {
+            [constraints addObject:[UIView registeredConstraintWithItem:view attribute:NSLayoutAttributeTop relatedBy:NSLayoutRelationEqual
+                                                                 toItem:self.views[index - 1] attribute:NSLayoutAttributeBottom
+                                                             multiplier:1 constant:4]];
+        }
+    }];
+    
+    __block CGFloat width = 320;
+    [self measureBenchmark:@"layout/chain/1000" block:^{
+        [NSLayoutConstraint activateConstraints:constraints];
+        width = width == 320 ? 375 : 320;
+        self.container.frame = CGRectMake(0, 0, width, 480);
+        [self.container layoutIfNeeded];
+        [NSLayoutConstraint deactivateConstraints:constraints];
+    }];
+}
+
+#pragma mark - Recording
+
+/**
+ @description Run block under -measureBlock: and also record each run's duration for the JSON report
+ */
+- (void)measureBenchmark:(NSString *)name block:(void (^)(void))block {
+    NSMutableArray *samples = CHABenchmarkSamples[name] ?: [NSMutableArray array];
+    CHABenchmarkSamples[name] = samples;
+    [self measureBlock:^{
+        CFTimeInterval start = CACurrentMediaTime();
+        block();
+        [samples addObject:@((CACurrentMediaTime() - start) * 1e9)];
+    }];
+}
+
+/**
+ @description Like measureBenchmark:block:, but with new views made before each run and left out of its time
+ */
+- (void)measureFreshViewsBenchmark:(NSString *)name block:(void (^)(void))block {
+    NSMutableArray *samples = CHABenchmarkSamples[name] ?: [NSMutableArray array];
+    CHABenchmarkSamples[name] = samples;
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self makeViews];
+        [self startMeasuring];
+        CFTimeInterval start = CACurrentMediaTime();
+        block();
+        [samples addObject:@((CACurrentMediaTime() - start) * 1e9)];
+        [self stopMeasuring];
+    }];
+}
+
+/**
+ @description Nearest-rank percentile of an ascending sample set
+ */
+static double CHAPercentile(NSArray *sorted, double fraction) {
+    NSUInteger rank = (NSUInteger)ceil(fraction * sorted.count);
+    return [sorted[MIN(MAX(rank, (NSUInteger)1), sorted.count) - 1] doubleValue];
+}
+
+/**
+ @description Write the same shape of JSON as the portable runner's --json, to $CHA_BENCHMARK_JSON or the temporary directory
+ */
++ (void)writeBenchmarkResults {
+    NSMutableArray *benchmarks = [NSMutableArray array];
+    for (NSString *name in [CHABenchmarkSamples.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        NSArray *sorted = [CHABenchmarkSamples[name] sortedArrayUsingSelector:@selector(compare:)];
+        if (sorted.count == 0) continue;
+        
+        NSNumber *mean = [sorted valueForKeyPath:@"@avg.self"];
+        [benchmarks addObject:@{@"name": name,
+                                @"size": @(CHABenchmarkViewCount),
+                                @"samples": @(sorted.count),
+                                @"min_ns": @([sorted.firstObject longLongValue]),
+                                @"p50_ns": @((long long)CHAPercentile(sorted, 0.5)),
+                                @"p90_ns": @((long long)CHAPercentile(sorted, 0.9)),
+                                @"p99_ns": @((long long)CHAPercentile(sorted, 0.99)),
+                                @"max_ns": @([sorted.lastObject longLongValue]),
+                                @"mean_ns": @(mean.longLongValue)}];
+    }
+    
+    NSString *path = [NSProcessInfo processInfo].environment[@"CHA_BENCHMARK_JSON"] ?:
+        [NSTemporaryDirectory() stringByAppendingPathComponent:@"CHAAutolayoutCategoriesBenchmarks.json"];
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"benchmarks": benchmarks} options:NSJSONWritingPrettyPrinted error:NULL];
+    [data writeToFile:path atomically:YES];
+    NSLog(@"Benchmark results written to %@", path);
+}
+
+@end
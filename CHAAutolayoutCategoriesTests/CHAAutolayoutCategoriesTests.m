@@ -8,6 +8,11 @@
 
 #import <UIKit/UIKit.h>
 #import <XCTest/XCTest.h>
+#import "UIView+AutoLayoutHelper.h"
+#import "CHALayoutPrecomputer.h"
+#import "CHAConstraintCommitter.h"
+#import "CHAConstraintEditHandle.h"
+#import "CHATextMeasurer.h"
 
 @interface CHAAutolayoutCategoriesTests : XCTestCase
 
@@ -30,11 +35,383 @@
     XCTAssert(YES, @"Pass");
 }
 
-- (void)testPerformanceExample {
-    // This is an example of a performance test case.
-    [self measureBlock:^{
-        // Put the code you want to measure the time of here.
-    }];
+- (void)testRepeatedPinningReusesRegisteredConstraint {
+    UIView *superview = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    UIView *view = [UIView new];
+    [superview addSubview:view];
+    [UIView resetConstraintRegistryCounters];
+    
+    NSLayoutConstraint *leading = [view pinLeading:10];
+    [superview addConstraint:leading];
+    for (NSUInteger pass = 0; pass < 1000; pass++) {
+        [superview addConstraints:[view pinSides:@[@(NSLayoutAttributeLeading)] constant:(pass % 2) ? 20 : 10]];
+    }
+    
+    CHAConstraintRegistryCounters counters = [UIView constraintRegistryCounters];
+    XCTAssertEqual(superview.constraints.count, (NSUInteger)1);
+    XCTAssertEqual(counters.created, (NSUInteger)1);
+    XCTAssertEqual(counters.reused, (NSUInteger)1000);
+    XCTAssertEqual(counters.updated, (NSUInteger)999);
+    XCTAssertEqual(leading.constant, 20);
+}
+
+- (void)testPinSidesKeepsTheCallersOrder {
+    UIView *superview = [UIView new];
+    UIView *view = [UIView new];
+    [superview addSubview:view];
+    
+    NSArray *constraints = [view pinSides:@[@(NSLayoutAttributeTrailing),@(NSLayoutAttributeTop),@(NSLayoutAttributeLeft),@(NSLayoutAttributeTop)]
+                                 constant:8];
+    
+    XCTAssertEqual(constraints.count, (NSUInteger)4);
+    XCTAssertEqual([constraints[0] firstAttribute], NSLayoutAttributeTrailing);
+    XCTAssertEqual([constraints[0] constant], -8);
+    XCTAssertEqual([constraints[1] firstAttribute], NSLayoutAttributeTop);
+    XCTAssertEqual([constraints[2] firstAttribute], NSLayoutAttributeLeading);
+    XCTAssertEqual(constraints[3], constraints[1]);
+}
+
+- (void)testRegistryReusesInstalledConstraintsOnlyAtTheirPriority {
+    UIView *superview = [UIView new];
+    UIView *view = [UIView new];
+    [superview addSubview:view];
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHAConstraintDescriptor *record = CHADescriptorBatchAppend(&batch, (__bridge const void *)view, CHALayoutAttributeWidth,
+                                                               CHALayoutRelationEqual, NULL, CHALayoutAttributeNotAnAttribute, 1, 40);
+    
+    // Required to optional: the installed constraint cannot be lowered, so a new one is made.
+    NSLayoutConstraint *required = [UIView constraintsWithDescriptorBatch:&batch].firstObject;
+    required.active = YES;
+    record->priority = 750;
+    NSLayoutConstraint *optional = [UIView constraintsWithDescriptorBatch:&batch].firstObject;
+    XCTAssertNotEqual(optional, required);
+    XCTAssertEqual(required.priority, UILayoutPriorityRequired);
+    XCTAssertEqual(optional.priority, (UILayoutPriority)750);
+    
+    // Optional back to required: the installed optional constraint is not handed back at 750.
+    required.active = NO;
+    optional.active = YES;
+    record->priority = CHALayoutPriorityRequired;
+    NSLayoutConstraint *requiredAgain = [UIView constraintsWithDescriptorBatch:&batch].firstObject;
+    XCTAssertNotEqual(requiredAgain, optional);
+    XCTAssertEqual(requiredAgain.priority, UILayoutPriorityRequired);
+    
+    // An inactive constraint is reused and takes whatever priority is asked for.
+    optional.active = NO;
+    record->priority = 500;
+    XCTAssertEqual([UIView constraintsWithDescriptorBatch:&batch].firstObject, requiredAgain);
+    XCTAssertEqual(requiredAgain.priority, (UILayoutPriority)500);
+}
+
+- (void)testDifferentRelationsAreRegisteredSeparately {
+    UIView *superview = [UIView new];
+    UIView *view = [UIView new];
+    [superview addSubview:view];
+    
+    NSLayoutConstraint *equal = [view pinSide:NSLayoutAttributeTop relation:NSLayoutRelationEqual constant:0];
+    NSLayoutConstraint *greater = [view pinSide:NSLayoutAttributeTop relation:NSLayoutRelationGreaterThanOrEqual constant:0];
+    XCTAssertNotEqual(equal, greater);
+    XCTAssertEqual(equal, [view pinToTopSuperview]);
+}
+
+- (void)testRemovingViewsDeactivatesConstraintsOnEveryAncestor {
+    UIView *root = [UIView new];
+    UIView *container = [UIView new];
+    UIView *top = [UIView new];
+    UIView *bottom = [UIView new];
+    [root addSubview:container];
+    [container addSubview:top];
+    [container addSubview:bottom];
+    
+    [container addConstraints:[top stackAboveView:bottom superviewMargin:8 interViewSpacing:4]];
+    [root addConstraint:[top equalWidthToView:root]];
+    [root addConstraint:[container pinLeading]];
+    
+    [root removeSuperviewConstraintsForViews:@[top]];
+    
+    XCTAssertEqual(container.constraints.count, (NSUInteger)3);
+    XCTAssertEqual(root.constraints.count, (NSUInteger)1);
+}
+
+- (void)testPrecomputedTemplateFramesMatchConstraints {
+    UIView *cell = [UIView new];
+    UIView *title = [UIView new];
+    UIView *body = [UIView new];
+    [cell addSubview:title];
+    [cell addSubview:body];
+    
+    NSMutableArray *constraints = [NSMutableArray array];
+    [constraints addObjectsFromArray:[title pinEdges:(CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing) constant:10]];
+    [constraints addObjectsFromArray:[body pinEdges:(CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing) constant:10]];
+    [constraints addObject:[UIView registeredConstraintWithItem:body attribute:NSLayoutAttributeTop relatedBy:NSLayoutRelationEqual
+                                                         toItem:title attribute:NSLayoutAttributeBottom multiplier:1 constant:8]];
+    CHALayoutTemplate *layoutTemplate = [[CHALayoutTemplate alloc] initWithContainer:cell views:@[title, body] constraints:constraints];
+    
+    CHALayoutPrecomputer *precomputer = [[CHALayoutPrecomputer alloc] initWithCacheCapacity:8];
+    NSArray *contentSizes = @[[NSValue valueWithCGSize:CGSizeMake(0, 20)], [NSValue valueWithCGSize:CGSizeMake(0, 60)]];
+    CGFloat height = [precomputer heightForTemplate:layoutTemplate width:320 contentHash:1 contentSizes:contentSizes];
+    XCTAssertEqualWithAccuracy(height, 108, 0.001);
+    
+    cell.frame = CGRectMake(0, 0, 320, height);
+    XCTAssertTrue([precomputer applyTemplate:layoutTemplate toContainer:cell views:@[title, body] contentHash:1 contentSizes:contentSizes]);
+    XCTAssertTrue(CGRectEqualToRect(title.frame, CGRectMake(10, 10, 300, 20)));
+    XCTAssertTrue(CGRectEqualToRect(body.frame, CGRectMake(10, 38, 300, 60)));
+}
+
+
+- (void)testStackingViewsEmitsMinimalChain {
+    UIView *form = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 208)];
+    NSMutableArray *rows = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 4; index++) {
+        UIView *row = [UIView new];
+        row.translatesAutoresizingMaskIntoConstraints = NO;
+        [form addSubview:row];
+        [rows addObject:row];
+    }
+    
+    NSArray *constraints = [form stackViews:rows
+                                       axis:UILayoutConstraintAxisVertical
+                                    spacing:8
+                                    margins:UIEdgeInsetsMake(10, 16, 10, 16)
+                               distribution:CHAStackDistributionFillEqually];
+    XCTAssertEqual(constraints.count, (NSUInteger)(1 + 3 + 1 + 3 + 2 * 4));
+    
+    [form addConstraints:constraints];
+    [form layoutIfNeeded];
+    XCTAssertTrue(CGRectEqualToRect([rows[0] frame], CGRectMake(16, 10, 288, 41)));
+    XCTAssertTrue(CGRectEqualToRect([rows[3] frame], CGRectMake(16, 157, 288, 41)));
+}
+
+
+- (void)testGridLayoutSetsSquareFrames {
+    UIView *grid = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    NSMutableArray *photos = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 10; index++) {
+        UIView *photo = [UIView new];
+        [grid addSubview:photo];
+        [photos addObject:photo];
+    }
+    
+    CGFloat height = [grid layoutGridViews:photos columns:4 spacing:2 insets:UIEdgeInsetsMake(4, 4, 4, 4)];
+    XCTAssertEqualWithAccuracy(height, 4 + 3 * 76.5 + 2 * 2 + 4, 0.001);
+    XCTAssertTrue(CGRectEqualToRect([photos[5] frame], CGRectMake(4 + 78.5, 4 + 78.5, 76.5, 76.5)));
+}
+
+
+- (void)testUpdatingConstraintsTouchesOnlyWhatChanged {
+    UIView *superview = [UIView new];
+    UIView *view = [UIView new];
+    [superview addSubview:view];
+    
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, (__bridge const void *)view, (__bridge const void *)superview,
+                                  CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing, 8);
+    NSArray *before = [UIView constraintsWithDescriptorBatch:&batch];
+    [NSLayoutConstraint activateConstraints:before];
+    
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, (__bridge const void *)view, (__bridge const void *)superview,
+                                  CHAEdgeTop | CHAEdgeLeading | CHAEdgeBottom, 8);
+    batch.records[2].constant = 16;
+    NSArray *after = [UIView updateConstraints:before toDescriptorBatch:&batch];
+    
+    // Edges are emitted top, bottom, leading, trailing: the top pin is kept, the leading pin updated, the trailing pin
+    // replaced by a bottom pin.
+    XCTAssertEqual(after.count, (NSUInteger)3);
+    XCTAssertEqual(after[0], before[0]);
+    XCTAssertEqual(after[2], before[1]);
+    XCTAssertEqual([after[2] constant], 16);
+    XCTAssertFalse([before[2] isActive]);
+    XCTAssertTrue([after[1] isActive]);
+    XCTAssertEqual([after[1] firstAttribute], NSLayoutAttributeBottom);
+    XCTAssertEqual(superview.constraints.count, (NSUInteger)3);
+}
+
+- (void)testAnalyzerFindsConflictsBeforeInstall {
+    UIView *superview = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    UIView *view = [UIView new];
+    view.accessibilityIdentifier = @"view";
+    [superview addSubview:view];
+    
+    NSMutableArray *constraints = [[view pinToSuperviewBounds] mutableCopy];
+    XCTAssertEqual([UIView analyzeConstraints:constraints inContainer:superview].count, (NSUInteger)0);
+    
+    [constraints addObject:[view width:400]];
+    NSArray *issues = [UIView analyzeConstraints:constraints inContainer:superview];
+    XCTAssertEqual(issues.count, (NSUInteger)1);
+    XCTAssertTrue([issues[0] hasPrefix:@"conflict: #4 view.width == 400"]);
+    XCTAssertTrue([[UIView recordingForConstraints:constraints inContainer:superview] containsString:@"constraint view width == - notAnAttribute 0 400 1000"]);
+    
+    // A symmetric inset pins trailing inward like leading.
+    UIView *inset = [UIView new];
+    [superview addSubview:inset];
+    NSArray *pins = [inset pinLeadingTrailing:10];
+    XCTAssertEqual([pins[1] constant], -10);
+}
+
+- (void)testCommitterInstallsBackgroundDescriptorsOnTheCommonAncestor {
+    UIView *container = [UIView new];
+    UIView *header = [UIView new];
+    UIView *content = [UIView new];
+    UIView *label = [UIView new];
+    [container addSubview:header];
+    [container addSubview:content];
+    [content addSubview:label];
+    
+    CHAConstraintCommitter *committer = [CHAConstraintCommitter new];
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, (__bridge const void *)header, (__bridge const void *)container,
+                                      CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing, 0);
+        CHADescriptorBatchAppend(&batch, (__bridge const void *)content, CHALayoutAttributeTop, CHALayoutRelationEqual,
+                                 (__bridge const void *)header, CHALayoutAttributeBottom, 1, 0);
+        [committer commitDescriptorBatch:&batch];
+    });
+    dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, (__bridge const void *)label, (__bridge const void *)content, CHAEdgeAll, 8);
+        CHADescriptorBatchAppend(&batch, (__bridge const void *)label, CHALayoutAttributeHeight, CHALayoutRelationEqual,
+                                 NULL, CHALayoutAttributeNotAnAttribute, 1, 44);
+        [committer commitDescriptorBatch:&batch];
+    });
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    
+    // Nothing is installed until the main thread commits, and then both producers share one commit.
+    XCTAssertEqual(container.constraints.count, (NSUInteger)0);
+    XCTAssertEqual([committer flush], (NSUInteger)9);
+    XCTAssertEqual(committer.commitCount, (NSUInteger)1);
+    XCTAssertEqual(container.constraints.count, (NSUInteger)4);
+    XCTAssertEqual(content.constraints.count, (NSUInteger)4);
+    XCTAssertEqual(label.constraints.count, (NSUInteger)1);
+    XCTAssertEqual([committer flush], (NSUInteger)0);
+}
+
+- (void)testRatioConstraintsIgnoreTheCurrentFrame {
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(160, 90), YES, 1);
+    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    
+    // None of these views has been laid out; their frames are CGRectZero.
+    UIImageView *imageView = [[UIImageView alloc] initWithImage:image];
+    imageView.frame = CGRectZero;
+    XCTAssertEqualWithAccuracy([imageView aspectRatio].multiplier, 90.0 / 160.0, 0.0001);
+    
+    UIImageView *placeholder = [UIImageView new];
+    XCTAssertNil([placeholder aspectRatio]);
+    XCTAssertEqualWithAccuracy([placeholder aspectRatio:4.f/3.f].multiplier, 0.75, 0.0001);
+    XCTAssertEqualWithAccuracy([placeholder aspectRatioForImageSize:CGSizeMake(1600, 900)].multiplier, 0.5625, 0.0001);
+    XCTAssertNil([placeholder aspectRatioForImageSize:CGSizeZero]);
+    XCTAssertEqualWithAccuracy([imageView proportionalHeightForWidth:45].multiplier, 2, 0.0001);
+    XCTAssertNil([placeholder proportionalHeightForWidth:45]);
+    XCTAssertNil([[UIView new] proportionalWidthForHeight:45]);
+}
+
+- (void)testEditHandlesMoveConstantsInPlace {
+    UIView *superview = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    UIView *topView = [UIView new];
+    UIView *bottomView = [UIView new];
+    topView.translatesAutoresizingMaskIntoConstraints = NO;
+    bottomView.translatesAutoresizingMaskIntoConstraints = NO;
+    [superview addSubview:topView];
+    [superview addSubview:bottomView];
+    NSArray *stack = [topView stackAboveView:bottomView superviewMargin:10 interViewSpacing:-8];
+    [superview addConstraints:stack];
+    // Answered with the stack's own leading constraint.
+    NSLayoutConstraint *leading = [topView pinLeading:10];
+    [superview layoutIfNeeded];
+    
+    CHAConstraintEditHandle *spacing = [topView editHandleForConstraint:stack.lastObject];
+    CHAConstraintEditHandle *margin = [topView editHandleForConstraint:leading];
+    XCTAssertEqual(spacing.value, -8);
+    XCTAssertEqual(margin.value, 10);
+    
+    for (CGFloat frame = 0; frame < 60; frame++) {
+        CGFloat values[] = {-8 - frame, 10 + frame};
+        [CHAConstraintEditHandle suggestValues:values forHandles:@[spacing, margin]];
+        [superview layoutIfNeeded];
+        XCTAssertEqualWithAccuracy(CGRectGetMinY(bottomView.frame) - CGRectGetMaxY(topView.frame), 8 + frame, 0.001);
+        XCTAssertEqualWithAccuracy(CGRectGetMinX(topView.frame), 10 + frame, 0.001);
+    }
+    
+    // The constraints themselves were edited, never replaced.
+    XCTAssertEqual(superview.constraints.count, stack.count);
+    XCTAssertTrue([superview.constraints containsObject:leading]);
+    XCTAssertEqual(leading.constant, 69);
+}
+
+- (void)testCompiledLayoutsRebuildTheirConstraintsForNewViews {
+    UIView *superview = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    UIView *topView = [UIView new];
+    UIView *bottomView = [UIView new];
+    topView.translatesAutoresizingMaskIntoConstraints = NO;
+    bottomView.translatesAutoresizingMaskIntoConstraints = NO;
+    topView.accessibilityIdentifier = @"top";
+    [superview addSubview:topView];
+    [superview addSubview:bottomView];
+    NSMutableArray *constraints = [[topView stackAboveView:bottomView superviewMargin:10 interViewSpacing:-8] mutableCopy];
+    [constraints addObject:[topView height:40]];
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"stack.chal"];
+    NSData *compiled = [UIView compiledLayoutWithConstraints:constraints container:superview views:@[topView, bottomView]];
+    XCTAssertTrue([compiled writeToFile:path atomically:YES]);
+    NSData *mapped = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:NULL];
+    XCTAssertEqualObjects(mapped, compiled);
+    
+    UIView *container = [[UIView alloc] initWithFrame:CGRectMake(0, 0, 320, 480)];
+    UIView *header = [UIView new];
+    UIView *content = [UIView new];
+    header.translatesAutoresizingMaskIntoConstraints = NO;
+    content.translatesAutoresizingMaskIntoConstraints = NO;
+    [container addSubview:header];
+    [container addSubview:content];
+    NSArray *loaded = [UIView constraintsWithCompiledLayout:mapped container:container views:@[header, content]];
+    XCTAssertEqual(loaded.count, constraints.count);
+    [container addConstraints:loaded];
+    [superview addConstraints:constraints];
+    [container layoutIfNeeded];
+    [superview layoutIfNeeded];
+    XCTAssertTrue(CGRectEqualToRect(topView.frame, CGRectMake(10, 10, 300, 40)));
+    XCTAssertTrue(CGRectEqualToRect(bottomView.frame, CGRectMake(10, 58, 300, 412)));
+    XCTAssertTrue(CGRectEqualToRect(header.frame, topView.frame));
+    XCTAssertTrue(CGRectEqualToRect(content.frame, bottomView.frame));
+    
+    // A layout for a different number of views, or one that was damaged, is refused.
+    XCTAssertNil([UIView constraintsWithCompiledLayout:mapped container:container views:@[header]]);
+    NSMutableData *damaged = [mapped mutableCopy];
+    ((uint8_t *)damaged.mutableBytes)[damaged.length - 1] ^= 0xff;
+    XCTAssertNil([UIView constraintsWithCompiledLayout:damaged container:container views:@[header, content]]);
+}
+
+- (void)testTextMeasurerMeasuresIdenticalTextOnce {
+    CHATextMeasurer *measurer = [CHATextMeasurer new];
+    UIFont *font = [UIFont systemFontOfSize:15];
+    NSString *biography = @"Your favorite app studio on both sides of the Atlantic! Your favorite app studio on both sides of the Atlantic!";
+    
+    CGSize wrapped = [measurer sizeForText:biography font:font width:200 lineLimit:0];
+    for (int scroll = 0; scroll < 10; scroll++)
+    {
+        // A copy with the same contents is the same key.
+        CGSize again = [measurer sizeForText:[biography mutableCopy] font:[UIFont systemFontOfSize:15] width:200 lineLimit:0];
+        XCTAssertTrue(CGSizeEqualToSize(wrapped, again));
+    }
+    XCTAssertEqual(measurer.missCount, (NSUInteger)1);
+    XCTAssertEqual(measurer.hitCount, (NSUInteger)10);
+    XCTAssertTrue(wrapped.width <= 200);
+    
+    CGSize twoLines = [measurer sizeForText:biography font:font width:200 lineLimit:2];
+    XCTAssertTrue(twoLines.height < wrapped.height);
+    XCTAssertEqualWithAccuracy(twoLines.height, ceil(2 * font.lineHeight), 1);
+    
+    measurer.byteBudget = 0;
+    XCTAssertEqual(measurer.evictionCount, (NSUInteger)2);
+    
+    UIView *label = [UIView new];
+    XCTAssertEqualWithAccuracy([label heightForText:@"Chisel Apps" font:font width:0 lineLimit:1].constant, ceil(font.lineHeight), 1);
 }
 
 @end
@@ -0,0 +1,106 @@
+//
+//  CHAAspectRatioTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHAAspectRatio.h"
+#include "CHALayoutSystem.h"
+
+namespace {
+
+int container, picture;
+
+// Pins an item's top, leading and trailing edges to the container so only its height is left to a ratio.
+void pinToTopEdges(cha::LayoutSystem &layout, const void *item)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, item, &container, CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing, 0);
+    layout.addBatch(batch);
+}
+
+}
+
+CHA_TEST(testRatiosResolveFromTheirSourceWithoutAFrame)
+{
+    double multiplier = 0;
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, cha::resolveRatio(cha::RatioSpec::declared(16, 9), -1, -1, &multiplier));
+    CHA_CHECK_CLOSE(9.0 / 16.0, multiplier, 1e-12);
+    CHA_CHECK_EQUAL(cha::RatioStatusInvalid, cha::resolveRatio(cha::RatioSpec::declared(16, 0), -1, -1, &multiplier));
+    CHA_CHECK_EQUAL(cha::RatioStatusInvalid, cha::resolveRatio(cha::RatioSpec::declared(-4, 3), -1, -1, &multiplier));
+
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, cha::resolveRatio(cha::RatioSpec::imageSize(1024, 768), 10, 10, &multiplier));
+    CHA_CHECK_CLOSE(0.75, multiplier, 1e-12);
+    CHA_CHECK_EQUAL(cha::RatioStatusPending, cha::resolveRatio(cha::RatioSpec::imageSize(0, 0), 10, 10, &multiplier));
+
+    // An intrinsic size wins over the fallback; without either the ratio waits.
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, cha::resolveRatio(cha::RatioSpec::intrinsicSize(1, 1), 200, 50, &multiplier));
+    CHA_CHECK_CLOSE(0.25, multiplier, 1e-12);
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, cha::resolveRatio(cha::RatioSpec::intrinsicSize(1, 1), -1, -1, &multiplier));
+    CHA_CHECK_CLOSE(1.0, multiplier, 1e-12);
+    CHA_CHECK_EQUAL(cha::RatioStatusPending, cha::resolveRatio(cha::RatioSpec::intrinsicSize(), -1, 50, &multiplier));
+}
+
+CHA_TEST(testAspectRatioResolvesAtFirstSolveAndIsCached)
+{
+    cha::LayoutSystem layout;
+    layout.setContainer(&container, 320, 480);
+    pinToTopEdges(layout, &picture);
+    const cha::LayoutSystem::AspectRatio ratio = layout.addAspectRatio(&picture, cha::RatioSpec::intrinsicSize());
+
+    // Nothing is resolved when the ratio is added, so the intrinsic size can arrive later.
+    CHA_CHECK_EQUAL(cha::RatioStatusPending, layout.aspectRatioStatus(ratio, nullptr));
+    layout.setIntrinsicSize(&picture, 400, 300);
+    layout.solve();
+
+    double multiplier = 0;
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, layout.aspectRatioStatus(ratio, &multiplier));
+    CHA_CHECK_CLOSE(0.75, multiplier, 1e-12);
+    CHA_CHECK_CLOSE(240, layout.frame(&picture).height, 1e-6);
+    CHA_CHECK_EQUAL((uint64_t)1, layout.ratioResolutionCount());
+
+    // Resizing re-solves with the cached multiplier; a new intrinsic size alone changes nothing.
+    layout.setContainer(&container, 200, 480);
+    layout.setIntrinsicSize(&picture, 100, 100);
+    layout.solve();
+    CHA_CHECK_CLOSE(150, layout.frame(&picture).height, 1e-6);
+    CHA_CHECK_EQUAL((uint64_t)1, layout.ratioResolutionCount());
+
+    layout.invalidateAspectRatios(&picture);
+    layout.solve();
+    CHA_CHECK_CLOSE(200, layout.frame(&picture).height, 1e-6);
+    CHA_CHECK_EQUAL((uint64_t)2, layout.ratioResolutionCount());
+}
+
+CHA_TEST(testPendingAspectRatioWaitsForItsSource)
+{
+    cha::LayoutSystem layout;
+    layout.setContainer(&container, 300, 600);
+    pinToTopEdges(layout, &picture);
+    const cha::LayoutSystem::AspectRatio pending = layout.addAspectRatio(&picture, cha::RatioSpec::intrinsicSize());
+    const cha::LayoutSystem::AspectRatio invalid = layout.addAspectRatio(&picture, cha::RatioSpec::declared(0, 1));
+
+    layout.solve();
+    CHA_CHECK_EQUAL(cha::RatioStatusPending, layout.aspectRatioStatus(pending, nullptr));
+    CHA_CHECK_EQUAL(cha::RatioStatusInvalid, layout.aspectRatioStatus(invalid, nullptr));
+    CHA_CHECK_EQUAL((uint64_t)0, layout.ratioResolutionCount());
+
+    layout.setIntrinsicSize(&picture, 3, 2);
+    layout.solve();
+    CHA_CHECK_EQUAL(cha::RatioStatusResolved, layout.aspectRatioStatus(pending, nullptr));
+    CHA_CHECK_CLOSE(200, layout.frame(&picture).height, 1e-6);
+    CHA_CHECK_EQUAL(cha::RatioStatusInvalid, layout.aspectRatioStatus(invalid, nullptr));
+    CHA_CHECK_EQUAL(cha::RatioStatusInvalid, layout.aspectRatioStatus(99, nullptr));
+
+    // A declared ratio at lower priority gives way to a required one.
+    cha::LayoutSystem declared;
+    declared.setContainer(&container, 320, 480);
+    pinToTopEdges(declared, &picture);
+    declared.addAspectRatio(&picture, cha::RatioSpec::declared(1, 1), 500.f);
+    declared.addAspectRatio(&picture, cha::RatioSpec::imageSize(1600, 900));
+    declared.solve();
+    CHA_CHECK_CLOSE(180, declared.frame(&picture).height, 1e-6);
+}
@@ -0,0 +1,246 @@
+//
+//  CHABenchmarkFixtures.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHABenchmarkFixtures.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cha {
+namespace test {
+
+namespace {
+
+void append(std::vector<CHAConstraintDescriptor> &descriptors, const CHADescriptorBatch &batch)
+{
+    descriptors.insert(descriptors.end(), batch.records, batch.records + batch.count);
+}
+
+void appendChain(size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    const void *container = fixtureItem(0);
+    for (size_t i = 1; i <= viewCount; i++)
+    {
+        const void *view = fixtureItem(i);
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeLeading | CHAEdgeTrailing, 8);
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, 44);
+        if (i == 1) CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeTop, 0);
+        else CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeTop, CHALayoutRelationEqual, fixtureItem(i - 1),
+                                      CHALayoutAttributeBottom, 1, 4);
+        append(descriptors, batch);
+    }
+}
+
+void appendGrid(size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    const void *container = fixtureItem(0);
+    const size_t columns = (size_t)std::ceil(std::sqrt((double)viewCount));
+    for (size_t i = 0; i < viewCount; i++)
+    {
+        const void *view = fixtureItem(i + 1);
+        const size_t column = i % columns;
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeWidth, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, 20);
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, 20);
+        if (column == 0) CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeLeading, 0);
+        else CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeLeading, CHALayoutRelationEqual, fixtureItem(i),
+                                      CHALayoutAttributeTrailing, 1, 2);
+        if (i < columns) CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeTop, 0);
+        else CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeTop, CHALayoutRelationEqual, fixtureItem(i + 1 - columns),
+                                      CHALayoutAttributeBottom, 1, 2);
+        append(descriptors, batch);
+    }
+}
+
+void appendNested(size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    const size_t fanOut = 4;
+    for (size_t i = 1; i <= viewCount; i++)
+    {
+        const size_t parent = (i - 1) / fanOut;
+        const size_t firstSibling = parent * fanOut + 1;
+        const size_t lastSibling = firstSibling + fanOut - 1 < viewCount ? firstSibling + fanOut - 1 : viewCount;
+        const void *view = fixtureItem(i);
+
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, view, fixtureItem(parent), CHAEdgeLeading | CHAEdgeTrailing, 2);
+        if (i == firstSibling) CHADescriptorBatchAppendEdges(&batch, view, fixtureItem(parent), CHAEdgeTop, 2);
+        else CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeTop, CHALayoutRelationEqual, fixtureItem(i - 1),
+                                      CHALayoutAttributeBottom, 1, 2);
+        if (i == lastSibling && parent != 0) CHADescriptorBatchAppendEdges(&batch, view, fixtureItem(parent), CHAEdgeBottom, 2);
+        // Leaves carry the content height the rest of the tree hugs.
+        if (i * fanOut + 1 > viewCount) CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeHeight, CHALayoutRelationEqual,
+                                                                 nullptr, CHALayoutAttributeNotAnAttribute, 1, 10);
+        append(descriptors, batch);
+    }
+}
+
+const size_t kViewsPerCard = 5;
+const size_t kCardsPerPage = 20;
+
+void appendCards(size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    const void *container = fixtureItem(0);
+    for (size_t card = 0; card < viewCount / kViewsPerCard; card++)
+    {
+        const size_t first = card * kViewsPerCard + 1;
+        const void *view = fixtureItem(first);
+        const void *picture = fixtureItem(first + 1);
+        const void *details = fixtureItem(first + 2);
+        const void *name = fixtureItem(first + 3);
+        const void *biography = fixtureItem(first + 4);
+
+        const double page = (double)(card / kCardsPerPage);
+
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        // Pages sit side by side; the container's trailing edge is its width, as it is placed at the origin.
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeLeading, CHALayoutRelationEqual, container,
+                                 CHALayoutAttributeTrailing, page, 0);
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeWidth, CHALayoutRelationEqual, container,
+                                 CHALayoutAttributeWidth, 1, 0);
+        CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, 120);
+        if (card % kCardsPerPage == 0) CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeTop, 0);
+        else CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeTop, CHALayoutRelationEqual,
+                                      fixtureItem(first - kViewsPerCard), CHALayoutAttributeBottom, 1, 8);
+
+        CHADescriptorBatchAppendEdges(&batch, picture, view, CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeading, 8);
+        CHADescriptorBatchAppend(&batch, picture, CHALayoutAttributeWidth, CHALayoutRelationEqual, picture,
+                                 CHALayoutAttributeHeight, 1, 0);
+        CHADescriptorBatchAppendEdges(&batch, details, view, CHAEdgeTop | CHAEdgeBottom | CHAEdgeTrailing, 8);
+        CHADescriptorBatchAppend(&batch, details, CHALayoutAttributeLeading, CHALayoutRelationEqual, picture,
+                                 CHALayoutAttributeTrailing, 1, 8);
+        append(descriptors, batch);
+
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, name, details, CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing, 0);
+        CHADescriptorBatchAppend(&batch, name, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, 20);
+        CHADescriptorBatchAppendEdges(&batch, biography, details, CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing, 0);
+        CHADescriptorBatchAppend(&batch, biography, CHALayoutAttributeTop, CHALayoutRelationEqual, name,
+                                 CHALayoutAttributeBottom, 1, 4);
+        append(descriptors, batch);
+    }
+}
+
+}
+
+const char *nameForShape(HierarchyShape shape)
+{
+    switch (shape)
+    {
+        case HierarchyShapeChain: return "chain";
+        case HierarchyShapeGrid: return "grid";
+        case HierarchyShapeNested: return "nested";
+        case HierarchyShapeCards: return "cards";
+    }
+    return "unknown";
+}
+
+void appendHierarchy(HierarchyShape shape, size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors)
+{
+    switch (shape)
+    {
+        case HierarchyShapeChain: appendChain(viewCount, descriptors); break;
+        case HierarchyShapeGrid: appendGrid(viewCount, descriptors); break;
+        case HierarchyShapeNested: appendNested(viewCount, descriptors); break;
+        case HierarchyShapeCards: appendCards(viewCount, descriptors); break;
+    }
+}
+
+size_t fixtureParent(HierarchyShape shape, size_t index)
+{
+    switch (shape)
+    {
+        case HierarchyShapeNested: return (index - 1) / 4;
+        case HierarchyShapeCards:
+        {
+            // Card, picture, details, name, biography.
+            const size_t position = (index - 1) % kViewsPerCard;
+            const size_t card = index - position;
+            return position == 0 ? 0 : position <= 2 ? card : card + 2;
+        }
+        default: return 0;
+    }
+}
+
+const void *fixtureParentItem(HierarchyShape shape, const void *item)
+{
+    const size_t index = (size_t)reinterpret_cast<uintptr_t>(item) - 1;
+    return index == 0 ? nullptr : fixtureItem(fixtureParent(shape, index));
+}
+
+TextSize fakeMeasureText(const std::string &text, double fontSize, double width, uint32_t lineLimit)
+{
+    const double glyphWidth = 0.5 * fontSize;
+    const double lineHeight = 1.2 * fontSize;
+    if (text.empty()) return TextSize{0, lineHeight};
+
+    double lineWidth = 0, widest = 0;
+    uint32_t lines = 1;
+    size_t wordStart = 0;
+    while (wordStart < text.size())
+    {
+        size_t wordEnd = text.find(' ', wordStart);
+        if (wordEnd == std::string::npos) wordEnd = text.size();
+        const double wordWidth = (double)(wordEnd - wordStart) * glyphWidth;
+        const double spaced = lineWidth > 0 ? lineWidth + glyphWidth + wordWidth : wordWidth;
+
+        if (width > 0 && spaced > width && lineWidth > 0)
+        {
+            if (lineLimit && lines == lineLimit) break;
+            widest = std::max(widest, lineWidth);
+            lines++;
+            lineWidth = wordWidth;
+        }
+        else
+        {
+            lineWidth = spaced;
+        }
+        wordStart = wordEnd + 1;
+    }
+
+    widest = std::max(widest, lineWidth);
+    if (width > 0) widest = std::min(widest, width);
+    return TextSize{widest, lines * lineHeight};
+}
+
+void appendParagraphs(size_t count, std::vector<std::string> &paragraphs)
+{
+    static const char *const words[] = { "your", "favorite", "app", "studio", "on", "both", "sides", "of", "the",
+                                         "atlantic", "layout", "constraint", "view", "solver", "frame", "cell" };
+    uint64_t state = 0x2545f4914f6cdd1dULL;
+    for (size_t paragraph = 0; paragraph < count; paragraph++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const size_t wordCount = 3 + state % 60;
+
+        std::string text;
+        for (size_t word = 0; word < wordCount; word++)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if (word) text += ' ';
+            text += words[state % (sizeof(words) / sizeof(words[0]))];
+        }
+        paragraphs.push_back(text);
+    }
+}
+
+}
+}
@@ -0,0 +1,79 @@
+//
+//  CHABenchmarkFixtures.h
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  Generated view hierarchies, expressed as the descriptor records the helpers would produce.
+//
+
+#ifndef CHAAutolayoutCategoriesTests_CHABenchmarkFixtures_h
+#define CHAAutolayoutCategoriesTests_CHABenchmarkFixtures_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CHAConstraintDescriptor.h"
+#include "CHATextMeasurementCache.h"
+
+namespace cha {
+namespace test {
+
+enum HierarchyShape
+{
+    // Views stacked top to bottom, each pinned leading/trailing to the container.
+    HierarchyShapeChain,
+    // Fixed-size cells in a square grid, each placed relative to its left and upper neighbours.
+    HierarchyShapeGrid,
+    // A tree with fan-out 4: children are stacked inside their parent and the parent hugs them.
+    HierarchyShapeNested,
+    // A horizontally paged feed: pages a container wide, each stacking 20 fixed-height cards laid out like CHAHeaderView,
+    // with a square picture and a details view holding a name and a biography. Five views per card; viewCount is
+    // rounded down to whole cards.
+    HierarchyShapeCards
+};
+
+const char *nameForShape(HierarchyShape shape);
+
+/**
+ @description The item handle for view index (0 is the container). Matches LayoutTemplate::slotHandle.
+ */
+inline const void *fixtureItem(size_t index)
+{
+    return reinterpret_cast<const void *>((uintptr_t)index + 1);
+}
+
+/**
+ @description Append the records for a hierarchy of viewCount views (not counting the container)
+ */
+void appendHierarchy(HierarchyShape shape, size_t viewCount, std::vector<CHAConstraintDescriptor> &descriptors);
+
+/**
+ @description The index of view index's superview in a hierarchy from appendHierarchy, 0 being the container
+ */
+size_t fixtureParent(HierarchyShape shape, size_t index);
+
+/**
+ @description The item handle of a fixture item's superview, or null for the container. Suits a cha::ParentFunction.
+ */
+const void *fixtureParentItem(HierarchyShape shape, const void *item);
+
+/**
+ @description A deterministic stand-in for UIKit text measurement: greedy word wrap with every glyph half the font size wide
+ and lines 1.2 font sizes tall. Like the real thing, its cost grows with the length of the text.
+ @param width The wrapping width; non-positive for a single unbounded line
+ @param lineLimit The maximum number of lines, or 0 for no limit
+ */
+TextSize fakeMeasureText(const std::string &text, double fontSize, double width, uint32_t lineLimit);
+
+/**
+ @description Append count paragraphs of pseudo-random words, identical on every run
+ */
+void appendParagraphs(size_t count, std::vector<std::string> &paragraphs);
+
+}
+}
+
+#endif
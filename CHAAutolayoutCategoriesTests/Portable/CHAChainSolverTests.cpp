@@ -0,0 +1,203 @@
+//
+//  CHAChainSolverTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAChainSolver.h"
+#include "CHALayoutTemplate.h"
+#include "CHAStackLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<const void *> makeItems(size_t count)
+{
+    std::vector<const void *> items;
+    for (size_t i = 1; i <= count; i++) items.push_back(cha::test::fixtureItem(i));
+    return items;
+}
+
+void checkFramesMatchGeneralSolver(const std::vector<CHAConstraintDescriptor> &descriptors,
+                                   const std::vector<const void *> &items,
+                                   double width,
+                                   double height)
+{
+    const void *container = cha::test::fixtureItem(0);
+    cha::StackLayout stack;
+    std::vector<cha::Frame> frames;
+    cha::Frame containerFrame;
+    CHA_CHECK(cha::recognizeStack(descriptors.data(), descriptors.size(), container, stack));
+    CHA_CHECK(cha::solveStack(stack, width, height, frames, &containerFrame));
+    CHA_CHECK_EQUAL(items.size(), stack.items.size());
+    if (frames.size() != items.size()) return;
+
+    cha::LayoutSystem layout;
+    layout.setContainer(container, width, height);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+    layout.solve();
+
+    const cha::Frame expectedContainer = layout.frame(container);
+    CHA_CHECK_CLOSE(expectedContainer.width, containerFrame.width, 1e-6);
+    CHA_CHECK_CLOSE(expectedContainer.height, containerFrame.height, 1e-6);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        CHA_CHECK(stack.items[i] == items[i]);
+        const cha::Frame expected = layout.frame(items[i]);
+        CHA_CHECK_CLOSE(expected.x, frames[i].x, 1e-6);
+        CHA_CHECK_CLOSE(expected.y, frames[i].y, 1e-6);
+        CHA_CHECK_CLOSE(expected.width, frames[i].width, 1e-6);
+        CHA_CHECK_CLOSE(expected.height, frames[i].height, 1e-6);
+    }
+}
+
+}
+
+CHA_TEST(testChainSolverPlacesFixedAndWeightedItems)
+{
+    cha::Chain chain = {10, 20, true, {}};
+    chain.items.push_back(cha::ChainItem{cha::ChainSizingFixed, 44, 0});
+    chain.items.push_back(cha::ChainItem{cha::ChainSizingWeighted, 1, 8});
+    chain.items.push_back(cha::ChainItem{cha::ChainSizingWeighted, 3, 8});
+
+    std::vector<cha::ChainSpan> spans;
+    CHA_CHECK_EQUAL(cha::ChainStatusOK, cha::solveChain(chain, 490, spans));
+    CHA_CHECK_CLOSE(10, spans[0].offset, 1e-9);
+    CHA_CHECK_CLOSE(44, spans[0].length, 1e-9);
+    CHA_CHECK_CLOSE(62, spans[1].offset, 1e-9);
+    CHA_CHECK_CLOSE(100, spans[1].length, 1e-9);
+    CHA_CHECK_CLOSE(170, spans[2].offset, 1e-9);
+    CHA_CHECK_CLOSE(300, spans[2].length, 1e-9);
+}
+
+CHA_TEST(testChainSolverReportsAmbiguousAndConflictingChains)
+{
+    std::vector<cha::ChainSpan> spans;
+    cha::Chain weighted = {0, 0, false, {cha::ChainItem{cha::ChainSizingWeighted, 1, 0}}};
+    CHA_CHECK_EQUAL(cha::ChainStatusUnderconstrained, cha::solveChain(weighted, 100, spans));
+
+    weighted.pinTrailing = true;
+    CHA_CHECK_EQUAL(cha::ChainStatusUnderconstrained, cha::solveChain(weighted, -1, spans));
+
+    cha::Chain fixed = {8, 8, true, {cha::ChainItem{cha::ChainSizingFixed, 44, 0}, cha::ChainItem{cha::ChainSizingFixed, 44, 4}}};
+    CHA_CHECK_EQUAL(cha::ChainStatusUnsatisfiable, cha::solveChain(fixed, 100, spans));
+
+    double length = 0;
+    CHA_CHECK_EQUAL(cha::ChainStatusOK, cha::solveChain(fixed, -1, spans, &length));
+    CHA_CHECK_CLOSE(108, length, 1e-9);
+}
+
+CHA_TEST(testStackEmitsOneRecordPerLink)
+{
+    const std::vector<const void *> items = makeItems(40);
+    cha::StackSpec spec = {CHAStackAxisVertical, CHAStackDistributionFillEqually, 8, 20, 16, 20, 16};
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::appendStackDescriptors(spec, cha::test::fixtureItem(0), items.data(), nullptr, items.size(), descriptors);
+
+    // Leading margin, 39 gaps, trailing margin, 39 equal heights and two cross-axis pins per row.
+    CHA_CHECK_EQUAL(1u + 39u + 1u + 39u + 80u, descriptors.size());
+
+    spec.distribution = CHAStackDistributionLeading;
+    descriptors.clear();
+    cha::appendStackDescriptors(spec, cha::test::fixtureItem(0), items.data(), nullptr, items.size(), descriptors);
+    CHA_CHECK_EQUAL(1u + 39u + 80u, descriptors.size());
+}
+
+CHA_TEST(testStackSolutionsMatchGeneralSolver)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const CHAStackDistribution distributions[] = { CHAStackDistributionLeading, CHAStackDistributionFill,
+                                                   CHAStackDistributionFillEqually, CHAStackDistributionFillProportionally };
+
+    for (int trial = 0; trial < 200; trial++)
+    {
+        const size_t count = 1 + random() % 60;
+        const std::vector<const void *> items = makeItems(count);
+        cha::StackSpec spec = {(CHAStackAxis)(random() % 2), distributions[random() % 4], std::floor(unit(random) * 12),
+                               std::floor(unit(random) * 30), std::floor(unit(random) * 30),
+                               std::floor(unit(random) * 30), std::floor(unit(random) * 30)};
+        const bool vertical = spec.axis == CHAStackAxisVertical;
+        const CHALayoutAttribute length = vertical ? CHALayoutAttributeHeight : CHALayoutAttributeWidth;
+
+        std::vector<double> weights;
+        for (size_t i = 0; i < count; i++) weights.push_back(1 + std::floor(unit(random) * 5));
+
+        std::vector<CHAConstraintDescriptor> descriptors;
+        cha::appendStackDescriptors(spec, cha::test::fixtureItem(0), items.data(), weights.data(), count, descriptors);
+
+        // Leading and Fill stacks take their lengths from the views; in a Fill stack one view is left to absorb the rest.
+        const bool ownLengths = spec.distribution == CHAStackDistributionLeading || spec.distribution == CHAStackDistributionFill;
+        const size_t absorbing = spec.distribution == CHAStackDistributionFill ? random() % count : count;
+        for (size_t i = 0; ownLengths && i < count; i++)
+        {
+            if (i == absorbing) continue;
+            descriptors.push_back(CHAConstraintDescriptor{items[i], nullptr, 1, 20 + std::floor(unit(random) * 40),
+                                                          CHALayoutPriorityRequired, length, CHALayoutAttributeNotAnAttribute,
+                                                          CHALayoutRelationEqual, 0});
+        }
+        std::shuffle(descriptors.begin(), descriptors.end(), random);
+
+        const double main = 2000 + std::floor(unit(random) * 1000), cross = 200 + std::floor(unit(random) * 300);
+        checkFramesMatchGeneralSolver(descriptors, items, vertical ? cross : main, vertical ? main : cross);
+    }
+}
+
+CHA_TEST(testStackDerivesFreeContainerLength)
+{
+    const std::vector<const void *> items = makeItems(5);
+    cha::StackSpec spec = {CHAStackAxisVertical, CHAStackDistributionFill, 4, 10, 10, 10, 10};
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::appendStackDescriptors(spec, cha::test::fixtureItem(0), items.data(), nullptr, items.size(), descriptors);
+    for (const void *item : items)
+    {
+        descriptors.push_back(CHAConstraintDescriptor{item, nullptr, 1, 30, CHALayoutPriorityRequired, CHALayoutAttributeHeight,
+                                                      CHALayoutAttributeNotAnAttribute, CHALayoutRelationEqual, 0});
+    }
+
+    checkFramesMatchGeneralSolver(descriptors, items, 320, -1);
+
+    cha::LayoutTemplate stackTemplate(1, 6);
+    for (const CHAConstraintDescriptor &descriptor : descriptors) stackTemplate.addDescriptor(descriptor);
+    std::vector<cha::Frame> frames;
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, stackTemplate.solve(cha::LayoutRequest{320, -1, 0, {}}, frames));
+    CHA_CHECK_CLOSE(10 + 5 * 30 + 4 * 4 + 10, frames[0].height, 1e-9);
+    CHA_CHECK_CLOSE(10 + 4 * 34, frames[5].y, 1e-9);
+}
+
+CHA_TEST(testStackRecognizerRejectsOtherConstraints)
+{
+    const void *container = cha::test::fixtureItem(0);
+    const std::vector<const void *> items = makeItems(3);
+    cha::StackSpec spec = {CHAStackAxisHorizontal, CHAStackDistributionFillEqually, 8, 0, 0, 0, 0};
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::appendStackDescriptors(spec, container, items.data(), nullptr, items.size(), descriptors);
+
+    cha::StackLayout stack;
+    CHA_CHECK(cha::recognizeStack(descriptors.data(), descriptors.size(), container, stack));
+    CHA_CHECK_EQUAL(CHAStackAxisHorizontal, stack.axis);
+
+    std::vector<CHAConstraintDescriptor> centered = descriptors;
+    centered.push_back(CHAConstraintDescriptor{items[1], container, 1, 0, CHALayoutPriorityRequired, CHALayoutAttributeCenterX,
+                                               CHALayoutAttributeCenterX, CHALayoutRelationEqual, 0});
+    CHA_CHECK(!cha::recognizeStack(centered.data(), centered.size(), container, stack));
+
+    std::vector<CHAConstraintDescriptor> optional = descriptors;
+    optional[0].priority = 750;
+    CHA_CHECK(!cha::recognizeStack(optional.data(), optional.size(), container, stack));
+
+    // Without the trailing pin nothing fixes the equal widths.
+    std::vector<CHAConstraintDescriptor> unpinned;
+    for (const CHAConstraintDescriptor &descriptor : descriptors)
+    {
+        if (!(descriptor.toItem == container && descriptor.attribute == CHALayoutAttributeTrailing)) unpinned.push_back(descriptor);
+    }
+    CHA_CHECK(!cha::recognizeStack(unpinned.data(), unpinned.size(), container, stack));
+}
@@ -0,0 +1,347 @@
+//
+//  CHACompiledLayoutTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHACompiledLayout.h"
+#include "CHALayoutDSL.h"
+#include "CHALayoutSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using cha::test::fixtureItem;
+
+const size_t kViewCount = 100;
+
+std::vector<CHAConstraintDescriptor> cardDescriptors()
+{
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeCards, kViewCount, descriptors);
+    // A lower-priority record and one against nothing, which the card fixture lacks.
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppend(&batch, fixtureItem(3), CHALayoutAttributeWidth, CHALayoutRelationLessThanOrEqual, nullptr,
+                             CHALayoutAttributeNotAnAttribute, 1, 400)->priority = 750;
+    descriptors.insert(descriptors.end(), batch.records, batch.records + batch.count);
+    return descriptors;
+}
+
+std::vector<uint8_t> compile(const std::vector<CHAConstraintDescriptor> &descriptors, bool named)
+{
+    cha::CompiledLayoutWriter writer(kViewCount + 1);
+    for (const CHAConstraintDescriptor &descriptor : descriptors) CHA_CHECK(writer.addDescriptor(descriptor));
+    for (uint32_t slot = 0; named && slot <= kViewCount; slot++) writer.setSlotName(slot, "view" + std::to_string(slot));
+
+    std::vector<uint8_t> bytes;
+    writer.write(bytes);
+    return bytes;
+}
+
+cha::CompiledLayoutHeader headerOf(const std::vector<uint8_t> &bytes)
+{
+    cha::CompiledLayoutHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+// Rewrite the header and checksum after a deliberate edit, so validation gets past the checksum to what was edited.
+void reseal(std::vector<uint8_t> &bytes, const cha::CompiledLayoutHeader &header)
+{
+    cha::CompiledLayoutHeader sealed = header;
+    const size_t end = std::min<size_t>(sealed.size, bytes.size());
+    const size_t start = std::min<size_t>(sealed.headerSize, end);
+    sealed.checksum = cha::compiledLayoutChecksum(bytes.data() + start, end - start);
+    std::memcpy(bytes.data(), &sealed, sizeof(sealed));
+}
+
+uint64_t nextRandom(uint64_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+}
+
+CHA_TEST(testCompiledLayoutRoundTripsDescriptors)
+{
+    const std::vector<CHAConstraintDescriptor> descriptors = cardDescriptors();
+    const std::vector<uint8_t> bytes = compile(descriptors, true);
+    CHA_CHECK_EQUAL(sizeof(cha::CompiledLayoutHeader) + descriptors.size() * sizeof(cha::CompiledRecord) +
+                        (kViewCount + 1) * sizeof(uint32_t) + 10 * 6 + 90 * 7 + 1 * 8,
+                    bytes.size());
+
+    cha::CompiledLayout layout;
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusOK, layout.open(bytes.data(), bytes.size()));
+    CHA_CHECK_EQUAL((uint16_t)1, layout.version());
+    CHA_CHECK_EQUAL((uint32_t)kViewCount + 1, layout.slotCount());
+    CHA_CHECK_EQUAL(descriptors.size(), layout.recordCount());
+    CHA_CHECK_EQUAL(std::string("view42"), std::string(layout.slotName(42)));
+    CHA_CHECK(layout.slotName((uint32_t)kViewCount + 1) == nullptr);
+    // Read in place rather than copied.
+    CHA_CHECK(reinterpret_cast<const uint8_t *>(layout.records()) == bytes.data() + sizeof(cha::CompiledLayoutHeader));
+
+    // Instantiated against other items, the records only swap their items.
+    std::vector<int> views(kViewCount + 1);
+    std::vector<const void *> items;
+    for (int &view : views) items.push_back(&view);
+    std::vector<CHAConstraintDescriptor> instantiated(layout.recordCount());
+    layout.instantiate(items.data(), instantiated.data());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < descriptors.size(); i++)
+    {
+        const CHAConstraintDescriptor &expected = descriptors[i], &actual = instantiated[i];
+        const void *toItem = expected.toItem ? items[reinterpret_cast<uintptr_t>(expected.toItem) - 1] : nullptr;
+        if (actual.item != items[reinterpret_cast<uintptr_t>(expected.item) - 1] || actual.toItem != toItem ||
+            actual.multiplier != expected.multiplier || actual.constant != expected.constant ||
+            actual.priority != expected.priority || actual.attribute != expected.attribute ||
+            actual.toAttribute != expected.toAttribute || actual.relation != expected.relation)
+        {
+            mismatches++;
+        }
+    }
+    CHA_CHECK_EQUAL((size_t)0, mismatches);
+
+    cha::LayoutSystem system;
+    system.setContainer(items[0], 320, 1e5);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, system.addDescriptors(instantiated.data(), instantiated.size()));
+    system.solve();
+    // The fourth card sits below three 120-point cards and their 8-point gaps.
+    CHA_CHECK_CLOSE(3 * 128, system.frame(items[3 * 5 + 1]).y, 1e-6);
+
+    // Unnamed layouts carry no name section.
+    const std::vector<uint8_t> unnamed = compile(descriptors, false);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusOK, layout.open(unnamed.data(), unnamed.size()));
+    CHA_CHECK(layout.slotName(0) == nullptr);
+    CHA_CHECK_EQUAL((uint32_t)0, headerOf(unnamed).nameOffset);
+}
+
+CHA_TEST(testCompiledLayoutWriterRejectsInvalidRecords)
+{
+    cha::CompiledLayoutWriter writer(2);
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(1), fixtureItem(0), CHAEdgeTop, 8);
+    CHA_CHECK(writer.addDescriptor(batch.records[0]));
+
+    CHAConstraintDescriptor outside = batch.records[0];
+    outside.toItem = fixtureItem(2);
+    CHA_CHECK(!writer.addDescriptor(outside));
+    CHAConstraintDescriptor view = batch.records[0];
+    view.item = &writer;
+    CHA_CHECK(!writer.addDescriptor(view));
+    CHAConstraintDescriptor margin = batch.records[0];
+    margin.attribute = 13;
+    CHA_CHECK(!writer.addDescriptor(margin));
+    CHAConstraintDescriptor infinite = batch.records[0];
+    infinite.constant = INFINITY;
+    CHA_CHECK(!writer.addDescriptor(infinite));
+    CHAConstraintDescriptor unprioritized = batch.records[0];
+    unprioritized.priority = 0;
+    CHA_CHECK(!writer.addDescriptor(unprioritized));
+
+    // Pairs UIKit refuses to relate, and a position with nothing to be relative to.
+    CHAConstraintDescriptor crossAxis = batch.records[0];
+    crossAxis.toAttribute = CHALayoutAttributeLeading;
+    CHA_CHECK(!writer.addDescriptor(crossAxis));
+    CHAConstraintDescriptor mixedDirection = batch.records[0];
+    mixedDirection.attribute = CHALayoutAttributeLeft;
+    mixedDirection.toAttribute = CHALayoutAttributeLeading;
+    CHA_CHECK(!writer.addDescriptor(mixedDirection));
+    CHAConstraintDescriptor positionToDimension = batch.records[0];
+    positionToDimension.toAttribute = CHALayoutAttributeHeight;
+    CHA_CHECK(!writer.addDescriptor(positionToDimension));
+    CHAConstraintDescriptor unanchored = batch.records[0];
+    unanchored.toItem = nullptr;
+    unanchored.toAttribute = CHALayoutAttributeNotAnAttribute;
+    CHA_CHECK(!writer.addDescriptor(unanchored));
+    CHAConstraintDescriptor fixedHeight = unanchored;
+    fixedHeight.attribute = CHALayoutAttributeHeight;
+    CHA_CHECK(writer.addDescriptor(fixedHeight));
+
+    CHA_CHECK(!writer.setSlotName(2, "missing"));
+    CHA_CHECK(!writer.setSlotName(1, std::string("a\0b", 3)));
+    CHA_CHECK_EQUAL((size_t)2, writer.recordCount());
+}
+
+CHA_TEST(testCompiledLayoutRejectsDamagedInput)
+{
+    const std::vector<uint8_t> valid = compile(cardDescriptors(), true);
+    const cha::CompiledLayoutHeader header = headerOf(valid);
+    const size_t firstRecord = header.recordOffset;
+
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusTruncated, cha::validateCompiledLayout(valid.data(), 20));
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusTruncated, cha::validateCompiledLayout(valid.data(), valid.size() - 1));
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusTruncated, cha::validateCompiledLayout(nullptr, 0));
+
+    std::vector<uint8_t> bytes = valid;
+    bytes[0] = 'X';
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadMagic, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    cha::CompiledLayoutHeader edited = header;
+    edited.version = 2;
+    bytes = valid;
+    reseal(bytes, edited);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusUnsupportedVersion, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    edited = header;
+    edited.recordCount = 0x10000000;
+    bytes = valid;
+    reseal(bytes, edited);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadSection, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    bytes = valid;
+    bytes[firstRecord + 3] ^= 0x40;
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadChecksum, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    // A record pointing past the last slot, behind a correct checksum.
+    bytes = valid;
+    const uint32_t slot = (uint32_t)kViewCount + 1;
+    std::memcpy(&bytes[firstRecord + offsetof(cha::CompiledRecord, toItem)], &slot, sizeof(slot));
+    reseal(bytes, header);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadRecord, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    // Records that are well formed but that UIKit would refuse, behind a correct checksum.
+    const cha::CompiledRecord &first = *reinterpret_cast<const cha::CompiledRecord *>(&valid[firstRecord]);
+    const CHALayoutAttribute unrelated = cha::dsl::isVerticalAttribute(first.attribute) ? CHALayoutAttributeLeading
+                                                                                        : CHALayoutAttributeTop;
+    bytes = valid;
+    std::memcpy(&bytes[firstRecord + offsetof(cha::CompiledRecord, toAttribute)], &unrelated, sizeof(unrelated));
+    reseal(bytes, header);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadRecord, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    bytes = valid;
+    const uint32_t noSlot = cha::CompiledRecordNoSlot;
+    const CHALayoutAttribute notAnAttribute = CHALayoutAttributeNotAnAttribute;
+    const CHALayoutAttribute position = CHALayoutAttributeCenterX;
+    std::memcpy(&bytes[firstRecord + offsetof(cha::CompiledRecord, toItem)], &noSlot, sizeof(noSlot));
+    std::memcpy(&bytes[firstRecord + offsetof(cha::CompiledRecord, toAttribute)], &notAnAttribute, sizeof(notAnAttribute));
+    std::memcpy(&bytes[firstRecord + offsetof(cha::CompiledRecord, attribute)], &position, sizeof(position));
+    reseal(bytes, header);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadRecord, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    // The last name losing its terminator.
+    bytes = valid;
+    bytes.back() = 'x';
+    reseal(bytes, header);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusBadName, cha::validateCompiledLayout(bytes.data(), bytes.size()));
+
+    // The same bytes one past an 8-byte boundary cannot be read in place.
+    std::vector<uint64_t> storage(valid.size() / 8 + 2);
+    uint8_t *shifted = reinterpret_cast<uint8_t *>(storage.data()) + 1;
+    std::memcpy(shifted, valid.data(), valid.size());
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusMisaligned, cha::validateCompiledLayout(shifted, valid.size()));
+
+    // A failed open leaves the view empty.
+    cha::CompiledLayout layout;
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusOK, layout.open(valid.data(), valid.size()));
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusMisaligned, layout.open(shifted, valid.size()));
+    CHA_CHECK_EQUAL((size_t)0, layout.recordCount());
+    CHA_CHECK(layout.records() == nullptr);
+}
+
+CHA_TEST(testMappedCompiledLayoutReadsFiles)
+{
+    const std::vector<CHAConstraintDescriptor> descriptors = cardDescriptors();
+    const std::vector<uint8_t> bytes = compile(descriptors, true);
+
+    char path[] = "/tmp/cha_compiled_layout_XXXXXX";
+    const int file = mkstemp(path);
+    CHA_CHECK(file >= 0);
+    CHA_CHECK_EQUAL((ssize_t)bytes.size(), write(file, bytes.data(), bytes.size()));
+    close(file);
+
+    cha::MappedCompiledLayout mapped;
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusOK, mapped.open(path));
+    CHA_CHECK_EQUAL(descriptors.size(), mapped.layout().recordCount());
+    CHA_CHECK_EQUAL(0, std::memcmp(mapped.layout().records(), bytes.data() + headerOf(bytes).recordOffset,
+                                   descriptors.size() * sizeof(cha::CompiledRecord)));
+    CHA_CHECK_EQUAL(std::string("view7"), std::string(mapped.layout().slotName(7)));
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "CHAL";
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusTruncated, mapped.open(path));
+    CHA_CHECK_EQUAL((size_t)0, mapped.layout().recordCount());
+    unlink(path);
+    CHA_CHECK_EQUAL(cha::CompiledLayoutStatusUnreadable, mapped.open(path));
+}
+
+CHA_TEST(testCompiledLayoutSurvivesFuzzedInput)
+{
+    const std::vector<uint8_t> valid = compile(cardDescriptors(), true);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    size_t accepted = 0;
+
+    for (int iteration = 0; iteration < 20000; iteration++)
+    {
+        std::vector<uint8_t> bytes = valid;
+        const int edits = 1 + (int)(nextRandom(state) % 4);
+        for (int edit = 0; edit < edits; edit++)
+        {
+            const uint64_t choice = nextRandom(state);
+            switch (choice % 4)
+            {
+                case 0: bytes[nextRandom(state) % bytes.size()] ^= (uint8_t)(1u << (nextRandom(state) % 8)); break;
+                case 1: bytes[nextRandom(state) % bytes.size()] = (uint8_t)nextRandom(state); break;
+                case 2: bytes.resize(nextRandom(state) % (bytes.size() + 1)); break;
+                case 3:
+                {
+                    // A header field set to a random or boundary value.
+                    const size_t field = 8 + 4 * (nextRandom(state) % 6);
+                    const uint32_t values[] = {0, 1, 0xffffffff, (uint32_t)valid.size(), (uint32_t)nextRandom(state)};
+                    if (bytes.size() >= field + 4) std::memcpy(&bytes[field], &values[nextRandom(state) % 5], 4);
+                    break;
+                }
+            }
+            if (bytes.empty()) break;
+        }
+        // Half the inputs carry a valid checksum, so the checks behind it see damaged records and names too.
+        if (bytes.size() >= sizeof(cha::CompiledLayoutHeader) && nextRandom(state) % 2) reseal(bytes, headerOf(bytes));
+
+        // An exactly sized heap copy, so any read past the end is a real overrun under a sanitizer.
+        std::vector<uint64_t> storage((bytes.size() + 7) / 8);
+        if (!bytes.empty()) std::memcpy(storage.data(), bytes.data(), bytes.size());
+
+        cha::CompiledLayout layout;
+        if (layout.open(storage.data(), bytes.size()) != cha::CompiledLayoutStatusOK) continue;
+        accepted++;
+
+        // A fuzzed slot count can be in the billions, so the table only covers the slots the records use.
+        uint32_t usedSlots = 0;
+        for (size_t index = 0; index < layout.recordCount(); index++)
+        {
+            const cha::CompiledRecord &record = layout.records()[index];
+            CHA_CHECK(record.item < layout.slotCount());
+            CHA_CHECK(record.toItem == cha::CompiledRecordNoSlot || record.toItem < layout.slotCount());
+            // Whatever loads can be handed to UIKit.
+            CHA_CHECK(record.toItem == cha::CompiledRecordNoSlot
+                          ? cha::dsl::isDimensionAttribute(record.attribute)
+                          : cha::dsl::canRelateAttributes(record.attribute, record.toAttribute));
+            usedSlots = std::max(usedSlots, record.item + 1);
+            if (record.toItem != cha::CompiledRecordNoSlot) usedSlots = std::max(usedSlots, record.toItem + 1);
+        }
+        std::vector<const void *> items(usedSlots);
+        for (uint32_t slot = 0; slot < usedSlots; slot++) items[slot] = fixtureItem(slot);
+        std::vector<CHAConstraintDescriptor> descriptors(layout.recordCount());
+        layout.instantiate(items.data(), descriptors.data());
+
+        const uint32_t namedSlots = layout.slotName(0) ? layout.slotCount() : 0;
+        for (uint32_t slot = 0; slot < namedSlots; slot++) CHA_CHECK(std::strlen(layout.slotName(slot)) < bytes.size());
+    }
+    // Some edits keep the layout valid, e.g. a changed constant behind a resealed checksum.
+    CHA_CHECK(accepted > 0);
+    CHA_CHECK(accepted < 20000);
+}
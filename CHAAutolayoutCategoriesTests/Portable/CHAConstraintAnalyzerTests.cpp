@@ -0,0 +1,218 @@
+//
+//  CHAConstraintAnalyzerTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAConstraintAnalyzer.h"
+#include "CHAConstraintRecording.h"
+#include "CHALayoutSystem.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+const void *const kContainer = cha::test::fixtureItem(0);
+const void *const kView = cha::test::fixtureItem(1);
+
+CHAConstraintDescriptor pin(const void *item, CHALayoutAttribute attribute, double constant, float priority = CHALayoutPriorityRequired)
+{
+    return CHAConstraintDescriptor{item, kContainer, 1, constant, priority, attribute, attribute, CHALayoutRelationEqual, 0};
+}
+
+CHAConstraintDescriptor fixed(const void *item, CHALayoutAttribute attribute, CHALayoutRelation relation, double constant)
+{
+    return CHAConstraintDescriptor{item, nullptr, 0, constant, CHALayoutPriorityRequired, attribute, CHALayoutAttributeNotAnAttribute,
+                                   relation, 0};
+}
+
+std::vector<CHAConstraintDescriptor> boundsPins(const void *item)
+{
+    return { pin(item, CHALayoutAttributeTop, 0), pin(item, CHALayoutAttributeBottom, 0), pin(item, CHALayoutAttributeLeading, 0),
+             pin(item, CHALayoutAttributeTrailing, 0) };
+}
+
+}
+
+CHA_TEST(testAnalyzerAcceptsAFullySpecifiedSet)
+{
+    std::vector<CHAConstraintDescriptor> records = boundsPins(kView);
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK(report.clean());
+}
+
+CHA_TEST(testAnalyzerTracesEqualityConflictsToTheirRecords)
+{
+    // -pinToSuperviewBounds plus a fixed-multiplier height over-constrains the view against the container height.
+    std::vector<CHAConstraintDescriptor> records = boundsPins(kView);
+    records.push_back(CHAConstraintDescriptor{kView, kContainer, 0.35, 0, CHALayoutPriorityRequired, CHALayoutAttributeHeight,
+                                              CHALayoutAttributeHeight, CHALayoutRelationEqual, 0});
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)1, report.issues.size());
+    CHA_CHECK_EQUAL((size_t)1, report.countOf(cha::AnalysisIssueConflict));
+    CHA_CHECK_EQUAL(4u, report.issues[0].record);
+    CHA_CHECK_EQUAL((int)cha::AnalysisAxisVertical, (int)report.issues[0].axis);
+    CHA_CHECK((report.issues[0].related == std::vector<uint32_t>{ 0, 1, cha::kAnalysisContainerHeightRecord }));
+
+    // Without a fixed container height the same set is satisfiable: the container follows the view.
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, -1, report);
+    CHA_CHECK_EQUAL((size_t)0, report.countOf(cha::AnalysisIssueConflict));
+}
+
+CHA_TEST(testAnalyzerNamesTheContainerSizeInConflicts)
+{
+    std::vector<CHAConstraintDescriptor> records = boundsPins(kView);
+    records.push_back(fixed(kView, CHALayoutAttributeWidth, CHALayoutRelationEqual, 400));
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)1, report.issues.size());
+    CHA_CHECK_EQUAL((int)cha::AnalysisAxisHorizontal, (int)report.issues[0].axis);
+    CHA_CHECK((report.issues[0].related == std::vector<uint32_t>{ 2, 3, cha::kAnalysisContainerWidthRecord }));
+}
+
+CHA_TEST(testAnalyzerReportsRedundantEqualities)
+{
+    std::vector<CHAConstraintDescriptor> records = boundsPins(kView);
+    records.push_back(pin(kView, CHALayoutAttributeCenterX, 0));
+    records.push_back(fixed(kView, CHALayoutAttributeWidth, CHALayoutRelationEqual, 320));
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)2, report.issues.size());
+    CHA_CHECK_EQUAL((size_t)2, report.countOf(cha::AnalysisIssueRedundant));
+    CHA_CHECK((report.issues[0].related == std::vector<uint32_t>{ 2, 3, cha::kAnalysisContainerWidthRecord }));
+}
+
+CHA_TEST(testAnalyzerReportsInfeasibleInequalities)
+{
+    std::vector<CHAConstraintDescriptor> records = { pin(kView, CHALayoutAttributeTop, 0), pin(kView, CHALayoutAttributeLeading, 0),
+                                                     fixed(kView, CHALayoutAttributeWidth, CHALayoutRelationGreaterThanOrEqual, 100),
+                                                     fixed(kView, CHALayoutAttributeWidth, CHALayoutRelationLessThanOrEqual, 50),
+                                                     fixed(kView, CHALayoutAttributeHeight, CHALayoutRelationEqual, 20) };
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)1, report.countOf(cha::AnalysisIssueConflict));
+    CHA_CHECK_EQUAL(3u, report.issues[0].record);
+    CHA_CHECK_EQUAL((int)cha::AnalysisAxisHorizontal, (int)report.issues[0].axis);
+    // The width is only bounded from below now, so it is also ambiguous.
+    CHA_CHECK_EQUAL((size_t)1, report.countOf(cha::AnalysisIssueAmbiguous));
+
+    // The same bounds on the height are reported on the vertical axis.
+    records[2].attribute = CHALayoutAttributeHeight;
+    records[3].attribute = CHALayoutAttributeHeight;
+    records[4].attribute = CHALayoutAttributeWidth;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)1, report.countOf(cha::AnalysisIssueConflict));
+    CHA_CHECK_EQUAL(3u, report.issues[0].record);
+    CHA_CHECK_EQUAL((int)cha::AnalysisAxisVertical, (int)report.issues[0].axis);
+}
+
+CHA_TEST(testAnalyzerReportsAmbiguousAxes)
+{
+    const void *label = cha::test::fixtureItem(2);
+    std::vector<CHAConstraintDescriptor> records = boundsPins(kView);
+    records.push_back(pin(label, CHALayoutAttributeLeading, 8));
+    records.push_back(pin(label, CHALayoutAttributeTop, 8));
+    records.push_back(fixed(label, CHALayoutAttributeHeight, CHALayoutRelationEqual, 20));
+    // An optional width settles the horizontal axis.
+    records.push_back(fixed(label, CHALayoutAttributeWidth, CHALayoutRelationGreaterThanOrEqual, 10));
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK_EQUAL((size_t)1, report.issues.size());
+    CHA_CHECK_EQUAL((int)cha::AnalysisIssueAmbiguous, (int)report.issues[0].kind);
+    CHA_CHECK_EQUAL((int)cha::AnalysisAxisHorizontal, (int)report.issues[0].axis);
+    CHA_CHECK(report.issues[0].item == label);
+    CHA_CHECK((report.issues[0].related == std::vector<uint32_t>{ 4, 7 }));
+
+    records.push_back(CHAConstraintDescriptor{label, nullptr, 0, 100, 250, CHALayoutAttributeWidth, CHALayoutAttributeNotAnAttribute,
+                                              CHALayoutRelationEqual, 0});
+    cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, 480, report);
+    CHA_CHECK(report.clean());
+}
+
+CHA_TEST(testAnalyzerAgreesWithTheSolverOnRandomEqualities)
+{
+    std::mt19937 random(11);
+    const CHALayoutAttribute attributes[] = { CHALayoutAttributeLeading, CHALayoutAttributeTrailing, CHALayoutAttributeWidth,
+                                              CHALayoutAttributeCenterX };
+
+    for (int trial = 0; trial < 100; trial++)
+    {
+        std::vector<CHAConstraintDescriptor> records;
+        const size_t count = 1 + random() % 24;
+        for (size_t i = 0; i < count; i++)
+        {
+            const void *item = cha::test::fixtureItem(1 + random() % 4);
+            const void *toItem = cha::test::fixtureItem(random() % 5);
+            const double multiplier = random() % 4 == 0 ? 0.5 : 1.0;
+            records.push_back(CHAConstraintDescriptor{item, toItem, multiplier, (double)(random() % 3) * 10, CHALayoutPriorityRequired,
+                                                      attributes[random() % 4], attributes[random() % 4], CHALayoutRelationEqual, 0});
+        }
+
+        cha::AnalysisReport report;
+        cha::analyzeConstraints(records.data(), records.size(), kContainer, 320, -1, report);
+        std::vector<uint32_t> conflicts;
+        for (const cha::AnalysisIssue &issue : report.issues)
+        {
+            if (issue.kind == cha::AnalysisIssueConflict) conflicts.push_back(issue.record);
+        }
+
+        cha::LayoutSystem layout;
+        layout.setContainer(kContainer, -1, -1);
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptor(fixed(kContainer, CHALayoutAttributeWidth, CHALayoutRelationEqual, 320)));
+        std::vector<uint32_t> unsatisfiable;
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            if (layout.addDescriptor(records[i]) == cha::Solver::StatusUnsatisfiable) unsatisfiable.push_back((uint32_t)i);
+        }
+        CHA_CHECK(conflicts == unsatisfiable);
+    }
+}
+
+CHA_TEST(testRecordingsRoundTripAndNameTheirOrigins)
+{
+    const char *text =
+        "# header view, 320pt wide\n"
+        "container header 320 -1\n"
+        "constraint picture leading == header leading 1 10 1000 -[UIView(AutoLayoutHelper) pinLeadingTrailing:]\n"
+        "constraint picture trailing == header trailing 1 -10 1000 -[UIView(AutoLayoutHelper) pinLeadingTrailing:]\n"
+        "constraint picture width == - notAnAttribute 0 320 1000 -[UIView(AutoLayoutHelper) width:]\n"
+        "constraint picture height >= header height 0.35 0 750\n";
+
+    cha::ConstraintRecording recording;
+    std::string error;
+    CHA_CHECK(cha::parseConstraintRecording(text, recording, &error));
+    CHA_CHECK_EQUAL((size_t)4, recording.records.size());
+    CHA_CHECK_EQUAL(std::string("picture"), recording.nameOfItem(recording.records[0].item));
+    CHA_CHECK(recording.records[2].toItem == nullptr);
+    CHA_CHECK_EQUAL((int)CHALayoutRelationGreaterThanOrEqual, (int)recording.records[3].relation);
+    CHA_CHECK_CLOSE(750, recording.records[3].priority, 0);
+
+    cha::ConstraintRecording reparsed;
+    CHA_CHECK(cha::parseConstraintRecording(cha::writeConstraintRecording(recording), reparsed, &error));
+    CHA_CHECK_EQUAL(cha::writeConstraintRecording(recording), cha::writeConstraintRecording(reparsed));
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(recording.records.data(), recording.records.size(), recording.container(), recording.width,
+                            recording.height, report);
+    CHA_CHECK_EQUAL((size_t)1, report.countOf(cha::AnalysisIssueConflict));
+
+    const std::vector<const char *> origins = recording.originPointers();
+    const std::string description = cha::describeIssue(report.issues[0], recording.records.data(), origins.data(),
+                                                       [&recording](const void *item) { return recording.nameOfItem(item); });
+    CHA_CHECK(description.find("#2 picture.width == 320 @1000 (from -[UIView(AutoLayoutHelper) width:])") != std::string::npos);
+    CHA_CHECK(description.find("pinLeadingTrailing:") != std::string::npos);
+
+    CHA_CHECK(!cha::parseConstraintRecording("constraint a top == - notAnAttribute 0 1 1000\n", recording, &error));
+    CHA_CHECK_EQUAL(std::string("line 1: constraint before container"), error);
+}
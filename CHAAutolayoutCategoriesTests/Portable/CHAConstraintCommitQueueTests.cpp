@@ -0,0 +1,273 @@
+//
+//  CHAConstraintCommitQueueTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAConstraintCommitQueue.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using cha::test::fixtureItem;
+
+// A fake hierarchy over fixture items: a tree with fan-out 4 rooted at item 0, plus detached items from
+// kDetachedBase on that have no parent at all.
+const size_t kDetachedBase = 1000000;
+
+size_t indexOf(const void *item)
+{
+    return (size_t)reinterpret_cast<uintptr_t>(item) - 1;
+}
+
+const void *fakeParent(const void *item)
+{
+    const size_t index = indexOf(item);
+    if (index == 0 || index >= kDetachedBase) return nullptr;
+    return fixtureItem((index - 1) / 4);
+}
+
+size_t expectedAncestor(size_t a, size_t b)
+{
+    while (a != b)
+    {
+        if (a > b) a = (a - 1) / 4;
+        else b = (b - 1) / 4;
+    }
+    return a;
+}
+
+CHAConstraintDescriptor makeRecord(size_t item, size_t toItem, double constant)
+{
+    CHAConstraintDescriptor record = {};
+    record.item = fixtureItem(item);
+    record.toItem = toItem == (size_t)-1 ? nullptr : fixtureItem(toItem);
+    record.multiplier = 1;
+    record.constant = constant;
+    record.priority = CHALayoutPriorityRequired;
+    record.attribute = CHALayoutAttributeTop;
+    record.toAttribute = record.toItem ? CHALayoutAttributeTop : CHALayoutAttributeNotAnAttribute;
+    record.relation = CHALayoutRelationEqual;
+    return record;
+}
+
+// Stands in for the main run loop: wake() enqueues a perform block, and run() services blocks on the calling thread
+// until stop() is called and nothing is left.
+class FakeRunLoop
+{
+public:
+    FakeRunLoop() : stopped_(false), blocksRun_(0) {}
+
+    void perform(std::function<void()> block)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks_.push_back(std::move(block));
+        condition_.notify_one();
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> block;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return stopped_ || !blocks_.empty(); });
+                if (blocks_.empty()) return;
+                block = std::move(blocks_.front());
+                blocks_.pop_front();
+            }
+            block();
+            blocksRun_++;
+        }
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        condition_.notify_one();
+    }
+
+    size_t blocksRun() const { return blocksRun_; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::function<void()>> blocks_;
+    bool stopped_;
+    size_t blocksRun_;
+};
+
+}
+
+CHA_TEST(testNearestCommonAncestorClimbsToTheSharedView)
+{
+    const cha::ParentFunction parentOf = fakeParent;
+
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(5), fixtureItem(5), parentOf) == fixtureItem(5));
+    // 5 and 6 are siblings under 1; 5 and 9 meet at the root; 21 is a grandchild of 5.
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(5), fixtureItem(6), parentOf) == fixtureItem(1));
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(5), fixtureItem(9), parentOf) == fixtureItem(0));
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(21), fixtureItem(5), parentOf) == fixtureItem(5));
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(0), fixtureItem(340), parentOf) == fixtureItem(0));
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(5), fixtureItem(kDetachedBase), parentOf) == nullptr);
+    CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(5), nullptr, parentOf) == nullptr);
+
+    for (size_t a = 0; a < 200; a += 3)
+    {
+        for (size_t b = 0; b < 200; b += 7)
+        {
+            CHA_CHECK(cha::nearestCommonAncestor(fixtureItem(a), fixtureItem(b), parentOf) ==
+                      fixtureItem(expectedAncestor(a, b)));
+        }
+    }
+
+    // Size constants have no toItem and belong to the item itself.
+    CHA_CHECK(cha::installationTarget(makeRecord(7, (size_t)-1, 44), parentOf) == fixtureItem(7));
+    CHA_CHECK(cha::installationTarget(makeRecord(7, 8, 0), parentOf) == fixtureItem(1));
+}
+
+CHA_TEST(testSubmissionsBeforeADrainShareOneCommit)
+{
+    std::vector<cha::CommitBatch> commits;
+    size_t wakes = 0;
+    cha::ConstraintCommitQueue queue(fakeParent,
+                                     [&commits](const cha::CommitBatch &batch) { commits.push_back(batch); },
+                                     [&wakes] { wakes++; });
+
+    CHA_CHECK_EQUAL((size_t)0, queue.drain());
+    CHA_CHECK_EQUAL((uint64_t)0, queue.commitCount());
+
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(5), fixtureItem(1), CHAEdgeAll, 8);
+    queue.submitBatch(batch);
+
+    const CHAConstraintDescriptor loose[] = {
+        makeRecord(5, 6, 0),
+        makeRecord(9, (size_t)-1, 44),
+        makeRecord(5, 9, 2),
+        makeRecord(kDetachedBase, 5, 0),
+        makeRecord(6, 5, 1),
+    };
+    queue.submit(loose, sizeof(loose) / sizeof(loose[0]));
+
+    // Only the first submission asks for a turn.
+    CHA_CHECK_EQUAL((size_t)1, wakes);
+    CHA_CHECK_EQUAL(batch.count + (size_t)5, queue.pendingCount());
+    CHA_CHECK(commits.empty());
+
+    CHA_CHECK_EQUAL(batch.count + (size_t)5, queue.drain());
+    CHA_CHECK_EQUAL((size_t)0, queue.pendingCount());
+    CHA_CHECK_EQUAL((size_t)1, commits.size());
+    CHA_CHECK_EQUAL((uint64_t)1, queue.commitCount());
+
+    // Groups appear in the order their targets were first seen; records keep submission order within a group.
+    const cha::CommitBatch &commit = commits[0];
+    CHA_CHECK_EQUAL((size_t)3, commit.groups.size());
+    CHA_CHECK(commit.groups[0].ancestor == fixtureItem(1));
+    CHA_CHECK_EQUAL((size_t)0, commit.groups[0].first);
+    CHA_CHECK_EQUAL((size_t)6, commit.groups[0].count);
+    CHA_CHECK(commit.groups[1].ancestor == fixtureItem(9));
+    CHA_CHECK_EQUAL((size_t)1, commit.groups[1].count);
+    CHA_CHECK(commit.groups[2].ancestor == fixtureItem(0));
+    CHA_CHECK_EQUAL((size_t)1, commit.groups[2].count);
+    CHA_CHECK_EQUAL((size_t)8, commit.records.size());
+    CHA_CHECK_EQUAL(CHALayoutAttributeTop, commit.records[0].attribute);
+    CHA_CHECK(commit.records[4].toItem == fixtureItem(6));
+    CHA_CHECK_CLOSE(1, commit.records[5].constant, 0);
+    CHA_CHECK_CLOSE(44, commit.records[6].constant, 0);
+    CHA_CHECK_CLOSE(2, commit.records[7].constant, 0);
+    CHA_CHECK_EQUAL((size_t)1, commit.orphans.size());
+    CHA_CHECK(commit.orphans[0].item == fixtureItem(kDetachedBase));
+
+    // The next submission asks for a new turn.
+    queue.submit(loose, 1);
+    CHA_CHECK_EQUAL((size_t)2, wakes);
+    CHA_CHECK_EQUAL((size_t)1, queue.drain());
+    CHA_CHECK_EQUAL((size_t)1, commits.back().records.size());
+}
+
+CHA_TEST(testConcurrentProducersCommitEveryRecordOnTheConsumerThread)
+{
+    const size_t producerCount = 8, batchesPerProducer = 2000, recordsPerBatch = 6;
+    const size_t viewCount = 400;
+
+    FakeRunLoop runLoop;
+    std::thread::id consumerThread;
+    std::vector<uint8_t> seen(producerCount * batchesPerProducer * recordsPerBatch, 0);
+    size_t committed = 0, misplaced = 0, offThread = 0, emptyCommits = 0;
+
+    cha::ConstraintCommitQueue *queuePointer = nullptr;
+    cha::ConstraintCommitQueue queue(
+        fakeParent,
+        [&](const cha::CommitBatch &batch) {
+            if (std::this_thread::get_id() != consumerThread) offThread++;
+            if (batch.records.empty()) emptyCommits++;
+            for (const cha::CommitGroup &group : batch.groups)
+            {
+                for (size_t index = group.first; index < group.first + group.count; index++)
+                {
+                    const CHAConstraintDescriptor &record = batch.records[index];
+                    const size_t expected = expectedAncestor(indexOf(record.item), indexOf(record.toItem));
+                    if (group.ancestor != fixtureItem(expected)) misplaced++;
+                    seen[(size_t)record.constant]++;
+                    committed++;
+                }
+            }
+        },
+        [&runLoop, &queuePointer] { runLoop.perform([&queuePointer] { queuePointer->drain(); }); });
+    queuePointer = &queue;
+
+    std::thread consumer([&runLoop, &consumerThread] {
+        consumerThread = std::this_thread::get_id();
+        runLoop.run();
+    });
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producerCount; p++)
+    {
+        producers.emplace_back([&queue, p, viewCount] {
+            for (size_t b = 0; b < batchesPerProducer; b++)
+            {
+                CHAConstraintDescriptor records[recordsPerBatch];
+                for (size_t r = 0; r < recordsPerBatch; r++)
+                {
+                    const size_t serial = (p * batchesPerProducer + b) * recordsPerBatch + r;
+                    const size_t item = 1 + (serial * 7919) % viewCount;
+                    const size_t toItem = 1 + (serial * 104729) % viewCount;
+                    records[r] = makeRecord(item, toItem, (double)serial);
+                }
+                queue.submit(records, recordsPerBatch);
+            }
+        });
+    }
+    for (std::thread &producer : producers) producer.join();
+    runLoop.stop();
+    consumer.join();
+
+    const size_t total = producerCount * batchesPerProducer * recordsPerBatch;
+    size_t once = 0;
+    for (uint8_t count : seen) once += count == 1;
+
+    CHA_CHECK_EQUAL(total, committed);
+    CHA_CHECK_EQUAL(total, once);
+    CHA_CHECK_EQUAL((size_t)0, misplaced);
+    CHA_CHECK_EQUAL((size_t)0, offThread);
+    CHA_CHECK_EQUAL((size_t)0, emptyCommits);
+    CHA_CHECK_EQUAL((size_t)0, queue.pendingCount());
+    // Every wake is answered by exactly one commit, and submissions that arrive while a turn is pending share it.
+    CHA_CHECK_EQUAL(queue.wakeCount(), queue.commitCount());
+    CHA_CHECK(queue.commitCount() <= producerCount * batchesPerProducer);
+    CHA_CHECK_EQUAL(queue.wakeCount(), (uint64_t)runLoop.blocksRun());
+}
@@ -0,0 +1,117 @@
+//
+//  CHAConstraintDescriptorTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHAConstraintDescriptor.h"
+
+#include <cstddef>
+
+static_assert(offsetof(CHAConstraintDescriptor, item) == 0, "item leads the record");
+static_assert(offsetof(CHAConstraintDescriptor, toItem) == sizeof(void *), "toItem follows item");
+static_assert(offsetof(CHAConstraintDescriptor, multiplier) == 2 * sizeof(void *), "doubles follow the items");
+static_assert(sizeof(CHAConstraintDescriptor) == 2 * sizeof(void *) + 24, "record has no hidden padding");
+static_assert(sizeof(CHADescriptorBatch) <= 16 + CHA_DESCRIPTOR_BATCH_CAPACITY * sizeof(CHAConstraintDescriptor),
+              "batch is a flat array plus a count");
+
+namespace {
+int view;
+int superview;
+}
+
+CHA_TEST(testAttributeValuesMatchUIKit)
+{
+    CHA_CHECK_EQUAL(1, CHALayoutAttributeLeft);
+    CHA_CHECK_EQUAL(5, CHALayoutAttributeLeading);
+    CHA_CHECK_EQUAL(8, CHALayoutAttributeHeight);
+    CHA_CHECK_EQUAL(10, CHALayoutAttributeCenterY);
+    CHA_CHECK_EQUAL(-1, CHALayoutRelationLessThanOrEqual);
+    CHA_CHECK_EQUAL(1, CHALayoutRelationGreaterThanOrEqual);
+}
+
+CHA_TEST(testEdgesEmitInCanonicalOrderWithPerEdgeSign)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+
+    size_t appended = CHADescriptorBatchAppendEdges(&batch, &view, &superview, CHAEdgeTrailing | CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeading, 10);
+    CHA_CHECK_EQUAL(4u, appended);
+    CHA_CHECK_EQUAL(4u, batch.count);
+
+    const CHALayoutAttribute expected[] = {
+        CHALayoutAttributeTop, CHALayoutAttributeBottom, CHALayoutAttributeLeading, CHALayoutAttributeTrailing
+    };
+    const double constants[] = { 10, -10, 10, -10 };
+    for (int i = 0; i < 4; i++)
+    {
+        const CHAConstraintDescriptor &record = batch.records[i];
+        CHA_CHECK_EQUAL(expected[i], record.attribute);
+        CHA_CHECK_EQUAL(expected[i], record.toAttribute);
+        CHA_CHECK_EQUAL(CHALayoutRelationEqual, record.relation);
+        CHA_CHECK(record.item == &view);
+        CHA_CHECK(record.toItem == &superview);
+        CHA_CHECK_EQUAL(1.0, record.multiplier);
+        CHA_CHECK_EQUAL(constants[i], record.constant);
+        CHA_CHECK_EQUAL(CHALayoutPriorityRequired, record.priority);
+    }
+}
+
+CHA_TEST(testLeftRightEdgesAreSignedLikeLeadingTrailing)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+
+    CHADescriptorBatchAppendEdges(&batch, &view, &superview, CHAEdgeLeft | CHAEdgeRight, 4);
+    CHA_CHECK_EQUAL(2u, batch.count);
+    CHA_CHECK_EQUAL(CHALayoutAttributeLeft, batch.records[0].attribute);
+    CHA_CHECK_EQUAL(4.0, batch.records[0].constant);
+    CHA_CHECK_EQUAL(CHALayoutAttributeRight, batch.records[1].attribute);
+    CHA_CHECK_EQUAL(-4.0, batch.records[1].constant);
+}
+
+CHA_TEST(testInsetsUseTheirOwnConstants)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+
+    CHA_CHECK_EQUAL(4u, CHADescriptorBatchAppendInsets(&batch, &view, &superview, 1, 2, 3, 4));
+    CHA_CHECK_EQUAL(1.0, batch.records[0].constant);
+    CHA_CHECK_EQUAL(-3.0, batch.records[1].constant);
+    CHA_CHECK_EQUAL(2.0, batch.records[2].constant);
+    CHA_CHECK_EQUAL(-4.0, batch.records[3].constant);
+}
+
+CHA_TEST(testBatchHoldsExactlyItsCapacity)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+
+    for (int i = 0; i < CHA_DESCRIPTOR_BATCH_CAPACITY; i++)
+    {
+        CHA_CHECK(CHADescriptorBatchAppend(&batch, &view, CHALayoutAttributeWidth, CHALayoutRelationEqual,
+                                           nullptr, CHALayoutAttributeNotAnAttribute, 1, i) != nullptr);
+    }
+    CHA_CHECK_EQUAL((uint32_t)CHA_DESCRIPTOR_BATCH_CAPACITY, batch.count);
+
+#ifdef NDEBUG
+    // Overflowing asserts; only a build without assertions reaches the fallback of dropping the record.
+    CHA_CHECK(CHADescriptorBatchAppend(&batch, &view, CHALayoutAttributeWidth, CHALayoutRelationEqual,
+                                       nullptr, CHALayoutAttributeNotAnAttribute, 1, 0) == nullptr);
+    CHA_CHECK_EQUAL(0u, CHADescriptorBatchAppendEdges(&batch, &view, &superview, CHAEdgeAll, 0));
+    CHA_CHECK_EQUAL((uint32_t)CHA_DESCRIPTOR_BATCH_CAPACITY, batch.count);
+#endif
+}
+
+CHA_TEST(testEdgeMaskRoundTrips)
+{
+    const CHAEdgeMask edges[] = { CHAEdgeTop, CHAEdgeBottom, CHAEdgeLeading, CHAEdgeTrailing, CHAEdgeLeft, CHAEdgeRight };
+    for (CHAEdgeMask edge : edges)
+    {
+        CHA_CHECK_EQUAL(edge, CHAEdgeMaskForAttribute(CHALayoutAttributeForEdge(edge)));
+    }
+    CHA_CHECK_EQUAL(0, CHAEdgeMaskForAttribute(CHALayoutAttributeWidth));
+    CHA_CHECK_EQUAL(CHALayoutAttributeNotAnAttribute, CHALayoutAttributeForEdge(CHAEdgeTop | CHAEdgeBottom));
+}
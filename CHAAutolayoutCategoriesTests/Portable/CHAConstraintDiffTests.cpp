@@ -0,0 +1,178 @@
+//
+//  CHAConstraintDiffTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAConstraintDiff.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+CHAConstraintDescriptor record(size_t item, CHALayoutAttribute attribute, size_t toItem, double constant, float priority = 1000)
+{
+    return CHAConstraintDescriptor{cha::test::fixtureItem(item), cha::test::fixtureItem(toItem), 1, constant, priority, attribute,
+                                   attribute, CHALayoutRelationEqual, 0};
+}
+
+bool identical(const CHAConstraintDescriptor &a, const CHAConstraintDescriptor &b)
+{
+    return cha::structurallyEqual(a, b) && a.constant == b.constant && a.priority == b.priority;
+}
+
+CHAConstraintDescriptor randomRecord(std::mt19937 &random)
+{
+    const CHALayoutAttribute attributes[] = { CHALayoutAttributeLeading, CHALayoutAttributeTrailing, CHALayoutAttributeTop,
+                                              CHALayoutAttributeBottom, CHALayoutAttributeWidth, CHALayoutAttributeHeight };
+    const double multipliers[] = { 1, 0.5, 2 };
+    const float priorities[] = { 1000, 750, 250 };
+    return CHAConstraintDescriptor{cha::test::fixtureItem(1 + random() % 12),
+                                   cha::test::fixtureItem(random() % 12),
+                                   multipliers[random() % 3],
+                                   (double)(random() % 5),
+                                   priorities[random() % 3],
+                                   attributes[random() % 6],
+                                   attributes[random() % 6],
+                                   (CHALayoutRelation)((int)(random() % 3) - 1),
+                                   0};
+}
+
+}
+
+CHA_TEST(testIdenticalSetsDiffToNothing)
+{
+    std::vector<CHAConstraintDescriptor> records = { record(1, CHALayoutAttributeLeading, 0, 10), record(1, CHALayoutAttributeTop, 0, 8),
+                                                     record(2, CHALayoutAttributeWidth, 1, 0) };
+    std::vector<CHAConstraintDescriptor> shuffled = { records[2], records[0], records[1] };
+
+    cha::ConstraintDiff diff;
+    cha::diffConstraints(records.data(), records.size(), shuffled.data(), shuffled.size(), diff);
+    CHA_CHECK_EQUAL((size_t)3, diff.matches.size());
+    CHA_CHECK_EQUAL((size_t)0, diff.changedCount());
+    CHA_CHECK_EQUAL(2u, diff.matches[0].oldIndex);
+    CHA_CHECK_EQUAL(0u, diff.matches[0].newIndex);
+}
+
+CHA_TEST(testDiffReportsConstantPriorityAndStructuralChanges)
+{
+    std::vector<CHAConstraintDescriptor> before = { record(1, CHALayoutAttributeLeading, 0, 10), record(1, CHALayoutAttributeTop, 0, 8),
+                                                    record(2, CHALayoutAttributeWidth, 1, 0, 750), record(3, CHALayoutAttributeHeight, 0, 0),
+                                                    record(4, CHALayoutAttributeTop, 0, 0, 250) };
+    std::vector<CHAConstraintDescriptor> after = { record(1, CHALayoutAttributeLeading, 0, 20), record(1, CHALayoutAttributeTop, 0, 8),
+                                                   record(2, CHALayoutAttributeWidth, 1, 0, 500), record(3, CHALayoutAttributeWidth, 0, 0),
+                                                   record(4, CHALayoutAttributeTop, 0, 0) };
+
+    cha::ConstraintDiff diff;
+    cha::diffConstraints(before.data(), before.size(), after.data(), after.size(), diff);
+    CHA_CHECK_EQUAL((size_t)4, diff.matches.size());
+    CHA_CHECK_EQUAL((int)cha::DiffChangeConstant, (int)diff.matches[0].changes);
+    CHA_CHECK_EQUAL((int)cha::DiffChangeNone, (int)diff.matches[1].changes);
+    CHA_CHECK_EQUAL((int)cha::DiffChangePriority, (int)diff.matches[2].changes);
+    CHA_CHECK_EQUAL((int)(cha::DiffChangePriority | cha::DiffChangeReinstall), (int)diff.matches[3].changes);
+    CHA_CHECK_EQUAL(4u, diff.matches[3].newIndex);
+    CHA_CHECK(diff.additions == std::vector<uint32_t>{ 3 });
+    CHA_CHECK(diff.removals == std::vector<uint32_t>{ 3 });
+    CHA_CHECK_EQUAL((size_t)5, diff.changedCount());
+}
+
+CHA_TEST(testRandomizedDiffsAreMinimalAndReproduceTheNewSet)
+{
+    std::mt19937 random(2015);
+
+    for (int trial = 0; trial < 300; trial++)
+    {
+        std::vector<CHAConstraintDescriptor> before;
+        const size_t count = random() % 80;
+        for (size_t i = 0; i < count; i++) before.push_back(randomRecord(random));
+        // Some exact duplicates, which must pair up one-to-one.
+        for (size_t i = 0; i < count / 8; i++) before.push_back(before[random() % count]);
+
+        std::vector<CHAConstraintDescriptor> after;
+        for (const CHAConstraintDescriptor &old : before)
+        {
+            switch (random() % 6)
+            {
+                case 0:
+                    break;
+                case 1:
+                    after.push_back(randomRecord(random));
+                    break;
+                case 2:
+                {
+                    CHAConstraintDescriptor changed = old;
+                    changed.constant += 1 + random() % 3;
+                    after.push_back(changed);
+                    break;
+                }
+                case 3:
+                {
+                    CHAConstraintDescriptor changed = old;
+                    changed.priority = changed.priority == 1000 ? 999 : 1000;
+                    after.push_back(changed);
+                    break;
+                }
+                default:
+                    after.push_back(old);
+                    break;
+            }
+        }
+        std::shuffle(after.begin(), after.end(), random);
+
+        cha::ConstraintDiff diff;
+        cha::diffConstraints(before.data(), before.size(), after.data(), after.size(), diff);
+
+        // Every old record is matched or removed, and every new record matched or added, exactly once.
+        std::vector<int> oldUses(before.size()), newUses(after.size());
+        for (const cha::DiffMatch &match : diff.matches)
+        {
+            oldUses[match.oldIndex]++;
+            newUses[match.newIndex]++;
+            CHA_CHECK(cha::structurallyEqual(before[match.oldIndex], after[match.newIndex]));
+
+            // Applying the reported changes to the old record reproduces the new one.
+            CHAConstraintDescriptor applied = before[match.oldIndex];
+            if (match.changes & cha::DiffChangeConstant) applied.constant = after[match.newIndex].constant;
+            if (match.changes & cha::DiffChangePriority) applied.priority = after[match.newIndex].priority;
+            CHA_CHECK(identical(applied, after[match.newIndex]));
+            const bool crossesRequired = (before[match.oldIndex].priority >= 1000) != (after[match.newIndex].priority >= 1000);
+            CHA_CHECK_EQUAL(crossesRequired, (match.changes & cha::DiffChangeReinstall) != 0);
+        }
+        for (uint32_t index : diff.removals) oldUses[index]++;
+        for (uint32_t index : diff.additions) newUses[index]++;
+        CHA_CHECK(std::all_of(oldUses.begin(), oldUses.end(), [](int uses) { return uses == 1; }));
+        CHA_CHECK(std::all_of(newUses.begin(), newUses.end(), [](int uses) { return uses == 1; }));
+        CHA_CHECK(std::is_sorted(diff.additions.begin(), diff.additions.end()));
+        CHA_CHECK(std::is_sorted(diff.removals.begin(), diff.removals.end()));
+        CHA_CHECK(std::is_sorted(diff.matches.begin(), diff.matches.end(),
+                                 [](const cha::DiffMatch &a, const cha::DiffMatch &b) { return a.newIndex < b.newIndex; }));
+
+        // Minimal: per structure, as many matches as the smaller side has records.
+        size_t expectedMatches = 0;
+        std::vector<bool> counted(before.size());
+        for (size_t i = 0; i < before.size(); i++)
+        {
+            if (counted[i]) continue;
+            size_t olds = 0, news = 0;
+            for (size_t j = i; j < before.size(); j++)
+            {
+                if (cha::structurallyEqual(before[i], before[j]))
+                {
+                    counted[j] = true;
+                    olds++;
+                }
+            }
+            for (const CHAConstraintDescriptor &candidate : after)
+            {
+                if (cha::structurallyEqual(before[i], candidate)) news++;
+            }
+            expectedMatches += std::min(olds, news);
+        }
+        CHA_CHECK_EQUAL(expectedMatches, diff.matches.size());
+    }
+}
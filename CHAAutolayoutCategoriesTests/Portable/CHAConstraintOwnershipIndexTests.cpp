@@ -0,0 +1,133 @@
+//
+//  CHAConstraintOwnershipIndexTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHAConstraintOwnershipIndex.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace {
+
+typedef cha::ConstraintOwnershipIndex::Handle Handle;
+
+Handle handle(uintptr_t value)
+{
+    return reinterpret_cast<Handle>(value * 16);
+}
+
+}
+
+CHA_TEST(testTakingAViewReturnsConstraintsOnBothSides)
+{
+    cha::ConstraintOwnershipIndex index;
+    Handle superview = handle(1), view = handle(2), sibling = handle(3);
+
+    index.add(handle(100), view, superview);
+    index.add(handle(101), view, sibling);
+    index.add(handle(102), sibling, superview);
+    index.add(handle(103), view, nullptr);
+    index.add(handle(103), view, nullptr);
+
+    CHA_CHECK_EQUAL(4u, index.constraintCount());
+    CHA_CHECK_EQUAL(3u, index.constraintCountForItem(view));
+
+    std::vector<Handle> taken;
+    CHA_CHECK_EQUAL(3u, index.takeConstraintsForItems(&view, 1, taken));
+    CHA_CHECK_EQUAL(1u, index.constraintCount());
+    CHA_CHECK(index.contains(handle(102)));
+    CHA_CHECK_EQUAL(1u, index.constraintCountForItem(sibling));
+    CHA_CHECK_EQUAL(1u, index.constraintCountForItem(superview));
+    CHA_CHECK_EQUAL(0u, index.constraintCountForItem(view));
+}
+
+CHA_TEST(testConstraintSharedByTwoTakenViewsIsReturnedOnce)
+{
+    cha::ConstraintOwnershipIndex index;
+    Handle views[] = { handle(1), handle(2) };
+    index.add(handle(100), views[0], views[1]);
+
+    std::vector<Handle> taken;
+    CHA_CHECK_EQUAL(1u, index.takeConstraintsForItems(views, 2, taken));
+    CHA_CHECK_EQUAL(1u, taken.size());
+    CHA_CHECK_EQUAL(0u, index.itemCount());
+}
+
+CHA_TEST(testRemovedConstraintsAreNotReturnedAfterSlotReuse)
+{
+    cha::ConstraintOwnershipIndex index;
+    Handle a = handle(1), b = handle(2);
+
+    index.add(handle(100), a, b);
+    index.add(handle(101), b, nullptr);
+    CHA_CHECK(index.remove(handle(100)));
+    CHA_CHECK(!index.remove(handle(100)));
+    index.add(handle(102), b, nullptr);
+
+    std::vector<Handle> taken;
+    CHA_CHECK_EQUAL(0u, index.takeConstraintsForItems(&a, 1, taken));
+    CHA_CHECK_EQUAL(2u, index.takeConstraintsForItems(&b, 1, taken));
+    CHA_CHECK_EQUAL(0u, index.constraintCount());
+}
+
+CHA_TEST(testStressHundredThousandViewsMatchesLinearScan)
+{
+    const uintptr_t viewCount = 100000;
+    std::mt19937 random(42);
+    cha::ConstraintOwnershipIndex index;
+
+    struct Record { Handle constraint, first, second; };
+    std::vector<Record> records;
+    uintptr_t nextConstraint = viewCount + 1;
+
+    for (uintptr_t view = 1; view < viewCount; view++)
+    {
+        Handle parent = handle(1 + random() % view);
+        for (int edge = 0; edge < 4; edge++)
+        {
+            Record record = { handle(nextConstraint++), handle(view + 1), parent };
+            index.add(record.constraint, record.first, record.second);
+            records.push_back(record);
+        }
+        if (view > 1)
+        {
+            Record record = { handle(nextConstraint++), handle(view + 1), handle(view) };
+            index.add(record.constraint, record.first, record.second);
+            records.push_back(record);
+        }
+    }
+    CHA_CHECK_EQUAL(records.size(), index.constraintCount());
+
+    std::set<Handle> removed;
+    for (size_t i = 0; i < records.size(); i += 7)
+    {
+        index.remove(records[i].constraint);
+        removed.insert(records[i].constraint);
+    }
+
+    for (int round = 0; round < 20; round++)
+    {
+        std::vector<Handle> views;
+        for (int i = 0; i < 200; i++) views.push_back(handle(1 + random() % viewCount));
+
+        std::set<Handle> expected;
+        std::set<Handle> requested(views.begin(), views.end());
+        for (const Record &record : records)
+        {
+            if (removed.count(record.constraint)) continue;
+            if (requested.count(record.first) || requested.count(record.second)) expected.insert(record.constraint);
+        }
+
+        std::vector<Handle> taken;
+        index.takeConstraintsForItems(views.data(), views.size(), taken);
+        CHA_CHECK_EQUAL(expected.size(), taken.size());
+        CHA_CHECK(std::set<Handle>(taken.begin(), taken.end()) == expected);
+        removed.insert(taken.begin(), taken.end());
+    }
+    CHA_CHECK_EQUAL(records.size() - removed.size(), index.constraintCount());
+}
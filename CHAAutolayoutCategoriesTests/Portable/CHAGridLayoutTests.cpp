@@ -0,0 +1,173 @@
+//
+//  CHAGridLayoutTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAGridLayout.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+const cha::GridKernel kKernels[] = { cha::GridKernelScalar, cha::GridKernelSSE2, cha::GridKernelAVX, cha::GridKernelNEON };
+
+CHAGridSpec makeSpec(uint32_t columns)
+{
+    CHAGridSpec spec = {};
+    spec.columns = columns;
+    return spec;
+}
+
+}
+
+CHA_TEST(testEqualGridFrames)
+{
+    CHAGridSpec spec = makeSpec(3);
+    spec.rowSpacing = 4;
+    spec.columnSpacing = 5;
+    spec.top = 10;
+    spec.leading = 20;
+    spec.bottom = 10;
+    spec.trailing = 20;
+    spec.rowHeight = 50;
+
+    cha::FrameBuffer frames;
+    double contentHeight = 0;
+    CHA_CHECK(cha::layoutGrid(spec, 320, -1, 7, frames, cha::preferredGridKernel(), &contentHeight));
+    CHA_CHECK_EQUAL((size_t)7, frames.size());
+    CHA_CHECK_CLOSE(10 + 3 * 50 + 2 * 4 + 10, contentHeight, 1e-9);
+
+    // 320 - 40 of insets - 10 of spacing leaves 270 for three columns.
+    const cha::Frame fifth = frames.frame(4);
+    CHA_CHECK_CLOSE(20 + 90 + 5, fifth.x, 1e-9);
+    CHA_CHECK_CLOSE(10 + 50 + 4, fifth.y, 1e-9);
+    CHA_CHECK_CLOSE(90, fifth.width, 1e-9);
+    CHA_CHECK_CLOSE(50, fifth.height, 1e-9);
+    CHA_CHECK_CLOSE(20, frames.frame(6).x, 1e-9);
+    CHA_CHECK_CLOSE(10 + 2 * 54, frames.frame(6).y, 1e-9);
+}
+
+CHA_TEST(testWeightedTracksShareTheRemainingSpace)
+{
+    const double columnWeights[] = { 1, 2, 1 };
+    const double rowWeights[] = { 3, 1 };
+    CHAGridSpec spec = makeSpec(3);
+    spec.rows = 2;
+    spec.columnWeights = columnWeights;
+    spec.rowWeights = rowWeights;
+
+    cha::FrameBuffer frames;
+    CHA_CHECK(cha::layoutGrid(spec, 400, 200, 6, frames));
+    CHA_CHECK_CLOSE(100, frames.frame(0).width, 1e-9);
+    CHA_CHECK_CLOSE(200, frames.frame(1).width, 1e-9);
+    CHA_CHECK_CLOSE(300, frames.frame(2).x, 1e-9);
+    CHA_CHECK_CLOSE(150, frames.frame(0).height, 1e-9);
+    CHA_CHECK_CLOSE(150, frames.frame(5).y, 1e-9);
+    CHA_CHECK_CLOSE(50, frames.frame(5).height, 1e-9);
+}
+
+CHA_TEST(testGridRejectsUndeterminedLayouts)
+{
+    cha::FrameBuffer frames;
+    CHA_CHECK(!cha::layoutGrid(makeSpec(0), 320, 480, 4, frames));
+    CHA_CHECK(!cha::layoutGrid(makeSpec(4), 320, -1, 4, frames));
+
+    CHAGridSpec tooFewRows = makeSpec(2);
+    tooFewRows.rows = 2;
+    CHA_CHECK(!cha::layoutGrid(tooFewRows, 320, 480, 5, frames));
+}
+
+CHA_TEST(testEveryKernelMatchesScalar)
+{
+    for (uint32_t columns = 1; columns <= 11; columns++)
+    {
+        for (size_t count : { (size_t)1, (size_t)columns, (size_t)(3 * columns - 1), (size_t)(7 * columns + 2) })
+        {
+            CHAGridSpec spec = makeSpec(columns);
+            spec.columnSpacing = 3;
+            spec.rowSpacing = 2;
+            spec.leading = 7;
+            spec.rowHeight = 40;
+
+            cha::FrameBuffer expected;
+            CHA_CHECK(cha::layoutGrid(spec, 375, -1, count, expected, cha::GridKernelScalar));
+
+            for (cha::GridKernel kernel : kKernels)
+            {
+                if (!cha::isGridKernelAvailable(kernel)) continue;
+                cha::FrameBuffer frames;
+                CHA_CHECK(cha::layoutGrid(spec, 375, -1, count, frames, kernel));
+                CHA_CHECK_EQUAL(expected.size(), frames.size());
+                for (size_t i = 0; i < frames.size() && i < expected.size(); i++)
+                {
+                    CHA_CHECK_EQUAL(expected.x[i], frames.x[i]);
+                    CHA_CHECK_EQUAL(expected.y[i], frames.y[i]);
+                    CHA_CHECK_EQUAL(expected.width[i], frames.width[i]);
+                    CHA_CHECK_EQUAL(expected.height[i], frames.height[i]);
+                }
+            }
+        }
+    }
+}
+
+CHA_TEST(testGridMatchesEqualWidthConstraints)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const void *container = cha::test::fixtureItem(0);
+
+    for (int trial = 0; trial < 60; trial++)
+    {
+        CHAGridSpec spec = makeSpec(1 + random() % 8);
+        const size_t count = 1 + random() % 40;
+        spec.rows = random() % 3 == 0 ? (uint32_t)(cha::gridRowCount(spec, count) + random() % 2) : 0;
+        spec.rowSpacing = std::floor(unit(random) * 8);
+        spec.columnSpacing = std::floor(unit(random) * 8);
+        spec.top = std::floor(unit(random) * 20);
+        spec.leading = std::floor(unit(random) * 20);
+        spec.bottom = std::floor(unit(random) * 20);
+        spec.trailing = std::floor(unit(random) * 20);
+        spec.rowHeight = random() % 2 ? 20 + std::floor(unit(random) * 40) : 0;
+
+        std::vector<double> columnWeights, rowWeights;
+        for (size_t i = 0; i < spec.columns; i++) columnWeights.push_back(1 + std::floor(unit(random) * 3));
+        for (size_t i = 0; i < cha::gridRowCount(spec, count); i++) rowWeights.push_back(1 + std::floor(unit(random) * 3));
+        if (random() % 2)
+        {
+            spec.columnWeights = columnWeights.data();
+            spec.rowWeights = rowWeights.data();
+        }
+
+        std::vector<const void *> items;
+        for (size_t i = 1; i <= count; i++) items.push_back(cha::test::fixtureItem(i));
+        std::vector<CHAConstraintDescriptor> descriptors;
+        cha::appendGridDescriptors(spec, container, items.data(), count, descriptors);
+
+        const double width = 300 + std::floor(unit(random) * 200);
+        const double height = spec.rowHeight > 0 ? -1 : 600 + std::floor(unit(random) * 400);
+        cha::FrameBuffer frames;
+        double contentHeight = 0;
+        CHA_CHECK(cha::layoutGrid(spec, width, height, count, frames, cha::preferredGridKernel(), &contentHeight));
+
+        cha::LayoutSystem layout;
+        layout.setContainer(container, width, height);
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+        layout.solve();
+
+        for (size_t i = 0; i < count && i < frames.size(); i++)
+        {
+            const cha::Frame expected = layout.frame(items[i]);
+            CHA_CHECK_CLOSE(expected.x, frames.x[i], 1e-6);
+            CHA_CHECK_CLOSE(expected.y, frames.y[i], 1e-6);
+            CHA_CHECK_CLOSE(expected.width, frames.width[i], 1e-6);
+            CHA_CHECK_CLOSE(expected.height, frames.height[i], 1e-6);
+        }
+        if (height >= 0) CHA_CHECK_CLOSE(height, contentHeight, 1e-6);
+    }
+}
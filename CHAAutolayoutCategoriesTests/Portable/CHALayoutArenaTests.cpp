@@ -0,0 +1,249 @@
+//
+//  CHALayoutArenaTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHALayoutArena.h"
+#include "CHALayoutPass.h"
+#include "CHALayoutSystem.h"
+#include "CHAPortableBenchmark.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Count heap allocations made on the current thread while a HeapAllocationCounter is alive. The replacement operators
+// apply to the whole test executable but only count inside a counter's scope. Every replaceable form is defined here,
+// nothrow and aligned included, so memory from any of them is always released by the matching replacement.
+
+namespace {
+
+thread_local bool countingAllocations = false;
+thread_local size_t allocationCount = 0;
+
+class HeapAllocationCounter
+{
+public:
+    HeapAllocationCounter()
+    {
+        allocationCount = 0;
+        countingAllocations = true;
+    }
+    ~HeapAllocationCounter() { countingAllocations = false; }
+
+    size_t count() const { return allocationCount; }
+};
+
+void *countedAllocation(size_t size, size_t alignment) noexcept
+{
+    if (countingAllocations) allocationCount++;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size ? size : 1);
+
+    void *pointer = nullptr;
+    return posix_memalign(&pointer, alignment, size ? size : 1) == 0 ? pointer : nullptr;
+}
+
+void *checkedAllocation(size_t size, size_t alignment)
+{
+    void *pointer = countedAllocation(size, alignment);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+}
+
+void *operator new(size_t size) { return checkedAllocation(size, 0); }
+void *operator new[](size_t size) { return checkedAllocation(size, 0); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return countedAllocation(size, 0); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return countedAllocation(size, 0); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+#if defined(__cpp_aligned_new)
+
+void *operator new(size_t size, std::align_val_t alignment) { return checkedAllocation(size, (size_t)alignment); }
+void *operator new[](size_t size, std::align_val_t alignment) { return checkedAllocation(size, (size_t)alignment); }
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocation(size, (size_t)alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocation(size, (size_t)alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+#endif
+
+namespace {
+
+const cha::test::HierarchyShape kShapes[] = { cha::test::HierarchyShapeChain, cha::test::HierarchyShapeGrid,
+                                              cha::test::HierarchyShapeNested };
+
+}
+
+CHA_TEST(testArenaRewindsIntoTheChunksItAlreadyHolds)
+{
+    cha::LayoutArena arena(1024);
+    for (int pass = 0; pass < 3; pass++)
+    {
+        arena.reset();
+        for (size_t size = 1; size < 200; size += 7)
+        {
+            void *pointer = arena.allocate(size, 16);
+            CHA_CHECK(reinterpret_cast<uintptr_t>(pointer) % 16 == 0);
+        }
+        // Larger than a chunk: gets one of its own.
+        CHA_CHECK(arena.allocate(5000) != nullptr);
+        CHA_CHECK(arena.highWaterMark() >= arena.bytesInUse());
+    }
+
+    const uint64_t chunks = arena.chunkAllocations();
+    const size_t highWater = arena.highWaterMark();
+    arena.reset();
+    CHA_CHECK_EQUAL((size_t)0, arena.bytesInUse());
+    CHA_CHECK_EQUAL(highWater, arena.highWaterMark());
+
+    HeapAllocationCounter counter;
+    for (size_t size = 1; size < 200; size += 7) arena.allocate(size, 16);
+    arena.allocate(5000);
+    CHA_CHECK_EQUAL((size_t)0, counter.count());
+    CHA_CHECK_EQUAL(chunks, arena.chunkAllocations());
+}
+
+CHA_TEST(testArenaAllocatorBacksStandardContainers)
+{
+    cha::LayoutArena arena;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        HeapAllocationCounter counter;
+        {
+            std::vector<int, cha::ArenaAllocator<int>> values{cha::ArenaAllocator<int>(&arena)};
+            for (int i = 0; i < 1000; i++) values.push_back(i);
+            CHA_CHECK_EQUAL(999, values.back());
+        }
+        arena.reset();
+        // The first pass takes a chunk; the second reuses it.
+        if (pass == 1) CHA_CHECK_EQUAL((size_t)0, counter.count());
+    }
+    CHA_CHECK_EQUAL((uint64_t)1, arena.chunkAllocations());
+
+    // Without an arena the allocator is the heap.
+    HeapAllocationCounter counter;
+    std::vector<int, cha::ArenaAllocator<int>> values;
+    values.push_back(1);
+    CHA_CHECK_EQUAL((size_t)1, counter.count());
+}
+
+CHA_TEST(testDescriptorBlocksAreRecycled)
+{
+    cha::DescriptorBlockPool pool;
+    std::vector<CHAConstraintDescriptor> records;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeGrid, 50, records);
+
+    cha::DescriptorList list(pool);
+    list.append(records.data(), records.size());
+    const size_t blocks = (records.size() + cha::kDescriptorBlockCapacity - 1) / cha::kDescriptorBlockCapacity;
+    CHA_CHECK_EQUAL(records.size(), list.count());
+    CHA_CHECK_EQUAL(blocks, pool.blocksInUse());
+
+    size_t index = 0;
+    for (const cha::DescriptorBlock *block = list.firstBlock(); block; block = block->next)
+    {
+        for (uint32_t i = 0; i < block->count; i++, index++) CHA_CHECK(block->records[i].item == records[index].item);
+    }
+    CHA_CHECK_EQUAL(records.size(), index);
+
+    list.clear();
+    CHA_CHECK_EQUAL((size_t)0, pool.blocksInUse());
+
+    HeapAllocationCounter counter;
+    list.append(records.data(), records.size());
+    CHA_CHECK_EQUAL((size_t)0, counter.count());
+    CHA_CHECK_EQUAL(blocks, pool.blocksCreated());
+    CHA_CHECK_EQUAL(blocks, pool.highWaterMark());
+}
+
+CHA_TEST(testLayoutPassMatchesAHeapBackedSystem)
+{
+    cha::DescriptorBlockPool pool;
+    cha::LayoutPass pass(pool, 4096);
+
+    for (cha::test::HierarchyShape shape : kShapes)
+    {
+        std::vector<CHAConstraintDescriptor> records;
+        cha::test::appendHierarchy(shape, 100, records);
+
+        cha::LayoutSystem layout;
+        layout.setContainer(cha::test::fixtureItem(0), 320, 480);
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(records.data(), records.size()));
+        layout.solve();
+
+        // Solve in two halves to exercise appending after a solve.
+        pass.begin(cha::test::fixtureItem(0), 320, 480);
+        pass.append(records.data(), records.size() / 2);
+        pass.solve();
+        pass.append(records.data() + records.size() / 2, records.size() - records.size() / 2);
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, pass.solve());
+        CHA_CHECK_EQUAL(records.size(), pass.descriptorCount());
+
+        for (size_t view = 0; view <= 100; view++)
+        {
+            const cha::Frame expected = layout.frame(cha::test::fixtureItem(view));
+            const cha::Frame actual = pass.frame(cha::test::fixtureItem(view));
+            CHA_CHECK_CLOSE(expected.x, actual.x, 1e-6);
+            CHA_CHECK_CLOSE(expected.y, actual.y, 1e-6);
+            CHA_CHECK_CLOSE(expected.width, actual.width, 1e-6);
+            CHA_CHECK_CLOSE(expected.height, actual.height, 1e-6);
+        }
+    }
+}
+
+CHA_TEST(testSteadyStatePassesDoNotAllocate)
+{
+    cha::DescriptorBlockPool pool;
+    cha::LayoutPass pass(pool);
+
+    for (cha::test::HierarchyShape shape : kShapes)
+    {
+        std::vector<CHAConstraintDescriptor> records;
+        cha::test::appendHierarchy(shape, 200, records);
+
+        size_t allocations[3];
+        for (int round = 0; round < 3; round++)
+        {
+            HeapAllocationCounter counter;
+            pass.begin(cha::test::fixtureItem(0), 375, 667);
+            for (const CHAConstraintDescriptor &record : records) pass.append(record);
+            CHA_CHECK_EQUAL(cha::Solver::StatusOK, pass.solve());
+            cha::test::doNotOptimize(pass.frame(cha::test::fixtureItem(200)));
+            allocations[round] = counter.count();
+        }
+
+        // The first pass at a new size grows the arena and the pool; repeating it allocates nothing.
+        if (shape == kShapes[0]) CHA_CHECK(allocations[0] > 0);
+        CHA_CHECK_EQUAL((size_t)0, allocations[1]);
+        CHA_CHECK_EQUAL((size_t)0, allocations[2]);
+        CHA_CHECK(pass.arena().highWaterMark() > 0);
+        CHA_CHECK(pass.arena().highWaterMark() <= pass.arena().capacity());
+    }
+    CHA_CHECK_EQUAL(pool.blocksCreated(), pool.highWaterMark());
+}
@@ -0,0 +1,475 @@
+//
+//  CHALayoutBenchmarks.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  Run with --benchmarks [--json results.json] [--baseline previous.json --tolerance 0.25].
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHACompiledLayout.h"
+#include "CHAConstraintRecording.h"
+#include "CHAConstraintDiff.h"
+#include "CHAGridLayout.h"
+#include "CHALayoutPass.h"
+#include "CHALayoutSystem.h"
+#include "CHAPartitionedLayout.h"
+#include "CHAPortableBenchmark.h"
+#include "CHAStackLayout.h"
+#include "CHATextMeasurementCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t kHelperCalls = 1000;
+const size_t kMaxSamples = 50;
+const double kBudgetSeconds = 1.0;
+
+const size_t kViewCounts[] = { 10, 100, 1000, 10000 };
+const size_t kStackCounts[] = { 10, 100, 1000 };
+// Long runs of equal lengths cost the general solver tens of seconds a sample beyond this.
+const size_t kGeneralSolverLimit = 100;
+// The arena keeps a pass's peak footprint for the next pass; dense tableaus beyond this hold hundreds of megabytes.
+const size_t kPassCounts[] = { 10, 100, 1000 };
+const size_t kGridCounts[] = { 100, 1000, 10000 };
+const cha::GridKernel kGridKernels[] = { cha::GridKernelScalar, cha::GridKernelSSE2, cha::GridKernelAVX, cha::GridKernelNEON };
+// Text cells in a feed, and the cache budgets tried against them, in entries.
+const size_t kFeedRows = 500;
+const size_t kTextCacheEntries[] = { 0, 16, 128, 1024 };
+// Card feeds split into per-card subtrees; one LayoutSystem holding all of a feed beyond this takes seconds a sample.
+const size_t kPartitionCounts[] = { 1000, 10000, 100000 };
+const size_t kSingleSystemLimit = 10000;
+
+const size_t kAnimationCounts[] = { 1000, 10000, 100000 };
+const size_t kAnimationFrames = 60;
+
+// Card feeds loaded from a compiled layout; parsing a text recording beyond this takes seconds a sample.
+const size_t kLoadCounts[] = { 1000, 10000, 100000 };
+const size_t kTextRecordingLimit = 1000;
+
+const cha::test::HierarchyShape kShapes[] = { cha::test::HierarchyShapeChain, cha::test::HierarchyShapeGrid,
+                                              cha::test::HierarchyShapeNested };
+
+}
+
+// The record-building half of each helper; the UIKit half is measured by the XCTest performance cases.
+
+CHA_BENCHMARK(benchmarkDescriptorHelpers)
+{
+    const void *container = cha::test::fixtureItem(0);
+    std::vector<const void *> views;
+    for (size_t i = 1; i <= kHelperCalls; i++) views.push_back(cha::test::fixtureItem(i));
+    CHADescriptorBatch batch;
+
+    // -pinToSuperviewBoundsInsets:
+    cha::test::measure("descriptors/pinToSuperviewBoundsInsets", kHelperCalls, kMaxSamples, kBudgetSeconds, [&] {
+        for (const void *view : views)
+        {
+            CHADescriptorBatchReset(&batch);
+            CHADescriptorBatchAppendInsets(&batch, view, container, 8, 16, 8, 16);
+            cha::test::doNotOptimize(batch);
+        }
+    });
+
+    // -pinSides:constant:
+    cha::test::measure("descriptors/pinSides", kHelperCalls, kMaxSamples, kBudgetSeconds, [&] {
+        for (const void *view : views)
+        {
+            CHADescriptorBatchReset(&batch);
+            CHADescriptorBatchAppendEdges(&batch, view, container, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeTop, 10);
+            cha::test::doNotOptimize(batch);
+        }
+    });
+
+    // -equalWidths:referenceView:multiplier:, in batches of the descriptor capacity
+    cha::test::measure("descriptors/equalWidths", kHelperCalls, kMaxSamples, kBudgetSeconds, [&] {
+        CHADescriptorBatchReset(&batch);
+        for (const void *view : views)
+        {
+            if (batch.count == CHA_DESCRIPTOR_BATCH_CAPACITY) CHADescriptorBatchReset(&batch);
+            CHADescriptorBatchAppend(&batch, view, CHALayoutAttributeWidth, CHALayoutRelationEqual, container,
+                                     CHALayoutAttributeWidth, 0.5, 0);
+        }
+        cha::test::doNotOptimize(batch);
+    });
+
+    // -stackAboveView:superviewMargin:interViewSpacing:
+    cha::test::measure("descriptors/stackAboveView", kHelperCalls, kMaxSamples, kBudgetSeconds, [&] {
+        for (size_t i = 1; i < views.size(); i++)
+        {
+            CHADescriptorBatchReset(&batch);
+            CHADescriptorBatchAppendEdges(&batch, views[i - 1], container, CHAEdgeTop, 8);
+            CHADescriptorBatchAppend(&batch, views[i - 1], CHALayoutAttributeBottom, CHALayoutRelationEqual, views[i],
+                                     CHALayoutAttributeTop, 1, -4);
+            CHADescriptorBatchAppendEdges(&batch, views[i], container, CHAEdgeBottom, 8);
+            cha::test::doNotOptimize(batch);
+        }
+    });
+}
+
+CHA_BENCHMARK(benchmarkSolveGeneratedHierarchies)
+{
+    for (cha::test::HierarchyShape shape : kShapes)
+    {
+        for (size_t viewCount : kViewCounts)
+        {
+            std::vector<CHAConstraintDescriptor> descriptors;
+            cha::test::appendHierarchy(shape, viewCount, descriptors);
+
+            const std::string name = std::string("solve/") + cha::test::nameForShape(shape) + "/" + std::to_string(viewCount);
+            cha::test::measure(name, viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                cha::LayoutSystem layout;
+                layout.setContainer(cha::test::fixtureItem(0), 320, 480);
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+                layout.solve();
+                cha::test::doNotOptimize(layout.frame(cha::test::fixtureItem(viewCount)));
+            });
+        }
+    }
+}
+
+// The same hierarchies re-solved on one reused layout pass, which allocates nothing from the heap after the first sample.
+
+CHA_BENCHMARK(benchmarkSolveOnReusedPass)
+{
+    for (cha::test::HierarchyShape shape : kShapes)
+    {
+        for (size_t viewCount : kPassCounts)
+        {
+            cha::LayoutPass pass;
+            std::vector<CHAConstraintDescriptor> descriptors;
+            cha::test::appendHierarchy(shape, viewCount, descriptors);
+
+            const std::string name = std::string("pass/") + cha::test::nameForShape(shape) + "/" + std::to_string(viewCount);
+            cha::test::measure(name, viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                pass.begin(cha::test::fixtureItem(0), 320, 480);
+                pass.append(descriptors.data(), descriptors.size());
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, pass.solve());
+                cha::test::doNotOptimize(pass.frame(cha::test::fixtureItem(viewCount)));
+            });
+            std::printf("%s: arena high-water mark %zu KB\n", name.c_str(), pass.arena().highWaterMark() / 1024);
+        }
+    }
+}
+
+// A vertical form of equal rows, through the general solver and through the stack fast path.
+
+CHA_BENCHMARK(benchmarkSolveStacks)
+{
+    const cha::StackSpec spec = { CHAStackAxisVertical, CHAStackDistributionFillEqually, 8, 20, 16, 20, 16 };
+
+    for (size_t viewCount : kStackCounts)
+    {
+        std::vector<const void *> items;
+        for (size_t i = 1; i <= viewCount; i++) items.push_back(cha::test::fixtureItem(i));
+        std::vector<CHAConstraintDescriptor> descriptors;
+        cha::appendStackDescriptors(spec, cha::test::fixtureItem(0), items.data(), nullptr, items.size(), descriptors);
+        const double height = 20.0 * (double)viewCount;
+
+        if (viewCount <= kGeneralSolverLimit)
+        {
+            cha::test::measure("stack/general/" + std::to_string(viewCount), viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                cha::LayoutSystem layout;
+                layout.setContainer(cha::test::fixtureItem(0), 320, height);
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+                layout.solve();
+                cha::test::doNotOptimize(layout.frame(items.back()));
+            });
+        }
+
+        cha::test::measure("stack/chain/" + std::to_string(viewCount), viewCount, kMaxSamples, kBudgetSeconds, [&] {
+            cha::StackLayout stack;
+            std::vector<cha::Frame> frames;
+            CHA_CHECK(cha::recognizeStack(descriptors.data(), descriptors.size(), cha::test::fixtureItem(0), stack));
+            CHA_CHECK(cha::solveStack(stack, 320, height, frames));
+            cha::test::doNotOptimize(frames.back());
+        });
+    }
+}
+
+// A four-column photo grid, as the equal-width constraint set through the general solver and in closed form.
+
+CHA_BENCHMARK(benchmarkSolveGrids)
+{
+    CHAGridSpec spec = {};
+    spec.columns = 4;
+    spec.rowSpacing = 2;
+    spec.columnSpacing = 2;
+    spec.rowHeight = 92;
+
+    for (size_t viewCount : kGridCounts)
+    {
+        std::vector<const void *> items;
+        for (size_t i = 1; i <= viewCount; i++) items.push_back(cha::test::fixtureItem(i));
+
+        if (viewCount <= kGeneralSolverLimit)
+        {
+            std::vector<CHAConstraintDescriptor> descriptors;
+            cha::appendGridDescriptors(spec, cha::test::fixtureItem(0), items.data(), items.size(), descriptors);
+            cha::test::measure("grid/general/" + std::to_string(viewCount), viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                cha::LayoutSystem layout;
+                layout.setContainer(cha::test::fixtureItem(0), 375, -1);
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+                layout.solve();
+                cha::test::doNotOptimize(layout.frame(items.back()));
+            });
+        }
+
+        for (cha::GridKernel kernel : kGridKernels)
+        {
+            if (!cha::isGridKernelAvailable(kernel)) continue;
+            cha::FrameBuffer frames;
+            const std::string name = std::string("grid/") + cha::nameForGridKernel(kernel) + "/" + std::to_string(viewCount);
+            cha::test::measure(name, viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                CHA_CHECK(cha::layoutGrid(spec, 375, -1, viewCount, frames, kernel));
+                cha::test::doNotOptimize(frames.y.back());
+            });
+        }
+    }
+}
+
+// Rebuilding a hierarchy's constraints with every tenth constant changed.
+
+CHA_BENCHMARK(benchmarkDiffConstraints)
+{
+    for (size_t viewCount : kViewCounts)
+    {
+        std::vector<CHAConstraintDescriptor> before;
+        cha::test::appendHierarchy(cha::test::HierarchyShapeGrid, viewCount, before);
+        std::vector<CHAConstraintDescriptor> after(before.rbegin(), before.rend());
+        for (size_t i = 0; i < after.size(); i += 10) after[i].constant += 1;
+
+        cha::ConstraintDiff diff;
+        cha::test::measure("diff/" + std::to_string(viewCount), before.size(), kMaxSamples, kBudgetSeconds, [&] {
+            cha::diffConstraints(before.data(), before.size(), after.data(), after.size(), diff);
+            cha::test::doNotOptimize(diff.matches.size());
+        });
+        CHA_CHECK_EQUAL(before.size(), diff.matches.size());
+    }
+}
+
+// Scrolling a feed of text cells down and back up at two widths. Each visible cell is asked for its height three times per
+// frame, as the engine does for intrinsic sizes, so a cache large enough for the visible window absorbs most of the
+// measuring. Budget 0 measures every time.
+
+CHA_BENCHMARK(benchmarkTextMeasurementCache)
+{
+    std::vector<std::string> paragraphs;
+    cha::test::appendParagraphs(kFeedRows, paragraphs);
+    const size_t visibleRows = 12, lookupsPerRow = 3;
+    const double widths[] = { 343, 647 };
+
+    std::vector<size_t> rows;
+    for (size_t top = 0; top + visibleRows <= kFeedRows; top += 2) rows.push_back(top);
+    for (size_t top = kFeedRows - visibleRows; top > 0; top -= 4) rows.push_back(top);
+    const size_t lookups = rows.size() * visibleRows * lookupsPerRow * 2;
+
+    for (size_t entries : kTextCacheEntries)
+    {
+        cha::TextMeasurementCache cache(entries * cha::TextMeasurementCache::kEntryFootprint,
+                                        [](const cha::TextMeasurementKey &key, const void *context) {
+                                            return cha::test::fakeMeasureText(*static_cast<const std::string *>(context),
+                                                                              15, key.width, key.lineLimit);
+                                        });
+
+        const std::string name = "textcache/" + std::to_string(entries);
+        cha::test::measure(name, lookups, kMaxSamples, kBudgetSeconds, [&] {
+            cache.clear();
+            for (double width : widths)
+            {
+                for (size_t top : rows)
+                {
+                    for (size_t row = top; row < top + visibleRows; row++)
+                    {
+                        const std::string &text = paragraphs[row];
+                        const cha::TextMeasurementKey key = {cha::hashBytes(text.data(), text.size()), 1, width, 0};
+                        for (size_t lookup = 0; lookup < lookupsPerRow; lookup++)
+                        {
+                            cha::test::doNotOptimize(cache.measure(key, &text));
+                        }
+                    }
+                }
+            }
+        });
+        std::printf("%s: hit rate %.3f, %llu evictions, %zu KB\n", name.c_str(), cache.hitRate(),
+                    (unsigned long long)cache.evictionCount(), cache.bytesInUse() / 1024);
+    }
+}
+
+// A feed of header-like cards, solved as one system and then split into per-card subtrees on 1 to N workers. The split
+// itself is timed separately, since it only reruns when the records change.
+
+CHA_BENCHMARK(benchmarkPartitionedSolve)
+{
+    const cha::test::HierarchyShape shape = cha::test::HierarchyShapeCards;
+    const cha::ParentFunction parentOf = [shape](const void *item) { return cha::test::fixtureParentItem(shape, item); };
+    const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(hardwareThreads);
+
+    for (size_t viewCount : kPartitionCounts)
+    {
+        std::vector<CHAConstraintDescriptor> descriptors;
+        cha::test::appendHierarchy(shape, viewCount, descriptors);
+        const std::string prefix = "partition/" + std::to_string(viewCount);
+
+        if (viewCount <= kSingleSystemLimit)
+        {
+            cha::test::measure(prefix + "/single", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                cha::LayoutSystem layout;
+                layout.setContainer(cha::test::fixtureItem(0), 320, 1e7);
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptors(descriptors.data(), descriptors.size()));
+                layout.solve();
+                cha::test::doNotOptimize(layout.frame(cha::test::fixtureItem(viewCount)));
+            });
+        }
+
+        cha::PartitionedLayout split;
+        split.setContainer(cha::test::fixtureItem(0), 320, 1e7);
+        cha::test::measure(prefix + "/split", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+            split.setDescriptors(descriptors.data(), descriptors.size(), parentOf);
+        });
+        std::printf("%s: %zu parts, %zu components, largest %zu records\n", prefix.c_str(), split.stats().partCount,
+                    split.stats().componentCount, split.stats().largestComponentRecords);
+
+        double oneThread = 0;
+        for (size_t threads : threadCounts)
+        {
+            cha::WorkerPool workers(threads);
+            cha::PartitionedLayout layout(&workers);
+            layout.setContainer(cha::test::fixtureItem(0), 320, 1e7);
+            layout.setDescriptors(descriptors.data(), descriptors.size(), parentOf);
+
+            const std::string name = prefix + "/threads/" + std::to_string(threads);
+            const cha::test::BenchmarkResult &result = cha::test::measure(name, viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.solve());
+                cha::test::doNotOptimize(layout.frame(cha::test::fixtureItem(viewCount)));
+            });
+            if (threads == 1) oneThread = result.p50;
+            std::printf("%s: %.2fx one worker, %llu steals\n", name.c_str(), oneThread / result.p50,
+                        (unsigned long long)workers.stealCount());
+        }
+    }
+}
+
+// One card's picture inset and biography spacing animated for a second at 60fps in a feed held as one system: first by
+// changing the two records' constants in place and reading the two frames back, then by removing and re-adding the records
+// and solving, as recreating the NSLayoutConstraints would. Only the second should grow with the feed.
+
+CHA_BENCHMARK(benchmarkAnimateConstants)
+{
+    double smallest = 0, largest = 0;
+    for (size_t viewCount : kAnimationCounts)
+    {
+        std::vector<CHAConstraintDescriptor> descriptors;
+        cha::test::appendHierarchy(cha::test::HierarchyShapeCards, viewCount, descriptors);
+
+        cha::LayoutSystem layout;
+        layout.setContainer(cha::test::fixtureItem(0), 320, 1e7);
+        std::vector<cha::Solver::Constraint> constraints(descriptors.size());
+        for (size_t i = 0; i < descriptors.size(); i++) layout.addDescriptor(descriptors[i], &constraints[i]);
+        layout.solve();
+
+        const size_t card = viewCount / 10;
+        const void *picture = cha::test::fixtureItem(card * 5 + 2), *biography = cha::test::fixtureItem(card * 5 + 5);
+        size_t animated[2] = {0, 0};
+        for (size_t i = 0; i < descriptors.size(); i++)
+        {
+            if (descriptors[i].item == picture && descriptors[i].attribute == CHALayoutAttributeLeading) animated[0] = i;
+            if (descriptors[i].item == biography && descriptors[i].attribute == CHALayoutAttributeTop) animated[1] = i;
+        }
+        cha::Solver::Constraint handles[2] = {constraints[animated[0]], constraints[animated[1]]};
+        const double initial[2] = {descriptors[animated[0]].constant, descriptors[animated[1]].constant};
+        const std::string prefix = "animate/" + std::to_string(viewCount);
+
+        size_t frame = 0;
+        const double editFrame = cha::test::measure(prefix + "/edit", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+            for (size_t i = 0; i < kAnimationFrames; i++, frame++)
+            {
+                const double offset = (double)(frame % 30);
+                const double constants[2] = {initial[0] + offset, initial[1] + offset};
+                CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.setConstants(handles, constants, 2));
+                cha::test::doNotOptimize(layout.currentFrame(picture));
+                cha::test::doNotOptimize(layout.currentFrame(biography));
+            }
+        }).p50 / kAnimationFrames;
+
+        const double readdFrame = cha::test::measure(prefix + "/readd", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+            for (size_t i = 0; i < kAnimationFrames; i++, frame++)
+            {
+                const double offset = (double)(frame % 30);
+                for (size_t record = 0; record < 2; record++)
+                {
+                    CHAConstraintDescriptor descriptor = descriptors[animated[record]];
+                    descriptor.constant = initial[record] + offset;
+                    layout.removeConstraint(handles[record]);
+                    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addDescriptor(descriptor, &handles[record]));
+                }
+                layout.solve();
+                cha::test::doNotOptimize(layout.frame(picture));
+                cha::test::doNotOptimize(layout.frame(biography));
+            }
+        }).p50 / kAnimationFrames;
+
+        std::printf("%s: %.2f us per frame edited, %.2f us re-added\n", prefix.c_str(), editFrame / 1e3, readdFrame / 1e3);
+        if (smallest == 0) smallest = editFrame;
+        largest = editFrame;
+    }
+    std::printf("animate: edits cost %.2fx per frame at %zu views as at %zu\n", largest / smallest,
+                kAnimationCounts[sizeof(kAnimationCounts) / sizeof(kAnimationCounts[0]) - 1], kAnimationCounts[0]);
+}
+
+CHA_BENCHMARK(benchmarkLoadCompiledLayout)
+{
+    for (size_t viewCount : kLoadCounts)
+    {
+        cha::ConstraintRecording recording;
+        recording.width = 320;
+        recording.height = -1;
+        for (size_t i = 0; i <= viewCount; i++) recording.itemNames.push_back("view" + std::to_string(i));
+        cha::test::appendHierarchy(cha::test::HierarchyShapeCards, viewCount, recording.records);
+        recording.origins.resize(recording.records.size());
+
+        cha::CompiledLayoutWriter writer((uint32_t)viewCount + 1);
+        for (size_t i = 0; i <= viewCount; i++) writer.setSlotName((uint32_t)i, recording.itemNames[i]);
+        for (const CHAConstraintDescriptor &record : recording.records) writer.addDescriptor(record);
+        std::vector<uint8_t> bytes;
+        writer.write(bytes);
+
+        std::vector<const void *> items;
+        for (size_t i = 0; i <= viewCount; i++) items.push_back(cha::test::fixtureItem(i));
+        std::vector<CHAConstraintDescriptor> descriptors(recording.records.size());
+        const std::string prefix = "load/" + std::to_string(viewCount);
+
+        const double compiled = cha::test::measure(prefix + "/compiled", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+            cha::CompiledLayout layout;
+            CHA_CHECK_EQUAL(cha::CompiledLayoutStatusOK, layout.open(bytes.data(), bytes.size()));
+            layout.instantiate(items.data(), descriptors.data());
+            cha::test::doNotOptimize(descriptors.data());
+        }).p50;
+
+        std::printf("%s: %zu records in %.1f us from %zu bytes compiled\n", prefix.c_str(), descriptors.size(),
+                    compiled / 1e3, bytes.size());
+
+        if (viewCount <= kTextRecordingLimit)
+        {
+            const std::string text = cha::writeConstraintRecording(recording);
+            const double parsed = cha::test::measure(prefix + "/text", viewCount, kMaxSamples, kBudgetSeconds, [&] {
+                cha::ConstraintRecording loaded;
+                CHA_CHECK(cha::parseConstraintRecording(text, loaded, nullptr));
+                cha::test::doNotOptimize(loaded.records.data());
+            }).p50;
+            std::printf("%s: %.1f us from %zu bytes of text, %.1fx the compiled load\n", prefix.c_str(), parsed / 1e3,
+                        text.size(), parsed / compiled);
+        }
+    }
+}
@@ -0,0 +1,204 @@
+//
+//  CHALayoutDSLTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHALayoutDSL.h"
+#include "CHALayoutSystem.h"
+
+#include <vector>
+
+namespace {
+
+using namespace cha::dsl;
+using cha::test::fixtureItem;
+
+// The card of CHAHeaderView: a picture beside a details view holding a name above a biography.
+constexpr View<1> card;
+constexpr View<2, 1> picture;
+constexpr View<3, 1> details;
+constexpr View<4, 3> name;
+constexpr View<5, 3> biography;
+
+constexpr auto kCard =
+    layout(pinEdges<CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing>(card), height(card, 120),
+           pinEdges<CHAEdgeTop | CHAEdgeLeading | CHAEdgeBottom>(picture, 8), aspectRatio<1, 1>(picture),
+           pin<CHALayoutAttributeLeading, CHALayoutAttributeTrailing>(details, picture, 8),
+           pinEdges<CHAEdgeTop | CHAEdgeTrailing | CHAEdgeBottom>(details, 8),
+           stackViews<CHAStackAxisVertical, CHAStackDistributionLeading>(details, views(name, biography), 4),
+           height(name, 20), height(biography, 40));
+
+static_assert(canRelateAttributes(CHALayoutAttributeLeading, CHALayoutAttributeTrailing), "");
+static_assert(canRelateAttributes(CHALayoutAttributeTop, CHALayoutAttributeCenterY), "");
+static_assert(canRelateAttributes(CHALayoutAttributeHeight, CHALayoutAttributeWidth), "");
+static_assert(!canRelateAttributes(CHALayoutAttributeWidth, CHALayoutAttributeLeading), "");
+static_assert(!canRelateAttributes(CHALayoutAttributeLeft, CHALayoutAttributeLeading), "");
+static_assert(!canRelateAttributes(CHALayoutAttributeTop, CHALayoutAttributeCenterX), "");
+
+static_assert(insetConstant(CHALayoutAttributeTop, 8) == 8 && insetConstant(CHALayoutAttributeLeading, 8) == 8, "");
+static_assert(insetConstant(CHALayoutAttributeBottom, 8) == -8 && insetConstant(CHALayoutAttributeTrailing, 8) == -8, "");
+static_assert(insetConstant(CHALayoutAttributeRight, 8) == -8, "");
+
+static_assert(decltype(pinEdges<CHAEdgeAll>(card))::count() == 4, "");
+static_assert(decltype(equalWidths(picture, views(picture, details, name)))::count() == 2, "");
+static_assert(decltype(equalWidths(card, views(picture, details, name)))::count() == 3, "");
+static_assert(decltype(stackAboveView(picture, details))::count() == 7, "");
+static_assert(stackRecordCount(CHAStackDistributionLeading, 3) == 3 + 6, "");
+static_assert(stackRecordCount(CHAStackDistributionFill, 3) == 4 + 6, "");
+static_assert(stackRecordCount(CHAStackDistributionFillEqually, 3) == 4 + 2 + 6, "");
+
+// The whole card is settled at compile time: its size, the items it needs and the values of its records.
+static_assert(kCard.count() == 3 + 1 + 3 + 1 + 1 + 3 + 6 + 2, "");
+static_assert(sizeof(kCard) == kCard.count() * sizeof(cha::CompiledRecord), "");
+static_assert(kCard.slotCount() == 6, "");
+static_assert(kCard[5].item == 2 && kCard[5].attribute == CHALayoutAttributeBottom && kCard[5].constant == -8, "");
+static_assert(kCard[8].toItem == 2 && kCard[8].toAttribute == CHALayoutAttributeTrailing && kCard[8].constant == 8, "");
+static_assert(kCard[3].toItem == cha::CompiledRecordNoSlot, "");
+
+std::vector<const void *> makeItems(uint32_t count)
+{
+    std::vector<const void *> items;
+    for (uint32_t index = 0; index < count; index++) items.push_back(fixtureItem(index));
+    return items;
+}
+
+template <size_t Count>
+std::vector<CHAConstraintDescriptor> instantiate(const Constraints<Count> &constraints)
+{
+    const std::vector<const void *> items = makeItems(constraints.slotCount());
+    std::vector<CHAConstraintDescriptor> descriptors(constraints.count());
+    constraints.instantiate(items.data(), descriptors.data());
+    return descriptors;
+}
+
+size_t countMismatches(const CHAConstraintDescriptor *expected, const std::vector<CHAConstraintDescriptor> &actual)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < actual.size(); i++)
+    {
+        if (actual[i].item != expected[i].item || actual[i].toItem != expected[i].toItem ||
+            actual[i].multiplier != expected[i].multiplier || actual[i].constant != expected[i].constant ||
+            actual[i].priority != expected[i].priority || actual[i].attribute != expected[i].attribute ||
+            actual[i].toAttribute != expected[i].toAttribute || actual[i].relation != expected[i].relation)
+        {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+}
+
+CHA_TEST(testLayoutDSLEdgesMatchDescriptorBatches)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(2), fixtureItem(1), CHAEdgeAll, 12);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(1), fixtureItem(0),
+                                  CHAEdgeTop | CHAEdgeBottom | CHAEdgeLeft | CHAEdgeRight, 4);
+    const std::vector<CHAConstraintDescriptor> edges =
+        instantiate(layout(pinEdges<CHAEdgeAll>(picture, 12), pinToSuperviewBounds(card, 4)));
+    CHA_CHECK_EQUAL(batch.count, edges.size());
+    CHA_CHECK_EQUAL((size_t)0, countMismatches(batch.records, edges));
+
+    // stackAboveView: pins each view to its superview on three sides, then the two views to each other.
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(2), fixtureItem(1), CHAEdgeTop | CHAEdgeLeading | CHAEdgeTrailing,
+                                  8);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(3), fixtureItem(1),
+                                  CHAEdgeBottom | CHAEdgeLeading | CHAEdgeTrailing, 8);
+    CHADescriptorBatchAppend(&batch, fixtureItem(2), CHALayoutAttributeBottom, CHALayoutRelationEqual, fixtureItem(3),
+                             CHALayoutAttributeTop, 1, 6);
+    const std::vector<CHAConstraintDescriptor> stacked = instantiate(stackAboveView(picture, details, 8, 6));
+    CHA_CHECK_EQUAL(batch.count, stacked.size());
+    CHA_CHECK_EQUAL((size_t)0, countMismatches(batch.records, stacked));
+}
+
+CHA_TEST(testLayoutDSLStacksMatchStackDescriptors)
+{
+    constexpr View<1> stack;
+    constexpr View<2, 1> first;
+    constexpr View<3, 1> second;
+    constexpr View<4, 1> third;
+    constexpr Insets margins = {20, 16, 10, 12};
+    constexpr auto row = views(first, second, third);
+    const std::vector<const void *> items = makeItems(5);
+    const std::vector<std::vector<CHAConstraintDescriptor>> expressions = {
+        instantiate(stackViews<CHAStackAxisVertical, CHAStackDistributionLeading>(stack, row, 8, margins)),
+        instantiate(stackViews<CHAStackAxisVertical, CHAStackDistributionFill>(stack, row, 8, margins)),
+        instantiate(stackViews<CHAStackAxisVertical, CHAStackDistributionFillEqually>(stack, row, 8, margins)),
+        instantiate(stackViews<CHAStackAxisHorizontal, CHAStackDistributionLeading>(stack, row, 8, margins)),
+        instantiate(stackViews<CHAStackAxisHorizontal, CHAStackDistributionFill>(stack, row, 8, margins)),
+        instantiate(stackViews<CHAStackAxisHorizontal, CHAStackDistributionFillEqually>(stack, row, 8, margins))};
+    const CHAStackDistribution distributions[] = {CHAStackDistributionLeading, CHAStackDistributionFill,
+                                                  CHAStackDistributionFillEqually};
+
+    for (size_t index = 0; index < expressions.size(); index++)
+    {
+        const cha::StackSpec spec = {index < 3 ? CHAStackAxisVertical : CHAStackAxisHorizontal, distributions[index % 3], 8,
+                                     margins.top, margins.leading, margins.bottom, margins.trailing};
+        std::vector<CHAConstraintDescriptor> expected;
+        cha::appendStackDescriptors(spec, items[1], items.data() + 2, nullptr, 3, expected);
+        CHA_CHECK_EQUAL(expected.size(), expressions[index].size());
+        CHA_CHECK_EQUAL((size_t)0, countMismatches(expected.data(), expressions[index]));
+    }
+}
+
+CHA_TEST(testLayoutDSLHelpersProduceTheirRecords)
+{
+    constexpr auto aligned = alignCenterVertical(views(picture, details), card);
+    CHA_CHECK_EQUAL((size_t)2, aligned.count());
+    CHA_CHECK_EQUAL((uint32_t)3, aligned[1].item);
+    CHA_CHECK_EQUAL((uint32_t)1, aligned[1].toItem);
+    CHA_CHECK_EQUAL((uint8_t)CHALayoutAttributeCenterY, (uint8_t)aligned[1].toAttribute);
+
+    // The reference is skipped wherever it appears in the list.
+    constexpr auto widths = equalWidths(details, views(picture, details, name), 0.5);
+    CHA_CHECK_EQUAL((size_t)2, widths.count());
+    CHA_CHECK_EQUAL((uint32_t)2, widths[0].item);
+    CHA_CHECK_EQUAL((uint32_t)4, widths[1].item);
+    CHA_CHECK_EQUAL(0.5, widths[1].multiplier);
+    CHA_CHECK_EQUAL((uint32_t)3, widths[1].toItem);
+
+    constexpr auto ratio = aspectRatio<16, 9>(picture);
+    CHA_CHECK_EQUAL((uint8_t)CHALayoutAttributeHeight, (uint8_t)ratio[0].attribute);
+    CHA_CHECK_EQUAL((uint8_t)CHALayoutAttributeWidth, (uint8_t)ratio[0].toAttribute);
+    CHA_CHECK_CLOSE(9.0 / 16.0, ratio[0].multiplier, 1e-12);
+
+    constexpr auto optional = withPriority(pinLeadingTrailing(name, 10), 250);
+    CHA_CHECK_EQUAL(250.f, optional[0].priority);
+    CHA_CHECK_EQUAL(250.f, optional[1].priority);
+    CHA_CHECK_EQUAL(10.0, optional[0].constant);
+    CHA_CHECK_EQUAL(-10.0, optional[1].constant);
+
+    constexpr auto bounded = width<CHALayoutRelationLessThanOrEqual>(name, 200) + pinToBottomSuperview(biography, 6);
+    CHA_CHECK_EQUAL((int8_t)CHALayoutRelationLessThanOrEqual, (int8_t)bounded[0].relation);
+    CHA_CHECK_EQUAL(cha::CompiledRecordNoSlot, bounded[0].toItem);
+    CHA_CHECK_EQUAL(-6.0, bounded[1].constant);
+    CHA_CHECK_EQUAL((uint32_t)3, bounded[1].toItem);
+}
+
+CHA_TEST(testLayoutDSLCardSolves)
+{
+    const std::vector<const void *> items = makeItems(kCard.slotCount());
+    CHAConstraintDescriptor descriptors[kCard.count()];
+    kCard.instantiate(items.data(), descriptors);
+
+    cha::LayoutSystem system;
+    system.setContainer(items[0], 320, 480);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, system.addDescriptors(descriptors, kCard.count()));
+    system.solve();
+
+    CHA_CHECK_CLOSE(104, system.frame(items[2]).width, 1e-6);
+    CHA_CHECK_CLOSE(104, system.frame(items[2]).height, 1e-6);
+    CHA_CHECK_CLOSE(120, system.frame(items[3]).x, 1e-6);
+    CHA_CHECK_CLOSE(192, system.frame(items[3]).width, 1e-6);
+    CHA_CHECK_CLOSE(120, system.frame(items[4]).x, 1e-6);
+    CHA_CHECK_CLOSE(192, system.frame(items[4]).width, 1e-6);
+    CHA_CHECK_CLOSE(32, system.frame(items[5]).y, 1e-6);
+    CHA_CHECK_CLOSE(40, system.frame(items[5]).height, 1e-6);
+}
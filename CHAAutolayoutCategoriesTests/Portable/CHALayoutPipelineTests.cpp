@@ -0,0 +1,153 @@
+//
+//  CHALayoutPipelineTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHALayoutPipeline.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+typedef cha::LayoutTemplate Template;
+
+// A self-sizing cell: a title and a body stacked vertically with 10pt margins.
+std::shared_ptr<const Template> makeCellTemplate(uint64_t identifier)
+{
+    std::shared_ptr<Template> cell = std::make_shared<Template>(identifier, 3);
+    const void *container = Template::slotHandle(0), *title = Template::slotHandle(1), *body = Template::slotHandle(2);
+
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, title, container, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeTop, 10);
+    CHADescriptorBatchAppendEdges(&batch, body, container, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeBottom, 10);
+    CHADescriptorBatchAppend(&batch, body, CHALayoutAttributeTop, CHALayoutRelationEqual, title, CHALayoutAttributeBottom, 1, 8);
+    cell->addBatch(batch);
+    return cell;
+}
+
+cha::LayoutRequest cellRequest(double width, double titleHeight, double bodyHeight)
+{
+    cha::LayoutRequest request = {width, -1, (uint64_t)titleHeight * 100003 + (uint64_t)bodyHeight, {}};
+    request.contentSizes.push_back(cha::ContentSize{1, 0, titleHeight});
+    request.contentSizes.push_back(cha::ContentSize{2, 0, bodyHeight});
+    return request;
+}
+
+}
+
+CHA_TEST(testTemplateSolvesFreeHeightFromContent)
+{
+    std::vector<cha::Frame> frames;
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, makeCellTemplate(1)->solve(cellRequest(320, 20, 60), frames));
+
+    CHA_CHECK_EQUAL(3u, frames.size());
+    CHA_CHECK_CLOSE(320, frames[0].width, 1e-6);
+    CHA_CHECK_CLOSE(10 + 20 + 8 + 60 + 10, frames[0].height, 1e-6);
+    CHA_CHECK_CLOSE(300, frames[1].width, 1e-6);
+    CHA_CHECK_CLOSE(38, frames[2].y, 1e-6);
+    CHA_CHECK_CLOSE(60, frames[2].height, 1e-6);
+}
+
+CHA_TEST(testPipelineCacheHitSkipsSolve)
+{
+    cha::LayoutPipeline pipeline(16, 2);
+    std::shared_ptr<const Template> cell = makeCellTemplate(1);
+    cha::LayoutRequest request = cellRequest(320, 20, 40);
+
+    CHA_CHECK(!pipeline.framesFor(*cell, request));
+    CHA_CHECK(pipeline.enqueue(cell, request));
+    pipeline.waitUntilIdle();
+
+    CHA_CHECK(!pipeline.enqueue(cell, request));
+    cha::FrameCache::Frames frames = pipeline.framesFor(*cell, request);
+    CHA_CHECK(frames != nullptr);
+    CHA_CHECK(frames == pipeline.solveSynchronously(*cell, request));
+    CHA_CHECK_EQUAL(1u, pipeline.solveCount());
+}
+
+CHA_TEST(testPipelineKeysOnHeightAndSkipsRejectedSolves)
+{
+    cha::LayoutPipeline pipeline(16, 1);
+    std::shared_ptr<const Template> cell = makeCellTemplate(3);
+    cha::LayoutRequest free = cellRequest(320, 20, 40);
+    cha::LayoutRequest fixed = free;
+    fixed.height = 200;
+
+    cha::FrameCache::Frames freeFrames = pipeline.solveSynchronously(*cell, free);
+    cha::FrameCache::Frames fixedFrames = pipeline.solveSynchronously(*cell, fixed);
+    CHA_CHECK(freeFrames != fixedFrames);
+    CHA_CHECK_CLOSE(10 + 20 + 8 + 40 + 10, (*freeFrames)[0].height, 1e-6);
+    CHA_CHECK_CLOSE(200, (*fixedFrames)[0].height, 1e-6);
+    CHA_CHECK_EQUAL(2u, pipeline.cache().size());
+
+    // Two required heights for the title: the solve is rejected, so nothing is cached for it.
+    std::shared_ptr<Template> conflicting = std::make_shared<Template>(4, 2);
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    for (double height : {20.0, 30.0})
+    {
+        CHADescriptorBatchAppend(&batch, Template::slotHandle(1), CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                                 CHALayoutAttributeNotAnAttribute, 1, height);
+    }
+    conflicting->addBatch(batch);
+    cha::LayoutRequest request = {320, 480, 0, {}};
+    CHA_CHECK(pipeline.solveSynchronously(*conflicting, request) != nullptr);
+    CHA_CHECK(!pipeline.framesFor(*conflicting, request));
+    pipeline.solveSynchronously(*conflicting, request);
+    CHA_CHECK_EQUAL(4u, pipeline.solveCount());
+}
+
+CHA_TEST(testPipelineConcurrentSolvesMatchSequential)
+{
+    cha::LayoutPipeline pipeline(1024, 4);
+    std::shared_ptr<const Template> cell = makeCellTemplate(7);
+
+    std::vector<cha::LayoutRequest> requests;
+    for (int i = 0; i < 200; i++) requests.push_back(cellRequest(280 + (i % 5) * 40, 10 + i % 13, 20 + i));
+
+    for (const cha::LayoutRequest &request : requests) pipeline.enqueue(cell, request);
+    // Duplicates while solves are in flight must not be scheduled twice.
+    for (const cha::LayoutRequest &request : requests) pipeline.enqueue(cell, request);
+    pipeline.waitUntilIdle();
+
+    CHA_CHECK_EQUAL(requests.size(), pipeline.solveCount());
+    for (const cha::LayoutRequest &request : requests)
+    {
+        std::vector<cha::Frame> expected;
+        cell->solve(request, expected);
+        cha::FrameCache::Frames frames = pipeline.framesFor(*cell, request);
+        CHA_CHECK(frames != nullptr);
+        if (!frames) continue;
+
+        for (size_t slot = 0; slot < expected.size(); slot++)
+        {
+            CHA_CHECK_CLOSE(expected[slot].y, (*frames)[slot].y, 1e-9);
+            CHA_CHECK_CLOSE(expected[slot].width, (*frames)[slot].width, 1e-9);
+            CHA_CHECK_CLOSE(expected[slot].height, (*frames)[slot].height, 1e-9);
+        }
+    }
+}
+
+CHA_TEST(testFrameCacheEvictsLeastRecentlyUsed)
+{
+    cha::FrameCache cache(2);
+    cha::FrameCache::Frames frames = std::make_shared<const std::vector<cha::Frame>>();
+    cha::FrameCacheKey a = {1, 320, -1, 1}, b = {1, 320, -1, 2}, c = {1, 375, -1, 1};
+
+    cache.insert(a, frames);
+    cache.insert(b, frames);
+    CHA_CHECK(cache.find(a) != nullptr);
+    cache.insert(c, frames);
+
+    CHA_CHECK_EQUAL(2u, cache.size());
+    CHA_CHECK(cache.find(a) != nullptr);
+    CHA_CHECK(cache.find(b) == nullptr);
+    CHA_CHECK(cache.find(c) != nullptr);
+    CHA_CHECK_EQUAL(3u, cache.hitCount());
+    CHA_CHECK_EQUAL(1u, cache.missCount());
+}
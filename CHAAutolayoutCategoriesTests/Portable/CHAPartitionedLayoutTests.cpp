@@ -0,0 +1,170 @@
+//
+//  CHAPartitionedLayoutTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHAPartitionedLayout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using cha::test::fixtureItem;
+
+const double kWidth = 320;
+const double kHeight = 100000;
+
+cha::ParentFunction parentsFor(cha::test::HierarchyShape shape)
+{
+    return [shape](const void *item) { return cha::test::fixtureParentItem(shape, item); };
+}
+
+// The largest difference between the partitioned frames and one LayoutSystem holding every record.
+double largestDeviation(const cha::PartitionedLayout &layout,
+                        const std::vector<CHAConstraintDescriptor> &descriptors,
+                        size_t viewCount)
+{
+    cha::LayoutSystem system;
+    system.setContainer(fixtureItem(0), kWidth, kHeight);
+    system.addDescriptors(descriptors.data(), descriptors.size());
+    system.solve();
+
+    double deviation = 0;
+    for (size_t i = 1; i <= viewCount; i++)
+    {
+        const cha::Frame expected = system.frame(fixtureItem(i)), actual = layout.frame(fixtureItem(i));
+        deviation = std::max(deviation, std::fabs(expected.x - actual.x));
+        deviation = std::max(deviation, std::fabs(expected.y - actual.y));
+        deviation = std::max(deviation, std::fabs(expected.width - actual.width));
+        deviation = std::max(deviation, std::fabs(expected.height - actual.height));
+    }
+    return deviation;
+}
+
+}
+
+CHA_TEST(testWorkerPoolRunsTasksSubmittedByTasks)
+{
+    cha::WorkerPool pool(4);
+    std::atomic<size_t> leaves(0);
+    for (int root = 0; root < 8; root++)
+    {
+        pool.submit([&pool, &leaves] {
+            for (int child = 0; child < 64; child++) pool.submit([&leaves] { leaves++; });
+        });
+    }
+    pool.waitUntilIdle();
+    CHA_CHECK_EQUAL((size_t)8 * 64, leaves.load());
+}
+
+CHA_TEST(testIndependentViewsSolveAsSeparateComponents)
+{
+    const void *container = fixtureItem(0), *left = fixtureItem(1), *right = fixtureItem(2), *below = fixtureItem(3);
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, left, container, CHAEdgeTop | CHAEdgeLeading, 10);
+    CHADescriptorBatchAppend(&batch, left, CHALayoutAttributeWidth, CHALayoutRelationEqual, nullptr,
+                             CHALayoutAttributeNotAnAttribute, 1, 100);
+    CHADescriptorBatchAppend(&batch, left, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                             CHALayoutAttributeNotAnAttribute, 1, 50);
+    CHADescriptorBatchAppendEdges(&batch, right, container, CHAEdgeTop | CHAEdgeTrailing | CHAEdgeBottom, 10);
+    CHADescriptorBatchAppend(&batch, right, CHALayoutAttributeWidth, CHALayoutRelationEqual, container,
+                             CHALayoutAttributeWidth, 0.25, 0);
+    CHADescriptorBatchAppend(&batch, below, CHALayoutAttributeTop, CHALayoutRelationEqual, left,
+                             CHALayoutAttributeBottom, 1, 8);
+    CHADescriptorBatchAppendEdges(&batch, below, left, CHAEdgeLeading | CHAEdgeTrailing, 0);
+    CHADescriptorBatchAppend(&batch, below, CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr,
+                             CHALayoutAttributeNotAnAttribute, 1, 20);
+    const std::vector<CHAConstraintDescriptor> descriptors(batch.records, batch.records + batch.count);
+
+    // Views constrained only against the container do not couple through it.
+    cha::PartitionedLayout layout;
+    layout.setContainer(container, kWidth, 480);
+    layout.setDescriptors(descriptors.data(), descriptors.size(), nullptr);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.solve());
+    CHA_CHECK_EQUAL((size_t)1, layout.stats().partCount);
+    CHA_CHECK_EQUAL((size_t)2, layout.stats().componentCount);
+
+    CHA_CHECK_CLOSE(10, layout.frame(left).x, 1e-9);
+    CHA_CHECK_CLOSE(230, layout.frame(right).x, 1e-9);
+    CHA_CHECK_CLOSE(460, layout.frame(right).height, 1e-9);
+    CHA_CHECK_CLOSE(68, layout.frame(below).y, 1e-9);
+    CHA_CHECK_CLOSE(100, layout.frame(below).width, 1e-9);
+}
+
+CHA_TEST(testCutSubtreesMatchASingleSystem)
+{
+    const size_t cards = 40, viewCount = cards * 5;
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeCards, viewCount, descriptors);
+
+    cha::WorkerPool pool(4);
+    cha::PartitionedLayout layout(&pool);
+    layout.setContainer(fixtureItem(0), kWidth, kHeight);
+    layout.setDescriptors(descriptors.data(), descriptors.size(), parentsFor(cha::test::HierarchyShapeCards));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.solve());
+
+    // The column of cards, then each card's interior, then each details view's interior.
+    CHA_CHECK_EQUAL(1 + 2 * cards, layout.stats().partCount);
+    CHA_CHECK_EQUAL((size_t)0, layout.stats().mergedCutCount);
+    CHA_CHECK_CLOSE(0, largestDeviation(layout, descriptors, viewCount), 1e-6);
+
+    const cha::Frame biography = layout.frame(fixtureItem(5 * 3 + 5));
+    CHA_CHECK_CLOSE(3 * 128 + 8 + 24, biography.y, 1e-6);
+    CHA_CHECK_CLOSE(kWidth - 8 - (104 + 16), biography.width, 1e-6);
+
+    // Sequential and concurrent solves agree exactly.
+    cha::PartitionedLayout sequential;
+    sequential.setContainer(fixtureItem(0), kWidth, kHeight);
+    sequential.setDescriptors(descriptors.data(), descriptors.size(), parentsFor(cha::test::HierarchyShapeCards));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, sequential.solve());
+    size_t mismatches = 0;
+    for (size_t i = 1; i <= viewCount; i++)
+    {
+        const cha::Frame a = layout.frame(fixtureItem(i)), b = sequential.frame(fixtureItem(i));
+        if (a.x != b.x || a.y != b.y || a.width != b.width || a.height != b.height) mismatches++;
+    }
+    CHA_CHECK_EQUAL((size_t)0, mismatches);
+}
+
+CHA_TEST(testSubtreesThatSizeTheirRootAreSolvedWithTheirParent)
+{
+    // Every parent hugs its children, so no root is fixed from outside its subtree.
+    const size_t viewCount = 340;
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeNested, viewCount, descriptors);
+
+    cha::WorkerPool pool(3);
+    cha::PartitionedLayout layout(&pool);
+    layout.setContainer(fixtureItem(0), kWidth, kHeight);
+    layout.setDescriptors(descriptors.data(), descriptors.size(), parentsFor(cha::test::HierarchyShapeNested));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.solve());
+
+    CHA_CHECK(layout.stats().partCount > 1);
+    CHA_CHECK_EQUAL(layout.stats().partCount - 1, layout.stats().mergedCutCount);
+    CHA_CHECK_CLOSE(0, largestDeviation(layout, descriptors, viewCount), 1e-6);
+}
+
+CHA_TEST(testPartitionedLayoutReportsConflicts)
+{
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeCards, 50, descriptors);
+    // A second top margin for one name, inside one of the cut subtrees.
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, fixtureItem(5 * 4 + 4), fixtureItem(5 * 4 + 3), CHAEdgeTop, 5);
+    descriptors.insert(descriptors.end(), batch.records, batch.records + batch.count);
+
+    cha::WorkerPool pool(2);
+    cha::PartitionedLayout layout(&pool);
+    layout.setContainer(fixtureItem(0), kWidth, kHeight);
+    layout.setDescriptors(descriptors.data(), descriptors.size(), parentsFor(cha::test::HierarchyShapeCards));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, layout.solve());
+}
@@ -0,0 +1,103 @@
+//
+//  CHAPortableBenchmark.h
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  Timing for CHA_BENCHMARK cases. Each measure() call times repeated runs of a body and records percentiles, which the
+//  runner prints and can write as JSON or compare against a previous run's JSON.
+//
+
+#ifndef CHAAutolayoutCategoriesTests_CHAPortableBenchmark_h
+#define CHAAutolayoutCategoriesTests_CHAPortableBenchmark_h
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cha {
+namespace test {
+
+struct BenchmarkResult
+{
+    std::string name;
+    size_t size;
+    size_t samples;
+    double minimum;
+    double p50;
+    double p90;
+    double p99;
+    double maximum;
+    double mean;
+};
+
+inline std::vector<BenchmarkResult> &benchmarkResults()
+{
+    static std::vector<BenchmarkResult> results;
+    return results;
+}
+
+/**
+ @description Nearest-rank percentile of an ascending sample set
+ */
+inline double percentile(const std::vector<double> &sorted, double fraction)
+{
+    if (sorted.empty()) return 0;
+    size_t rank = (size_t)std::ceil(fraction * sorted.size());
+    return sorted[rank == 0 ? 0 : std::min(rank, sorted.size()) - 1];
+}
+
+inline BenchmarkResult summarize(const std::string &name, size_t size, std::vector<double> &samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples) total += sample;
+
+    BenchmarkResult result = {name, size, samples.size(), samples.front(), percentile(samples, 0.5), percentile(samples, 0.9),
+                              percentile(samples, 0.99), samples.back(), total / samples.size()};
+    return result;
+}
+
+/**
+ @description Time body repeatedly and record the distribution in nanoseconds per run
+ @param size The problem size the body works on (views, records, ...), reported alongside the timings
+ @param maxSamples Stop after this many runs
+ @param budgetSeconds Stop once this much time has been spent, but always take at least one sample
+ */
+template <typename Body>
+const BenchmarkResult &measure(const std::string &name, size_t size, size_t maxSamples, double budgetSeconds, Body body)
+{
+    typedef std::chrono::steady_clock Clock;
+    std::vector<double> samples;
+    samples.reserve(maxSamples);
+
+    const Clock::time_point start = Clock::now();
+    while (samples.size() < maxSamples)
+    {
+        const Clock::time_point before = Clock::now();
+        body();
+        const Clock::time_point after = Clock::now();
+        samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+        if (std::chrono::duration<double>(after - start).count() > budgetSeconds) break;
+    }
+
+    benchmarkResults().push_back(summarize(name, size, samples));
+    return benchmarkResults().back();
+}
+
+/**
+ @description Keep the optimizer from discarding a computed value
+ */
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,81 @@
+//
+//  CHAPortableTest.h
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  A minimal test harness for the UIKit-free core. Every file in this directory is compiled into a
+//  single executable; see the README for the one-line build command.
+//
+
+#ifndef CHAAutolayoutCategoriesTests_CHAPortableTest_h
+#define CHAAutolayoutCategoriesTests_CHAPortableTest_h
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace cha {
+namespace test {
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+    const char *name;
+    TestFunction function;
+    bool benchmark;
+};
+
+inline std::vector<TestCase> &registry()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+struct Registrar
+{
+    Registrar(const char *name, TestFunction function, bool benchmark)
+    {
+        registry().push_back(TestCase{name, function, benchmark});
+    }
+};
+
+inline int &failureCount()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline void fail(const char *file, int line, const std::string &message)
+{
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+    failureCount()++;
+}
+
+}
+}
+
+#define CHA_TEST(name) \
+    static void name(); \
+    static ::cha::test::Registrar name##_registrar(#name, &name, false); \
+    static void name()
+
+#define CHA_BENCHMARK(name) \
+    static void name(); \
+    static ::cha::test::Registrar name##_registrar(#name, &name, true); \
+    static void name()
+
+#define CHA_CHECK(condition) \
+    do { if (!(condition)) ::cha::test::fail(__FILE__, __LINE__, "check failed: " #condition); } while (0)
+
+#define CHA_CHECK_EQUAL(expected, actual) \
+    do { if (!((expected) == (actual))) ::cha::test::fail(__FILE__, __LINE__, "expected " #expected " == " #actual); } while (0)
+
+#define CHA_CHECK_CLOSE(expected, actual, tolerance) \
+    do { if (std::fabs((double)(expected) - (double)(actual)) > (tolerance)) \
+        ::cha::test::fail(__FILE__, __LINE__, "expected " #actual " close to " #expected \
+                          " (got " + std::to_string((double)(actual)) + ")"); } while (0)
+
+#endif
@@ -0,0 +1,134 @@
+//
+//  CHAPortableTestMain.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableBenchmark.h"
+#include "CHAPortableTest.h"
+#include "CHATraceExporter.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+namespace {
+
+// Names are keyed in their escaped form, the way writeJSON quotes them.
+std::string quotedName(const std::string &name)
+{
+    std::string quoted;
+    cha::appendJSONString(name.c_str(), quoted);
+    return quoted;
+}
+
+bool writeJSON(const char *path)
+{
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "{\n  \"benchmarks\": [\n";
+    const std::vector<cha::test::BenchmarkResult> &results = cha::test::benchmarkResults();
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const cha::test::BenchmarkResult &result = results[i];
+        out << "    {\"name\": " << quotedName(result.name) << ", \"size\": " << result.size << ", \"samples\": " << result.samples
+            << ", \"min_ns\": " << (long long)result.minimum << ", \"p50_ns\": " << (long long)result.p50
+            << ", \"p90_ns\": " << (long long)result.p90 << ", \"p99_ns\": " << (long long)result.p99
+            << ", \"max_ns\": " << (long long)result.maximum << ", \"mean_ns\": " << (long long)result.mean << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return (bool)out;
+}
+
+// Reads back the "name" and "p50_ns" fields of a file written by writeJSON, keeping names quoted and escaped.
+std::map<std::string, double> readBaseline(const char *path)
+{
+    std::map<std::string, double> medians;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const size_t name = line.find("\"name\": \"");
+        if (name == std::string::npos) continue;
+
+        const size_t nameStart = name + std::strlen("\"name\": ");
+        size_t nameEnd = nameStart + 1;
+        while (nameEnd < line.size() && line[nameEnd] != '"') nameEnd += line[nameEnd] == '\\' ? 2 : 1;
+        const size_t median = line.find("\"p50_ns\": ", nameEnd);
+        if (nameEnd >= line.size() || median == std::string::npos) continue;
+        medians[line.substr(nameStart, nameEnd + 1 - nameStart)] = std::atof(line.c_str() + median + std::strlen("\"p50_ns\": "));
+    }
+    return medians;
+}
+
+int compareWithBaseline(const char *path, double tolerance)
+{
+    const std::map<std::string, double> baseline = readBaseline(path);
+    int regressions = 0;
+    for (const cha::test::BenchmarkResult &result : cha::test::benchmarkResults())
+    {
+        auto previous = baseline.find(quotedName(result.name));
+        if (previous == baseline.end() || previous->second <= 0) continue;
+
+        const double ratio = result.p50 / previous->second;
+        if (ratio > 1.0 + tolerance)
+        {
+            std::fprintf(stderr, "[REGRESSION] %s: p50 %.0f ns vs %.0f ns baseline (%.2fx)\n",
+                         result.name.c_str(), result.p50, previous->second, ratio);
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    bool runBenchmarks = false;
+    const char *filter = nullptr;
+    const char *jsonPath = nullptr;
+    const char *baselinePath = nullptr;
+    double tolerance = 0.25;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--benchmarks") == 0) runBenchmarks = true;
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+        else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = std::atof(argv[++i]);
+        else filter = argv[i];
+    }
+
+    int ran = 0;
+    for (const cha::test::TestCase &testCase : cha::test::registry())
+    {
+        if (testCase.benchmark != runBenchmarks) continue;
+        if (filter && !std::strstr(testCase.name, filter)) continue;
+
+        int failuresBefore = cha::test::failureCount();
+        testCase.function();
+        std::fprintf(stderr, "[%s] %s\n", cha::test::failureCount() == failuresBefore ? "PASS" : "FAIL", testCase.name);
+        ran++;
+    }
+
+    for (const cha::test::BenchmarkResult &result : cha::test::benchmarkResults())
+    {
+        std::fprintf(stderr, "  %-40s n=%-4zu p50 %12.0f ns  p90 %12.0f ns  p99 %12.0f ns\n",
+                     result.name.c_str(), result.samples, result.p50, result.p90, result.p99);
+    }
+
+    int regressions = 0;
+    if (jsonPath && !writeJSON(jsonPath))
+    {
+        std::fprintf(stderr, "could not write %s\n", jsonPath);
+        regressions++;
+    }
+    if (baselinePath) regressions += compareWithBaseline(baselinePath, tolerance);
+
+    std::fprintf(stderr, "%d ran, %d failed checks\n", ran, cha::test::failureCount());
+    return cha::test::failureCount() == 0 && regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+//
+//  CHASimplexSolverTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHALayoutSystem.h"
+#include "CHASimplexSolver.h"
+
+namespace {
+
+typedef cha::Solver::Term Term;
+
+int root, header, picture, details, nameLabel, biography, content;
+
+void append(CHADescriptorBatch &batch, const void *item, CHALayoutAttribute attribute, CHALayoutRelation relation,
+            const void *toItem, CHALayoutAttribute toAttribute, double multiplier, double constant)
+{
+    CHADescriptorBatchAppend(&batch, item, attribute, relation, toItem, toAttribute, multiplier, constant);
+}
+
+// Mirrors ViewController -setupMainContainers and CHAHeaderView -setupConstraints.
+void addHeaderScreen(cha::LayoutSystem &layout)
+{
+    CHADescriptorBatch batch;
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, &header, &root, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeTop, 0);
+    append(batch, &header, CHALayoutAttributeHeight, CHALayoutRelationEqual, &root, CHALayoutAttributeHeight, 1.0 / 3.0, 0);
+    append(batch, &content, CHALayoutAttributeTop, CHALayoutRelationEqual, &header, CHALayoutAttributeBottom, 1, 0);
+    CHADescriptorBatchAppendEdges(&batch, &content, &root, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeBottom, 0);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addBatch(batch));
+
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, &picture, &header, CHAEdgeLeading, 10);
+    append(batch, &picture, CHALayoutAttributeCenterY, CHALayoutRelationEqual, &header, CHALayoutAttributeCenterY, 1, 0);
+    append(batch, &picture, CHALayoutAttributeHeight, CHALayoutRelationEqual, &picture, CHALayoutAttributeWidth, 1, 0);
+    append(batch, &picture, CHALayoutAttributeHeight, CHALayoutRelationEqual, &header, CHALayoutAttributeHeight, 0.35, 0);
+    append(batch, &picture, CHALayoutAttributeTop, CHALayoutRelationGreaterThanOrEqual, &header, CHALayoutAttributeTop, 1, 10);
+    CHADescriptorBatchAppendEdges(&batch, &details, &header, CHAEdgeTrailing, 10);
+    append(batch, &details, CHALayoutAttributeLeading, CHALayoutRelationEqual, &picture, CHALayoutAttributeTrailing, 1, 10);
+    append(batch, &details, CHALayoutAttributeTop, CHALayoutRelationEqual, &picture, CHALayoutAttributeTop, 1, 0);
+    append(batch, &details, CHALayoutAttributeBottom, CHALayoutRelationEqual, &picture, CHALayoutAttributeBottom, 1, 0);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addBatch(batch));
+
+    CHADescriptorBatchReset(&batch);
+    CHADescriptorBatchAppendEdges(&batch, &nameLabel, &details, CHAEdgeLeading | CHAEdgeTop | CHAEdgeTrailing, 0);
+    append(batch, &nameLabel, CHALayoutAttributeHeight, CHALayoutRelationEqual, &details, CHALayoutAttributeHeight, 0.33, 0);
+    CHADescriptorBatchAppendEdges(&batch, &biography, &details, CHAEdgeLeading | CHAEdgeTrailing | CHAEdgeBottom, 0);
+    append(batch, &biography, CHALayoutAttributeTop, CHALayoutRelationEqual, &nameLabel, CHALayoutAttributeBottom, 1, 0);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addBatch(batch));
+}
+
+void checkFrame(const cha::LayoutSystem &layout, const void *item, double x, double y, double width, double height)
+{
+    cha::Frame frame = layout.frame(item);
+    CHA_CHECK_CLOSE(x, frame.x, 1e-6);
+    CHA_CHECK_CLOSE(y, frame.y, 1e-6);
+    CHA_CHECK_CLOSE(width, frame.width, 1e-6);
+    CHA_CHECK_CLOSE(height, frame.height, 1e-6);
+}
+
+}
+
+CHA_TEST(testSolverRequiredEqualities)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable(), y = solver.addVariable();
+
+    Term xIsTen[] = { {x, 1.0} };
+    Term yIsTwiceX[] = { {y, 1.0}, {x, -2.0} };
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.addConstraint(xIsTen, 1, -10, CHALayoutRelationEqual, cha::Strength::required, nullptr));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.addConstraint(yIsTwiceX, 2, 0, CHALayoutRelationEqual, cha::Strength::required, nullptr));
+    solver.updateVariables();
+
+    CHA_CHECK_CLOSE(10, solver.value(x), 1e-9);
+    CHA_CHECK_CLOSE(20, solver.value(y), 1e-9);
+}
+
+CHA_TEST(testSolverStrengthsAndInequalities)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable();
+    Term term[] = { {x, 1.0} };
+
+    cha::Solver::Constraint weak, strong;
+    solver.addConstraint(term, 1, -100, CHALayoutRelationEqual, cha::Strength::weak, &weak);
+    solver.addConstraint(term, 1, -50, CHALayoutRelationLessThanOrEqual, cha::Strength::required, nullptr);
+    solver.updateVariables();
+    CHA_CHECK_CLOSE(50, solver.value(x), 1e-9);
+
+    solver.addConstraint(term, 1, -20, CHALayoutRelationEqual, cha::Strength::strong, &strong);
+    solver.updateVariables();
+    CHA_CHECK_CLOSE(20, solver.value(x), 1e-9);
+
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.removeConstraint(strong));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnknownConstraint, solver.removeConstraint(strong));
+    solver.updateVariables();
+    CHA_CHECK_CLOSE(50, solver.value(x), 1e-9);
+}
+
+CHA_TEST(testSolverRejectsConflictingRequiredConstraints)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable();
+    Term term[] = { {x, 1.0} };
+
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.addConstraint(term, 1, -10, CHALayoutRelationEqual, cha::Strength::required, nullptr));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.addConstraint(term, 1, -20, CHALayoutRelationEqual, cha::Strength::required, nullptr));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.addConstraint(term, 1, -30, CHALayoutRelationGreaterThanOrEqual, cha::Strength::required, nullptr));
+    CHA_CHECK_EQUAL(1u, solver.constraintCount());
+    solver.updateVariables();
+    CHA_CHECK_CLOSE(10, solver.value(x), 1e-9);
+}
+
+CHA_TEST(testSolverRemovedConstraintsCanBeAddedAgain)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable(), y = solver.addVariable();
+    Term xTerm[] = { {x, 1.0} };
+    Term yAfterX[] = { {y, 1.0}, {x, -1.0} };
+
+    cha::Solver::Constraint spacing;
+    solver.addConstraint(xTerm, 1, -10, CHALayoutRelationEqual, cha::Strength::required, nullptr);
+    solver.addConstraint(yAfterX, 2, -5, CHALayoutRelationEqual, cha::Strength::required, &spacing);
+    const size_t rows = solver.rowCount();
+
+    // Recreating a constraint with a new constant, as animating by replacing NSLayoutConstraints does.
+    for (double gap = 6; gap <= 9; gap++)
+    {
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.removeConstraint(spacing));
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.addConstraint(yAfterX, 2, -gap, CHALayoutRelationEqual, cha::Strength::required, &spacing));
+        CHA_CHECK_EQUAL(rows, solver.rowCount());
+        solver.updateVariables();
+        CHA_CHECK_CLOSE(10 + gap, solver.value(y), 1e-9);
+    }
+}
+
+CHA_TEST(testSolverEditVariables)
+{
+    cha::Solver solver;
+    cha::Solver::Variable width = solver.addVariable(), half = solver.addVariable();
+    Term halfOfWidth[] = { {half, 2.0}, {width, -1.0} };
+    solver.addConstraint(halfOfWidth, 2, 0, CHALayoutRelationEqual, cha::Strength::required, nullptr);
+
+    CHA_CHECK_EQUAL(cha::Solver::StatusBadRequiredStrength, solver.addEditVariable(width, cha::Strength::required));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.addEditVariable(width, cha::Strength::strong));
+    CHA_CHECK_EQUAL(cha::Solver::StatusDuplicateEditVariable, solver.addEditVariable(width, cha::Strength::strong));
+
+    for (double value = 0; value <= 1000; value += 125)
+    {
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.suggestValue(width, value));
+        solver.updateVariables();
+        CHA_CHECK_CLOSE(value / 2, solver.value(half), 1e-9);
+    }
+
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.removeEditVariable(width));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnknownEditVariable, solver.suggestValue(width, 10));
+}
+
+CHA_TEST(testSolverSetConstantKeepsEditSemantics)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable(), y = solver.addVariable();
+    Term xTerm[] = { {x, 1.0} };
+    Term yAfterX[] = { {y, 1.0}, {x, -1.0} };
+
+    cha::Solver::Constraint preferred, limit, spacing;
+    solver.addConstraint(xTerm, 1, -100, CHALayoutRelationEqual, cha::Strength::weak, &preferred);
+    solver.addConstraint(xTerm, 1, -50, CHALayoutRelationLessThanOrEqual, cha::Strength::required, &limit);
+    solver.addConstraint(yAfterX, 2, -8, CHALayoutRelationEqual, cha::Strength::required, &spacing);
+    solver.updateVariables();
+    CHA_CHECK_CLOSE(50, solver.currentValue(x), 1e-9);
+
+    // Moving the limit past the preference releases x to the weak value, and back again.
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.setConstant(limit, -150));
+    CHA_CHECK_CLOSE(100, solver.currentValue(x), 1e-9);
+    CHA_CHECK_CLOSE(108, solver.currentValue(y), 1e-9);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.setConstant(limit, -30));
+    CHA_CHECK_CLOSE(30, solver.currentValue(x), 1e-9);
+
+    const double constants[] = {-20, -70, -120};
+    const cha::Solver::Constraint constraints[] = {spacing, limit, preferred};
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.setConstants(constraints, constants, 3));
+    CHA_CHECK_CLOSE(70, solver.currentValue(x), 1e-9);
+    CHA_CHECK_CLOSE(90, solver.currentValue(y), 1e-9);
+
+    // Only the values change; value() still reflects the last updateVariables().
+    CHA_CHECK_CLOSE(50, solver.value(x), 1e-9);
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnknownConstraint, solver.setConstant(99, 0));
+}
+
+CHA_TEST(testSolverSetConstantRejectsConflicts)
+{
+    cha::Solver solver;
+    cha::Solver::Variable x = solver.addVariable();
+    Term term[] = { {x, 1.0} };
+
+    cha::Solver::Constraint fixed, duplicate, minimum;
+    solver.addConstraint(term, 1, -10, CHALayoutRelationEqual, cha::Strength::required, &fixed);
+    solver.addConstraint(term, 1, -10, CHALayoutRelationEqual, cha::Strength::required, &duplicate);
+    solver.addConstraint(term, 1, -5, CHALayoutRelationGreaterThanOrEqual, cha::Strength::required, &minimum);
+
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.setConstant(duplicate, -20));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.setConstant(minimum, -15));
+    CHA_CHECK_CLOSE(10, solver.currentValue(x), 1e-9);
+
+    // A batch either applies whole or not at all.
+    const cha::Solver::Constraint constraints[] = {fixed, duplicate, minimum};
+    const double conflicting[] = {-4, -4, -6};
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.setConstants(constraints, conflicting, 3));
+    CHA_CHECK_CLOSE(10, solver.currentValue(x), 1e-9);
+
+    const double agreeing[] = {-4, -4, -3};
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.setConstants(constraints, agreeing, 3));
+    CHA_CHECK_CLOSE(4, solver.currentValue(x), 1e-9);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, solver.setConstant(minimum, -4));
+    CHA_CHECK_EQUAL(cha::Solver::StatusUnsatisfiable, solver.setConstant(minimum, -4.5));
+}
+
+CHA_TEST(testLayoutSystemSetConstantMatchesRebuiltSystem)
+{
+    const size_t viewCount = 100;
+    std::vector<CHAConstraintDescriptor> descriptors;
+    cha::test::appendHierarchy(cha::test::HierarchyShapeCards, viewCount, descriptors);
+
+    cha::LayoutSystem edited;
+    edited.setContainer(cha::test::fixtureItem(0), 320, 480);
+    std::vector<cha::Solver::Constraint> constraints(descriptors.size());
+    for (size_t i = 0; i < descriptors.size(); i++) edited.addDescriptor(descriptors[i], &constraints[i]);
+    edited.solve();
+
+    // Move one record in seven, one at a time and then as a batch.
+    std::vector<cha::Solver::Constraint> moved;
+    std::vector<double> constants;
+    for (size_t i = 3; i < descriptors.size(); i += 7)
+    {
+        descriptors[i].constant += 6;
+        moved.push_back(constraints[i]);
+        constants.push_back(descriptors[i].constant);
+    }
+    const uint64_t pivots = edited.solver().pivotCount();
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, edited.setConstant(moved[0], constants[0]));
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, edited.setConstants(moved.data() + 1, constants.data() + 1, moved.size() - 1));
+    // Every record is a required equality, so the new constants are absorbed without a pivot.
+    CHA_CHECK_EQUAL(pivots, edited.solver().pivotCount());
+
+    cha::LayoutSystem rebuilt;
+    rebuilt.setContainer(cha::test::fixtureItem(0), 320, 480);
+    CHA_CHECK_EQUAL(cha::Solver::StatusOK, rebuilt.addDescriptors(descriptors.data(), descriptors.size()));
+    rebuilt.solve();
+
+    for (size_t i = 1; i <= viewCount; i++)
+    {
+        const cha::Frame expected = rebuilt.frame(cha::test::fixtureItem(i));
+        const cha::Frame actual = edited.currentFrame(cha::test::fixtureItem(i));
+        CHA_CHECK_CLOSE(expected.x, actual.x, 1e-6);
+        CHA_CHECK_CLOSE(expected.y, actual.y, 1e-6);
+        CHA_CHECK_CLOSE(expected.width, actual.width, 1e-6);
+        CHA_CHECK_CLOSE(expected.height, actual.height, 1e-6);
+    }
+}
+
+CHA_TEST(testLayoutSystemSolvesHeaderScreen)
+{
+    cha::LayoutSystem layout;
+    layout.setContainer(&root, 320, 480);
+    addHeaderScreen(layout);
+    layout.solve();
+
+    checkFrame(layout, &header, 0, 0, 320, 160);
+    checkFrame(layout, &content, 0, 160, 320, 320);
+    checkFrame(layout, &picture, 10, 52, 56, 56);
+    checkFrame(layout, &details, 76, 52, 234, 56);
+    checkFrame(layout, &nameLabel, 76, 52, 234, 56 * 0.33);
+    checkFrame(layout, &biography, 76, 52 + 56 * 0.33, 234, 56 * 0.67);
+
+    layout.setContainer(&root, 480, 300);
+    layout.solve();
+    checkFrame(layout, &header, 0, 0, 480, 100);
+    checkFrame(layout, &picture, 10, 32.5, 35, 35);
+    checkFrame(layout, &details, 55, 32.5, 415, 35);
+}
+
+CHA_TEST(testLayoutSystemSolvesLongChains)
+{
+    const int viewCount = 2000;
+    std::vector<int> views(viewCount);
+
+    cha::LayoutSystem layout;
+    layout.setContainer(&root, 320, 480);
+    for (int i = 0; i < viewCount; i++)
+    {
+        CHADescriptorBatch batch;
+        CHADescriptorBatchReset(&batch);
+        CHADescriptorBatchAppendEdges(&batch, &views[i], &root, CHAEdgeLeading | CHAEdgeTrailing, 8);
+        append(batch, &views[i], CHALayoutAttributeHeight, CHALayoutRelationEqual, nullptr, CHALayoutAttributeNotAnAttribute, 1, 44);
+        if (i == 0) CHADescriptorBatchAppendEdges(&batch, &views[i], &root, CHAEdgeTop, 0);
+        else append(batch, &views[i], CHALayoutAttributeTop, CHALayoutRelationEqual, &views[i - 1], CHALayoutAttributeBottom, 1, 4);
+        CHA_CHECK_EQUAL(cha::Solver::StatusOK, layout.addBatch(batch));
+    }
+    layout.solve();
+
+    CHA_CHECK_EQUAL((size_t)viewCount + 1, layout.itemCount());
+    checkFrame(layout, &views[viewCount - 1], 8, (viewCount - 1) * 48.0, 304, 44);
+}
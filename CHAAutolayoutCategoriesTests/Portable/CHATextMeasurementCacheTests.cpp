@@ -0,0 +1,151 @@
+//
+//  CHATextMeasurementCacheTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHABenchmarkFixtures.h"
+#include "CHATextMeasurementCache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const double kFontSize = 10;
+const uint64_t kFontHash = 17;
+
+cha::TextMeasurementKey keyFor(const std::string &text, double width, uint32_t lineLimit = 0, uint64_t fontHash = kFontHash)
+{
+    return cha::TextMeasurementKey{cha::hashBytes(text.data(), text.size()), fontHash, width, lineLimit};
+}
+
+cha::TextSize measureFake(const cha::TextMeasurementKey &key, const void *context)
+{
+    return cha::test::fakeMeasureText(*static_cast<const std::string *>(context), kFontSize, key.width, key.lineLimit);
+}
+
+}
+
+CHA_TEST(testFakeMeasurerWrapsWordsDeterministically)
+{
+    // Glyphs are 5 points wide and lines 12 points tall at size 10.
+    cha::TextSize size = cha::test::fakeMeasureText("aa bb cc", kFontSize, 25, 0);
+    CHA_CHECK_CLOSE(25, size.width, 1e-9);
+    CHA_CHECK_CLOSE(24, size.height, 1e-9);
+
+    size = cha::test::fakeMeasureText("aa bb cc", kFontSize, 25, 1);
+    CHA_CHECK_CLOSE(12, size.height, 1e-9);
+    size = cha::test::fakeMeasureText("aa bb cc", kFontSize, 0, 0);
+    CHA_CHECK_CLOSE(40, size.width, 1e-9);
+    CHA_CHECK_CLOSE(12, size.height, 1e-9);
+
+    std::vector<std::string> first, second;
+    cha::test::appendParagraphs(20, first);
+    cha::test::appendParagraphs(20, second);
+    CHA_CHECK(first == second);
+}
+
+CHA_TEST(testTextMeasurementCacheMeasuresEachKeyOnce)
+{
+    size_t measurements = 0;
+    cha::TextMeasurementCache cache(1 << 20, [&measurements](const cha::TextMeasurementKey &key, const void *context) {
+        measurements++;
+        return measureFake(key, context);
+    });
+
+    const std::string biography = "your favorite app studio on both sides of the atlantic";
+    for (int scroll = 0; scroll < 10; scroll++)
+    {
+        const cha::TextSize size = cache.measure(keyFor(biography, 100), &biography);
+        CHA_CHECK_CLOSE(cha::test::fakeMeasureText(biography, kFontSize, 100, 0).height, size.height, 1e-9);
+    }
+    CHA_CHECK_EQUAL((size_t)1, measurements);
+    CHA_CHECK_EQUAL((uint64_t)9, cache.hitCount());
+    CHA_CHECK_EQUAL((uint64_t)1, cache.missCount());
+    CHA_CHECK_CLOSE(0.9, cache.hitRate(), 1e-9);
+
+    // Every part of the key matters.
+    cache.measure(keyFor(biography, 120), &biography);
+    cache.measure(keyFor(biography, 100, 2), &biography);
+    cache.measure(keyFor(biography, 100, 0, kFontHash + 1), &biography);
+    const std::string name = "chisel apps";
+    cache.measure(keyFor(name, 100), &name);
+    CHA_CHECK_EQUAL((size_t)5, measurements);
+    CHA_CHECK_EQUAL((size_t)5, cache.size());
+    CHA_CHECK_EQUAL(5 * cha::TextMeasurementCache::kEntryFootprint, cache.bytesInUse());
+
+    cache.resetCounters();
+    CHA_CHECK_CLOSE(0, cache.hitRate(), 0);
+    cache.clear();
+    CHA_CHECK_EQUAL((size_t)0, cache.size());
+}
+
+CHA_TEST(testTextMeasurementCacheEvictsLeastRecentlyUsedWithinBudget)
+{
+    const size_t footprint = cha::TextMeasurementCache::kEntryFootprint;
+    cha::TextMeasurementCache cache(3 * footprint + footprint / 2, measureFake);
+    const std::string texts[] = { "a", "b", "c", "d" };
+
+    cache.measure(keyFor(texts[0], 50), &texts[0]);
+    cache.measure(keyFor(texts[1], 50), &texts[1]);
+    cache.measure(keyFor(texts[2], 50), &texts[2]);
+    // Touch "a" so "b" is the least recently used when "d" arrives.
+    CHA_CHECK(cache.find(keyFor(texts[0], 50), nullptr));
+    cache.measure(keyFor(texts[3], 50), &texts[3]);
+
+    CHA_CHECK_EQUAL((size_t)3, cache.size());
+    CHA_CHECK_EQUAL((uint64_t)1, cache.evictionCount());
+    CHA_CHECK(cache.bytesInUse() <= cache.byteBudget());
+    CHA_CHECK(cache.find(keyFor(texts[0], 50), nullptr));
+    CHA_CHECK(!cache.find(keyFor(texts[1], 50), nullptr));
+    CHA_CHECK(cache.find(keyFor(texts[2], 50), nullptr));
+    CHA_CHECK(cache.find(keyFor(texts[3], 50), nullptr));
+
+    // Shrinking the budget evicts at once, oldest first.
+    cache.setByteBudget(footprint);
+    CHA_CHECK_EQUAL((size_t)1, cache.size());
+    CHA_CHECK(cache.find(keyFor(texts[3], 50), nullptr));
+
+    // A budget below one entry caches nothing but still measures.
+    cache.setByteBudget(footprint - 1);
+    CHA_CHECK_EQUAL((size_t)0, cache.size());
+    const cha::TextSize size = cache.measure(keyFor(texts[0], 50), &texts[0]);
+    CHA_CHECK_CLOSE(12, size.height, 1e-9);
+    CHA_CHECK_EQUAL((size_t)0, cache.size());
+}
+
+CHA_TEST(testConcurrentMeasurementsMatchTheMeasurer)
+{
+    std::vector<std::string> paragraphs;
+    cha::test::appendParagraphs(64, paragraphs);
+    const size_t budget = 256 * cha::TextMeasurementCache::kEntryFootprint;
+    cha::TextMeasurementCache cache(budget, measureFake);
+
+    const size_t threadCount = 4, lookups = 20000;
+    std::atomic<size_t> mismatches(0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < lookups; i++)
+            {
+                const std::string &text = paragraphs[(i * 31 + t) % paragraphs.size()];
+                const double width = (i % 3 + 1) * 100.0;
+                const cha::TextSize size = cache.measure(keyFor(text, width), &text);
+                const cha::TextSize expected = cha::test::fakeMeasureText(text, kFontSize, width, 0);
+                if (size.width != expected.width || size.height != expected.height) mismatches++;
+            }
+        });
+    }
+    for (std::thread &thread : threads) thread.join();
+
+    CHA_CHECK_EQUAL((size_t)0, mismatches.load());
+    CHA_CHECK_EQUAL(threadCount * lookups, (size_t)(cache.hitCount() + cache.missCount()));
+    CHA_CHECK(cache.bytesInUse() <= budget);
+    CHA_CHECK(cache.hitRate() > 0.5);
+}
@@ -0,0 +1,290 @@
+//
+//  CHATraceRecorderTests.cpp
+//  CHAAutolayoutCategoriesTests
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+
+#include "CHAPortableTest.h"
+#include "CHATraceExporter.h"
+#include "CHATraceRecorder.h"
+
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int view, otherView;
+
+// A strict recursive-descent check that text is one JSON value, with valid UTF-8 throughout.
+class JSONValidator
+{
+public:
+    explicit JSONValidator(const std::string &text) : p_(text.c_str()), end_(text.c_str() + text.size()) {}
+
+    bool validate()
+    {
+        skipSpace();
+        if (!value()) return false;
+        skipSpace();
+        return p_ == end_;
+    }
+
+private:
+    void skipSpace()
+    {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) p_++;
+    }
+
+    bool literal(const char *word)
+    {
+        const size_t length = std::strlen(word);
+        if ((size_t)(end_ - p_) < length || std::strncmp(p_, word, length) != 0) return false;
+        p_ += length;
+        return true;
+    }
+
+    bool value()
+    {
+        if (p_ == end_) return false;
+        switch (*p_)
+        {
+            case '{': return object();
+            case '[': return array();
+            case '"': return string();
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return number();
+        }
+    }
+
+    bool object()
+    {
+        p_++;
+        skipSpace();
+        if (p_ < end_ && *p_ == '}') { p_++; return true; }
+        for (;;)
+        {
+            skipSpace();
+            if (!string()) return false;
+            skipSpace();
+            if (p_ == end_ || *p_++ != ':') return false;
+            skipSpace();
+            if (!value()) return false;
+            skipSpace();
+            if (p_ == end_) return false;
+            if (*p_ == '}') { p_++; return true; }
+            if (*p_++ != ',') return false;
+        }
+    }
+
+    bool array()
+    {
+        p_++;
+        skipSpace();
+        if (p_ < end_ && *p_ == ']') { p_++; return true; }
+        for (;;)
+        {
+            skipSpace();
+            if (!value()) return false;
+            skipSpace();
+            if (p_ == end_) return false;
+            if (*p_ == ']') { p_++; return true; }
+            if (*p_++ != ',') return false;
+        }
+    }
+
+    bool string()
+    {
+        if (p_ == end_ || *p_ != '"') return false;
+        p_++;
+        while (p_ < end_)
+        {
+            const unsigned char c = (unsigned char)*p_;
+            if (c == '"') { p_++; return true; }
+            if (c < 0x20) return false;
+            if (c == '\\')
+            {
+                if (++p_ == end_) return false;
+                if (*p_ == 'u')
+                {
+                    for (int i = 1; i <= 4; i++)
+                    {
+                        if (p_ + i >= end_ || !std::isxdigit((unsigned char)p_[i])) return false;
+                    }
+                    p_ += 5;
+                }
+                else if (std::strchr("\"\\/bfnrt", *p_)) p_++;
+                else return false;
+                continue;
+            }
+            if (c < 0x80) { p_++; continue; }
+
+            const size_t length = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+            if (length == 0 || (size_t)(end_ - p_) < length) return false;
+            for (size_t i = 1; i < length; i++)
+            {
+                if (((unsigned char)p_[i] & 0xC0) != 0x80) return false;
+            }
+            p_ += length;
+        }
+        return false;
+    }
+
+    bool number()
+    {
+        const char *start = p_;
+        if (p_ < end_ && *p_ == '-') p_++;
+        while (p_ < end_ && (std::isdigit((unsigned char)*p_) || *p_ == '.' || *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-')) p_++;
+        return p_ > start && std::isdigit((unsigned char)p_[-1]);
+    }
+
+    const char *p_;
+    const char *end_;
+};
+
+}
+
+CHA_TEST(testNestedHelperScopesRecordOnlyTheOutermostCall)
+{
+    cha::TraceRecorder recorder(16);
+    recorder.setEnabled(true);
+    {
+        cha::HelperTraceScope outer("pinLeading", &view, recorder);
+        {
+            cha::HelperTraceScope inner("pinSide:constant:", &view, recorder);
+            cha::HelperTraceScope::noteConstraint(true, &view);
+        }
+        cha::HelperTraceScope::noteConstraint(false, &view);
+    }
+
+    std::vector<cha::TraceEvent> events;
+    CHA_CHECK_EQUAL(1u, recorder.snapshot(events));
+    CHA_CHECK(std::strcmp("pinLeading", events[0].name) == 0);
+    CHA_CHECK_EQUAL(&view, events[0].item);
+    CHA_CHECK_EQUAL(1u, events[0].created);
+    CHA_CHECK_EQUAL(1u, events[0].reused);
+}
+
+CHA_TEST(testDisabledRecorderRecordsNothing)
+{
+    cha::TraceRecorder recorder(16);
+    {
+        cha::SiteTraceScope site("setupConstraints", recorder);
+        cha::HelperTraceScope helper("pinLeading", &view, recorder);
+        cha::HelperTraceScope::noteConstraint(true, &view);
+    }
+
+    std::vector<cha::TraceEvent> events;
+    CHA_CHECK_EQUAL(0u, recorder.snapshot(events));
+}
+
+CHA_TEST(testSitesLabelTheHelperCallsInsideThem)
+{
+    cha::TraceRecorder recorder(16);
+    recorder.setEnabled(true);
+    {
+        cha::SiteTraceScope site("setupMainContainers", recorder);
+        for (int i = 0; i < 3; i++)
+        {
+            cha::HelperTraceScope helper("pinLeadingTrailing", &otherView, recorder);
+            cha::HelperTraceScope::noteConstraint(i == 0, &otherView);
+        }
+    }
+    {
+        cha::HelperTraceScope helper("aspectRatio", &view, recorder);
+        cha::HelperTraceScope::noteConstraint(true, &view);
+    }
+
+    std::vector<cha::TraceEvent> events;
+    recorder.snapshot(events);
+    const cha::TraceSummary summary = cha::summarizeTrace(events.data(), events.size());
+
+    CHA_CHECK_EQUAL(4u, summary.total.calls);
+    CHA_CHECK_EQUAL(2u, summary.total.created);
+    CHA_CHECK_EQUAL(2u, summary.total.reused);
+    CHA_CHECK_EQUAL(3u, summary.byHelper.at("pinLeadingTrailing").calls);
+    CHA_CHECK_EQUAL(1u, summary.bySite.at("setupMainContainers").created);
+    CHA_CHECK_EQUAL(2u, summary.bySite.at("setupMainContainers").reused);
+    CHA_CHECK_EQUAL(3u, summary.byItem.at(&otherView).calls);
+    CHA_CHECK_EQUAL(1u, summary.byItem.at(&view).created);
+    CHA_CHECK(events.back().site == nullptr);
+}
+
+CHA_TEST(testConcurrentRecordingKeepsOrDropsEveryEvent)
+{
+    const size_t threadCount = 8, perThread = 5000;
+    for (size_t capacity : { threadCount * perThread, (size_t)1000 })
+    {
+        cha::TraceRecorder recorder(capacity);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&recorder, t] {
+                for (size_t i = 0; i < perThread; i++)
+                {
+                    cha::TraceEvent event = {"record", nullptr, nullptr, i, 0, (uint32_t)t, (uint32_t)i, 0, cha::TraceEventHelper};
+                    recorder.record(event);
+                }
+            });
+        }
+        for (std::thread &thread : threads) thread.join();
+
+        std::vector<cha::TraceEvent> events;
+        recorder.snapshot(events);
+        std::set<std::pair<uint32_t, uint32_t>> seen;
+        for (const cha::TraceEvent &event : events) seen.insert(std::make_pair(event.thread, event.created));
+
+        CHA_CHECK_EQUAL(capacity, events.size());
+        CHA_CHECK_EQUAL(events.size(), seen.size());
+        CHA_CHECK_EQUAL(threadCount * perThread - capacity, recorder.droppedCount());
+
+        recorder.reset();
+        events.clear();
+        CHA_CHECK_EQUAL(0u, recorder.snapshot(events));
+    }
+}
+
+CHA_TEST(testChromeTraceExportIsValidJSONForArbitraryNames)
+{
+    std::mt19937 random(7);
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; i++)
+    {
+        std::string name;
+        const int length = (int)(random() % 24);
+        for (int j = 0; j < length; j++) name += (char)(1 + random() % 255);
+        names.push_back(name);
+    }
+    names.push_back("quote \" backslash \\ newline \n");
+    names.push_back("caf\xc3\xa9 \xe2\x9c\x93 \xf0\x9f\x93\x90");
+    names.push_back("overlong \xc0\xaf surrogate \xed\xa0\x80 truncated \xe2\x9c");
+
+    std::vector<cha::TraceEvent> events;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        cha::TraceEvent event = {names[i].c_str(), names[(i * 7) % names.size()].c_str(), i % 3 ? &view : nullptr,
+                                 random() % 1000000, random() % 10000, (uint32_t)(i % 4), (uint32_t)(random() % 5),
+                                 (uint32_t)(random() % 5), i % 5 ? cha::TraceEventHelper : cha::TraceEventSite};
+        events.push_back(event);
+    }
+
+    std::string json;
+    cha::writeChromeTrace(events.data(), events.size(), json);
+    CHA_CHECK(JSONValidator(json).validate());
+    CHA_CHECK(json.find("\"ph\":\"C\"") != std::string::npos);
+
+    std::string escaped;
+    cha::appendJSONString(names[names.size() - 3].c_str(), escaped);
+    CHA_CHECK_EQUAL(std::string("\"quote \\\" backslash \\\\ newline \\u000a\""), escaped);
+    escaped.clear();
+    cha::appendJSONString(names.back().c_str(), escaped);
+    CHA_CHECK_EQUAL(std::string("\"overlong \\ufffd\\ufffd surrogate \\ufffd\\ufffd\\ufffd truncated \\ufffd\\ufffd\""), escaped);
+}
@@ -0,0 +1,87 @@
+//
+//  CHAAnalyzeMain.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  Checks recorded constraint sets for required conflicts, redundant equalities and ambiguous views.
+//  Usage: cha_analyze [--quiet] recording.txt...
+//  Exits 1 when any set has a conflict or an ambiguity, 2 when a file cannot be read.
+//
+
+#include "CHAConstraintAnalyzer.h"
+#include "CHAConstraintRecording.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+int analyzeFile(const char *path, bool quiet)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 2;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    cha::ConstraintRecording recording;
+    std::string error;
+    if (!cha::parseConstraintRecording(text.str(), recording, &error))
+    {
+        fprintf(stderr, "%s: %s\n", path, error.c_str());
+        return 2;
+    }
+
+    cha::AnalysisReport report;
+    cha::analyzeConstraints(recording.records.data(), recording.records.size(), recording.container(), recording.width,
+                            recording.height, report);
+
+    const std::vector<const char *> origins = recording.originPointers();
+    const cha::ItemNamer nameForItem = [&recording](const void *item) { return recording.nameOfItem(item); };
+    for (const cha::AnalysisIssue &issue : report.issues)
+    {
+        if (quiet && issue.kind == cha::AnalysisIssueRedundant) continue;
+        printf("%s: %s\n", path, cha::describeIssue(issue, recording.records.data(), origins.data(), nameForItem).c_str());
+    }
+
+    const size_t conflicts = report.countOf(cha::AnalysisIssueConflict);
+    const size_t redundancies = report.countOf(cha::AnalysisIssueRedundant);
+    const size_t ambiguities = report.countOf(cha::AnalysisIssueAmbiguous);
+    printf("%s: %zu constraints, %zu conflicts, %zu redundant, %zu ambiguous\n", path, recording.records.size(), conflicts,
+           redundancies, ambiguities);
+    return conflicts + ambiguities > 0 ? 1 : 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    bool quiet = false;
+    int result = 0;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--quiet") == 0)
+        {
+            quiet = true;
+            continue;
+        }
+        const int status = analyzeFile(argv[i], quiet);
+        if (status > result) result = status;
+        files++;
+    }
+
+    if (files == 0)
+    {
+        fprintf(stderr, "usage: %s [--quiet] recording.txt...\n", argv[0]);
+        return 2;
+    }
+    return result;
+}
@@ -0,0 +1,79 @@
+//
+//  CHACompiledLayoutFuzzMain.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  A libFuzzer target for the compiled layout loader: any input either fails validation or loads and instantiates without
+//  reading out of bounds, into records UIKit would accept.
+//  Build with clang -fsanitize=fuzzer,address -DCHA_LIBFUZZER, seeding the corpus with files from cha_layoutc. Without
+//  CHA_LIBFUZZER it builds a driver that replays the files named on its command line, e.g. a crash found elsewhere.
+//
+
+#include "CHACompiledLayout.h"
+#include "CHALayoutDSL.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    // The loader reads records in place, so it wants them aligned as a mapping would be; fuzzer inputs are not.
+    std::vector<uint64_t> storage((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    if (size > 0) std::memcpy(storage.data(), data, size);
+
+    cha::CompiledLayout layout;
+    if (layout.open(storage.data(), size) != cha::CompiledLayoutStatusOK) return 0;
+
+    // A valid layout can declare far more slots than it uses, so the items table only covers the used ones.
+    uint32_t usedSlots = 0;
+    for (size_t index = 0; index < layout.recordCount(); index++)
+    {
+        const cha::CompiledRecord &record = layout.records()[index];
+        usedSlots = std::max(usedSlots, record.item + 1);
+        if (record.toItem != cha::CompiledRecordNoSlot) usedSlots = std::max(usedSlots, record.toItem + 1);
+
+        const bool accepted = record.toItem == cha::CompiledRecordNoSlot
+                                  ? cha::dsl::isDimensionAttribute(record.attribute)
+                                  : cha::dsl::canRelateAttributes(record.attribute, record.toAttribute);
+        if (!accepted) std::abort();
+    }
+    std::vector<const void *> items(usedSlots);
+    for (uint32_t slot = 0; slot < usedSlots; slot++) items[slot] = cha::CompiledLayoutWriter::slotHandle(slot);
+    std::vector<CHAConstraintDescriptor> descriptors(layout.recordCount());
+    layout.instantiate(items.data(), descriptors.data());
+
+    // Names may share storage, so only reading each one to its terminator is checked, by the sanitizer.
+    volatile size_t length = 0;
+    for (uint32_t slot = 0; layout.slotName(0) && slot < layout.slotCount(); slot++)
+    {
+        length += std::strlen(layout.slotName(slot));
+    }
+    return 0;
+}
+
+#ifndef CHA_LIBFUZZER
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in)
+        {
+            fprintf(stderr, "%s: cannot open\n", argv[i]);
+            return 2;
+        }
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+        printf("%s: %zu bytes replayed\n", argv[i], bytes.size());
+    }
+    return 0;
+}
+
+#endif
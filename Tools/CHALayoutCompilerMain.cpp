@@ -0,0 +1,140 @@
+//
+//  CHALayoutCompilerMain.cpp
+//  CHAAutolayoutCategories
+//
+//  Copyright (c) 2015 ChiselApps. All rights reserved.
+//
+//  Compiles recorded constraint sets into the memory-mappable compiled layout format, and checks or prints compiled layouts.
+//  Usage: cha_layoutc recording.txt -o layout.chal
+//         cha_layoutc --validate layout.chal...
+//         cha_layoutc --dump layout.chal
+//  Exits 1 when a recording does not compile or a layout is invalid, 2 when a file cannot be read or written.
+//
+
+#include "CHACompiledLayout.h"
+#include "CHAConstraintRecording.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+int compileFile(const char *path, const char *outputPath)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 2;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    cha::ConstraintRecording recording;
+    std::string error;
+    if (!cha::parseConstraintRecording(text.str(), recording, &error))
+    {
+        fprintf(stderr, "%s: %s\n", path, error.c_str());
+        return 2;
+    }
+
+    // Recording items are numbered the way slots are, so item i compiles to slot i and the container to slot 0.
+    cha::CompiledLayoutWriter writer((uint32_t)recording.itemNames.size());
+    for (size_t index = 0; index < recording.itemNames.size(); index++)
+    {
+        writer.setSlotName((uint32_t)index, recording.itemNames[index]);
+    }
+    int result = 0;
+    for (size_t index = 0; index < recording.records.size(); index++)
+    {
+        if (writer.addDescriptor(recording.records[index])) continue;
+        const std::string &origin = recording.origins[index];
+        fprintf(stderr, "%s: constraint %zu cannot be compiled%s%s\n", path, index + 1, origin.empty() ? "" : " at ",
+                origin.c_str());
+        result = 1;
+    }
+    if (result != 0) return result;
+
+    std::vector<uint8_t> bytes;
+    writer.write(bytes);
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), (std::streamsize)bytes.size());
+    if (!out)
+    {
+        fprintf(stderr, "%s: cannot write\n", outputPath);
+        return 2;
+    }
+    printf("%s: %zu constraints, %u slots, %zu bytes\n", outputPath, writer.recordCount(), writer.slotCount(), bytes.size());
+    return 0;
+}
+
+int openLayout(const char *path, cha::MappedCompiledLayout &mapped)
+{
+    const cha::CompiledLayoutStatus status = mapped.open(path);
+    if (status == cha::CompiledLayoutStatusOK) return 0;
+    fprintf(stderr, "%s: %s\n", path, cha::describeCompiledLayoutStatus(status));
+    return status == cha::CompiledLayoutStatusUnreadable ? 2 : 1;
+}
+
+int validateFile(const char *path)
+{
+    cha::MappedCompiledLayout mapped;
+    const int result = openLayout(path, mapped);
+    if (result != 0) return result;
+
+    const cha::CompiledLayout &layout = mapped.layout();
+    printf("%s: version %u, %zu constraints, %u slots%s\n", path, layout.version(), layout.recordCount(), layout.slotCount(),
+           layout.slotName(0) ? ", named" : "");
+    return 0;
+}
+
+int dumpFile(const char *path)
+{
+    cha::MappedCompiledLayout mapped;
+    const int result = openLayout(path, mapped);
+    if (result != 0) return result;
+
+    // Printed as a recording with a free container, so the output feeds straight into cha_analyze.
+    const cha::CompiledLayout &layout = mapped.layout();
+    cha::ConstraintRecording recording;
+    recording.width = -1;
+    recording.height = -1;
+    std::vector<const void *> items;
+    for (uint32_t slot = 0; slot < layout.slotCount(); slot++)
+    {
+        const char *name = layout.slotName(slot);
+        recording.itemNames.push_back(name && *name ? name : "slot" + std::to_string(slot));
+        items.push_back(cha::ConstraintRecording::item(slot));
+    }
+    recording.records.resize(layout.recordCount());
+    recording.origins.resize(layout.recordCount());
+    layout.instantiate(items.data(), recording.records.data());
+
+    fputs(cha::writeConstraintRecording(recording).c_str(), stdout);
+    return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 3 && std::strcmp(argv[1], "--validate") == 0)
+    {
+        int result = 0;
+        for (int i = 2; i < argc; i++)
+        {
+            const int status = validateFile(argv[i]);
+            if (status > result) result = status;
+        }
+        return result;
+    }
+    if (argc == 3 && std::strcmp(argv[1], "--dump") == 0) return dumpFile(argv[2]);
+    if (argc == 4 && std::strcmp(argv[2], "-o") == 0) return compileFile(argv[1], argv[3]);
+
+    fprintf(stderr, "usage: %s recording.txt -o layout.chal\n", argv[0]);
+    fprintf(stderr, "       %s --validate layout.chal...\n", argv[0]);
+    fprintf(stderr, "       %s --dump layout.chal\n", argv[0]);
+    return 2;
+}